@@ -0,0 +1,202 @@
+#include "config.h"
+#include "axis_predictor.h"
+#include "fixed_point.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/* Velocity uncertainty before the first two samples (deg/s) */
+#define PRED_INIT_VEL_SIGMA   (100.0F)
+
+void PRED_DefaultConfig(PredictorConfig_t *cfg)
+{
+    cfg->accel_noise    = PRED_ACCEL_NOISE;
+    cfg->pos_noise_deg  = PRED_POS_NOISE_DEG;
+    cfg->vel_noise      = 0.0F;
+    cfg->vel_to_deg_s   = 0.0F;
+    cfg->max_horizon_us = PRED_MAX_HORIZON_US;
+}
+
+void PRED_Init(AxisPredictor_t *p, const PredictorConfig_t *cfg)
+{
+    (void)memset(p, 0, sizeof(*p));
+    if (cfg != NULL)
+    {
+        p->cfg = *cfg;
+    }
+    else
+    {
+        PRED_DefaultConfig(&p->cfg);
+    }
+}
+
+/*----------------------------------------------------------
+ * Helper: signed interval to a time, clamped to the horizon
+ *----------------------------------------------------------*/
+static float Horizon(const AxisPredictor_t *p, uint64_t at_us)
+{
+    int64_t dt_us = (int64_t)(at_us - p->t_us);
+    int64_t h = (int64_t)p->cfg.max_horizon_us;
+
+    dt_us = (dt_us > h) ? h : ((dt_us < -h) ? -h : dt_us);
+    return (float)dt_us * 1e-6F;
+}
+
+/*----------------------------------------------------------
+ * Time update: x = F x, P = F P F' + Q (white acceleration)
+ *----------------------------------------------------------*/
+static void Propagate(AxisPredictor_t *p, float dt)
+{
+    float q = p->cfg.accel_noise;
+
+    p->pos += p->vel * dt;
+    p->p00 += (dt * ((2.0F * p->p01) + (dt * p->p11))) + ((q * dt * dt * dt) / 3.0F);
+    p->p01 += (dt * p->p11) + ((q * dt * dt) / 2.0F);
+    p->p11 += q * dt;
+}
+
+/*----------------------------------------------------------
+ * Measurement updates (scalar, one after the other)
+ *----------------------------------------------------------*/
+static void CorrectPosition(AxisPredictor_t *p, float z)
+{
+    float r  = p->cfg.pos_noise_deg * p->cfg.pos_noise_deg;
+    float s  = p->p00 + r;
+    float k0 = p->p00 / s;
+    float k1 = p->p01 / s;
+    float y  = z - p->pos;
+
+    p->pos += k0 * y;
+    p->vel += k1 * y;
+    p->p11 -= k1 * p->p01;
+    p->p01 *= (1.0F - k0);
+    p->p00 *= (1.0F - k0);
+}
+
+static void CorrectVelocity(AxisPredictor_t *p, float z)
+{
+    float r  = p->cfg.vel_noise * p->cfg.vel_noise;
+    float s  = p->p11 + r;
+    float k0 = p->p01 / s;
+    float k1 = p->p11 / s;
+    float y  = z - p->vel;
+
+    p->pos += k0 * y;
+    p->vel += k1 * y;
+    p->p00 -= k0 * p->p01;
+    p->p01 *= (1.0F - k1);
+    p->p11 *= (1.0F - k1);
+}
+
+bool PRED_Update(AxisPredictor_t *p, uint64_t sample_us, float pos_deg, float vel)
+{
+    bool use_vel = (p->cfg.vel_to_deg_s != 0.0F) && (p->cfg.vel_noise > 0.0F);
+
+    if (!p->valid)
+    {
+        float r = p->cfg.pos_noise_deg;
+
+        p->pos = pos_deg;
+        p->vel = use_vel ? (vel * p->cfg.vel_to_deg_s) : 0.0F;
+        p->p00 = r * r;
+        p->p01 = 0.0F;
+        p->p11 = use_vel ? (p->cfg.vel_noise * p->cfg.vel_noise)
+                         : (PRED_INIT_VEL_SIGMA * PRED_INIT_VEL_SIGMA);
+        p->t_us = sample_us;
+        p->valid = true;
+        return true;
+    }
+
+    if (sample_us <= p->t_us)
+    {
+        return false;                   /* same or older sample */
+    }
+
+    /* Score what a caller would have been told for this instant */
+    {
+        float err = fabsf(pos_deg - PRED_Position(p, sample_us));
+
+        p->stats.samples++;
+        p->stats.err_sq_sum += err * err;
+        p->stats.err_max = (err > p->stats.err_max) ? err : p->stats.err_max;
+        p->stats.interval_sum_us += sample_us - p->t_us;
+    }
+
+    Propagate(p, (float)(sample_us - p->t_us) * 1e-6F);
+    p->t_us = sample_us;
+
+    CorrectPosition(p, pos_deg);
+    if (use_vel)
+    {
+        CorrectVelocity(p, vel * p->cfg.vel_to_deg_s);
+    }
+    return true;
+}
+
+float PRED_Position(const AxisPredictor_t *p, uint64_t at_us)
+{
+    return p->valid ? (p->pos + (p->vel * Horizon(p, at_us))) : 0.0F;
+}
+
+float PRED_Velocity(const AxisPredictor_t *p)
+{
+    return p->vel;
+}
+
+float PRED_Sigma(const AxisPredictor_t *p, uint64_t at_us)
+{
+    AxisPredictor_t ahead;
+
+    if (!p->valid)
+    {
+        return 0.0F;
+    }
+    ahead = *p;
+    Propagate(&ahead, fabsf(Horizon(p, at_us)));
+    return sqrtf(ahead.p00);
+}
+
+uint32_t PRED_UpdateFromStore(AxisPredictor_t *bank, const AxisStateStore_t *store)
+{
+    uint32_t n = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < store->count; i++)
+    {
+        if ((store->sample_us[i] != 0U) &&
+            PRED_Update(&bank[i], store->sample_us[i],
+                        FIX_ToFloat(store->position_deg[i]),
+                        FIX_ToFloat(store->velocity[i])))
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+const PredictorStats_t *PRED_GetStats(const AxisPredictor_t *p)
+{
+    return &p->stats;
+}
+
+void PRED_ResetStats(AxisPredictor_t *p)
+{
+    (void)memset(&p->stats, 0, sizeof(p->stats));
+}
+
+void PRED_PrintStats(const AxisPredictor_t *p, const char *name)
+{
+    const PredictorStats_t *s = &p->stats;
+
+    if (s->samples == 0U)
+    {
+        printf("  %-6s: no samples scored\n", name);
+        return;
+    }
+    printf("  %-6s: poll %lu us | prediction error rms %.4f deg, max %.4f deg (%lu samples)\n",
+           name, (unsigned long)(s->interval_sum_us / s->samples),
+           (double)sqrtf(s->err_sq_sum / (float)s->samples), (double)s->err_max,
+           (unsigned long)s->samples);
+}
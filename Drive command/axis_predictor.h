@@ -0,0 +1,125 @@
+#ifndef AXIS_PREDICTOR_H
+#define AXIS_PREDICTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_state.h"
+
+/*===========================================================
+ * Per-Axis Position Predictor
+ *===========================================================*/
+/* Constant-velocity Kalman filter on timestamped feedback. Samples
+ * arrive at irregular intervals (poll jitter, retries); the filter
+ * takes the interval from the sample times, so it needs no fixed
+ * period. At a steady poll rate it settles to an alpha-beta filter.
+ * Between polls the position at any time is extrapolated from the
+ * last estimate, so the HMI, tracker and limit checks can read
+ * positions at their own rate without another network read.
+ *
+ * Accuracy: before each update the filter predicts the new sample
+ * from the previous one. The error of that prediction is the error
+ * a caller would have seen at the current poll interval, and
+ * PRED_GetStats() reports its RMS and maximum. */
+
+/* Defaults for PRED_DefaultConfig() */
+#ifndef PRED_ACCEL_NOISE
+    #define PRED_ACCEL_NOISE      (400.0F)     /* (deg/s^2)^2 per Hz */
+#endif
+#ifndef PRED_POS_NOISE_DEG
+    #define PRED_POS_NOISE_DEG    (0.01F)      /* 1 count of POS_DEG */
+#endif
+#ifndef PRED_MAX_HORIZON_US
+    #define PRED_MAX_HORIZON_US   (200000U)    /* Hold after 200 ms */
+#endif
+
+/**
+ * @brief Filter tuning
+ */
+typedef struct
+{
+    float    accel_noise;       /**< Process noise: unmodelled accel, (deg/s^2)^2/Hz */
+    float    pos_noise_deg;     /**< Position measurement sigma (deg) */
+    float    vel_noise;         /**< Velocity measurement sigma (deg/s); 0 = ignore */
+    float    vel_to_deg_s;      /**< Velocity register unit to deg/s; 0 = ignore */
+    uint32_t max_horizon_us;    /**< Extrapolate at most this far past a sample */
+} PredictorConfig_t;
+
+/**
+ * @brief Prediction error at sample times
+ */
+typedef struct
+{
+    uint32_t samples;           /**< Updates scored */
+    float    err_sq_sum;        /**< Sum of squared errors (deg^2) */
+    float    err_max;           /**< Largest absolute error (deg) */
+    uint64_t interval_sum_us;   /**< For the mean poll interval */
+} PredictorStats_t;
+
+/**
+ * @brief State of one axis
+ */
+typedef struct
+{
+    PredictorConfig_t cfg;
+    float    pos;               /**< Estimate at t_us (deg) */
+    float    vel;               /**< deg/s */
+    float    p00;               /**< Covariance [pos pos; pos vel; vel vel] */
+    float    p01;
+    float    p11;
+    uint64_t t_us;              /**< Time of the estimate (TIME_NowUs base) */
+    bool     valid;             /**< Has seen a sample */
+    PredictorStats_t stats;
+} AxisPredictor_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief Defaults above; position only
+ */
+void PRED_DefaultConfig(PredictorConfig_t *cfg);
+
+/**
+ * @brief Reset an axis (cfg NULL = defaults)
+ */
+void PRED_Init(AxisPredictor_t *p, const PredictorConfig_t *cfg);
+
+/**
+ * @brief Feed one sample
+ * @param sample_us  Sample time (e.g. FeedbackSample_t.sample_us)
+ * @param pos_deg    Measured position
+ * @param vel        Measured velocity in register units (used when
+ *                   vel_to_deg_s and vel_noise are set)
+ * @return false if the sample is not newer than the estimate (ignored)
+ */
+bool PRED_Update(AxisPredictor_t *p, uint64_t sample_us, float pos_deg, float vel);
+
+/**
+ * @brief Predicted position / velocity at a time (past or future);
+ *        0 before the first sample
+ */
+float PRED_Position(const AxisPredictor_t *p, uint64_t at_us);
+float PRED_Velocity(const AxisPredictor_t *p);
+
+/**
+ * @brief Standard deviation of PRED_Position at a time (deg)
+ */
+float PRED_Sigma(const AxisPredictor_t *p, uint64_t at_us);
+
+/**
+ * @brief Feed every axis of a polled store whose sample is new
+ *        (bank[i] belongs to store index i)
+ * @return Axes updated
+ */
+uint32_t PRED_UpdateFromStore(AxisPredictor_t *bank, const AxisStateStore_t *store);
+
+/**
+ * @brief Prediction error statistics
+ */
+const PredictorStats_t *PRED_GetStats(const AxisPredictor_t *p);
+void PRED_ResetStats(AxisPredictor_t *p);
+void PRED_PrintStats(const AxisPredictor_t *p, const char *name);
+
+#endif /* AXIS_PREDICTOR_H */
@@ -0,0 +1,159 @@
+#include "config.h"
+#include "axis_state.h"
+#include "modbus_functions.h"
+#include "modbus_decode.h"
+#include "register_access.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Word offsets inside the per-axis input block */
+#define OFS_FAULT_STATUS   (REG_PAN_FAULT_STATUS   - AXIS_BLOCK_FIRST)
+#define OFS_POS_DEG        (REG_PAN_POS_DEG        - AXIS_BLOCK_FIRST)
+#define OFS_VEL_SPD        (REG_PAN_VEL_SPD        - AXIS_BLOCK_FIRST)
+#define OFS_POS_MM         (REG_PAN_POS_MM         - AXIS_BLOCK_FIRST)
+#define OFS_RPM            (REG_PAN_RPM            - AXIS_BLOCK_FIRST)
+#define OFS_CURRENT        (REG_PAN_ACTUAL_CURRENT - AXIS_BLOCK_FIRST)
+#define OFS_IO_STATUS      (REG_PAN_IO_STATUS      - AXIS_BLOCK_FIRST)
+#define OFS_SYS_STATUS     (REG_PAN_SYSTEM_STATUS  - AXIS_BLOCK_FIRST)
+#define OFS_DCBUS          (REG_PAN_DCBUS_VOLT     - AXIS_BLOCK_FIRST)
+#define OFS_TEMP           (REG_PAN_TEMP           - AXIS_BLOCK_FIRST)
+#define OFS_FAULT_CODE     (REG_PAN_FAULT_CODE     - AXIS_BLOCK_FIRST)
+
+/*----------------------------------------------------------
+ * Initialize store
+ *----------------------------------------------------------*/
+void AXIS_STATE_Init(AxisStateStore_t *store, uint32_t count)
+{
+    uint32_t i;
+
+    (void)memset(store, 0, sizeof(*store));
+    store->count = (count > AXIS_STATE_CAPACITY) ? AXIS_STATE_CAPACITY : count;
+
+    for (i = 0U; i < store->count; i++)
+    {
+        if (AXIS_IsValid((Axis_t)(i + 1U)))
+        {
+            const AxisDescriptor_t *desc = AXIS_Get((Axis_t)(i + 1U));
+            store->limit_min_deg[i] = FIX_FromFloat(desc->limit_min_deg);
+            store->limit_max_deg[i] = FIX_FromFloat(desc->limit_max_deg);
+        }
+    }
+}
+
+/*----------------------------------------------------------
+ * Decode one axis block straight into the arrays
+ *----------------------------------------------------------*/
+void AXIS_STATE_Decode(AxisStateStore_t *store, uint32_t idx, const uint8_t *regs)
+{
+    uint16_t w[AXIS_BLOCK_REGS];
+
+    /* Whole block to host order in one pass, then gather the fields */
+    MODBUS_DecodeWords(regs, w, AXIS_BLOCK_REGS);
+
+    store->fault_bits[idx]   = w[OFS_FAULT_STATUS];
+    store->raw_pos_deg[idx]  = (int16_t)w[OFS_POS_DEG];
+    store->raw_velocity[idx] = (int16_t)w[OFS_VEL_SPD];
+    store->raw_pos_mm[idx]   = (int16_t)w[OFS_POS_MM];
+    store->raw_rpm[idx]      = (int16_t)w[OFS_RPM];
+    store->raw_current[idx]  = (int16_t)w[OFS_CURRENT];
+    store->io_status[idx]    = w[OFS_IO_STATUS];
+    store->sys_status[idx]   = w[OFS_SYS_STATUS];
+    store->raw_dcbus[idx]    = w[OFS_DCBUS];
+    store->raw_temp[idx]     = w[OFS_TEMP];
+    store->fault_code[idx]   = w[OFS_FAULT_CODE];
+}
+
+/*----------------------------------------------------------
+ * Unit conversion: one straight loop per quantity
+ *   (scales from the register table, as the Read_* functions)
+ *----------------------------------------------------------*/
+void AXIS_STATE_Convert(AxisStateStore_t *store)
+{
+    uint32_t i;
+    uint32_t n = store->count;
+
+    for (i = 0U; i < n; i++) { store->position_deg[i] = REG_Decode_POS_DEG((uint16_t)store->raw_pos_deg[i]); }
+    for (i = 0U; i < n; i++) { store->position_mm[i]  = REG_Decode_POS_MM((uint16_t)store->raw_pos_mm[i]); }
+    for (i = 0U; i < n; i++) { store->velocity[i]     = REG_Decode_VEL_SPD((uint16_t)store->raw_velocity[i]); }
+    for (i = 0U; i < n; i++) { store->rpm[i]          = REG_Decode_RPM((uint16_t)store->raw_rpm[i]); }
+    for (i = 0U; i < n; i++) { store->current[i]      = REG_Decode_ACTUAL_CURRENT((uint16_t)store->raw_current[i]); }
+    for (i = 0U; i < n; i++) { store->dcbus[i]        = REG_Decode_DCBUS_VOLT(store->raw_dcbus[i]); }
+    for (i = 0U; i < n; i++) { store->temperature[i]  = REG_Decode_TEMP(store->raw_temp[i]); }
+}
+
+/*----------------------------------------------------------
+ * Limit check across all axes (branch-free body)
+ *----------------------------------------------------------*/
+uint32_t AXIS_STATE_CheckLimits(const AxisStateStore_t *store, AxisMask_t *mask)
+{
+    uint32_t found = 0U;
+    uint32_t i;
+
+    (void)memset(mask, 0, sizeof(*mask));
+    for (i = 0U; i < store->count; i++)
+    {
+        uint32_t out = (uint32_t)((store->position_deg[i] < store->limit_min_deg[i]) |
+                                  (store->position_deg[i] > store->limit_max_deg[i]));
+        mask->word[i / 32U] |= out << (i % 32U);
+        found += out;
+    }
+    return found;
+}
+
+/*----------------------------------------------------------
+ * Fault scan across all axes
+ *----------------------------------------------------------*/
+uint32_t AXIS_STATE_ScanFaults(const AxisStateStore_t *store, AxisMask_t *mask)
+{
+    uint32_t found = 0U;
+    uint32_t i;
+
+    (void)memset(mask, 0, sizeof(*mask));
+    for (i = 0U; i < store->count; i++)
+    {
+        uint32_t faulted = (uint32_t)((store->fault_bits[i] & FAULT_ANY_MASK) != 0U);
+        mask->word[i / 32U] |= faulted << (i % 32U);
+        found += faulted;
+    }
+    return found;
+}
+
+/*----------------------------------------------------------
+ * Poll every configured axis: one block read each
+ *----------------------------------------------------------*/
+uint32_t AXIS_STATE_Poll(AxisStateStore_t *store)
+{
+    uint32_t ok = 0U;
+    uint32_t i;
+    uint32_t n = (store->count < AXIS_COUNT) ? store->count : AXIS_COUNT;
+
+    for (i = 0U; i < n; i++)
+    {
+        Axis_t axis = (Axis_t)(i + 1U);
+        ModbusView_t view;
+        int32_t len = MODBUS_ReadView(AXIS_UnitId(axis), MODBUS_FUNC_READ_INPUT,
+                                      AXIS_Reg(axis, AXIS_BLOCK_FIRST),
+                                      AXIS_BLOCK_REGS, &view);
+
+        if (len < 0)
+        {
+            printf("[ERROR] %s state block read failed\n", AXIS_Get(axis)->name);
+            continue;
+        }
+
+        /* Decode straight out of the pooled frame */
+        AXIS_STATE_Decode(store, i, view.regs);
+        store->sample_us[i] = TSTAMP_Midpoint(&view.stamp);
+        MODBUS_ViewRelease(&view);
+        ok++;
+    }
+
+    AXIS_STATE_Convert(store);
+    return ok;
+}
+
+void AXIS_STATE_PollTask(void *arg)
+{
+    (void)AXIS_STATE_Poll((AxisStateStore_t *)arg);
+}
@@ -0,0 +1,129 @@
+#ifndef AXIS_STATE_H
+#define AXIS_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_table.h"
+#include "fixed_point.h"
+
+/*===========================================================
+ * Structure-of-Arrays Axis State Store
+ *===========================================================*/
+
+/* Capacity of the store (axes). Override at build time for gateways
+ * aggregating several controllers, e.g. -DAXIS_STATE_CAPACITY=256 */
+#ifndef AXIS_STATE_CAPACITY
+    #define AXIS_STATE_CAPACITY   (AXIS_MAX_COUNT)
+#endif
+
+/* Set of axes, bit (i % 32) of word (i / 32) = store index i; sized
+ * to the capacity so no axis falls outside the scans */
+#define AXIS_MASK_WORDS       ((AXIS_STATE_CAPACITY + 31U) / 32U)
+
+typedef struct
+{
+    uint32_t word[AXIS_MASK_WORDS];
+} AxisMask_t;
+
+static inline bool AXIS_MASK_Test(const AxisMask_t *mask, uint32_t idx)
+{
+    return ((mask->word[idx / 32U] >> (idx % 32U)) & 1U) != 0U;
+}
+
+/* One input block per axis: fault status (384) .. fault code (430) */
+#define AXIS_BLOCK_FIRST      (REG_PAN_FAULT_STATUS)
+#define AXIS_BLOCK_REGS       ((REG_PAN_FAULT_CODE - REG_PAN_FAULT_STATUS) + 1U)
+
+/* Fault bits that make an axis faulted */
+#define FAULT_ANY_MASK        (FAULT_SHORT_CKT | FAULT_OVER_TEMP | FAULT_OVER_VOLT | \
+                               FAULT_UNDER_VOLT | FAULT_LOCK_ROTOR)
+
+/**
+ * @brief Axis state, one contiguous array per quantity
+ */
+typedef struct
+{
+    uint32_t count;                                /**< Axes in use */
+
+    /* Raw register words, filled by the block decoder */
+    int16_t  raw_pos_deg[AXIS_STATE_CAPACITY];
+    int16_t  raw_velocity[AXIS_STATE_CAPACITY];
+    int16_t  raw_pos_mm[AXIS_STATE_CAPACITY];
+    int16_t  raw_rpm[AXIS_STATE_CAPACITY];
+    int16_t  raw_current[AXIS_STATE_CAPACITY];
+    uint16_t raw_dcbus[AXIS_STATE_CAPACITY];
+    uint16_t raw_temp[AXIS_STATE_CAPACITY];
+
+    /* Engineering units (Q16.16), produced by AXIS_STATE_Convert */
+    fix16_t  position_deg[AXIS_STATE_CAPACITY];
+    fix16_t  velocity[AXIS_STATE_CAPACITY];
+    fix16_t  position_mm[AXIS_STATE_CAPACITY];
+    fix16_t  rpm[AXIS_STATE_CAPACITY];
+    fix16_t  current[AXIS_STATE_CAPACITY];
+    fix16_t  dcbus[AXIS_STATE_CAPACITY];
+    fix16_t  temperature[AXIS_STATE_CAPACITY];
+
+    /* Status words and packed fault bitmasks */
+    uint16_t fault_bits[AXIS_STATE_CAPACITY];
+    uint16_t io_status[AXIS_STATE_CAPACITY];
+    uint16_t sys_status[AXIS_STATE_CAPACITY];
+    uint16_t fault_code[AXIS_STATE_CAPACITY];
+
+    /* Sample time of each axis block (midpoint of request and reply,
+     * monotonic us); kept from the last successful read */
+    uint64_t sample_us[AXIS_STATE_CAPACITY];
+
+    /* Software limits (Q16.16), converted once from the axis table */
+    fix16_t  limit_min_deg[AXIS_STATE_CAPACITY];
+    fix16_t  limit_max_deg[AXIS_STATE_CAPACITY];
+} AxisStateStore_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief Clear the store and load limits for axes 1..count from the table
+ */
+void AXIS_STATE_Init(AxisStateStore_t *store, uint32_t count);
+
+/**
+ * @brief Decode one axis input block (AXIS_BLOCK_REGS big-endian words)
+ * @param idx   Store index (axis - 1)
+ * @param regs  Register data of the block, as received
+ */
+void AXIS_STATE_Decode(AxisStateStore_t *store, uint32_t idx, const uint8_t *regs);
+
+/**
+ * @brief Convert all raw words to Q16.16 engineering units in one pass
+ *        (integer only; use FIX_ToFloat() where a float is needed)
+ */
+void AXIS_STATE_Convert(AxisStateStore_t *store);
+
+/**
+ * @brief  Axes outside their software limits
+ * @param  mask  Filled with the axes found (all store indices)
+ * @return Number of axes found
+ */
+uint32_t AXIS_STATE_CheckLimits(const AxisStateStore_t *store, AxisMask_t *mask);
+
+/**
+ * @brief  Axes with any FAULT_ANY_MASK bit set
+ * @param  mask  Filled with the axes found (all store indices)
+ * @return Number of axes found
+ */
+uint32_t AXIS_STATE_ScanFaults(const AxisStateStore_t *store, AxisMask_t *mask);
+
+/**
+ * @brief Read the input block of every axis, decode and convert
+ * @return Number of axes read successfully
+ */
+uint32_t AXIS_STATE_Poll(AxisStateStore_t *store);
+
+/**
+ * @brief CyclicTaskFn_t wrapper: arg is an AxisStateStore_t *
+ */
+void AXIS_STATE_PollTask(void *arg);
+
+#endif /* AXIS_STATE_H */
@@ -0,0 +1,81 @@
+#include "config.h"
+#include "axis_table.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*----------------------------------------------------------
+ * Axis descriptor table (user editable, one row per axis)
+ *----------------------------------------------------------*/
+static const AxisDescriptor_t axis_table[] =
+{
+    /* Axis 1: PAN */
+    {
+        AXIS1_NAME, 0U * AXIS_REG_STRIDE, MODBUS_UNIT_ID,
+        AXIS1_IP_ADDR, AXIS1_PORT_UDP,
+        PAN_LIMIT_LEFT_DEG, PAN_LIMIT_RIGHT_DEG,
+        PAN_LIMIT_LEFT_MM,  PAN_LIMIT_RIGHT_MM,
+        MAX_RPM, DPMR_MM, ACCEL_FACTOR
+    },
+#if (AXIS_COUNT >= 2U)
+    /* Axis 2: TILT */
+    {
+        AXIS2_NAME, 1U * AXIS_REG_STRIDE, MODBUS_UNIT_ID,
+        AXIS2_IP_ADDR, AXIS2_PORT_UDP,
+        TILT_LIMIT_DOWN_DEG, TILT_LIMIT_UP_DEG,
+        TILT_LIMIT_DOWN_MM,  TILT_LIMIT_UP_MM,
+        MAX_RPM, DPMR_MM, ACCEL_FACTOR
+    },
+#endif
+};
+
+/* One row per configured axis: fails to compile (negative array
+ * size) when AXIS_COUNT is raised without adding its rows */
+typedef char axis_table_rows_check[((sizeof(axis_table) / sizeof(axis_table[0])) == AXIS_COUNT) ? 1 : -1];
+
+/*----------------------------------------------------------
+ * Axis validity check (API boundaries)
+ *----------------------------------------------------------*/
+bool AXIS_IsValid(Axis_t axis)
+{
+    return ((uint32_t)axis >= 1U) && ((uint32_t)axis <= AXIS_COUNT);
+}
+
+/*----------------------------------------------------------
+ * Descriptor lookup
+ *----------------------------------------------------------*/
+const AxisDescriptor_t *AXIS_Get(Axis_t axis)
+{
+    return &axis_table[(uint32_t)axis - 1U];
+}
+
+/*----------------------------------------------------------
+ * Register address: table lookup, no per-axis branching
+ *----------------------------------------------------------*/
+uint16_t AXIS_Reg(Axis_t axis, uint16_t pan_addr)
+{
+    return (uint16_t)(pan_addr + axis_table[(uint32_t)axis - 1U].reg_offset);
+}
+
+/*----------------------------------------------------------
+ * Modbus endpoint of an axis
+ *----------------------------------------------------------*/
+uint8_t AXIS_UnitId(Axis_t axis)
+{
+    return axis_table[(uint32_t)axis - 1U].unit_id;
+}
+
+bool AXIS_SharedEndpoint(void)
+{
+    uint32_t i;
+
+    for (i = 1U; i < AXIS_COUNT; i++)
+    {
+        if ((axis_table[i].port != axis_table[0].port) ||
+            (strcmp(axis_table[i].ip_addr, axis_table[0].ip_addr) != 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef AXIS_TABLE_H
+#define AXIS_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+/* Axis number (1-based). PAN/TILT kept for the dual-axis gimbal;
+ * axes 3..AXIS_COUNT are addressed as (Axis_t)n. */
+typedef enum
+{
+    AXIS_PAN = 1U,
+    AXIS_TILT = 2U
+} Axis_t;
+
+/**
+ * @brief Static description of one drive axis
+ */
+typedef struct
+{
+    const char *name;           /**< Display name */
+    uint16_t    reg_offset;     /**< Added to the axis-1 register address */
+    uint8_t     unit_id;        /**< Modbus slave ID of the controller */
+    const char *ip_addr;        /**< UDP endpoint of the controller */
+    uint16_t    port;
+    float       limit_min_deg;  /**< Software limits (deg) */
+    float       limit_max_deg;
+    float       limit_min_mm;   /**< Software limits (mm) */
+    float       limit_max_mm;
+    float       max_rpm;        /**< Motor speed limit */
+    float       mm_per_rev;     /**< Travel per motor revolution */
+    float       accel_factor;   /**< Max accel = max vel x factor */
+} AxisDescriptor_t;
+
+#if (AXIS_COUNT > AXIS_MAX_COUNT) || (AXIS_COUNT < 1U)
+    #error "AXIS_COUNT must be between 1 and AXIS_MAX_COUNT"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  true if axis is 1..AXIS_COUNT
+ */
+bool AXIS_IsValid(Axis_t axis);
+
+/**
+ * @brief  Descriptor of a valid axis (see AXIS_IsValid)
+ */
+const AxisDescriptor_t *AXIS_Get(Axis_t axis);
+
+/**
+ * @brief  Register address of this axis for an axis-1 (REG_PAN_*) address
+ */
+uint16_t AXIS_Reg(Axis_t axis, uint16_t pan_addr);
+
+/**
+ * @brief  Modbus unit ID serving this axis
+ */
+uint8_t AXIS_UnitId(Axis_t axis);
+
+/**
+ * @brief  true if every configured axis uses the endpoint of axis 1
+ */
+bool AXIS_SharedEndpoint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AXIS_TABLE_H */
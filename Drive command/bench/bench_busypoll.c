@@ -0,0 +1,103 @@
+/*
+ * Control socket latency: blocking receive vs busy polling.
+ *
+ * Runs one register read per cycle of a 1 kHz cyclic executive, first
+ * with the plain blocking receive, then spinning up to the budget, and
+ * prints round trip and CPU time per cycle for both.
+ *
+ *   bench_busypoll [cycles] [cpu] [spin_us] [busy_poll_us]
+ *
+ * Build (from "Drive command"; simulator on DRIVE_IP_ADDR:DRIVE_PORT_UDP):
+ *   gcc -O2 -I. bench/bench_busypoll.c modbus_functions.c net_timestamp.c
+ *       frame_pool.c cyclic_exec.c drive_time.c axis_table.c -o bench_busypoll
+ */
+#include "config.h"
+#include "modbus_functions.h"
+#include "cyclic_exec.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__linux__)
+    #include <unistd.h>
+#endif
+
+#define BENCH_ADDR   (412U)     /* REG_PAN_POSITION: two input registers */
+#define BENCH_REGS   (2U)
+
+static uint32_t failures = 0U;
+
+static void ReadTask(void *arg)
+{
+    ModbusView_t view;
+
+    (void)arg;
+    if (MODBUS_ReadView(1U, MODBUS_FUNC_READ_INPUT, BENCH_ADDR, BENCH_REGS, &view) < 0)
+    {
+        failures++;
+    }
+    MODBUS_ViewRelease(&view);
+}
+
+static void RunMode(const char *name, const ModbusLowLatency_t *ll, uint64_t cycles)
+{
+    const ModbusRxStats_t *s = MODBUS_GetRxStats();
+    clock_t c0;
+    double  cpu_us;
+
+    (void)MODBUS_SetLowLatency(ll);
+    CYCLIC_Run(20U);                    /* warm up */
+    MODBUS_ResetRxStats();
+    failures = 0U;
+
+    c0 = clock();
+    CYCLIC_Run(cycles);
+    cpu_us = ((double)(clock() - c0) * 1e6) / (double)CLOCKS_PER_SEC;
+
+    if (s->receives == 0U)
+    {
+        printf("%-9s no replies (simulator running?)\n", name);
+        return;
+    }
+    printf("%-9s rtt avg %5lu us  min %4lu  max %5lu | cpu %6.1f us/cycle | "
+           "spin hits %llu fallbacks %llu | failed %u\n",
+           name, (unsigned long)(s->rtt_sum_us / s->receives),
+           (unsigned long)s->rtt_min_us, (unsigned long)s->rtt_max_us,
+           cpu_us / (double)cycles,
+           (unsigned long long)s->spin_hits, (unsigned long long)s->fallbacks,
+           (unsigned)failures);
+}
+
+int main(int argc, char **argv)
+{
+    CyclicConfig_t     cfg = { 1000U, 0, -1, false };
+    ModbusLowLatency_t off = { 0U, 0U };
+    ModbusLowLatency_t spin = { MODBUS_SPIN_BUDGET_US, 0U };
+    uint64_t           cycles = 2000U;
+
+    cycles = (argc > 1) ? (uint64_t)atoi(argv[1]) : cycles;
+    cfg.cpu = (argc > 2) ? (int32_t)atoi(argv[2]) : cfg.cpu;
+    spin.spin_budget_us = (argc > 3) ? (uint32_t)atoi(argv[3]) : spin.spin_budget_us;
+    spin.busy_poll_us = (argc > 4) ? (uint32_t)atoi(argv[4]) : spin.busy_poll_us;
+
+    (void)CYCLIC_Init(&cfg);
+    (void)CYCLIC_AddTask("read", ReadTask, NULL, 1U);
+    MODBUS_Init();
+
+    printf("%llu cycles at 1 kHz, spin budget %u us, SO_BUSY_POLL %u us\n",
+           (unsigned long long)cycles, (unsigned)spin.spin_budget_us,
+           (unsigned)spin.busy_poll_us);
+#if defined(__linux__)
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2)
+    {
+        printf("Single CPU: the spin competes with the drive / simulator for it\n");
+    }
+#endif
+    RunMode("blocking", &off, cycles);
+    RunMode("spin", &spin, cycles);
+
+    MODBUS_Close();
+    return 0;
+}
@@ -0,0 +1,413 @@
+/*
+ * Fleet polling benchmark: blocking vs epoll vs io_uring.
+ *
+ * Opens N UDP endpoints and reads two input registers from each, once
+ * per cycle, through three backends:
+ *   blocking  TRANSPORT_Transact on one endpoint after the other
+ *   epoll     send to all, wait on an epoll set, TRANSPORT_Poll the
+ *             ready endpoints
+ *   uring     URING_SendBatch to all, URING_Poll (modbus_uring.c)
+ *
+ * Without an address it answers itself from a responder thread, so the
+ * numbers are client cost rather than drive or simulator latency.
+ *
+ *   bench_transport [endpoints] [cycles] [rtu-udp|mbap-udp] [ip port]
+ *
+ * Linux only. Build (from "Drive command"; the pool must cover the ring
+ * plus one view per endpoint):
+ *   gcc -O2 -I. -DFRAME_POOL_COUNT=1024 -DURING_RX_FRAMES=512
+ *       bench/bench_transport.c modbus_transport.c modbus_uring.c
+ *       modbus_tcp.c modbus_functions.c net_timestamp.c frame_pool.c
+ *       drive_time.c axis_table.c -lpthread -o bench_transport
+ */
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* recvmmsg, sendmmsg */
+#endif
+
+#include "config.h"
+#include "modbus_transport.h"
+#include "modbus_uring.h"
+#include "frame_pool.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define BENCH_ADDR       (412U)     /* REG_PAN_POSITION: two input registers */
+#define BENCH_REGS       (2U)
+#define RESPONDER_BATCH  (64U)
+
+#if (URING_RX_FRAMES >= FRAME_POOL_COUNT)
+    #error "Build with a frame pool larger than URING_RX_FRAMES"
+#endif
+
+static Transport_t  *ep_t;
+static ModbusReq_t  *ep_req;
+static uint32_t      ep_n;
+static uint8_t       kind;
+static volatile int  responder_stop = 0;
+
+/*----------------------------------------------------------
+ * Responder thread: answers reads with zeros, in batches
+ *----------------------------------------------------------*/
+static uint16_t Answer(const uint8_t *rq, uint16_t n, uint8_t *rs)
+{
+    uint16_t hdr = (kind == TRANSPORT_MBAP_UDP) ? 6U : 0U;
+    uint16_t regs;
+    uint16_t len;
+    uint16_t crc;
+
+    if (n < (uint16_t)(hdr + 6U))
+    {
+        return 0U;
+    }
+    regs = (uint16_t)(((uint16_t)rq[hdr + 4U] << 8U) | rq[hdr + 5U]);
+    if (regs > 125U)
+    {
+        return 0U;
+    }
+
+    (void)memcpy(rs, rq, (size_t)hdr + 2U);             /* [MBAP] unit func */
+    rs[hdr + 2U] = (uint8_t)(regs * 2U);
+    (void)memset(&rs[hdr + 3U], 0, (size_t)regs * 2U);
+    len = (uint16_t)(hdr + 3U + (regs * 2U));
+
+    if (hdr != 0U)
+    {
+        rs[4] = (uint8_t)((len - 6U) >> 8U);
+        rs[5] = (uint8_t)((len - 6U) & 0xFFU);
+        return len;
+    }
+    crc = MODBUS_CRC16(rs, len);
+    rs[len] = (uint8_t)(crc & 0xFFU);
+    rs[len + 1U] = (uint8_t)(crc >> 8U);
+    return (uint16_t)(len + 2U);
+}
+
+static void *Responder(void *arg)
+{
+    int sock = *(int *)arg;
+    static uint8_t rq[RESPONDER_BATCH][MODBUS_MAX_RESP];
+    static uint8_t rs[RESPONDER_BATCH][MODBUS_MAX_RESP];
+    struct sockaddr_in from[RESPONDER_BATCH];
+    struct mmsghdr in[RESPONDER_BATCH];
+    struct mmsghdr out[RESPONDER_BATCH];
+    struct iovec   iov_in[RESPONDER_BATCH];
+    struct iovec   iov_out[RESPONDER_BATCH];
+    struct timeval tv = { 0, 100000 };
+    uint32_t i;
+
+    (void)setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    while (responder_stop == 0)
+    {
+        int got;
+        uint32_t k = 0U;
+
+        (void)memset(in, 0, sizeof(in));
+        for (i = 0U; i < RESPONDER_BATCH; i++)
+        {
+            iov_in[i].iov_base = rq[i];
+            iov_in[i].iov_len  = sizeof(rq[i]);
+            in[i].msg_hdr.msg_iov     = &iov_in[i];
+            in[i].msg_hdr.msg_iovlen  = 1U;
+            in[i].msg_hdr.msg_name    = &from[i];
+            in[i].msg_hdr.msg_namelen = sizeof(from[i]);
+        }
+        got = recvmmsg(sock, in, RESPONDER_BATCH, MSG_WAITFORONE, NULL);
+        if (got <= 0)
+        {
+            continue;
+        }
+
+        (void)memset(out, 0, sizeof(out));
+        for (i = 0U; i < (uint32_t)got; i++)
+        {
+            uint16_t len = Answer(rq[i], (uint16_t)in[i].msg_len, rs[k]);
+
+            if (len > 0U)
+            {
+                iov_out[k].iov_base = rs[k];
+                iov_out[k].iov_len  = len;
+                out[k].msg_hdr.msg_iov     = &iov_out[k];
+                out[k].msg_hdr.msg_iovlen  = 1U;
+                out[k].msg_hdr.msg_name    = &from[i];
+                out[k].msg_hdr.msg_namelen = in[i].msg_hdr.msg_namelen;
+                k++;
+            }
+        }
+        if (k > 0U)
+        {
+            (void)sendmmsg(sock, out, k, 0);
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------
+ * Backends: one cycle reads every endpoint once
+ *----------------------------------------------------------*/
+static uint32_t Collect(void)
+{
+    uint32_t ok = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < ep_n; i++)
+    {
+        ok += (ep_req[i].view.status == MODBUS_OK) ? 1U : 0U;
+        MODBUS_ViewRelease(&ep_req[i].view);
+    }
+    return ok;
+}
+
+static uint32_t CycleBlocking(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < ep_n; i++)
+    {
+        ModbusReq_t *p = &ep_req[i];
+
+        TRANSPORT_ReqRead(p, 1U, MODBUS_FUNC_READ_INPUT, BENCH_ADDR, BENCH_REGS);
+        (void)TRANSPORT_Transact(&ep_t[i], &p, 1U);
+    }
+    return Collect();
+}
+
+static uint32_t CycleEpoll(int epfd, uint32_t *waits)
+{
+    struct epoll_event ev[64];
+    uint32_t pending = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < ep_n; i++)
+    {
+        ModbusReq_t *p = &ep_req[i];
+
+        TRANSPORT_ReqRead(p, 1U, MODBUS_FUNC_READ_INPUT, BENCH_ADDR, BENCH_REGS);
+        pending += (TRANSPORT_SendBatch(&ep_t[i], &p, 1U) == 1) ? 1U : 0U;
+    }
+
+    while (pending > 0U)
+    {
+        int n = epoll_wait(epfd, ev, 64, 10);
+        int k;
+
+        (*waits)++;
+        if (n <= 0)
+        {
+            /* Quiet: let every endpoint expire its requests */
+            for (i = 0U; i < ep_n; i++)
+            {
+                pending -= (uint32_t)TRANSPORT_Poll(&ep_t[i], 0U);
+            }
+            continue;
+        }
+        for (k = 0; k < n; k++)
+        {
+            pending -= (uint32_t)TRANSPORT_Poll(&ep_t[ev[k].data.u32], 0U);
+        }
+    }
+    return Collect();
+}
+
+static uint32_t CycleUring(UringRing_t *r, const int32_t *ring_ep)
+{
+    uint32_t i;
+
+    for (i = 0U; i < ep_n; i++)
+    {
+        ModbusReq_t *p = &ep_req[i];
+
+        TRANSPORT_ReqRead(p, 1U, MODBUS_FUNC_READ_INPUT, BENCH_ADDR, BENCH_REGS);
+        (void)URING_SendBatch(r, ring_ep[i], &p, 1U);
+    }
+    while (URING_Pending(r) > 0U)
+    {
+        if (URING_Poll(r, URING_Pending(r), 10000U) < 0)
+        {
+            break;
+        }
+    }
+    return Collect();
+}
+
+static void Report(const char *name, uint32_t cycles, uint64_t us, uint32_t ok, uint32_t calls)
+{
+    printf("%-9s %8.1f us/cycle %7.2f us/read  ok %u/%u",
+           name, (double)us / (double)cycles, (double)us / ((double)cycles * (double)ep_n),
+           (unsigned)ok, (unsigned)(cycles * ep_n));
+    if (calls > 0U)
+    {
+        printf("  %.1f waits/cycle", (double)calls / (double)cycles);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t    cycles = 200U;
+    const char *ip = "127.0.0.1";
+    uint16_t    port = 0U;
+    int         rsock = -1;
+    pthread_t   rthread;
+    static UringRing_t ring;
+    int32_t    *ring_ep;
+    int         epfd;
+    uint32_t    i;
+    uint32_t    c;
+    uint32_t    ok;
+    uint32_t    waits = 0U;
+    uint64_t    t0;
+
+    ep_n = (argc > 1) ? (uint32_t)atoi(argv[1]) : 256U;
+    cycles = (argc > 2) ? (uint32_t)atoi(argv[2]) : cycles;
+    kind = (argc > 3) ? TRANSPORT_KindFromName(argv[3]) : (uint8_t)TRANSPORT_RTU_UDP;
+    if ((kind != TRANSPORT_RTU_UDP) && (kind != TRANSPORT_MBAP_UDP))
+    {
+        printf("Kind must be rtu-udp or mbap-udp\n");
+        return 1;
+    }
+    if (ep_n > URING_MAX_ENDPOINTS)
+    {
+        ep_n = URING_MAX_ENDPOINTS;
+    }
+    if (ep_n > (FRAME_POOL_COUNT - URING_RX_FRAMES))
+    {
+        ep_n = FRAME_POOL_COUNT - URING_RX_FRAMES;
+    }
+    if ((ep_n == 0U) || (cycles == 0U))
+    {
+        return 1;
+    }
+
+    if (argc > 5)
+    {
+        ip = argv[4];
+        port = (uint16_t)atoi(argv[5]);
+    }
+    else
+    {
+        struct sockaddr_in a;
+        socklen_t alen = sizeof(a);
+        int sz = 4 << 20;
+
+        rsock = socket(AF_INET, SOCK_DGRAM, 0);
+        (void)memset(&a, 0, sizeof(a));
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        (void)setsockopt(rsock, SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz));
+        if ((bind(rsock, (struct sockaddr *)&a, sizeof(a)) != 0) ||
+            (getsockname(rsock, (struct sockaddr *)&a, &alen) != 0))
+        {
+            printf("Responder socket failed\n");
+            return 1;
+        }
+        port = ntohs(a.sin_port);
+        (void)pthread_create(&rthread, NULL, Responder, &rsock);
+    }
+
+    ep_t    = calloc(ep_n, sizeof(Transport_t));
+    ep_req  = calloc(ep_n, sizeof(ModbusReq_t));
+    ring_ep = calloc(ep_n, sizeof(int32_t));
+    epfd    = epoll_create1(0);
+    if ((ep_t == NULL) || (ep_req == NULL) || (ring_ep == NULL) || (epfd < 0))
+    {
+        return 1;
+    }
+
+    for (i = 0U; i < ep_n; i++)
+    {
+        struct epoll_event ev;
+
+        if (TRANSPORT_Open(&ep_t[i], kind, ip, port) != 0)
+        {
+            printf("Open of endpoint %u failed\n", (unsigned)i);
+            return 1;
+        }
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        (void)epoll_ctl(epfd, EPOLL_CTL_ADD, (int)ep_t[i].sock, &ev);
+    }
+
+    printf("%u endpoints, %u cycles, %s to %s:%u\n", (unsigned)ep_n, (unsigned)cycles,
+           ep_t[0].ops->name, ip, (unsigned)port);
+
+    /* Blocking */
+    ok = 0U;
+    t0 = TIME_NowUs();
+    for (c = 0U; c < cycles; c++)
+    {
+        ok += CycleBlocking();
+    }
+    Report("blocking", cycles, TIME_NowUs() - t0, ok, 0U);
+
+    /* epoll */
+    ok = 0U;
+    t0 = TIME_NowUs();
+    for (c = 0U; c < cycles; c++)
+    {
+        ok += CycleEpoll(epfd, &waits);
+    }
+    Report("epoll", cycles, TIME_NowUs() - t0, ok, waits);
+
+    /* io_uring */
+    if (URING_Open(&ring) == 0)
+    {
+        for (i = 0U; i < ep_n; i++)
+        {
+            ring_ep[i] = URING_Attach(&ring, &ep_t[i]);
+        }
+        ok = 0U;
+        t0 = TIME_NowUs();
+        for (c = 0U; c < cycles; c++)
+        {
+            ok += CycleUring(&ring, ring_ep);
+        }
+        Report("io_uring", cycles, TIME_NowUs() - t0, ok, ring.stats.enters);
+        printf("          %u sqes, %u cqes, %u datagrams, %u re-arms\n",
+               (unsigned)ring.stats.sqes, (unsigned)ring.stats.cqes,
+               (unsigned)ring.stats.datagrams, (unsigned)ring.stats.rearms);
+        URING_Close(&ring);
+    }
+    else
+    {
+        printf("io_uring  not available\n");
+    }
+
+    for (i = 0U; i < ep_n; i++)
+    {
+        TRANSPORT_Close(&ep_t[i]);
+    }
+    (void)close(epfd);
+    if (rsock >= 0)
+    {
+        responder_stop = 1;
+        (void)pthread_join(rthread, NULL);
+        (void)close(rsock);
+    }
+    printf("frames in use: %u\n", (unsigned)FRAME_InUse());
+    free(ep_t);
+    free(ep_req);
+    free(ring_ep);
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("bench_transport needs Linux (epoll, io_uring)\n");
+    return 0;
+}
+
+#endif
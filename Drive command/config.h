@@ -6,6 +6,7 @@
  *===========================================================*/
 #define DRIVE_IP_ADDR        "127.0.0.1"
 #define DRIVE_PORT_UDP       (1502U)
+#define DRIVE_PORT_TCP       (1502U)   /* Modbus/TCP (502 on real drives) */
 
 /*===========================================================
  * Modbus Protocol Constants
@@ -24,70 +25,95 @@
 #define AXIS1_NAME   "PAN"
 #define AXIS2_NAME   "TILT"
 
-/*===========================================================
- * Holding Registers (0x03 / 0x10)
- *===========================================================*/
-/* ---- PAN Axis (Axis 1) ---- */
-#define REG_PAN_POSITION          (282U)
-#define REG_PAN_VELOCITY          (284U)
-#define REG_PAN_ACCEL             (286U)
-#define REG_PAN_DECEL             (288U)
-#define REG_PAN_HOME_OFFSET       (310U)
-#define REG_PAN_DEG_CORRECTION    (312U)
-#define REG_PAN_DEG_POS           (314U)
-
-/* ---- TILT Axis (Axis 2) ---- */
-#define REG_TILT_POSITION         (782U)
-#define REG_TILT_VELOCITY         (784U)
-#define REG_TILT_ACCEL            (786U)
-#define REG_TILT_DECEL            (788U)
-#define REG_TILT_HOME_OFFSET      (810U)
-#define REG_TILT_DEG_CORRECTION   (812U)
-#define REG_TILT_DEG_POS          (814U)
+/* UDP endpoint of each axis controller; both default to the one
+ * drive above. Axes sharing a unit ID must share an endpoint. */
+#define AXIS1_IP_ADDR       DRIVE_IP_ADDR
+#define AXIS1_PORT_UDP      DRIVE_PORT_UDP
+#define AXIS2_IP_ADDR       DRIVE_IP_ADDR
+#define AXIS2_PORT_UDP      DRIVE_PORT_UDP
 
-/*===========================================================
- * Input Registers (0x04) – ApplicationReadPara (from image)
- *===========================================================*/
-/* ---- PAN Axis ---- */
-#define REG_PAN_POS_DEG           (412U)
-#define REG_PAN_VEL_SPD           (414U)
-#define REG_PAN_POS_MM            (416U)
-#define REG_PAN_RPM               (418U)
-#define REG_PAN_ACTUAL_CURRENT    (420U)
-#define REG_PAN_IO_STATUS         (422U)
-#define REG_PAN_SYSTEM_STATUS     (424U)
-#define REG_PAN_DCBUS_VOLT        (426U)
-
-/* ---- TILT Axis ---- */
-#define REG_TILT_POS_DEG          (912U)
-#define REG_TILT_VEL_SPD          (914U)
-#define REG_TILT_POS_MM           (916U)
-#define REG_TILT_RPM              (918U)
-#define REG_TILT_ACTUAL_CURRENT   (920U)
-#define REG_TILT_IO_STATUS        (922U)
-#define REG_TILT_SYSTEM_STATUS    (924U)
-#define REG_TILT_DCBUS_VOLT       (926U)
+/* Axis descriptor table lives in axis_table.c; one row per axis.
+ * Per-axis registers are the PAN (axis 1) addresses below plus the
+ * axis register offset, by default (axis - 1) * AXIS_REG_STRIDE. */
+#define AXIS_COUNT          (2U)      /* configured axes (max AXIS_MAX_COUNT) */
+#define AXIS_MAX_COUNT      (6U)
+#define AXIS_REG_STRIDE     (500U)    /* TILT registers = PAN + 500 */
 
 /*===========================================================
- * Command Registers (0x06)
+ * Register Scaling (counts per engineering unit)
  *===========================================================*/
-#define REG_CMD_HALT              (445U)
-#define REG_CMD_EMG_STOP          (446U)
-#define REG_CMD_ENABLE            (448U)
-#define REG_CMD_RESET             (449U)
-#define REG_CMD_POS_MOVE          (451U)
-#define REG_CMD_HOME_MOVE_DEG     (452U)
-#define REG_CMD_VEL_FWD           (453U)
-#define REG_CMD_VEL_REV           (454U)
-#define REG_CMD_POS_MOVE_DEG      (455U)
+/* Every scaled register uses one of these; fixed_point.c derives
+ * the Q16.16 encode/decode constants from them. */
+#define SCALE_POSITION      (100)     /* 0.01 deg / 0.01 mm  */
+#define SCALE_VELOCITY      (10)      /* 0.1 speed units     */
+#define SCALE_ACCEL         (10)      /* 0.1 accel units     */
+#define SCALE_CURRENT       (10)      /* 0.1 A               */
+#define SCALE_TEMP          (10)      /* 0.1 degC            */
+#define SCALE_UNITY         (1)       /* rpm, DC bus volts   */
 
 /*===========================================================
- * Fault Register
+ * Register Table
  *===========================================================*/
-#define REG_FAULT_STATUS_PAN      (384U)
-#define REG_FAULT_STATUS_TILT     (884U)
-
-/* Fault Bits */
+/* Single source of truth for the drive register map. The C client
+ * generates its address constants and accessors (register_access.h)
+ * from these rows, and rtu_udp_server_database.py parses them to
+ * build its register database.
+ *
+ * X(name, pan_addr, area, width, scale, signed, access)
+ *   pan_addr : PAN (axis 1) address; other axes via AXIS_Reg()
+ *   area     : HOLDING (0x03/0x06/0x10) or INPUT (0x04)
+ *   width    : words; the 16-bit accessors need 1 (checked at compile
+ *              time), the simulator sizes its database from it
+ *   scale    : SCALE_<scale> counts per engineering unit
+ *   signed   : 1 = int16_t, 0 = uint16_t
+ *   access   : RO, WO or RW
+ */
+#define DRIVE_AXIS_REGISTERS(X) \
+    /* ---- Holding: motion parameters ---- */ \
+    X(POSITION,        282U, HOLDING, 1U, POSITION, 1, RW) \
+    X(VELOCITY,        284U, HOLDING, 1U, VELOCITY, 1, RW) \
+    X(ACCEL,           286U, HOLDING, 1U, ACCEL,    1, RW) \
+    X(DECEL,           288U, HOLDING, 1U, ACCEL,    1, RW) \
+    X(HOME_OFFSET,     310U, HOLDING, 1U, POSITION, 1, RW) \
+    X(DEG_CORRECTION,  312U, HOLDING, 1U, POSITION, 1, RW) \
+    X(DEG_POS,         314U, HOLDING, 1U, POSITION, 1, RW) \
+    /* ---- Input: fault status, feedback, diagnostics ---- */ \
+    X(FAULT_STATUS,    384U, INPUT,   1U, UNITY,    0, RO) \
+    X(POS_DEG,         412U, INPUT,   1U, POSITION, 1, RO) \
+    X(VEL_SPD,         414U, INPUT,   1U, UNITY,    1, RO) \
+    X(POS_MM,          416U, INPUT,   1U, POSITION, 1, RO) \
+    X(RPM,             418U, INPUT,   1U, UNITY,    1, RO) \
+    X(ACTUAL_CURRENT,  420U, INPUT,   1U, CURRENT,  1, RO) \
+    X(IO_STATUS,       422U, INPUT,   1U, UNITY,    0, RO) \
+    X(SYSTEM_STATUS,   424U, INPUT,   1U, UNITY,    0, RO) \
+    X(DCBUS_VOLT,      426U, INPUT,   1U, UNITY,    0, RO) \
+    X(TEMP,            428U, INPUT,   1U, TEMP,     0, RO) \
+    X(FAULT_CODE,      430U, INPUT,   1U, UNITY,    0, RO)
+
+/* Shared command registers; the value written selects the axis */
+#define DRIVE_COMMAND_REGISTERS(X) \
+    X(CMD_HALT,        445U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_EMG_STOP,    446U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_ENABLE,      448U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_RESET,       449U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_POS_MOVE,    451U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_HOME_MOVE_DEG, 452U, HOLDING, 1U, UNITY,  0, WO) \
+    X(CMD_VEL_FWD,     453U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_VEL_REV,     454U, HOLDING, 1U, UNITY,    0, WO) \
+    X(CMD_POS_MOVE_DEG, 455U, HOLDING, 1U, UNITY,   0, WO)
+
+/* Address constants: REG_PAN_<name> (axis registers), REG_<name> (commands) */
+#define REGTAB_AXIS_ADDR(n, addr, area, w, sc, sg, acc)   REG_PAN_##n = (addr),
+#define REGTAB_CMD_ADDR(n, addr, area, w, sc, sg, acc)    REG_##n = (addr),
+enum
+{
+    DRIVE_AXIS_REGISTERS(REGTAB_AXIS_ADDR)
+    DRIVE_COMMAND_REGISTERS(REGTAB_CMD_ADDR)
+};
+#undef REGTAB_AXIS_ADDR
+#undef REGTAB_CMD_ADDR
+
+/* Fault Bits (REG_PAN_FAULT_STATUS) */
 #define FAULT_SHORT_CKT           (0x0001U)
 #define FAULT_SYSTEM_HEALTHY      (0x0002U)
 #define FAULT_OVER_TEMP           (0x0008U)
@@ -96,17 +122,6 @@
 #define FAULT_LOCK_ROTOR          (0x0400U)
 #define FAULT_MOTION_COMPLETE     (0x8000U)
 
-/*===========================================================
- * Extended Diagnostic Registers
- *===========================================================*/
-/* ---- PAN Axis ---- */
-#define REG_PAN_TEMP        (428U)
-#define REG_PAN_FAULT_CODE  (430U)
-
-/* ---- TILT Axis ---- */
-#define REG_TILT_TEMP       (928U)
-#define REG_TILT_FAULT_CODE (930U)
-
 /*===========================================================
  * Software Limit Settings (User Editable)
  *===========================================================*/
@@ -0,0 +1,343 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* sched_setaffinity, CPU_SET */
+#endif
+
+#include "cyclic_exec.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__linux__)
+    #include <errno.h>
+    #include <sched.h>
+    #include <time.h>
+    #include <sys/mman.h>
+#endif
+
+/*----------------------------------------------------------
+ * Task table and executive state
+ *----------------------------------------------------------*/
+typedef struct
+{
+    CyclicTaskFn_t fn;
+    void          *arg;
+    uint32_t       divider;
+} CyclicTask_t;
+
+static CyclicTask_t   cyclic_tasks[CYCLIC_MAX_TASKS];
+static CyclicStats_t  cyclic_stats;
+static uint32_t       cyclic_period_us = 1000U;
+static volatile bool  cyclic_stop_req = false;
+
+/*----------------------------------------------------------
+ * Histogram helpers
+ *----------------------------------------------------------*/
+static void Hist_Reset(CyclicHist_t *h)
+{
+    (void)memset(h, 0, sizeof(*h));
+    h->min_us = UINT32_MAX;
+}
+
+static void Hist_Add(CyclicHist_t *h, uint32_t us)
+{
+    uint32_t idx = 0U;
+    uint32_t v = us;
+
+    /* bucket 0 = 0 us, bucket n = [2^(n-1), 2^n) us, last bucket open */
+    while ((v != 0U) && (idx < (CYCLIC_HIST_BUCKETS - 1U)))
+    {
+        v >>= 1U;
+        idx++;
+    }
+    h->bucket[idx]++;
+
+    if (us < h->min_us) { h->min_us = us; }
+    if (us > h->max_us) { h->max_us = us; }
+    h->sum_us += us;
+    h->count++;
+}
+
+static void Hist_Print(const char *label, const CyclicHist_t *h)
+{
+    uint32_t i;
+
+    if (h->count == 0U)
+    {
+        printf("  %-10s: no samples\n", label);
+        return;
+    }
+
+    printf("  %-10s: min %lu us | avg %lu us | max %lu us\n", label,
+           (unsigned long)h->min_us,
+           (unsigned long)(h->sum_us / h->count),
+           (unsigned long)h->max_us);
+
+    for (i = 0U; i < CYCLIC_HIST_BUCKETS; i++)
+    {
+        if (h->bucket[i] != 0U)
+        {
+            unsigned long lo = (i == 0U) ? 0UL : (1UL << (i - 1U));
+
+            if (i == (CYCLIC_HIST_BUCKETS - 1U))
+            {
+                printf("      >= %6lu us : %lu\n", lo, (unsigned long)h->bucket[i]);
+            }
+            else
+            {
+                printf("      < %7lu us : %lu\n", 1UL << i, (unsigned long)h->bucket[i]);
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------
+ * Sleep until an absolute CLOCK_MONOTONIC deadline (us)
+ *----------------------------------------------------------*/
+static void SleepUntil(uint64_t deadline_us)
+{
+#if defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(deadline_us / 1000000U);
+    ts.tv_nsec = (long)((deadline_us % 1000000U) * 1000U);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+        /* restart on signal; absolute deadline does not drift */
+    }
+#else
+    uint64_t now = TIME_NowUs();
+    if (deadline_us > now)
+    {
+        TIME_SleepUs((uint32_t)(deadline_us - now));
+    }
+#endif
+}
+
+/*----------------------------------------------------------
+ * Touch the stack so later page faults cannot hit the RT loop
+ *----------------------------------------------------------*/
+static void PrefaultStack(void)
+{
+    volatile uint8_t stack_area[CYCLIC_PREFAULT_STACK];
+    uint32_t i;
+
+    for (i = 0U; i < CYCLIC_PREFAULT_STACK; i += 512U)
+    {
+        stack_area[i] = 0U;
+    }
+    (void)stack_area[0];
+}
+
+/*----------------------------------------------------------
+ * Initialize executive (RT policy, affinity, memory lock)
+ *----------------------------------------------------------*/
+bool CYCLIC_Init(const CyclicConfig_t *cfg)
+{
+    bool ok = true;
+
+    if ((cfg == NULL) || (cfg->period_us == 0U))
+    {
+        return false;
+    }
+
+    cyclic_period_us = cfg->period_us;
+    CYCLIC_ResetStats();
+
+#if defined(__linux__)
+    if (cfg->lock_memory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            printf("[CYCLIC] mlockall failed (errno %d)\n", errno);
+            ok = false;
+        }
+        PrefaultStack();
+    }
+
+    if (cfg->cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        {
+            printf("[CYCLIC] Pinning to CPU %ld failed (errno %d)\n", (long)cfg->cpu, errno);
+            ok = false;
+        }
+    }
+
+    if (cfg->rt_priority > 0)
+    {
+        struct sched_param sp;
+        (void)memset(&sp, 0, sizeof(sp));
+        sp.sched_priority = cfg->rt_priority;
+        if (sched_setscheduler(0, SCHED_FIFO, &sp) != 0)
+        {
+            printf("[CYCLIC] SCHED_FIFO prio %ld failed (errno %d)\n",
+                   (long)cfg->rt_priority, errno);
+            ok = false;
+        }
+    }
+#else
+    if (cfg->lock_memory)
+    {
+        PrefaultStack();
+    }
+    if ((cfg->cpu >= 0) || (cfg->rt_priority > 0))
+    {
+        printf("[CYCLIC] RT priority / CPU pinning only supported on Linux\n");
+        ok = false;
+    }
+#endif
+
+    printf("[CYCLIC] Period %lu us, prio %ld, cpu %ld, mlock %u\n",
+           (unsigned long)cfg->period_us, (long)cfg->rt_priority,
+           (long)cfg->cpu, (unsigned)cfg->lock_memory);
+    return ok;
+}
+
+/*----------------------------------------------------------
+ * Register a task
+ *----------------------------------------------------------*/
+bool CYCLIC_AddTask(const char *name, CyclicTaskFn_t fn, void *arg, uint32_t divider)
+{
+    uint32_t n = cyclic_stats.num_tasks;
+
+    if ((fn == NULL) || (divider == 0U) || (n >= CYCLIC_MAX_TASKS))
+    {
+        return false;
+    }
+
+    cyclic_tasks[n].fn      = fn;
+    cyclic_tasks[n].arg     = arg;
+    cyclic_tasks[n].divider = divider;
+
+    cyclic_stats.task[n].name = name;
+    Hist_Reset(&cyclic_stats.task[n].exec);
+    cyclic_stats.task[n].runs = 0U;
+    cyclic_stats.num_tasks = n + 1U;
+
+    return true;
+}
+
+/*----------------------------------------------------------
+ * Main loop: absolute deadlines, no cumulative drift
+ *----------------------------------------------------------*/
+void CYCLIC_Run(uint64_t num_cycles)
+{
+    uint64_t cycle = 0U;
+    uint64_t deadline = TIME_NowUs() + cyclic_period_us;
+
+    cyclic_stop_req = false;
+
+    while (!cyclic_stop_req && ((num_cycles == 0U) || (cycle < num_cycles)))
+    {
+        uint64_t wake, t_task, t_end;
+        uint32_t i;
+
+        SleepUntil(deadline);
+        wake = TIME_NowUs();
+        Hist_Add(&cyclic_stats.latency, (uint32_t)((wake > deadline) ? (wake - deadline) : 0U));
+
+        t_task = wake;
+        for (i = 0U; i < cyclic_stats.num_tasks; i++)
+        {
+            if ((cycle % cyclic_tasks[i].divider) == 0U)
+            {
+                uint64_t t_next;
+
+                cyclic_tasks[i].fn(cyclic_tasks[i].arg);
+                t_next = TIME_NowUs();
+                Hist_Add(&cyclic_stats.task[i].exec, (uint32_t)(t_next - t_task));
+                cyclic_stats.task[i].runs++;
+                t_task = t_next;
+            }
+        }
+        t_end = t_task;
+        Hist_Add(&cyclic_stats.exec, (uint32_t)(t_end - wake));
+
+        cyclic_stats.cycles++;
+        cycle++;
+        deadline += cyclic_period_us;
+
+        /* Overrun: skip the deadlines already in the past, keep the phase.
+         * The streak tells a watchdog task the loop can no longer keep up. */
+        if (t_end >= deadline)
+        {
+            uint64_t late = ((t_end - deadline) / cyclic_period_us) + 1U;
+            cyclic_stats.overruns++;
+            cyclic_stats.missed += late;
+            deadline += late * cyclic_period_us;
+            cycle += late;
+            cyclic_stats.overrun_streak++;
+            if (cyclic_stats.overrun_streak > cyclic_stats.max_streak)
+            {
+                cyclic_stats.max_streak = cyclic_stats.overrun_streak;
+            }
+        }
+        else
+        {
+            cyclic_stats.overrun_streak = 0U;
+        }
+    }
+}
+
+/*----------------------------------------------------------
+ * Stop request (safe from a task or signal handler)
+ *----------------------------------------------------------*/
+void CYCLIC_Stop(void)
+{
+    cyclic_stop_req = true;
+}
+
+/*----------------------------------------------------------
+ * Statistics access
+ *----------------------------------------------------------*/
+const CyclicStats_t *CYCLIC_GetStats(void)
+{
+    return &cyclic_stats;
+}
+
+void CYCLIC_ResetStats(void)
+{
+    uint32_t i;
+
+    cyclic_stats.cycles   = 0U;
+    cyclic_stats.overruns = 0U;
+    cyclic_stats.missed   = 0U;
+    cyclic_stats.overrun_streak = 0U;
+    cyclic_stats.max_streak     = 0U;
+    Hist_Reset(&cyclic_stats.latency);
+    Hist_Reset(&cyclic_stats.exec);
+
+    for (i = 0U; i < cyclic_stats.num_tasks; i++)
+    {
+        Hist_Reset(&cyclic_stats.task[i].exec);
+        cyclic_stats.task[i].runs = 0U;
+    }
+}
+
+void CYCLIC_PrintStats(void)
+{
+    uint32_t i;
+
+    printf("\n====== CYCLIC EXECUTIVE (%lu us) ======\n", (unsigned long)cyclic_period_us);
+    printf("Cycles: %llu | Overruns: %llu | Missed deadlines: %llu | Longest streak: %lu\n",
+           (unsigned long long)cyclic_stats.cycles,
+           (unsigned long long)cyclic_stats.overruns,
+           (unsigned long long)cyclic_stats.missed,
+           (unsigned long)cyclic_stats.max_streak);
+    Hist_Print("wakeup", &cyclic_stats.latency);
+    Hist_Print("cycle", &cyclic_stats.exec);
+
+    for (i = 0U; i < cyclic_stats.num_tasks; i++)
+    {
+        printf(" Task %-10s runs %llu\n", (cyclic_stats.task[i].name != NULL) ?
+               cyclic_stats.task[i].name : "?",
+               (unsigned long long)cyclic_stats.task[i].runs);
+        Hist_Print("exec", &cyclic_stats.task[i].exec);
+    }
+    printf("=====================================\n");
+}
@@ -0,0 +1,115 @@
+#ifndef CYCLIC_EXEC_H
+#define CYCLIC_EXEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*===========================================================
+ * Cyclic Executive Configuration
+ *===========================================================*/
+#define CYCLIC_MAX_TASKS        (8U)
+#define CYCLIC_HIST_BUCKETS     (16U)     /* log2(us) buckets: 0, <2, <4 ... */
+#define CYCLIC_PREFAULT_STACK   (65536U)  /* bytes touched before going RT */
+
+/**
+ * @brief Cyclic task entry point, called from the executive thread
+ */
+typedef void (*CyclicTaskFn_t)(void *arg);
+
+/**
+ * @brief Executive settings (applied by CYCLIC_Init)
+ */
+typedef struct
+{
+    uint32_t period_us;     /**< Base cycle, e.g. 1000 for 1 kHz */
+    int32_t  rt_priority;   /**< SCHED_FIFO priority 1..99, 0 = keep default */
+    int32_t  cpu;           /**< CPU to pin the executive to, -1 = no pinning */
+    bool     lock_memory;   /**< mlockall() and pre-fault the stack */
+} CyclicConfig_t;
+
+/**
+ * @brief Log2 histogram of microsecond samples
+ */
+typedef struct
+{
+    uint32_t bucket[CYCLIC_HIST_BUCKETS];
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint64_t count;
+} CyclicHist_t;
+
+/**
+ * @brief Per-task statistics
+ */
+typedef struct
+{
+    const char     *name;
+    CyclicHist_t    exec;        /**< Task execution time */
+    uint64_t        runs;
+} CyclicTaskStats_t;
+
+/**
+ * @brief Executive statistics
+ */
+typedef struct
+{
+    uint64_t          cycles;
+    uint64_t          overruns;      /**< Cycles that ran past the next deadline */
+    uint64_t          missed;        /**< Deadlines skipped after an overrun */
+    uint32_t          overrun_streak;  /**< Consecutive overrun cycles, 0 = on time */
+    uint32_t          max_streak;      /**< Longest streak (watchdog input) */
+    CyclicHist_t      latency;       /**< Wakeup latency vs. absolute deadline */
+    CyclicHist_t      exec;          /**< Whole-cycle execution time */
+    CyclicTaskStats_t task[CYCLIC_MAX_TASKS];
+    uint32_t          num_tasks;
+} CyclicStats_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Apply scheduling policy, CPU affinity and memory locking
+ * @param  cfg  Executive settings
+ * @return true if every requested setting was applied
+ */
+bool CYCLIC_Init(const CyclicConfig_t *cfg);
+
+/**
+ * @brief  Register a cyclic task
+ * @param  name     Name used in the statistics report
+ * @param  fn       Task function
+ * @param  arg      Passed to fn unchanged
+ * @param  divider  Run every N base cycles (1 = every cycle)
+ * @return false if the task table is full or arguments are invalid
+ */
+bool CYCLIC_AddTask(const char *name, CyclicTaskFn_t fn, void *arg, uint32_t divider);
+
+/**
+ * @brief  Run the executive on the calling thread
+ * @param  num_cycles  Number of base cycles to run, 0 = until CYCLIC_Stop()
+ */
+void CYCLIC_Run(uint64_t num_cycles);
+
+/**
+ * @brief  Request the executive to return after the current cycle
+ */
+void CYCLIC_Stop(void);
+
+/**
+ * @brief  Access the statistics collected so far
+ */
+const CyclicStats_t *CYCLIC_GetStats(void);
+
+/**
+ * @brief  Clear all statistics (task table is kept)
+ */
+void CYCLIC_ResetStats(void);
+
+/**
+ * @brief  Print latency, execution time and overrun report
+ */
+void CYCLIC_PrintStats(void);
+
+#endif /* CYCLIC_EXEC_H */
@@ -0,0 +1,547 @@
+#ifndef DRIVE_ASYNC_HPP
+#define DRIVE_ASYNC_HPP
+
+/*===========================================================
+ * Coroutine Command Sequencing (C++20, header-only)
+ *===========================================================*/
+/* Drive sequences written as straight-line code that suspends at every
+ * Modbus exchange instead of blocking. One IoLoop runs any number of
+ * sequences on the calling thread; each in-flight request owns a
+ * non-blocking channel (modbus_functions.h), so responses never need
+ * to be matched across sequences.
+ *
+ *   drive::Task<bool> homeAxis(drive::AsyncDrive &d, Axis_t axis)
+ *   {
+ *       co_await d.reset(axis);
+ *       co_await d.enable(axis);
+ *       co_await d.setMotion(axis, drive::Degrees{0.0F}, drive::MmPerSec{50.0F},
+ *                            drive::MmPerSec2{100.0F}, drive::MmPerSec2{100.0F});
+ *       co_await d.positionMove(axis);
+ *       co_return co_await d.waitMotionComplete(axis, 10'000'000U);
+ *   }
+ *
+ *   drive::IoLoop loop;
+ *   drive::AsyncDrive d(loop);
+ *   for (Axis_t a : axes) { loop.spawn(homeAxis(d, a)); }
+ *   loop.run();                        // returns when every sequence finished
+ */
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "axis_table.h"
+#include "modbus_functions.h"
+#include "drive_time.h"
+#include "drive_registers.hpp"
+
+namespace drive
+{
+
+/*===========================================================
+ * Task<T>: lazily started, awaitable coroutine
+ *===========================================================*/
+template <typename T>
+class Task;
+
+namespace detail
+{
+struct PromiseBase
+{
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr      error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+            /* Symmetric transfer back to whoever awaited this task */
+            return h.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase
+{
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    template <typename U>
+    void return_value(U &&v) { value.emplace(std::forward<U>(v)); }
+    T take()
+    {
+        if (error) { std::rethrow_exception(error); }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase
+{
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void take()
+    {
+        if (error) { std::rethrow_exception(error); }
+    }
+};
+} // namespace detail
+
+template <typename T = void>
+class [[nodiscard]] Task
+{
+public:
+    using promise_type = detail::Promise<T>;
+    using handle_type  = std::coroutine_handle<promise_type>;
+
+    explicit Task(handle_type h) noexcept : handle_(h) {}
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_) { handle_.destroy(); }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task()
+    {
+        if (handle_) { handle_.destroy(); }
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    T await_resume() { return handle_.promise().take(); }
+
+    /* Used by IoLoop::spawn */
+    handle_type release() noexcept { return std::exchange(handle_, {}); }
+
+private:
+    handle_type handle_;
+};
+
+namespace detail
+{
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept
+{
+    return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept
+{
+    return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+} // namespace detail
+
+/*===========================================================
+ * Result of one Modbus exchange
+ *===========================================================*/
+struct Response
+{
+    std::int32_t   len = -1;                /**< Bytes, 0 = timeout, -1 = error */
+    ModbusStatus_t status = MODBUS_ERR_IO;  /**< Validation result */
+    std::uint8_t   ex_code = 0U;            /**< Exception code, if any */
+    std::uint8_t   frame[MODBUS_MAX_RESP] = {};
+
+    /* Validated answer to the request (see MODBUS_CheckResponse) */
+    bool ok() const { return status == MODBUS_OK; }
+};
+
+/*===========================================================
+ * IoLoop: channels, timers and the ready queue
+ *===========================================================*/
+class IoLoop
+{
+public:
+    static constexpr std::uint64_t kRequestTimeoutUs = MODBUS_TIMEOUT_SEC * 1000000ULL;
+
+    IoLoop() = default;
+    IoLoop(const IoLoop &) = delete;
+    IoLoop &operator=(const IoLoop &) = delete;
+
+    ~IoLoop()
+    {
+        for (auto &slot : channels_) { MODBUS_ChannelClose(&slot->ch); }
+        for (auto h : roots_) { h.destroy(); }
+    }
+
+    /**
+     * @brief Start a top-level sequence; it runs inside run()
+     */
+    template <typename T>
+    void spawn(Task<T> task)
+    {
+        auto h = task.release();
+        roots_.push_back(h);
+        ready_.push_back(h);
+    }
+
+    /**
+     * @brief Run until every spawned sequence has finished
+     */
+    void run()
+    {
+        while (true)
+        {
+            while (!ready_.empty())
+            {
+                auto h = ready_.front();
+                ready_.pop_front();
+                h.resume();
+            }
+
+            reapRoots();
+            if (roots_.empty()) { break; }
+
+            pollOnce();
+        }
+    }
+
+    /* Awaitable: send a frame on a free channel, resume with the response */
+    struct Exchange
+    {
+        enum class Op : std::uint8_t { Read, WriteSingle, WriteMultiple };
+
+        IoLoop      &loop;
+        Op           kind;
+        std::uint8_t slave;
+        std::uint8_t func;
+        std::uint16_t addr;
+        std::uint16_t count;
+        std::uint16_t value;
+        std::vector<std::uint16_t> data;
+        Response     resp;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { loop.submit(this, h); }
+        Response await_resume() { return std::move(resp); }
+    };
+
+    /* Awaitable: resume after a delay */
+    struct Sleep
+    {
+        IoLoop       &loop;
+        std::uint64_t us;
+
+        bool await_ready() const noexcept { return us == 0U; }
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            loop.timers_.push_back(Timer{TIME_NowUs() + us, h});
+        }
+        void await_resume() const noexcept {}
+    };
+
+    Exchange read(std::uint8_t slave, std::uint8_t func, std::uint16_t addr, std::uint16_t count)
+    {
+        return Exchange{*this, Exchange::Op::Read, slave, func, addr, count, 0U, {}, {}};
+    }
+    Exchange writeSingle(std::uint8_t slave, std::uint16_t addr, std::uint16_t value)
+    {
+        return Exchange{*this, Exchange::Op::WriteSingle, slave, MODBUS_FUNC_WRITE_SINGLE, addr, 1U, value, {}, {}};
+    }
+    Exchange writeMultiple(std::uint8_t slave, std::uint16_t addr, std::vector<std::uint16_t> data)
+    {
+        const auto n = static_cast<std::uint16_t>(data.size());
+        return Exchange{*this, Exchange::Op::WriteMultiple, slave, MODBUS_FUNC_WRITE_MULTIPLE, addr, n, 0U, std::move(data), {}};
+    }
+    Sleep sleep(std::uint64_t us) { return Sleep{*this, us}; }
+
+private:
+    struct Slot
+    {
+        ModbusChannel_t          ch{};
+        Exchange                *op = nullptr;
+        std::coroutine_handle<>  waiter;
+        std::uint64_t            deadline_us = 0U;
+    };
+
+    struct Timer
+    {
+        std::uint64_t           due_us;
+        std::coroutine_handle<> h;
+    };
+
+    void submit(Exchange *op, std::coroutine_handle<> h)
+    {
+        Slot *slot = freeSlot();
+        std::int32_t sent = -1;
+
+        if (slot != nullptr)
+        {
+            switch (op->kind)
+            {
+            case Exchange::Op::Read:
+                sent = MODBUS_ChannelSendRead(&slot->ch, op->slave, op->func, op->addr, op->count);
+                break;
+            case Exchange::Op::WriteSingle:
+                sent = MODBUS_ChannelSendWriteSingle(&slot->ch, op->slave, op->addr, op->value);
+                break;
+            default:
+                sent = MODBUS_ChannelSendWriteMultiple(&slot->ch, op->slave, op->addr,
+                                                       op->count, op->data.data());
+                break;
+            }
+        }
+
+        if (sent <= 0)
+        {
+            op->resp.len = -1;
+            ready_.push_back(h);
+            return;
+        }
+
+        slot->op = op;
+        slot->waiter = h;
+        slot->deadline_us = TIME_NowUs() + kRequestTimeoutUs;
+    }
+
+    Slot *freeSlot()
+    {
+        for (auto &slot : channels_)
+        {
+            if (slot->op == nullptr) { return slot.get(); }
+        }
+
+        auto slot = std::make_unique<Slot>();
+        if (MODBUS_ChannelOpen(&slot->ch) != 0) { return nullptr; }
+        channels_.push_back(std::move(slot));
+        return channels_.back().get();
+    }
+
+    void complete(Slot &slot, std::int32_t len, ModbusStatus_t status)
+    {
+        slot.op->resp.len = len;
+        slot.op->resp.status = status;
+        ready_.push_back(slot.waiter);
+        slot.op = nullptr;
+        slot.waiter = {};
+    }
+
+    void pollOnce()
+    {
+        std::vector<ModbusChannel_t *> busy;
+        std::uint64_t now = TIME_NowUs();
+        std::uint64_t next = now + kRequestTimeoutUs;
+
+        for (auto &slot : channels_)
+        {
+            if (slot->op != nullptr)
+            {
+                busy.push_back(&slot->ch);
+                next = (slot->deadline_us < next) ? slot->deadline_us : next;
+            }
+        }
+        for (const Timer &t : timers_)
+        {
+            next = (t.due_us < next) ? t.due_us : next;
+        }
+
+        const std::uint64_t wait_us = (next > now) ? (next - now) : 0U;
+        (void)MODBUS_ChannelWait(busy.data(), static_cast<std::uint32_t>(busy.size()),
+                                 static_cast<std::uint32_t>(wait_us));
+
+        now = TIME_NowUs();
+        for (auto &slot : channels_)
+        {
+            if (slot->op == nullptr) { continue; }
+
+            const std::int32_t len = MODBUS_ChannelRecv(&slot->ch, slot->op->resp.frame,
+                                                        sizeof(slot->op->resp.frame));
+            if (len > 0)
+            {
+                Exchange &op = *slot->op;
+                const ModbusStatus_t st = MODBUS_CheckResponse(op.resp.frame, len, op.slave,
+                                                               op.func, op.count, &op.resp.ex_code);
+
+                if ((st == MODBUS_OK) || (st == MODBUS_ERR_EXCEPTION))
+                {
+                    complete(*slot, len, st);
+                    continue;
+                }
+                /* Stray, late or corrupt frame: drop it, keep waiting */
+                slot->ch.busy = 1U;
+            }
+            else if (len < 0)
+            {
+                complete(*slot, len, MODBUS_ERR_IO);
+                continue;
+            }
+
+            if (now >= slot->deadline_us)
+            {
+                slot->ch.busy = 0U;         /* a late reply is drained on next send */
+                complete(*slot, 0, MODBUS_ERR_IO);
+            }
+        }
+
+        for (std::size_t i = 0U; i < timers_.size();)
+        {
+            if (timers_[i].due_us <= now)
+            {
+                ready_.push_back(timers_[i].h);
+                timers_[i] = timers_.back();
+                timers_.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    void reapRoots()
+    {
+        for (std::size_t i = 0U; i < roots_.size();)
+        {
+            if (roots_[i].done())
+            {
+                roots_[i].destroy();
+                roots_[i] = roots_.back();
+                roots_.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot>>   channels_;
+    std::vector<Timer>                   timers_;
+    std::deque<std::coroutine_handle<>>  ready_;
+    std::vector<std::coroutine_handle<>> roots_;
+};
+
+/*===========================================================
+ * AsyncDrive: drive commands as awaitables
+ *===========================================================*/
+class AsyncDrive
+{
+public:
+    static constexpr std::uint64_t kPollFastUs = 2000U;    /* first polls after a move */
+    static constexpr std::uint64_t kPollSlowUs = 50000U;   /* settled polling interval */
+
+    explicit AsyncDrive(IoLoop &loop) : loop_(loop) {}
+
+    Task<bool> enable(Axis_t axis)       { return command(REG_CMD_ENABLE, axis); }
+    Task<bool> reset(Axis_t axis)        { return command(REG_CMD_RESET, axis); }
+    Task<bool> halt(Axis_t axis)         { return command(REG_CMD_HALT, axis); }
+    Task<bool> estop(Axis_t axis)        { return command(REG_CMD_EMG_STOP, axis); }
+    Task<bool> positionMove(Axis_t axis) { return command(REG_CMD_POS_MOVE, axis); }
+    Task<bool> homeMove(Axis_t axis)     { return command(REG_CMD_HOME_MOVE_DEG, axis); }
+
+    /**
+     * @brief Read one typed register (see drive_registers.hpp)
+     */
+    template <typename Reg>
+        requires Reg::readable
+    Task<std::optional<typename Reg::value_type>> read(Axis_t axis)
+    {
+        const std::uint8_t func = (Reg::area == Area::INPUT) ? MODBUS_FUNC_READ_INPUT
+                                                             : MODBUS_FUNC_READ_HOLDING;
+        Response r = co_await loop_.read(AXIS_UnitId(axis), func,
+                                         AXIS_Reg(axis, Reg::address), 1U);
+
+        if (!r.ok())
+        {
+            co_return std::nullopt;
+        }
+        co_return Reg::decode(be16(&r.frame[3]));
+    }
+
+    /**
+     * @brief Write one typed holding register
+     */
+    template <typename Reg>
+        requires(Reg::writable && (Reg::area == Area::HOLDING))
+    Task<bool> write(Axis_t axis, typename Reg::value_type value)
+    {
+        Response r = co_await loop_.writeSingle(AXIS_UnitId(axis), AXIS_Reg(axis, Reg::address),
+                                                Reg::encode(value));
+        co_return r.ok();
+    }
+
+    /**
+     * @brief Position, velocity, acceleration and deceleration in one 0x10
+     *        (same layout as Set_MotionParameters)
+     */
+    Task<bool> setMotion(Axis_t axis, Degrees pos, MmPerSec vel, MmPerSec2 accel, MmPerSec2 decel)
+    {
+        std::vector<std::uint16_t> regs{Position::encode(pos), Velocity::encode(vel),
+                                        Accel::encode(accel), Decel::encode(decel)};
+        Response r = co_await loop_.writeMultiple(AXIS_UnitId(axis),
+                                                  AXIS_Reg(axis, Position::address),
+                                                  std::move(regs));
+        co_return r.ok();
+    }
+
+    /**
+     * @brief Suspend until FAULT_MOTION_COMPLETE is set, a fault bit
+     *        appears or the timeout expires. Polls fast right after the
+     *        move, then backs off.
+     */
+    Task<bool> waitMotionComplete(Axis_t axis, std::uint64_t timeout_us)
+    {
+        const std::uint64_t deadline = TIME_NowUs() + timeout_us;
+        std::uint64_t interval = kPollFastUs;
+
+        while (TIME_NowUs() < deadline)
+        {
+            auto status = co_await read<FaultStatus>(axis);
+
+            if (status && ((*status & FAULT_MOTION_COMPLETE) != 0U))
+            {
+                co_return true;
+            }
+            if (status && ((*status & (FAULT_SHORT_CKT | FAULT_OVER_TEMP | FAULT_OVER_VOLT |
+                                       FAULT_UNDER_VOLT | FAULT_LOCK_ROTOR)) != 0U))
+            {
+                co_return false;
+            }
+
+            co_await loop_.sleep(interval);
+            interval = (interval * 2U < kPollSlowUs) ? (interval * 2U) : kPollSlowUs;
+        }
+        co_return false;
+    }
+
+    IoLoop::Sleep sleep(std::uint64_t us) { return loop_.sleep(us); }
+
+private:
+    Task<bool> command(std::uint16_t reg, Axis_t axis)
+    {
+        /* Command registers are shared; the value selects the axis */
+        Response r = co_await loop_.writeSingle(AXIS_UnitId(axis), reg,
+                                                static_cast<std::uint16_t>(axis));
+        co_return r.ok();
+    }
+
+    IoLoop &loop_;
+};
+
+} // namespace drive
+
+#endif /* DRIVE_ASYNC_HPP */
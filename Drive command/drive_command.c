@@ -1,5 +1,6 @@
 #include "config.h"
 #include "drive_command.h"
+#include "axis_table.h"
 #include "modbus_functions.h"
 #include <stdio.h>
 #include <stdint.h>
@@ -9,8 +10,8 @@
  *----------------------------------------------------------*/
 static void WriteCommand(uint16_t reg_addr, Axis_t axis)
 {
-    /* Example: Writing 1U for command execution */
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, reg_addr, (uint16_t)axis);
+    /* Command registers are shared; the value selects the axis */
+    (void)MODBUS_WriteSingle(AXIS_UnitId(axis), reg_addr, (uint16_t)axis);
     printf("Command 0x%X executed for Axis %u\n", reg_addr, axis);
 }
 
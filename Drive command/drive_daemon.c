@@ -0,0 +1,689 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* accept4, SOCK_NONBLOCK / SOCK_CLOEXEC */
+#endif
+
+#include "config.h"
+#include "drive_daemon.h"
+#include "axis_table.h"
+#include "axis_state.h"
+#include "register_access.h"
+#include "modbus_functions.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <errno.h>
+
+/* Command registers a client may write (DAEMON_OP_COMMAND) */
+#define DAEMON_CMD_ADDR(n, addr, area, w, sc, sg, acc)   (uint16_t)(addr),
+static const uint16_t CMD_REGS[] = { DRIVE_COMMAND_REGISTERS(DAEMON_CMD_ADDR) };
+#undef DAEMON_CMD_ADDR
+
+#define CMD_REG_COUNT   (sizeof(CMD_REGS) / sizeof(CMD_REGS[0]))
+#define RSP_MAX_LEN     (DAEMON_RSP_LEN + (AXIS_STATE_CAPACITY * DAEMON_AXIS_LEN))
+
+/*----------------------------------------------------------
+ * Little-endian field access
+ *----------------------------------------------------------*/
+static uint16_t GetU16(const uint8_t *p)
+{
+    return (uint16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t GetU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void PutU16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void PutU32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/*----------------------------------------------------------
+ * Message layouts (see drive_daemon.h)
+ *----------------------------------------------------------*/
+static void EncodeRequest(const DaemonRequest_t *req, uint8_t *msg)
+{
+    msg[0] = req->op;
+    msg[1] = req->axis;
+    PutU16(&msg[2], req->arg);
+    PutU32(&msg[4], req->tag);
+    PutU32(&msg[8], (uint32_t)req->value);
+}
+
+static void DecodeRequest(const uint8_t *msg, DaemonRequest_t *req)
+{
+    req->op    = msg[0];
+    req->axis  = msg[1];
+    req->arg   = GetU16(&msg[2]);
+    req->tag   = GetU32(&msg[4]);
+    req->value = (fix16_t)GetU32(&msg[8]);
+}
+
+static void EncodeResponse(const DaemonResponse_t *rsp, uint8_t *msg)
+{
+    msg[0] = rsp->op;
+    msg[1] = rsp->status;
+    msg[2] = rsp->ex_code;
+    msg[3] = rsp->count;
+    PutU32(&msg[4], rsp->tag);
+    PutU32(&msg[8], (uint32_t)rsp->value);
+}
+
+static void DecodeResponse(const uint8_t *msg, DaemonResponse_t *rsp)
+{
+    rsp->op      = msg[0];
+    rsp->status  = msg[1];
+    rsp->ex_code = msg[2];
+    rsp->count   = msg[3];
+    rsp->tag     = GetU32(&msg[4]);
+    rsp->value   = (fix16_t)GetU32(&msg[8]);
+}
+
+static void EncodeAxis(const AxisStateStore_t *s, uint32_t i, uint8_t *rec)
+{
+    const fix16_t q[7] = { s->position_deg[i], s->velocity[i], s->position_mm[i],
+                           s->rpm[i], s->current[i], s->dcbus[i], s->temperature[i] };
+    uint32_t k;
+
+    PutU32(&rec[0], (uint32_t)s->sample_us[i]);
+    PutU32(&rec[4], (uint32_t)(s->sample_us[i] >> 32));
+    for (k = 0U; k < 7U; k++)
+    {
+        PutU32(&rec[8U + (4U * k)], (uint32_t)q[k]);
+    }
+    PutU16(&rec[36], s->fault_bits[i]);
+    PutU16(&rec[38], s->io_status[i]);
+    PutU16(&rec[40], s->sys_status[i]);
+    PutU16(&rec[42], s->fault_code[i]);
+}
+
+static void DecodeAxis(const uint8_t *rec, DaemonAxis_t *a)
+{
+    a->sample_us    = (uint64_t)GetU32(&rec[0]) | ((uint64_t)GetU32(&rec[4]) << 32);
+    a->position_deg = (fix16_t)GetU32(&rec[8]);
+    a->velocity     = (fix16_t)GetU32(&rec[12]);
+    a->position_mm  = (fix16_t)GetU32(&rec[16]);
+    a->rpm          = (fix16_t)GetU32(&rec[20]);
+    a->current      = (fix16_t)GetU32(&rec[24]);
+    a->dcbus        = (fix16_t)GetU32(&rec[28]);
+    a->temperature  = (fix16_t)GetU32(&rec[32]);
+    a->fault_bits   = GetU16(&rec[36]);
+    a->io_status    = GetU16(&rec[38]);
+    a->sys_status   = GetU16(&rec[40]);
+    a->fault_code   = GetU16(&rec[42]);
+}
+
+/*----------------------------------------------------------
+ * Request handling
+ *----------------------------------------------------------*/
+
+/* Helper: register table row for an axis 1 address, or NULL */
+static const RegDesc_t *FindRegister(uint16_t pan_addr, RegId_t *id)
+{
+    uint32_t i;
+
+    for (i = 0U; i < (uint32_t)REGID_COUNT; i++)
+    {
+        if (REG_TABLE[i].pan_addr == pan_addr)
+        {
+            *id = (RegId_t)i;
+            return &REG_TABLE[i];
+        }
+    }
+    return NULL;
+}
+
+static bool IsCommand(uint16_t addr)
+{
+    uint32_t i;
+
+    for (i = 0U; i < CMD_REG_COUNT; i++)
+    {
+        if (CMD_REGS[i] == addr)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Helper: fold a drive call's result into the response */
+static void DriveStatus(int32_t rc, DaemonResponse_t *rsp)
+{
+    if (rc < 0)
+    {
+        rsp->status = (uint8_t)MODBUS_LastStatus(&rsp->ex_code);
+        if (rsp->status == (uint8_t)MODBUS_OK)
+        {
+            rsp->status = (uint8_t)MODBUS_ERR_IO;
+        }
+    }
+}
+
+/* Builds the response in msg; returns its length */
+static uint32_t Handle(Daemon_t *d, const DaemonRequest_t *req, uint8_t *msg)
+{
+    DaemonResponse_t rsp;
+    const RegDesc_t *desc;
+    RegId_t id = (RegId_t)0;
+    Axis_t axis = (Axis_t)req->axis;
+    uint32_t len = DAEMON_RSP_LEN;
+    uint32_t i;
+
+    (void)memset(&rsp, 0, sizeof(rsp));
+    rsp.op  = req->op;
+    rsp.tag = req->tag;
+
+    if (!((req->op == (uint8_t)DAEMON_OP_PING) ||
+          ((req->op == (uint8_t)DAEMON_OP_SNAPSHOT) && (req->axis == 0U))) &&
+        !AXIS_IsValid(axis))
+    {
+        rsp.status = DAEMON_ERR_AXIS;
+    }
+    else
+    {
+        switch (req->op)
+        {
+            case DAEMON_OP_PING:
+                rsp.value = (fix16_t)d->image_no;
+                break;
+
+            case DAEMON_OP_COMMAND:
+                if (!IsCommand(req->arg))
+                {
+                    rsp.status = DAEMON_ERR_REGISTER;
+                    break;
+                }
+                /* Command registers are shared; the value selects the axis */
+                DriveStatus(MODBUS_WriteSingle(AXIS_UnitId(axis), req->arg, (uint16_t)axis), &rsp);
+                break;
+
+            case DAEMON_OP_WRITE:
+            case DAEMON_OP_READ:
+                desc = FindRegister(req->arg, &id);
+                if (desc == NULL)
+                {
+                    rsp.status = DAEMON_ERR_REGISTER;
+                }
+                else if (req->op == (uint8_t)DAEMON_OP_WRITE)
+                {
+                    if ((desc->access == REG_ACCESS_RO) || (desc->area != REG_AREA_HOLDING))
+                    {
+                        rsp.status = DAEMON_ERR_ACCESS;
+                    }
+                    else
+                    {
+                        float v = FIX_ToFloat(req->value);
+                        float asked = v;
+
+                        /* The checks a menu or script write makes */
+                        rsp.value = req->value;
+                        if (!REG_CheckValue(axis, id, &v))
+                        {
+                            rsp.status = DAEMON_ERR_VALUE;
+                        }
+                        else
+                        {
+                            rsp.value = (v != asked) ? FIX_FromFloat(v) : req->value;
+                            DriveStatus(REG_Write(axis, id, rsp.value), &rsp);
+                        }
+                    }
+                }
+                else if (desc->access == REG_ACCESS_WO)
+                {
+                    rsp.status = DAEMON_ERR_ACCESS;
+                }
+                else
+                {
+                    DriveStatus(REG_Read(axis, id, &rsp.value), &rsp);
+                }
+                break;
+
+            case DAEMON_OP_SNAPSHOT:
+                rsp.value = (fix16_t)d->image_no;
+                for (i = 0U; i < d->image.count; i++)
+                {
+                    if ((req->axis == 0U) || (req->axis == (i + 1U)))
+                    {
+                        EncodeAxis(&d->image, i, &msg[len]);
+                        len += DAEMON_AXIS_LEN;
+                        rsp.count++;
+                    }
+                }
+                break;
+
+            default:
+                rsp.status = DAEMON_ERR_REQUEST;
+                break;
+        }
+    }
+
+    d->stats.requests++;
+    d->stats.errors += (rsp.status != 0U) ? 1U : 0U;
+    EncodeResponse(&rsp, msg);
+    return len;
+}
+
+/*----------------------------------------------------------
+ * Server sockets
+ *----------------------------------------------------------*/
+int32_t DAEMON_Open(Daemon_t *d, const char *path)
+{
+    struct sockaddr_un addr;
+    uint32_t i;
+    int fd;
+
+    (void)memset(d, 0, sizeof(*d));
+    d->listen_fd = -1;
+    for (i = 0U; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        d->client[i] = -1;
+    }
+    AXIS_STATE_Init(&d->image, AXIS_COUNT);
+
+    if (path == NULL)
+    {
+        path = DAEMON_SOCKET_PATH;
+    }
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        printf("Daemon: socket path too long\n");
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        printf("Daemon: socket() failed (%d)\n", errno);
+        return -1;
+    }
+
+    (void)memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    (void)strcpy(addr.sun_path, path);
+    (void)unlink(path);                 /* left behind by a previous run */
+
+    if ((bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+        (chmod(path, DAEMON_SOCKET_MODE) != 0) ||
+        (listen(fd, (int)DAEMON_MAX_CLIENTS) != 0))
+    {
+        printf("Daemon: cannot listen on %s (%d)\n", path, errno);
+        (void)close(fd);
+        (void)unlink(path);
+        return -1;
+    }
+
+    d->listen_fd = fd;
+    (void)strcpy(d->path, path);
+    printf("Daemon: listening on %s\n", path);
+    return 0;
+}
+
+void DAEMON_Close(Daemon_t *d)
+{
+    uint32_t i;
+
+    for (i = 0U; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if (d->client[i] >= 0)
+        {
+            (void)close(d->client[i]);
+            d->client[i] = -1;
+        }
+    }
+    if (d->listen_fd >= 0)
+    {
+        (void)close(d->listen_fd);
+        d->listen_fd = -1;
+    }
+    TELEM_Close(&d->telem);
+    if (d->path[0] != '\0')
+    {
+        (void)unlink(d->path);
+        d->path[0] = '\0';
+    }
+}
+
+/* Helper: take every pending connection */
+static void AcceptClients(Daemon_t *d)
+{
+    uint32_t i;
+    int fd;
+
+    for (;;)
+    {
+        fd = accept4(d->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+        for (i = 0U; (i < DAEMON_MAX_CLIENTS) && (d->client[i] >= 0); i++)
+        {
+        }
+        if (i == DAEMON_MAX_CLIENTS)
+        {
+            (void)close(fd);
+            d->stats.refused++;
+            continue;
+        }
+        d->client[i] = fd;
+        d->stats.connects++;
+    }
+}
+
+/* Helper: answer up to DAEMON_BURST requests; false = client gone */
+static bool ServeClient(Daemon_t *d, int fd, int32_t *served)
+{
+    static uint8_t out[RSP_MAX_LEN];
+    uint8_t in[DAEMON_REQ_LEN + 1U];    /* one spare byte exposes oversize */
+    DaemonRequest_t req;
+    uint32_t len;
+    uint32_t k;
+    ssize_t n;
+
+    for (k = 0U; k < DAEMON_BURST; k++)
+    {
+        n = recv(fd, in, sizeof(in), 0);
+        if (n == 0)
+        {
+            return false;               /* orderly close */
+        }
+        if (n < 0)
+        {
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+        }
+
+        if (n == (ssize_t)DAEMON_REQ_LEN)
+        {
+            DecodeRequest(in, &req);
+        }
+        else
+        {
+            (void)memset(&req, 0, sizeof(req));
+            req.op = 0xFFU;             /* answered with DAEMON_ERR_REQUEST */
+        }
+        len = Handle(d, &req, out);
+        (*served)++;
+
+        if (send(fd, out, len, MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                return false;
+            }
+            d->stats.sent_dropped++;
+        }
+    }
+    return true;
+}
+
+int32_t DAEMON_Service(Daemon_t *d, int32_t timeout_ms)
+{
+    struct pollfd pfd[DAEMON_MAX_CLIENTS + 1U];
+    int32_t  slot[DAEMON_MAX_CLIENTS + 1U];
+    int32_t  served = 0;
+    uint32_t n = 0U;
+    uint32_t i;
+    int rc;
+
+    pfd[n].fd = d->listen_fd;
+    pfd[n].events = POLLIN;
+    slot[n++] = -1;
+    for (i = 0U; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if (d->client[i] >= 0)
+        {
+            pfd[n].fd = d->client[i];
+            pfd[n].events = POLLIN;
+            slot[n++] = (int32_t)i;
+        }
+    }
+
+    rc = poll(pfd, (nfds_t)n, timeout_ms);
+    if (rc < 0)
+    {
+        return (errno == EINTR) ? 0 : -1;
+    }
+
+    for (i = 1U; (i < n) && (rc > 0); i++)
+    {
+        if (pfd[i].revents == 0)
+        {
+            continue;
+        }
+        rc--;
+        if (((pfd[i].revents & POLLIN) == 0) || !ServeClient(d, pfd[i].fd, &served))
+        {
+            (void)close(pfd[i].fd);
+            d->client[slot[i]] = -1;
+        }
+    }
+    if ((pfd[0].revents & POLLIN) != 0)
+    {
+        AcceptClients(d);
+    }
+    return served;
+}
+
+void DAEMON_Run(Daemon_t *d, uint32_t image_us)
+{
+    uint64_t next;
+    uint64_t now;
+    int32_t  wait_ms;
+
+    if (image_us == 0U)
+    {
+        image_us = DAEMON_IMAGE_US;
+    }
+
+    (void)DAEMON_Refresh(d);
+    next = TIME_NowUs() + image_us;
+
+    while (!__atomic_load_n(&d->stop, __ATOMIC_RELAXED))
+    {
+        now = TIME_NowUs();
+        wait_ms = (next > now) ? (int32_t)(((next - now) + 999U) / 1000U) : 0;
+
+        if (DAEMON_Service(d, wait_ms) < 0)
+        {
+            printf("Daemon: poll failed, stopping\n");
+            break;
+        }
+
+        now = TIME_NowUs();
+        if (now >= next)
+        {
+            (void)DAEMON_Refresh(d);
+            next += image_us;
+            if (next <= now)
+            {
+                next = now + image_us;  /* fell behind: don't burst */
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------
+ * Client side
+ *----------------------------------------------------------*/
+int32_t DAEMON_Connect(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (path == NULL)
+    {
+        path = DAEMON_SOCKET_PATH;
+    }
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    (void)memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    (void)strcpy(addr.sun_path, path);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        (void)close(fd);
+        return -1;
+    }
+    return (int32_t)fd;
+}
+
+void DAEMON_Disconnect(int32_t fd)
+{
+    if (fd >= 0)
+    {
+        (void)close(fd);
+    }
+}
+
+int32_t DAEMON_Call(int32_t fd, const DaemonRequest_t *req, DaemonResponse_t *rsp,
+                    DaemonAxis_t *axes, uint32_t max_axes)
+{
+    static uint8_t in[RSP_MAX_LEN];
+    uint8_t out[DAEMON_REQ_LEN];
+    uint32_t i;
+    ssize_t n;
+
+    EncodeRequest(req, out);
+    if (send(fd, out, sizeof(out), MSG_NOSIGNAL) != (ssize_t)sizeof(out))
+    {
+        return -1;
+    }
+
+    /* Skip answers to earlier requests that were given up on */
+    do
+    {
+        n = recv(fd, in, sizeof(in), 0);
+        if (n < (ssize_t)DAEMON_RSP_LEN)
+        {
+            return -1;
+        }
+        DecodeResponse(in, rsp);
+    } while (rsp->tag != req->tag);
+
+    for (i = 0U; (axes != NULL) && (i < rsp->count) && (i < max_axes) &&
+                 ((DAEMON_RSP_LEN + ((i + 1U) * DAEMON_AXIS_LEN)) <= (uint32_t)n); i++)
+    {
+        DecodeAxis(&in[DAEMON_RSP_LEN + (i * DAEMON_AXIS_LEN)], &axes[i]);
+    }
+    return 0;
+}
+
+#else /* _WIN32: no SOCK_SEQPACKET Unix sockets */
+
+int32_t DAEMON_Open(Daemon_t *d, const char *path)
+{
+    (void)memset(d, 0, sizeof(*d));
+    d->listen_fd = -1;
+    (void)path;
+    printf("Daemon: Unix domain sockets not available on this platform\n");
+    return -1;
+}
+
+void DAEMON_Close(Daemon_t *d)
+{
+    TELEM_Close(&d->telem);
+}
+
+int32_t DAEMON_Service(Daemon_t *d, int32_t timeout_ms)
+{
+    (void)d;
+    (void)timeout_ms;
+    return -1;
+}
+
+void DAEMON_Run(Daemon_t *d, uint32_t image_us)
+{
+    (void)d;
+    (void)image_us;
+}
+
+int32_t DAEMON_Connect(const char *path)
+{
+    (void)path;
+    return -1;
+}
+
+void DAEMON_Disconnect(int32_t fd)
+{
+    (void)fd;
+}
+
+int32_t DAEMON_Call(int32_t fd, const DaemonRequest_t *req, DaemonResponse_t *rsp,
+                    DaemonAxis_t *axes, uint32_t max_axes)
+{
+    (void)fd;
+    (void)req;
+    (void)rsp;
+    (void)axes;
+    (void)max_axes;
+    return -1;
+}
+#endif
+
+/*----------------------------------------------------------
+ * Image and statistics (all platforms)
+ *----------------------------------------------------------*/
+uint32_t DAEMON_Refresh(Daemon_t *d)
+{
+    uint32_t n = AXIS_STATE_Poll(&d->image);
+
+    d->image_no++;
+    TELEM_Publish(&d->telem, &d->image, d->image_no);
+    d->stats.images++;
+    d->stats.image_errors += (n < d->image.count) ? 1U : 0U;
+    return n;
+}
+
+void DAEMON_Stop(Daemon_t *d)
+{
+    __atomic_store_n(&d->stop, true, __ATOMIC_RELAXED);
+}
+
+void DAEMON_Task(void *arg)
+{
+    (void)DAEMON_Service((Daemon_t *)arg, 0);
+}
+
+void DAEMON_PrintStats(const Daemon_t *d)
+{
+    const DaemonStats_t *s = &d->stats;
+
+    printf("\n====== DRIVE DAEMON ======\n");
+    printf("  clients    : %llu connected | %llu refused\n",
+           (unsigned long long)s->connects, (unsigned long long)s->refused);
+    printf("  requests   : %llu | errors %llu | responses dropped %llu\n",
+           (unsigned long long)s->requests, (unsigned long long)s->errors,
+           (unsigned long long)s->sent_dropped);
+    printf("  image      : %llu refreshes | %llu incomplete\n",
+           (unsigned long long)s->images, (unsigned long long)s->image_errors);
+}
@@ -0,0 +1,229 @@
+#ifndef DRIVE_DAEMON_H
+#define DRIVE_DAEMON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_state.h"
+#include "fixed_point.h"
+#include "telemetry_shm.h"
+
+/*===========================================================
+ * Drive Daemon (local control socket)
+ *===========================================================*/
+/* One process owns the Modbus connection to the drives and a cyclic
+ * image of every axis (AxisStateStore_t, refreshed by AXIS_STATE_Poll).
+ * Local clients (HMI, scripts, logger) talk to it over a Unix domain
+ * SOCK_SEQPACKET socket, so each message is one request or one
+ * response. One thread multiplexes all clients with poll() and
+ * serialises their drive I/O on the shared connection. Snapshots come
+ * from the image and make no drive I/O at all. With TELEM_Create() on
+ * d->telem, every refresh is also published to shared memory
+ * (telemetry_shm.h).
+ *
+ * Request, 12 bytes, little-endian:
+ *
+ *   0   u8   op (DAEMON_OP_*)
+ *   1   u8   axis (1..AXIS_COUNT; 0 = all, SNAPSHOT only)
+ *   2   u16  arg: command register (REG_CMD_*) for COMMAND, axis 1
+ *            register address (REG_PAN_*) for READ / WRITE
+ *   4   u32  tag, echoed in the response
+ *   8   i32  value, Q16.16 engineering units (WRITE)
+ *
+ * Response, 12 bytes + count * DAEMON_AXIS_LEN:
+ *
+ *   0   u8   op
+ *   1   u8   status: 0 ok, ModbusStatus_t on a drive error, or
+ *            DAEMON_ERR_*
+ *   2   u8   Modbus exception code (MODBUS_ERR_EXCEPTION)
+ *   3   u8   count of axis records that follow (SNAPSHOT)
+ *   4   u32  tag
+ *   8   i32  value: register value (READ), value written (WRITE, after
+ *            clamping), image number (SNAPSHOT)
+ *
+ * Axis record, DAEMON_AXIS_LEN bytes:
+ *
+ *   0   u64  sample time (monotonic us, 0 = never read)
+ *   8   i32  x7 position deg, velocity, position mm, rpm, current,
+ *            DC bus, temperature (Q16.16)
+ *   36  u16  x4 fault bits, IO status, system status, fault code
+ *
+ * POSIX only; on Windows DAEMON_Open() and DAEMON_Connect() fail. */
+
+#ifndef DAEMON_SOCKET_PATH
+    #define DAEMON_SOCKET_PATH    "/tmp/drive_control.sock"
+#endif
+#ifndef DAEMON_SOCKET_MODE
+    #define DAEMON_SOCKET_MODE    (0660)     /* owner and group */
+#endif
+#ifndef DAEMON_MAX_CLIENTS
+    #define DAEMON_MAX_CLIENTS    (16U)
+#endif
+#ifndef DAEMON_BURST
+    #define DAEMON_BURST          (8U)       /* Requests per client per pass */
+#endif
+#ifndef DAEMON_IMAGE_US
+    #define DAEMON_IMAGE_US       (20000U)   /* Image refresh period */
+#endif
+
+#define DAEMON_REQ_LEN            (12U)
+#define DAEMON_RSP_LEN            (12U)
+#define DAEMON_AXIS_LEN           (44U)
+
+/**
+ * @brief Operations
+ */
+typedef enum
+{
+    DAEMON_OP_PING     = 0,    /**< Liveness; value = image number */
+    DAEMON_OP_COMMAND  = 1,    /**< Write a command register for the axis */
+    DAEMON_OP_WRITE    = 2,    /**< REG_Write(axis, register, value), after
+                                    REG_CheckValue() */
+    DAEMON_OP_READ     = 3,    /**< REG_Read from the drive */
+    DAEMON_OP_SNAPSHOT = 4     /**< Axis records from the image */
+} DaemonOp_t;
+
+/**
+ * @brief Daemon status codes (above every ModbusStatus_t)
+ */
+#define DAEMON_ERR_REQUEST        (0x80U)    /* Wrong size or unknown op */
+#define DAEMON_ERR_AXIS           (0x81U)
+#define DAEMON_ERR_REGISTER       (0x82U)    /* Not in the register table */
+#define DAEMON_ERR_ACCESS         (0x83U)    /* Not readable / writable */
+#define DAEMON_ERR_VALUE          (0x84U)    /* Outside the software limits */
+
+/**
+ * @brief Decoded request
+ */
+typedef struct
+{
+    uint8_t  op;
+    uint8_t  axis;
+    uint16_t arg;
+    uint32_t tag;
+    fix16_t  value;
+} DaemonRequest_t;
+
+/**
+ * @brief Decoded response header
+ */
+typedef struct
+{
+    uint8_t  op;
+    uint8_t  status;
+    uint8_t  ex_code;
+    uint8_t  count;
+    uint32_t tag;
+    fix16_t  value;
+} DaemonResponse_t;
+
+/**
+ * @brief Decoded axis record
+ */
+typedef struct
+{
+    uint64_t sample_us;
+    fix16_t  position_deg;
+    fix16_t  velocity;
+    fix16_t  position_mm;
+    fix16_t  rpm;
+    fix16_t  current;
+    fix16_t  dcbus;
+    fix16_t  temperature;
+    uint16_t fault_bits;
+    uint16_t io_status;
+    uint16_t sys_status;
+    uint16_t fault_code;
+} DaemonAxis_t;
+
+/**
+ * @brief Daemon counters
+ */
+typedef struct
+{
+    uint64_t requests;
+    uint64_t errors;         /**< Responses with a non-zero status */
+    uint64_t sent_dropped;   /**< Client not reading: response discarded */
+    uint64_t connects;
+    uint64_t refused;        /**< Client table full */
+    uint64_t images;         /**< Image refreshes */
+    uint64_t image_errors;   /**< Refreshes that missed an axis */
+} DaemonStats_t;
+
+/**
+ * @brief Daemon state (caller-owned)
+ */
+typedef struct
+{
+    int32_t          listen_fd;
+    int32_t          client[DAEMON_MAX_CLIENTS];   /**< -1 = free */
+    char             path[108];
+    volatile bool    stop;
+    AxisStateStore_t image;
+    uint32_t         image_no;
+    TelemetryShm_t   telem;        /**< Published on refresh if mapped */
+    DaemonStats_t    stats;
+} Daemon_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Bind and listen (path NULL = DAEMON_SOCKET_PATH) and set up
+ *         the image for AXIS_COUNT axes; MODBUS_Init() must have run
+ * @return 0, or -1
+ */
+int32_t DAEMON_Open(Daemon_t *d, const char *path);
+void DAEMON_Close(Daemon_t *d);
+
+/**
+ * @brief  Accept clients and answer their requests, waiting up to
+ *         timeout_ms (0 = only what is already queued)
+ * @return Requests answered, or -1 if polling failed
+ */
+int32_t DAEMON_Service(Daemon_t *d, int32_t timeout_ms);
+
+/**
+ * @brief  Re-read the image from the drives and publish it to the
+ *         telemetry segment, if one is mapped
+ * @return Axes read
+ */
+uint32_t DAEMON_Refresh(Daemon_t *d);
+
+/**
+ * @brief  Serve and refresh the image every image_us (0 =
+ *         DAEMON_IMAGE_US) until DAEMON_Stop(); safe to stop from a
+ *         signal handler
+ */
+void DAEMON_Run(Daemon_t *d, uint32_t image_us);
+void DAEMON_Stop(Daemon_t *d);
+
+/**
+ * @brief  CyclicTaskFn_t wrapper (arg is a Daemon_t *): serve queued
+ *         requests without waiting; refresh the image in a task of its own
+ */
+void DAEMON_Task(void *arg);
+
+void DAEMON_PrintStats(const Daemon_t *d);
+
+/*===========================================================
+ * Client Side
+ *===========================================================*/
+
+/**
+ * @brief  Connect to a daemon (path NULL = DAEMON_SOCKET_PATH)
+ * @return Socket, or -1
+ */
+int32_t DAEMON_Connect(const char *path);
+void DAEMON_Disconnect(int32_t fd);
+
+/**
+ * @brief  One request / response round trip
+ * @param  axes      Receives up to max_axes records (SNAPSHOT), may be NULL
+ * @return 0 if a response arrived (check rsp->status), -1 otherwise
+ */
+int32_t DAEMON_Call(int32_t fd, const DaemonRequest_t *req, DaemonResponse_t *rsp,
+                    DaemonAxis_t *axes, uint32_t max_axes);
+
+#endif /* DRIVE_DAEMON_H */
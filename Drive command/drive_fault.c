@@ -1,35 +1,19 @@
 #include "config.h"
 #include "drive_fault.h"
+#include "axis_table.h"
 #include "modbus_functions.h"
+#include "register_access.h"
 #include <stdio.h>
 #include <stdint.h>
 
-/*----------------------------------------------------------
- * Internal helper
- *----------------------------------------------------------*/
-static uint16_t GetRegisterAddress(Axis_t axis, uint16_t pan_addr, uint16_t tilt_addr)
-{
-    if (axis == AXIS_PAN)
-    {
-        return pan_addr;
-    }
-    else
-    {
-        return tilt_addr;
-    }
-}
-
 /*----------------------------------------------------------
  * Read and decode fault status bits
  *----------------------------------------------------------*/
 void Read_FaultStatus(Axis_t axis, FaultStatus_t *status)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_FAULT_STATUS_PAN, REG_FAULT_STATUS_TILT);
-
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
+    uint16_t raw = 0U;
 
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
+    (void)REG_ReadRaw(axis, REG_PAN_FAULT_STATUS, REG_AREA_INPUT, &raw);
     status->raw_code = raw;
 
     /* Decode bits */
@@ -49,14 +33,10 @@ void Read_FaultStatus(Axis_t axis, FaultStatus_t *status)
  *----------------------------------------------------------*/
 float Read_Temperature(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_TEMP, REG_TILT_TEMP);
+    fix16_t temp = 0;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float temp = ((float)raw) / 10.0F; /* e.g., scaled ×10 in register */
-
-    return temp;
+    (void)REG_Get_TEMP(axis, &temp);
+    return FIX_ToFloat(temp);
 }
 
 /*----------------------------------------------------------
@@ -64,11 +44,8 @@ float Read_Temperature(Axis_t axis)
  *----------------------------------------------------------*/
 uint16_t Read_FaultCode(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_FAULT_CODE, REG_TILT_FAULT_CODE);
-
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t code = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
+    uint16_t code = 0U;
 
+    (void)REG_ReadRaw(axis, REG_PAN_FAULT_CODE, REG_AREA_INPUT, &code);
     return code;
 }
@@ -21,21 +21,21 @@ typedef struct
 
 /**
  * @brief Read drive fault register and decode fault bits
- * @param axis Axis to read (AXIS_PAN or AXIS_TILT)
+ * @param axis Axis to read (1..AXIS_COUNT)
  * @param status Pointer to FaultStatus_t structure to populate
  */
 void Read_FaultStatus(Axis_t axis, FaultStatus_t *status);
 
 /**
  * @brief Read drive temperature (°C)
- * @param axis Axis to read (AXIS_PAN or AXIS_TILT)
+ * @param axis Axis to read (1..AXIS_COUNT)
  * @return Temperature in °C
  */
 float Read_Temperature(Axis_t axis);
 
 /**
  * @brief Read fault code (numeric code from drive)
- * @param axis Axis to read (AXIS_PAN or AXIS_TILT)
+ * @param axis Axis to read (1..AXIS_COUNT)
  * @return Raw fault code
  */
 uint16_t Read_FaultCode(Axis_t axis);
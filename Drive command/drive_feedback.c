@@ -1,39 +1,44 @@
 #include "config.h"
 #include "drive_feedback.h"
+#include "axis_table.h"
 #include "drive_command.h"
 #include "modbus_functions.h"
+#include "register_access.h"
 #include <stdio.h>
 #include <stdint.h>
 
 /*----------------------------------------------------------
- * Internal helper to get register address based on axis and type
+ * Read Position (Degrees)
  *----------------------------------------------------------*/
-static uint16_t GetRegisterAddress(Axis_t axis, uint16_t pan_addr, uint16_t tilt_addr)
+float Read_Position_Deg(Axis_t axis)
 {
-    if (axis == AXIS_PAN)
-    {
-        return pan_addr;
-    }
-    else
-    {
-        return tilt_addr;
-    }
+    fix16_t position = 0;
+
+    (void)REG_Get_POS_DEG(axis, &position);
+    return FIX_ToFloat(position);
 }
 
 /*----------------------------------------------------------
- * Read Position (Degrees)
+ * Sampled reads: value plus the time it was taken
  *----------------------------------------------------------*/
-float Read_Position_Deg(Axis_t axis)
+static int32_t ReadSample(Axis_t axis, RegId_t id, FeedbackSample_t *sample)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_POS_DEG, REG_TILT_POS_DEG);
+    RegSample_t s;
+    int32_t len = REG_ReadSample(axis, id, &s);
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
+    sample->value     = FIX_ToFloat(s.value);
+    sample->sample_us = s.sample_us;
+    return len;
+}
 
-    /* Combine bytes (Big Endian) */
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float position = ((float)raw) / 100.0F; /* scaled by *100 per documentation */
-    return position;
+int32_t Read_Position_Deg_Sample(Axis_t axis, FeedbackSample_t *sample)
+{
+    return ReadSample(axis, REGID_POS_DEG, sample);
+}
+
+int32_t Read_Velocity_Sample(Axis_t axis, FeedbackSample_t *sample)
+{
+    return ReadSample(axis, REGID_VEL_SPD, sample);
 }
 
 /*----------------------------------------------------------
@@ -41,13 +46,10 @@ float Read_Position_Deg(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_Position_MM(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_POS_MM, REG_TILT_POS_MM);
+    fix16_t pos_mm = 0;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float pos_mm = ((float)raw) / 100.0F;
-    return pos_mm;
+    (void)REG_Get_POS_MM(axis, &pos_mm);
+    return FIX_ToFloat(pos_mm);
 }
 
 /*----------------------------------------------------------
@@ -55,13 +57,10 @@ float Read_Position_MM(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_Velocity(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_VEL_SPD, REG_TILT_VEL_SPD);
+    fix16_t velocity = 0;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float velocity = (float)raw;
-    return velocity;
+    (void)REG_Get_VEL_SPD(axis, &velocity);
+    return FIX_ToFloat(velocity);
 }
 
 /*----------------------------------------------------------
@@ -69,13 +68,10 @@ float Read_Velocity(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_RPM(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_RPM, REG_TILT_RPM);
+    fix16_t rpm = 0;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float rpm = (float)raw;
-    return rpm;
+    (void)REG_Get_RPM(axis, &rpm);
+    return FIX_ToFloat(rpm);
 }
 
 /*----------------------------------------------------------
@@ -83,13 +79,10 @@ float Read_RPM(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_Current(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_ACTUAL_CURRENT, REG_TILT_ACTUAL_CURRENT);
+    fix16_t current = 0;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float current = ((float)raw) / 10.0F; /* Example scale factor */
-    return current;
+    (void)REG_Get_ACTUAL_CURRENT(axis, &current);
+    return FIX_ToFloat(current);
 }
 
 /*----------------------------------------------------------
@@ -97,13 +90,10 @@ float Read_Current(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_DCBusVoltage(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_DCBUS_VOLT, REG_TILT_DCBUS_VOLT);
+    fix16_t voltage = 0;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    float voltage = ((float)raw);
-    return voltage;
+    (void)REG_Get_DCBUS_VOLT(axis, &voltage);
+    return FIX_ToFloat(voltage);
 }
 
 /*----------------------------------------------------------
@@ -111,11 +101,9 @@ float Read_DCBusVoltage(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_IOStatus(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = (axis == AXIS_PAN) ? REG_PAN_IO_STATUS : REG_TILT_IO_STATUS;
+    uint16_t raw = 0U;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = ((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U];
+    (void)REG_ReadRaw(axis, REG_PAN_IO_STATUS, REG_AREA_INPUT, &raw);
 
     /* Return as-is; user can decode bits externally */
     return (float)raw;
@@ -126,29 +114,28 @@ float Read_IOStatus(Axis_t axis)
  *----------------------------------------------------------*/
 float Read_SystemStatus(Axis_t axis)
 {
-    uint8_t rx_buf[8U];
-    uint16_t addr = (axis == AXIS_PAN) ? REG_PAN_SYSTEM_STATUS : REG_TILT_SYSTEM_STATUS;
+    uint16_t raw = 0U;
 
-    (void)MODBUS_ReadInput(MODBUS_UNIT_ID, addr, 1U, rx_buf);
-    uint16_t raw = ((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U];
+    (void)REG_ReadRaw(axis, REG_PAN_SYSTEM_STATUS, REG_AREA_INPUT, &raw);
 
     /* Return as-is; user can decode system bits later */
     return (float)raw;
 }
 void Read_IO_Status(Axis_t axis)
 {
-    uint16_t addr = (axis == AXIS_PAN) ? REG_PAN_IO_STATUS : REG_TILT_IO_STATUS;
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_IO_STATUS);
 
-    uint8_t rx_buf[16] = {0};
-    int len = MODBUS_ReadHolding(MODBUS_UNIT_ID, addr, 1, rx_buf);
+    ModbusView_t view;
+    int len = MODBUS_ReadView(AXIS_UnitId(axis), MODBUS_FUNC_READ_HOLDING, addr, 1, &view);
 
-    if (len < 7)
+    if (len < 0)
     {
         printf("[ERROR] IO Status read failed! Len=%d\n", len);
         return;
     }
 
-    uint16_t io_raw = (rx_buf[3] << 8) | rx_buf[4];
+    uint16_t io_raw = MODBUS_ViewReg(&view, 0U);
+    MODBUS_ViewRelease(&view);
 
     uint8_t outputs = (io_raw >> 8) & 0xFF;  // CC Byte
     uint8_t inputs  =  io_raw       & 0xFF;  // DD Byte
@@ -2,19 +2,30 @@
 #define DRIVE_FEEDBACK_H
 
 #include <stdint.h>
+#include "axis_table.h"   /* Axis_t and axis descriptor table */
 
-/* Axis enumeration */
-typedef enum
+/**
+ * @brief A feedback value and the time the drive sampled it
+ *        (midpoint of request and reply, TIME_NowUs() base)
+ */
+typedef struct
 {
-    AXIS_PAN = 1U,
-    AXIS_TILT = 2U
-} Axis_t;
+    float    value;
+    uint64_t sample_us;   /**< 0 if the read failed */
+} FeedbackSample_t;
 
 /**
  * @brief Read position in degrees from the drive (Input Reg 0x04)
  */
 float Read_Position_Deg(Axis_t axis);
 
+/**
+ * @brief Read_Position_Deg / Read_Velocity with the sample time
+ * @return Response length, or -1 if the read failed
+ */
+int32_t Read_Position_Deg_Sample(Axis_t axis, FeedbackSample_t *sample);
+int32_t Read_Velocity_Sample(Axis_t axis, FeedbackSample_t *sample);
+
 /**
  * @brief Read position in millimeters from the drive (Input Reg 0x04)
  */
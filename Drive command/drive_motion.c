@@ -0,0 +1,172 @@
+#include "config.h"
+#include "drive_motion.h"
+#include "drive_parameters.h"
+#include "axis_table.h"
+#include "modbus_functions.h"
+#include "drive_time.h"
+#include "register_access.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+/* Smallest non-zero value representable in the x10 velocity/accel registers */
+#define MOTION_MIN_SCALED   (0.1F)
+
+/*----------------------------------------------------------
+ * Helper: minimum move time of a symmetric trapezoid
+ *----------------------------------------------------------*/
+static float MinMoveTime(float dist, float vmax, float amax, float *v_peak)
+{
+    float t;
+
+    if (dist <= 0.0F)
+    {
+        *v_peak = 0.0F;
+        t = 0.0F;
+    }
+    else if (dist >= ((vmax * vmax) / amax))
+    {
+        /* Trapezoid: reaches vmax */
+        *v_peak = vmax;
+        t = (dist / vmax) + (vmax / amax);
+    }
+    else
+    {
+        /* Triangle: never reaches vmax */
+        *v_peak = sqrtf(dist * amax);
+        t = 2.0F * sqrtf(dist / amax);
+    }
+    return t;
+}
+
+/*----------------------------------------------------------
+ * Helper: stretch an axis profile to the common move time
+ *----------------------------------------------------------*/
+static void StretchProfile(AxisProfile_t *axis, float t_axis, float v_peak,
+                           float amax, float t_common)
+{
+    float s = (t_common > 0.0F) ? (t_axis / t_common) : 0.0F;
+
+    axis->velocity = v_peak * s;
+    axis->accel    = amax * s * s;
+}
+
+/*----------------------------------------------------------
+ * Plan coordinated PAN/TILT profiles
+ *----------------------------------------------------------*/
+void Plan_CoordinatedMove(CoordinatedMove_t *move)
+{
+    float pan_amax  = Compute_MaxAccelerationDeg(AXIS_PAN);
+    float tilt_amax = Compute_MaxAccelerationDeg(AXIS_TILT);
+    float pan_peak, tilt_peak;
+
+    float t_pan  = MinMoveTime(fabsf(move->pan.target - move->pan.start),
+                               Compute_MaxVelocityDeg(AXIS_PAN), pan_amax, &pan_peak);
+    float t_tilt = MinMoveTime(fabsf(move->tilt.target - move->tilt.start),
+                               Compute_MaxVelocityDeg(AXIS_TILT), tilt_amax, &tilt_peak);
+
+    move->move_time_s = (t_pan > t_tilt) ? t_pan : t_tilt;
+
+    StretchProfile(&move->pan,  t_pan,  pan_peak,  pan_amax,  move->move_time_s);
+    StretchProfile(&move->tilt, t_tilt, tilt_peak, tilt_amax, move->move_time_s);
+}
+
+/*----------------------------------------------------------
+ * Helper: pack one axis into the 4-register motion block
+ *   (velocity / accel registers are in drive speed units)
+ *----------------------------------------------------------*/
+static void PackMotionBlock(Axis_t id, const AxisProfile_t *axis, uint16_t *reg_data)
+{
+    float mm_per_deg = 1.0F / Compute_DegPerMm(id);
+    float vel = axis->velocity * mm_per_deg;
+    float acc = axis->accel * mm_per_deg;
+
+    /* A moving axis must not round down to zero in the x10 registers */
+    if (axis->target != axis->start)
+    {
+        if (vel < MOTION_MIN_SCALED) { vel = MOTION_MIN_SCALED; }
+        if (acc < MOTION_MIN_SCALED) { acc = MOTION_MIN_SCALED; }
+    }
+
+    reg_data[0] = REG_Encode_POSITION(FIX_FromFloat(axis->target));
+    reg_data[1] = REG_Encode_VELOCITY(FIX_FromFloat(vel));
+    reg_data[2] = REG_Encode_ACCEL(FIX_FromFloat(acc));
+    reg_data[3] = REG_Encode_DECEL(FIX_FromFloat(acc));
+}
+
+/*----------------------------------------------------------
+ * Coordinated move: stage both axes, trigger back to back
+ *----------------------------------------------------------*/
+bool Drive_CoordinatedMove(float pan_deg, float tilt_deg, CoordinatedMove_t *move)
+{
+    uint16_t pan_regs[4U];
+    uint16_t tilt_regs[4U];
+    fix16_t  pan_pos = 0;
+    fix16_t  tilt_pos = 0;
+    uint64_t t_start, t_pan, t_tilt, t_done;
+    bool     ok = true;
+
+    if (!Check_SoftwareLimit(AXIS_PAN, pan_deg) ||
+        !Check_SoftwareLimit(AXIS_TILT, tilt_deg))
+    {
+        printf("[SOFT LIMIT BLOCK] Coordinated move rejected.\n");
+        return false;
+    }
+
+    /* 1) Plan from current positions; a stale start would mistime both axes */
+    if ((REG_Get_POS_DEG(AXIS_PAN, &pan_pos) < 0) || (REG_Get_POS_DEG(AXIS_TILT, &tilt_pos) < 0))
+    {
+        printf("[ERROR] Coordinated move: position read failed, nothing sent.\n");
+        return false;
+    }
+    move->pan.start   = FIX_ToFloat(pan_pos);
+    move->pan.target  = pan_deg;
+    move->tilt.start  = FIX_ToFloat(tilt_pos);
+    move->tilt.target = tilt_deg;
+    Plan_CoordinatedMove(move);
+
+    PackMotionBlock(AXIS_PAN,  &move->pan,  pan_regs);
+    PackMotionBlock(AXIS_TILT, &move->tilt, tilt_regs);
+
+    /* 2) Stage both axes: two 0x10 frames in flight, one RTT */
+    (void)MODBUS_SendWriteMultiple(AXIS_UnitId(AXIS_PAN),
+                                   AXIS_Reg(AXIS_PAN, REG_PAN_POSITION), 4U, pan_regs);
+    (void)MODBUS_SendWriteMultiple(AXIS_UnitId(AXIS_TILT),
+                                   AXIS_Reg(AXIS_TILT, REG_PAN_POSITION), 4U, tilt_regs);
+    ok = (MODBUS_ReceiveExpect(AXIS_UnitId(AXIS_PAN), MODBUS_FUNC_WRITE_MULTIPLE, 0U) > 0) && ok;
+    ok = (MODBUS_ReceiveExpect(AXIS_UnitId(AXIS_TILT), MODBUS_FUNC_WRITE_MULTIPLE, 0U) > 0) && ok;
+
+    if (!ok)
+    {
+        printf("[ERROR] Coordinated move: staging not acknowledged.\n");
+        return false;
+    }
+
+    /* 3) Trigger both axes back to back; nothing else between the sends */
+    t_start = TIME_NowUs();
+    (void)MODBUS_SendWriteSingle(AXIS_UnitId(AXIS_PAN), REG_CMD_POS_MOVE, (uint16_t)AXIS_PAN);
+    t_pan = TIME_NowUs();
+    (void)MODBUS_SendWriteSingle(AXIS_UnitId(AXIS_TILT), REG_CMD_POS_MOVE, (uint16_t)AXIS_TILT);
+    t_tilt = TIME_NowUs();
+    ok = (MODBUS_ReceiveExpect(AXIS_UnitId(AXIS_PAN), MODBUS_FUNC_WRITE_SINGLE, 0U) > 0) && ok;
+    ok = (MODBUS_ReceiveExpect(AXIS_UnitId(AXIS_TILT), MODBUS_FUNC_WRITE_SINGLE, 0U) > 0) && ok;
+    t_done = TIME_NowUs();
+
+    move->start_skew_us = (uint32_t)(t_tilt - t_pan);
+    move->trigger_us    = (uint32_t)(t_done - t_start);
+
+    printf("Coordinated move: PAN %.2f->%.2f (v=%.2f a=%.2f) | "
+           "TILT %.2f->%.2f (v=%.2f a=%.2f)\n",
+           move->pan.start, move->pan.target, move->pan.velocity, move->pan.accel,
+           move->tilt.start, move->tilt.target, move->tilt.velocity, move->tilt.accel);
+    printf("  Arrival in %.3f s | start skew %lu us | trigger ack %lu us\n",
+           move->move_time_s, (unsigned long)move->start_skew_us,
+           (unsigned long)move->trigger_us);
+
+    if (!ok)
+    {
+        printf("[ERROR] Coordinated move: trigger not acknowledged.\n");
+    }
+    return ok;
+}
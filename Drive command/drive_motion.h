@@ -0,0 +1,57 @@
+#ifndef DRIVE_MOTION_H
+#define DRIVE_MOTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drive_feedback.h"   /* For Axis_t enum */
+
+/**
+ * @brief Per-axis trapezoidal profile of a coordinated move
+ */
+typedef struct
+{
+    float start;        /**< Position at plan time (deg) */
+    float target;       /**< Target position (deg) */
+    float velocity;     /**< Planned peak velocity (deg/s) */
+    float accel;        /**< Planned acceleration = deceleration (deg/s^2) */
+} AxisProfile_t;
+
+/**
+ * @brief Coordinated PAN/TILT move plan and measured trigger timing
+ */
+typedef struct
+{
+    AxisProfile_t pan;
+    AxisProfile_t tilt;
+    float    move_time_s;     /**< Common arrival time of both axes */
+    uint32_t start_skew_us;   /**< Gap between PAN and TILT trigger frames */
+    uint32_t trigger_us;      /**< Time until both triggers were acknowledged */
+} CoordinatedMove_t;
+
+/**
+ * @brief Compute per-axis velocity/acceleration so both axes start and
+ *        finish together, using each axis' velocity/acceleration limits
+ *
+ * The slower axis runs its minimum-time profile; the other axis runs the
+ * same profile stretched in time (v scaled by s, a by s^2). Planned in
+ * degrees against Compute_MaxVelocityDeg / Compute_MaxAccelerationDeg.
+ *
+ * @param move  In: pan/tilt start and target. Out: velocity, accel, time.
+ */
+void Plan_CoordinatedMove(CoordinatedMove_t *move);
+
+/**
+ * @brief Move PAN and TILT to absolute targets with synchronized arrival
+ *
+ * Reads both current positions, plans the profiles, stages both axes with
+ * one 0x10 frame each and fires both position-move commands back to back.
+ * Nothing is sent if either position cannot be read.
+ *
+ * @param pan_deg   PAN target (deg)
+ * @param tilt_deg  TILT target (deg)
+ * @param move      Filled with the plan and the measured start skew
+ * @return true if both axes were staged and triggered
+ */
+bool Drive_CoordinatedMove(float pan_deg, float tilt_deg, CoordinatedMove_t *move);
+
+#endif /* DRIVE_MOTION_H */
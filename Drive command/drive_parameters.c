@@ -1,41 +1,27 @@
 #include "config.h"
 #include "drive_parameters.h"
+#include "axis_table.h"
 #include "modbus_functions.h"
+#include "register_access.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 
-static bool Check_SoftwareLimit(Axis_t axis, float target_deg)
+bool Check_SoftwareLimit(Axis_t axis, float target_deg)
 {
-    if (axis == AXIS_PAN)
+    const AxisDescriptor_t *desc = AXIS_Get(axis);
+
+    if (target_deg < desc->limit_min_deg)
     {
-        if (target_deg < PAN_LIMIT_LEFT_DEG)
-        {
-            printf("[LIMIT] PAN left limit reached: %.2f° < %.2f°\n",
-                    target_deg, PAN_LIMIT_LEFT_DEG);
-            return false;
-        }
-        if (target_deg > PAN_LIMIT_RIGHT_DEG)
-        {
-            printf("[LIMIT] PAN right limit reached: %.2f° > %.2f°\n",
-                    target_deg, PAN_LIMIT_RIGHT_DEG);
-            return false;
-        }
+        printf("[LIMIT] %s lower limit reached: %.2f° < %.2f°\n",
+                desc->name, target_deg, desc->limit_min_deg);
+        return false;
     }
-    else /* AXIS_TILT */
+    if (target_deg > desc->limit_max_deg)
     {
-        if (target_deg < TILT_LIMIT_DOWN_DEG)
-        {
-            printf("[LIMIT] TILT down limit reached: %.2f° < %.2f°\n",
-                    target_deg, TILT_LIMIT_DOWN_DEG);
-            return false;
-        }
-        if (target_deg > TILT_LIMIT_UP_DEG)
-        {
-            printf("[LIMIT] TILT up limit reached: %.2f° > %.2f°\n",
-                    target_deg, TILT_LIMIT_UP_DEG);
-            return false;
-        }
+        printf("[LIMIT] %s upper limit reached: %.2f° > %.2f°\n",
+                desc->name, target_deg, desc->limit_max_deg);
+        return false;
     }
 
     return true; /* Move allowed */
@@ -43,70 +29,81 @@ static bool Check_SoftwareLimit(Axis_t axis, float target_deg)
 
 static bool Check_SoftwareLimit_MM(Axis_t axis, float target_mm)
 {
-    if (axis == AXIS_PAN)
-    {
-        if (target_mm < PAN_LIMIT_LEFT_MM)  return false;
-        if (target_mm > PAN_LIMIT_RIGHT_MM) return false;
-    }
-    else
-    {
-        if (target_mm < TILT_LIMIT_DOWN_MM) return false;
-        if (target_mm > TILT_LIMIT_UP_MM)   return false;
-    }
+    const AxisDescriptor_t *desc = AXIS_Get(axis);
+
+    if (target_mm < desc->limit_min_mm) return false;
+    if (target_mm > desc->limit_max_mm) return false;
     return true;
 }
 
 
-static float Compute_MaxVelocity(void)
+float Compute_MaxVelocity(Axis_t axis)
 {
     /* Formula: (RPM / 60) × mm_per_rev */
-    return (MAX_RPM / 60.0F) * DPMR_MM;
+    const AxisDescriptor_t *desc = AXIS_Get(axis);
+    return (desc->max_rpm / 60.0F) * desc->mm_per_rev;
 }
 
-static float Compute_MaxAcceleration(void)
+float Compute_MaxAcceleration(Axis_t axis)
 {
     /* Formula: MaxVelocity × factor (1.5 to 2) */
-    float vmax = Compute_MaxVelocity();
-    return vmax * ACCEL_FACTOR;
+    float vmax = Compute_MaxVelocity(axis);
+    return vmax * AXIS_Get(axis)->accel_factor;
 }
-/*----------------------------------------------------------
- * Helper: Select the correct Modbus register address
- *----------------------------------------------------------*/
-static uint16_t GetRegisterAddress(Axis_t axis, uint16_t pan_addr, uint16_t tilt_addr)
+
+float Compute_DegPerMm(Axis_t axis)
 {
-    if (axis == AXIS_PAN)
-    {
-        return pan_addr;
-    }
-    else
-    {
-        return tilt_addr;
-    }
+    const AxisDescriptor_t *desc = AXIS_Get(axis);
+    float span_mm = desc->limit_max_mm - desc->limit_min_mm;
+
+    return (span_mm > 0.0F) ? ((desc->limit_max_deg - desc->limit_min_deg) / span_mm) : 1.0F;
 }
 
+float Compute_MaxVelocityDeg(Axis_t axis)
+{
+    return Compute_MaxVelocity(axis) * Compute_DegPerMm(axis);
+}
+
+float Compute_MaxAccelerationDeg(Axis_t axis)
+{
+    return Compute_MaxAcceleration(axis) * Compute_DegPerMm(axis);
+}
 /*----------------------------------------------------------
  * Helper: Convert float to scaled uint16_t value
+ *   Kept for callers with an ad-hoc scale; rounds and
+ *   saturates like FIX_FloatToReg instead of wrapping.
  *----------------------------------------------------------*/
-static uint16_t FloatToReg(float value, float scale)
+uint16_t FloatToReg(float value, float scale)
 {
-    int16_t temp = (int16_t)(value * scale);
-    return (uint16_t)temp;
+    float counts = value * scale;
+
+    if (counts >= 32767.0F)  { return (uint16_t)INT16_MAX; }
+    if (counts <= -32768.0F) { return (uint16_t)(int16_t)INT16_MIN; }
+    if (!(counts == counts)) { return 0U; }
+
+    return (uint16_t)(int16_t)((counts >= 0.0F) ? (counts + 0.5F) : (counts - 0.5F));
 }
 
 /*----------------------------------------------------------
  * Helper: Read back and verify write (optional)
  *----------------------------------------------------------*/
-static void VerifyParameterWrite(uint16_t addr)
+static void VerifyParameterWrite(Axis_t axis, uint16_t addr)
 {
-    uint8_t rx_buf[8U];
-    (void)MODBUS_ReadHolding(MODBUS_UNIT_ID, addr, 1U, rx_buf);
+    ModbusView_t view;
 
-    uint16_t raw = (uint16_t)(((uint16_t)rx_buf[3U] << 8U) | rx_buf[4U]);
-    printf("   Verified Write: [0x%X] = %u\n", addr, raw);
+    if (MODBUS_ReadView(AXIS_UnitId(axis), MODBUS_FUNC_READ_HOLDING, addr, 1U, &view) < 0)
+    {
+        printf("   Verify read of [0x%X] failed\n", addr);
+        return;
+    }
+
+    printf("   Verified Write: [0x%X] = %u\n", addr, MODBUS_ViewReg(&view, 0U));
+    MODBUS_ViewRelease(&view);
 }
 
 /*----------------------------------------------------------
- * Set Position (mm)
+ * Set Position (mm offset; the POSITION setpoint is in
+ * degrees, as Set_MotionParameters writes it)
  *----------------------------------------------------------*/
 void Set_Position(Axis_t axis, float mm)
 {
@@ -126,21 +123,22 @@ void Set_Position(Axis_t axis, float mm)
         return;
     }
 
-    /* 4) Select correct register */
-    uint16_t addr = GetRegisterAddress(axis,
-                                       REG_PAN_POS_MM,
-                                       REG_TILT_POS_MM);
+    /* 4) mm -> deg: the mm and deg limits bound the same travel */
+    const AxisDescriptor_t *desc = AXIS_Get(axis);
+    float target_deg = desc->limit_min_deg +
+                       ((target_mm - desc->limit_min_mm) * Compute_DegPerMm(axis));
 
-    /* 5) convert mm→register (use ×100 scaling, same as degrees) */
-    uint16_t val = FloatToReg(target_mm, 100.0F);
+    /* 5) Select correct register: the POSITION setpoint; POS_MM is
+     *    the read-only feedback */
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_POSITION);
 
-    /* 6) Write to drive */
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    /* 6) Write to drive (scale from the register table) */
+    (void)REG_Set_POSITION(axis, FIX_FromFloat(target_deg));
 
-    printf("[MOVE OK] Axis %u -> Target: %.2f mm (Reg 0x%X)\n",
-           axis, target_mm, addr);
+    printf("[MOVE OK] Axis %u -> Target: %.2f mm = %.2f deg (Reg 0x%X)\n",
+           axis, target_mm, target_deg, addr);
 
-    VerifyParameterWrite(addr);
+    VerifyParameterWrite(axis, addr);
 }
 
 
@@ -149,7 +147,7 @@ void Set_Position(Axis_t axis, float mm)
  *----------------------------------------------------------*/
 void Set_Velocity(Axis_t axis, float vel)
 {
-    float vmax = Compute_MaxVelocity();
+    float vmax = Compute_MaxVelocity(axis);
 
     if (vel > vmax)
     {
@@ -158,20 +156,19 @@ void Set_Velocity(Axis_t axis, float vel)
         vel = vmax;
     }
 
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_VELOCITY, REG_TILT_VELOCITY);
-    uint16_t val  = FloatToReg(vel, 10.0F);
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_VELOCITY);
 
-    MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    (void)REG_Set_VELOCITY(axis, FIX_FromFloat(vel));
 
     printf("Axis %u: Set Velocity = %.2f mm/s\n", axis, vel);
-    VerifyParameterWrite(addr);
+    VerifyParameterWrite(axis, addr);
 }
 /*----------------------------------------------------------
  * Set Acceleration
  *----------------------------------------------------------*/
 void Set_Acceleration(Axis_t axis, float accel)
 {
-    float amax = Compute_MaxAcceleration();
+    float amax = Compute_MaxAcceleration(axis);
 
     if (accel > amax)
     {
@@ -180,13 +177,12 @@ void Set_Acceleration(Axis_t axis, float accel)
         accel = amax;
     }
 
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_ACCEL, REG_TILT_ACCEL);
-    uint16_t val  = FloatToReg(accel, 10.0F);
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_ACCEL);
 
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    (void)REG_Set_ACCEL(axis, FIX_FromFloat(accel));
 
     printf("Axis %u: Set Accel = %.2f mm/s²\n", axis, accel);
-    VerifyParameterWrite(addr);
+    VerifyParameterWrite(axis, addr);
 }
 
 
@@ -195,13 +191,12 @@ void Set_Acceleration(Axis_t axis, float accel)
  *----------------------------------------------------------*/
 void Set_Deceleration(Axis_t axis, float decel)
 {
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_DECEL, REG_TILT_DECEL);
-    uint16_t val = FloatToReg(decel, 10.0F);
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_DECEL);
 
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    (void)REG_Set_DECEL(axis, FIX_FromFloat(decel));
     printf("Axis %u: Set Decel = %.2f (Reg 0x%X)\n", axis, decel, addr);
 
-    VerifyParameterWrite(addr);
+    VerifyParameterWrite(axis, addr);
 }
 
 /*----------------------------------------------------------
@@ -209,13 +204,12 @@ void Set_Deceleration(Axis_t axis, float decel)
  *----------------------------------------------------------*/
 void Set_HomeOffset(Axis_t axis, float offset)
 {
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_HOME_OFFSET, REG_TILT_HOME_OFFSET);
-    uint16_t val = FloatToReg(offset, 100.0F);
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_HOME_OFFSET);
 
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    (void)REG_Set_HOME_OFFSET(axis, FIX_FromFloat(offset));
     printf("Axis %u: Set HomeOffset = %.2f (Reg 0x%X)\n", axis, offset, addr);
 
-    VerifyParameterWrite(addr);
+    VerifyParameterWrite(axis, addr);
 }
 
 /*----------------------------------------------------------
@@ -223,13 +217,12 @@ void Set_HomeOffset(Axis_t axis, float offset)
  *----------------------------------------------------------*/
 void Set_DegCorrection(Axis_t axis, float deg_corr)
 {
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_DEG_CORRECTION, REG_TILT_DEG_CORRECTION);
-    uint16_t val = FloatToReg(deg_corr, 100.0F);
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_DEG_CORRECTION);
 
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    (void)REG_Set_DEG_CORRECTION(axis, FIX_FromFloat(deg_corr));
     printf("Axis %u: Set DegCorrection = %.2f (Reg 0x%X)\n", axis, deg_corr, addr);
 
-    VerifyParameterWrite(addr);
+    VerifyParameterWrite(axis, addr);
 }
 
 /*----------------------------------------------------------
@@ -249,19 +242,16 @@ void Set_DegPosition(Axis_t axis, float deg_pos)
         return;  /* Do NOT write to drive */
     }
     /* 3) Select correct axis register */
-    uint16_t addr = GetRegisterAddress(axis, REG_PAN_DEG_POS, REG_TILT_DEG_POS);
-
-    /* 4) Convert degree to register value (×100 scaling) */
-    uint16_t val = FloatToReg(deg_pos, 100.0F);
+    uint16_t addr = AXIS_Reg(axis, REG_PAN_DEG_POS);
 
-    /* 5) Write to modbus register */
-    (void)MODBUS_WriteSingle(MODBUS_UNIT_ID, addr, val);
+    /* 4) Write to modbus register (scale from the register table) */
+    (void)REG_Set_DEG_POS(axis, FIX_FromFloat(deg_pos));
 
     printf("[MOVE OK] Axis %u: Set DegPosition = %.2f° (Reg 0x%X)\n",
            axis, deg_pos, addr);
 
-    /* 6) Verify write (optional but useful for debugging) */
-    VerifyParameterWrite(addr);
+    /* 5) Verify write (optional but useful for debugging) */
+    VerifyParameterWrite(axis, addr);
 }
 
 
@@ -271,27 +261,18 @@ void Set_DegPosition(Axis_t axis, float deg_pos)
  *----------------------------------------------------------*/
 void Set_MotionParameters(Axis_t axis, float pos, float vel, float accel, float decel)
 {
-    uint16_t start_addr;
+    uint16_t start_addr = AXIS_Reg(axis, REG_PAN_POSITION);
     uint16_t reg_data[4U]; /* 4 registers */
 
-    if (axis == AXIS_PAN)
-    {
-        start_addr = REG_PAN_POSITION;
-    }
-    else
-    {
-        start_addr = REG_TILT_POSITION;
-    }
-
-    reg_data[0] = FloatToReg(pos,   100.0F);
-    reg_data[1] = FloatToReg(vel,   10.0F);
-    reg_data[2] = FloatToReg(accel, 10.0F);
-    reg_data[3] = FloatToReg(decel, 10.0F);
+    reg_data[0] = REG_Encode_POSITION(FIX_FromFloat(pos));
+    reg_data[1] = REG_Encode_VELOCITY(FIX_FromFloat(vel));
+    reg_data[2] = REG_Encode_ACCEL(FIX_FromFloat(accel));
+    reg_data[3] = REG_Encode_DECEL(FIX_FromFloat(decel));
 
-    (void)MODBUS_WriteMultiple(MODBUS_UNIT_ID, start_addr, 4U, reg_data);
+    (void)MODBUS_WriteMultiple(AXIS_UnitId(axis), start_addr, 4U, reg_data);
 
     printf("Axis %u: Multi-param write @0x%X Pos=%.2f Vel=%.2f Acc=%.2f Dec=%.2f\n",
            axis, start_addr, pos, vel, accel, decel);
 
-    VerifyParameterWrite(start_addr);
+    VerifyParameterWrite(axis, start_addr);
 }
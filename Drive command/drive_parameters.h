@@ -2,12 +2,47 @@
 #define DRIVE_PARAMETERS_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "drive_feedback.h"  /* For Axis_t type */
 
 /**
- * @brief Set target position (degrees)
+ * @brief Check a target angle against the axis software limits
+ * @return true if the move is allowed
  */
-void Set_Position(Axis_t axis, float deg);
+bool Check_SoftwareLimit(Axis_t axis, float target_deg);
+
+/**
+ * @brief Maximum velocity of an axis from its max RPM and mm per revolution
+ */
+float Compute_MaxVelocity(Axis_t axis);
+
+/**
+ * @brief Maximum acceleration of an axis (MaxVelocity x accel factor)
+ */
+float Compute_MaxAcceleration(Axis_t axis);
+
+/**
+ * @brief Degrees of axis travel per mm (the deg and mm software limits
+ *        bound the same travel)
+ */
+float Compute_DegPerMm(Axis_t axis);
+
+/**
+ * @brief Compute_MaxVelocity / Compute_MaxAcceleration in deg/s, deg/s^2
+ */
+float Compute_MaxVelocityDeg(Axis_t axis);
+float Compute_MaxAccelerationDeg(Axis_t axis);
+
+/**
+ * @brief Convert an engineering value to a scaled signed register word
+ */
+uint16_t FloatToReg(float value, float scale);
+
+/**
+ * @brief Move by mm from the current position; the POSITION setpoint
+ *        is written in degrees
+ */
+void Set_Position(Axis_t axis, float mm);
 
 /**
  * @brief Set velocity (speed units)
@@ -43,7 +78,7 @@ void Set_DegPosition(Axis_t axis, float deg_pos);
  * @brief Set motion parameters (position, velocity, acceleration, deceleration)
  *        in one Modbus multi-register command (0x10)
  *
- * @param axis   Axis to command (AXIS_PAN or AXIS_TILT)
+ * @param axis   Axis to command (1..AXIS_COUNT)
  * @param pos    Target position in degrees
  * @param vel    Velocity
  * @param accel  Acceleration
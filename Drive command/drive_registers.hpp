@@ -0,0 +1,390 @@
+#ifndef DRIVE_REGISTERS_HPP
+#define DRIVE_REGISTERS_HPP
+
+/*===========================================================
+ * Typed Register API (C++20, header-only)
+ *===========================================================*/
+/* Thin layer over the C transport (modbus_functions.h). Register
+ * address, area, scale and signedness come from the register table in
+ * config.h; the unit type is chosen here. Everything except the
+ * MODBUS_Read / MODBUS_Write calls is resolved at compile time.
+ *
+ *   auto deg = drive::read<drive::PosDeg>(AXIS_PAN);          // optional<Degrees>
+ *   drive::write<drive::Velocity>(AXIS_TILT, drive::MmPerSec{25.0F});
+ *
+ *   // Planned at compile time: 0x03 282..288, 0x04 384, 0x04 412..420
+ *   auto s = drive::readBatch<drive::PosDeg, drive::Current,
+ *                             drive::FaultStatus, drive::Position,
+ *                             drive::Decel>(AXIS_PAN);
+ *   if (s) { auto [deg, amps, faults, pos, dec] = *s; }
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+#include "axis_table.h"
+#include "modbus_functions.h"
+#include "modbus_decode.h"
+
+namespace drive
+{
+
+/*===========================================================
+ * Units
+ *===========================================================*/
+template <typename Tag>
+struct Quantity
+{
+    float value = 0.0F;
+
+    constexpr Quantity() = default;
+    constexpr explicit Quantity(float v) : value(v) {}
+
+    friend constexpr bool operator==(Quantity, Quantity) = default;
+};
+
+using Degrees     = Quantity<struct DegreesTag>;
+using Millimeters = Quantity<struct MillimetersTag>;
+using MmPerSec    = Quantity<struct MmPerSecTag>;
+using MmPerSec2   = Quantity<struct MmPerSec2Tag>;
+using SpeedUnits  = Quantity<struct SpeedUnitsTag>;
+using Rpm         = Quantity<struct RpmTag>;
+using Amps        = Quantity<struct AmpsTag>;
+using Volts       = Quantity<struct VoltsTag>;
+using Celsius     = Quantity<struct CelsiusTag>;
+
+template <typename T>
+inline constexpr bool is_quantity_v = false;
+template <typename Tag>
+inline constexpr bool is_quantity_v<Quantity<Tag>> = true;
+
+/*===========================================================
+ * Register Type
+ *===========================================================*/
+enum class Area : std::uint8_t { HOLDING, INPUT };
+enum class Access : std::uint8_t { RO = 1, WO = 2, RW = 3 };
+
+/* Big-endian register word */
+constexpr std::uint16_t be16(const std::uint8_t *p)
+{
+    return static_cast<std::uint16_t>((static_cast<unsigned>(p[0]) << 8U) | p[1]);
+}
+
+/**
+ * @brief One drive register: area, axis-1 address, value type and scale
+ *        (counts per unit). T is a Quantity or std::uint16_t for raw words.
+ */
+template <Area A, std::uint16_t Addr, typename T, std::int32_t Scale,
+          bool Signed = true, Access Acc = Access::RW>
+struct Register
+{
+    using value_type = T;
+
+    static constexpr Area          area      = A;
+    static constexpr std::uint16_t address   = Addr;
+    static constexpr std::int32_t  scale     = Scale;
+    static constexpr bool          is_signed = Signed;
+    static constexpr Access        access    = Acc;
+    static constexpr bool readable = (static_cast<unsigned>(Acc) & 1U) != 0U;
+    static constexpr bool writable = (static_cast<unsigned>(Acc) & 2U) != 0U;
+
+    static_assert(Scale > 0, "scale is counts per unit");
+    static_assert(is_quantity_v<T> || std::is_same_v<T, std::uint16_t>,
+                  "value type is a drive::Quantity or a raw std::uint16_t");
+
+    static constexpr T decode(std::uint16_t raw)
+    {
+        if constexpr (std::is_same_v<T, std::uint16_t>)
+        {
+            return raw;
+        }
+        else
+        {
+            constexpr float k = 1.0F / static_cast<float>(Scale);
+            const float counts = Signed ? static_cast<float>(static_cast<std::int16_t>(raw))
+                                        : static_cast<float>(raw);
+            return T{counts * k};
+        }
+    }
+
+    /* Rounded to nearest and saturated to the register range */
+    static constexpr std::uint16_t encode(T v)
+    {
+        if constexpr (std::is_same_v<T, std::uint16_t>)
+        {
+            return v;
+        }
+        else
+        {
+            constexpr float lo = Signed ? -32768.0F : 0.0F;
+            constexpr float hi = Signed ? 32767.0F : 65535.0F;
+            float counts = v.value * static_cast<float>(Scale);
+
+            if (!(counts == counts)) { counts = 0.0F; }
+            counts = (counts < lo) ? lo : ((counts > hi) ? hi : counts);
+            counts += (counts >= 0.0F) ? 0.5F : -0.5F;
+
+            return Signed ? static_cast<std::uint16_t>(static_cast<std::int16_t>(counts))
+                          : static_cast<std::uint16_t>(counts);
+        }
+    }
+};
+
+/*===========================================================
+ * Registers from the config.h table
+ *===========================================================*/
+namespace rows
+{
+#define REGTAB_CXX_ROW(n, addr, ar, w, sc, sg, acc) \
+    struct n \
+    { \
+        static constexpr Area          area      = Area::ar; \
+        static constexpr std::uint16_t address   = (addr); \
+        static constexpr std::int32_t  scale     = SCALE_##sc; \
+        static constexpr bool          is_signed = ((sg) != 0); \
+        static constexpr Access        access    = Access::acc; \
+        static_assert((w) == 1U, "multi-word registers need a wider value type"); \
+    };
+DRIVE_AXIS_REGISTERS(REGTAB_CXX_ROW)
+#undef REGTAB_CXX_ROW
+} // namespace rows
+
+template <typename Row, typename T>
+using RegisterOf = Register<Row::area, Row::address, T, Row::scale, Row::is_signed, Row::access>;
+
+using Position      = RegisterOf<rows::POSITION,       Degrees>;
+using Velocity      = RegisterOf<rows::VELOCITY,       MmPerSec>;
+using Accel         = RegisterOf<rows::ACCEL,          MmPerSec2>;
+using Decel         = RegisterOf<rows::DECEL,          MmPerSec2>;
+using HomeOffset    = RegisterOf<rows::HOME_OFFSET,    Degrees>;
+using DegCorrection = RegisterOf<rows::DEG_CORRECTION, Degrees>;
+using DegPos        = RegisterOf<rows::DEG_POS,        Degrees>;
+using FaultStatus   = RegisterOf<rows::FAULT_STATUS,   std::uint16_t>;
+using PosDeg        = RegisterOf<rows::POS_DEG,        Degrees>;
+using VelSpd        = RegisterOf<rows::VEL_SPD,        SpeedUnits>;
+using PosMm         = RegisterOf<rows::POS_MM,         Millimeters>;
+using MotorRpm      = RegisterOf<rows::RPM,            Rpm>;
+using Current       = RegisterOf<rows::ACTUAL_CURRENT, Amps>;
+using IoStatus      = RegisterOf<rows::IO_STATUS,      std::uint16_t>;
+using SystemStatus  = RegisterOf<rows::SYSTEM_STATUS,  std::uint16_t>;
+using DcBus         = RegisterOf<rows::DCBUS_VOLT,     Volts>;
+using Temperature   = RegisterOf<rows::TEMP,           Celsius>;
+using FaultCode     = RegisterOf<rows::FAULT_CODE,     std::uint16_t>;
+
+/*===========================================================
+ * Compile-time Block Plan
+ *===========================================================*/
+inline constexpr std::uint16_t kMaxBlockRegs = 125U;  /* 0x03/0x04 limit */
+inline constexpr std::uint16_t kMaxBlockGap  = 8U;    /* read through small holes */
+
+struct Block
+{
+    Area          area     = Area::HOLDING;
+    std::uint16_t pan_addr = 0U;
+    std::uint16_t count    = 0U;
+};
+
+template <typename... Regs>
+struct BlockPlan
+{
+    static constexpr std::size_t kRegs = sizeof...(Regs);
+
+    struct Key
+    {
+        Area          area;
+        std::uint16_t addr;
+    };
+
+    /* Sort by (area, address) and merge runs closer than kMaxBlockGap */
+    static constexpr auto build()
+    {
+        std::array<Key, kRegs> keys{Key{Regs::area, Regs::address}...};
+        std::array<Block, kRegs> blocks{};
+        std::size_t n = 0U;
+
+        for (std::size_t i = 1U; i < kRegs; ++i)
+        {
+            for (std::size_t j = i; j > 0U; --j)
+            {
+                const Key a = keys[j - 1U];
+                const Key b = keys[j];
+                if ((a.area > b.area) || ((a.area == b.area) && (a.addr > b.addr)))
+                {
+                    keys[j - 1U] = b;
+                    keys[j] = a;
+                }
+            }
+        }
+
+        for (const Key &k : keys)
+        {
+            if (n > 0U)
+            {
+                Block &last = blocks[n - 1U];
+                const unsigned end  = static_cast<unsigned>(last.pan_addr) + last.count;
+                const unsigned span = (static_cast<unsigned>(k.addr) - last.pan_addr) + 1U;
+
+                if ((last.area == k.area) && (k.addr < end))
+                {
+                    continue;       /* duplicate */
+                }
+                if ((last.area == k.area) && (k.addr <= (end + kMaxBlockGap)) &&
+                    (span <= kMaxBlockRegs))
+                {
+                    last.count = static_cast<std::uint16_t>(span);
+                    continue;
+                }
+            }
+            blocks[n++] = Block{k.area, k.addr, 1U};
+        }
+
+        return std::pair{blocks, n};
+    }
+
+    static constexpr auto kPlan   = build();
+    static constexpr auto kBlocks = kPlan.first;
+    static constexpr std::size_t kCount = kPlan.second;
+
+    /* Block holding a register, and its word offset in that block */
+    template <typename Reg>
+    static constexpr std::pair<std::size_t, std::size_t> locate()
+    {
+        for (std::size_t b = 0U; b < kCount; ++b)
+        {
+            const Block &blk = kBlocks[b];
+            if ((blk.area == Reg::area) && (Reg::address >= blk.pan_addr) &&
+                (Reg::address < (blk.pan_addr + blk.count)))
+            {
+                return {b, static_cast<std::size_t>(Reg::address - blk.pan_addr)};
+            }
+        }
+        return {kCount, 0U};
+    }
+};
+
+/*===========================================================
+ * Access
+ *===========================================================*/
+namespace detail
+{
+/* Pooled response view, released on scope exit; the words are
+ * decoded in one bulk pass when the block arrives */
+struct FrameView
+{
+    ModbusView_t view{};
+    std::array<std::uint16_t, MODBUS_MAX_READ_REGS> words{};
+
+    FrameView() = default;
+    FrameView(const FrameView &) = delete;
+    FrameView &operator=(const FrameView &) = delete;
+    ~FrameView() { MODBUS_ViewRelease(&view); }
+
+    std::uint16_t operator[](std::uint16_t i) const { return words[i]; }
+};
+
+/* One 0x03/0x04 request; true if the response carries all words */
+inline bool readBlock(Axis_t axis, Area area, std::uint16_t pan_addr, std::uint16_t count,
+                      FrameView &out)
+{
+    const std::uint8_t func = (area == Area::INPUT) ? MODBUS_FUNC_READ_INPUT
+                                                    : MODBUS_FUNC_READ_HOLDING;
+
+    if (MODBUS_ReadView(AXIS_UnitId(axis), func, AXIS_Reg(axis, pan_addr),
+                        count, &out.view) < 0)
+    {
+        return false;
+    }
+    MODBUS_DecodeWords(out.view.regs, out.words.data(), count);
+    return true;
+}
+} // namespace detail
+
+/**
+ * @brief Read one register of an axis
+ */
+template <typename Reg>
+    requires Reg::readable
+std::optional<typename Reg::value_type> read(Axis_t axis)
+{
+    detail::FrameView fv;
+
+    if (!detail::readBlock(axis, Reg::area, Reg::address, 1U, fv))
+    {
+        return std::nullopt;
+    }
+    return Reg::decode(fv[0U]);
+}
+
+/**
+ * @brief Write one holding register of an axis (0x06)
+ */
+template <typename Reg>
+    requires(Reg::writable && (Reg::area == Area::HOLDING))
+bool write(Axis_t axis, typename Reg::value_type value)
+{
+    return MODBUS_WriteSingle(AXIS_UnitId(axis), AXIS_Reg(axis, Reg::address),
+                              Reg::encode(value)) > 0;
+}
+
+/**
+ * @brief Read a set of registers with the fewest block reads the
+ *        compiler can plan, decoded in declaration order
+ */
+template <typename... Regs>
+    requires((Regs::readable && ...) && (sizeof...(Regs) > 0U))
+std::optional<std::tuple<typename Regs::value_type...>> readBatch(Axis_t axis)
+{
+    using Plan = BlockPlan<Regs...>;
+    std::array<detail::FrameView, Plan::kCount> fv;
+
+    static_assert(Plan::kCount <= FRAME_POOL_COUNT, "block plan exceeds the frame pool");
+
+    for (std::size_t b = 0U; b < Plan::kCount; ++b)
+    {
+        const Block &blk = Plan::kBlocks[b];
+        if (!detail::readBlock(axis, blk.area, blk.pan_addr, blk.count, fv[b]))
+        {
+            return std::nullopt;
+        }
+    }
+
+    return std::tuple<typename Regs::value_type...>{
+        Regs::decode(fv[Plan::template locate<Regs>().first]
+                       [static_cast<std::uint16_t>(Plan::template locate<Regs>().second)])...};
+}
+
+/**
+ * @brief Write consecutive holding registers in one 0x10 request
+ *        (e.g. writeBlock<Position, Velocity>(...) when adjacent)
+ */
+template <typename First, typename... Rest>
+    requires((First::writable && ... && Rest::writable) &&
+             (First::area == Area::HOLDING))
+bool writeBlock(Axis_t axis, typename First::value_type first,
+                typename Rest::value_type... rest)
+{
+    constexpr std::uint16_t kCount = 1U + sizeof...(Rest);
+
+    static_assert([] {
+        const std::array<std::uint16_t, kCount> addrs{First::address, Rest::address...};
+        for (std::uint16_t i = 0U; i < kCount; ++i)
+        {
+            if (addrs[i] != (First::address + i)) { return false; }
+        }
+        return true;
+    }(), "writeBlock registers must be consecutive");
+
+    std::uint16_t regs[kCount] = {First::encode(first), Rest::encode(rest)...};
+    return MODBUS_WriteMultiple(AXIS_UnitId(axis), AXIS_Reg(axis, First::address),
+                                kCount, regs) > 0;
+}
+
+} // namespace drive
+
+#endif /* DRIVE_REGISTERS_HPP */
@@ -0,0 +1,780 @@
+#include "config.h"
+#include "drive_script.h"
+#include "axis_table.h"
+#include "axis_state.h"
+#include "register_access.h"
+#include "drive_parameters.h"
+#include "modbus_functions.h"
+#include "modbus_transport.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#define SCRIPT_LINE_MAX    (256U)
+#define SCRIPT_TOKENS_MAX  (8U)
+
+/* Per-axis activity in the open batch */
+#define TOUCH_READ         (0x01U)
+#define TOUCH_WRITE        (0x02U)
+#define TOUCH_CMD          (0x04U)
+
+typedef enum
+{
+    SOP_WRITE = 0,
+    SOP_MOTION,
+    SOP_CMD,
+    SOP_READ,
+    SOP_EXPECT,
+    SOP_WAIT,
+    SOP_SLEEP,
+    SOP_SNAPSHOT
+} ScriptOpKind_t;
+
+/**
+ * @brief One parsed command
+ */
+typedef struct
+{
+    uint8_t     kind;          /* ScriptOpKind_t */
+    Axis_t      axis;          /* 0: all axes (snapshot) */
+    RegId_t     id;            /* SOP_WRITE / READ / EXPECT */
+    uint16_t    addr;          /* Wire address */
+    uint16_t    count;         /* Registers written */
+    uint16_t    data[4];
+    float       value[4];      /* As written (after the checks) / expected */
+    float       tol;
+    uint32_t    ms;
+    uint32_t    line;
+    const char *word;          /* Command as written in the script */
+} ScriptOp_t;
+
+/**
+ * @brief Requests of the open batch
+ */
+typedef struct
+{
+    Transport_t  t;
+    ModbusReq_t  req[SCRIPT_BATCH_MAX];
+    ModbusReq_t *ptr[SCRIPT_BATCH_MAX];
+    ScriptOp_t  *op[SCRIPT_BATCH_MAX];
+    uint32_t     n;
+    uint8_t      touched[AXIS_MAX_COUNT + 1U];
+} ScriptBatch_t;
+
+typedef struct
+{
+    const char *word;
+    uint16_t    reg;
+} ScriptCmd_t;
+
+/* Same registers as CMD_Enable .. CMD_VelocityRev */
+static const ScriptCmd_t CMDS[] =
+{
+    { "enable",   (uint16_t)REG_CMD_ENABLE },
+    { "reset",    (uint16_t)REG_CMD_RESET },
+    { "halt",     (uint16_t)REG_CMD_HALT },
+    { "estop",    (uint16_t)REG_CMD_EMG_STOP },
+    { "move",     (uint16_t)REG_CMD_POS_MOVE },
+    { "move_deg", (uint16_t)REG_CMD_POS_MOVE_DEG },
+    { "home",     (uint16_t)REG_CMD_HOME_MOVE_DEG },
+    { "vel_fwd",  (uint16_t)REG_CMD_VEL_FWD },
+    { "vel_rev",  (uint16_t)REG_CMD_VEL_REV }
+};
+#define CMD_COUNT   (sizeof(CMDS) / sizeof(CMDS[0]))
+
+static ScriptOp_t       ops[SCRIPT_MAX_OPS];
+static ScriptBatch_t    batch;
+static AxisStateStore_t snap;
+
+/*----------------------------------------------------------
+ * Parsing helpers
+ *----------------------------------------------------------*/
+static bool SameWord(const char *a, const char *b)
+{
+    while ((*a != '\0') && (*b != '\0'))
+    {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b))
+        {
+            return false;
+        }
+        a++;
+        b++;
+    }
+    return (*a == '\0') && (*b == '\0');
+}
+
+static bool ParseFloat(const char *tok, float *value)
+{
+    char *end = NULL;
+
+    *value = strtof(tok, &end);
+    return (end != tok) && (*end == '\0') && !isnan(*value) && !isinf(*value);
+}
+
+static bool ParseUint(const char *tok, uint32_t *value)
+{
+    char *end = NULL;
+    unsigned long v = strtoul(tok, &end, 10);
+
+    *value = (uint32_t)v;
+    return (end != tok) && (*end == '\0') && (tok[0] != '-');
+}
+
+static bool ParseAxis(const char *tok, Axis_t *axis)
+{
+    uint32_t n;
+    uint32_t i;
+
+    if (ParseUint(tok, &n))
+    {
+        *axis = (Axis_t)n;
+        return AXIS_IsValid(*axis);
+    }
+    for (i = 1U; i <= AXIS_COUNT; i++)
+    {
+        if (SameWord(tok, AXIS_Get((Axis_t)i)->name))
+        {
+            *axis = (Axis_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseRegister(const char *tok, RegId_t *id)
+{
+    uint32_t i;
+
+    for (i = 0U; i < (uint32_t)REGID_COUNT; i++)
+    {
+        if (SameWord(tok, REG_TABLE[i].name))
+        {
+            *id = (RegId_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint16_t Encode(RegId_t id, float value)
+{
+    const RegDesc_t *d = &REG_TABLE[id];
+    fix16_t v = FIX_FromFloat(value);
+
+    return d->is_signed ? FIX_EncodeS16(v, d->scale) : FIX_EncodeU16(v, d->scale);
+}
+
+static float Decode(RegId_t id, uint16_t raw)
+{
+    const RegDesc_t *d = &REG_TABLE[id];
+
+    return FIX_ToFloat(d->is_signed ? FIX_DecodeS16(raw, d->scale) : FIX_DecodeU16(raw, d->scale));
+}
+
+/*----------------------------------------------------------
+ * Helper: the checks Set_* make before writing
+ * (false = value refused)
+ *----------------------------------------------------------*/
+static bool CheckValue(Axis_t axis, RegId_t id, float *value, uint32_t line)
+{
+    float asked = *value;
+
+    if (!REG_CheckValue(axis, id, value))
+    {
+        return false;
+    }
+    if (*value != asked)
+    {
+        printf("line %lu: [WARN] %s %.2f exceeds max %.2f, clamped\n",
+               (unsigned long)line, REG_TABLE[id].name, (double)asked, (double)*value);
+    }
+    return true;
+}
+
+/*----------------------------------------------------------
+ * Parse one line: 1 = command, 0 = blank, -1 = error
+ *----------------------------------------------------------*/
+static int32_t ParseLine(char *text, uint32_t line, ScriptOp_t *op)
+{
+    char    *tok[SCRIPT_TOKENS_MAX];
+    char    *hash = strchr(text, '#');
+    uint32_t n = 0U;
+    uint32_t i;
+    const char *err = NULL;
+
+    if (hash != NULL)
+    {
+        *hash = '\0';
+    }
+    /* More than SCRIPT_TOKENS_MAX words fits no command: stop counting */
+    for (tok[0] = strtok(text, " \t\r\n"); tok[n] != NULL; tok[n] = strtok(NULL, " \t\r\n"))
+    {
+        if (++n == SCRIPT_TOKENS_MAX)
+        {
+            break;
+        }
+    }
+    if (n == 0U)
+    {
+        return 0;
+    }
+
+    (void)memset(op, 0, sizeof(*op));
+    op->line = line;
+
+    for (i = 0U; i < CMD_COUNT; i++)
+    {
+        if (SameWord(tok[0], CMDS[i].word))
+        {
+            op->kind  = (uint8_t)SOP_CMD;
+            op->word  = CMDS[i].word;
+            op->addr  = CMDS[i].reg;
+            op->count = 1U;
+            if ((n != 2U) || !ParseAxis(tok[1], &op->axis))
+            {
+                err = "expected: <command> <axis>";
+            }
+            op->data[0] = (uint16_t)op->axis;  /* the value selects the axis */
+            break;
+        }
+    }
+
+    if (i < CMD_COUNT)
+    {
+        /* command parsed above */
+    }
+    else if (SameWord(tok[0], "set"))
+    {
+        op->kind = (uint8_t)SOP_WRITE;
+        op->word = "set";
+        op->count = 1U;
+        if ((n != 4U) || !ParseAxis(tok[1], &op->axis) || !ParseRegister(tok[2], &op->id) ||
+            !ParseFloat(tok[3], &op->value[0]))
+        {
+            err = "expected: set <axis> <register> <value>";
+        }
+        else if (REG_TABLE[op->id].access == REG_ACCESS_RO)
+        {
+            err = "register is read-only";
+        }
+        else if (!CheckValue(op->axis, op->id, &op->value[0], line))
+        {
+            err = "value refused";
+        }
+        else
+        {
+            op->addr    = AXIS_Reg(op->axis, REG_TABLE[op->id].pan_addr);
+            op->data[0] = Encode(op->id, op->value[0]);
+        }
+    }
+    else if (SameWord(tok[0], "motion"))
+    {
+        static const RegId_t MOTION_IDS[4] = { REGID_POSITION, REGID_VELOCITY, REGID_ACCEL, REGID_DECEL };
+
+        op->kind = (uint8_t)SOP_MOTION;
+        op->word = "motion";
+        op->count = 4U;
+        if ((n != 6U) || !ParseAxis(tok[1], &op->axis))
+        {
+            err = "expected: motion <axis> <pos> <vel> <acc> <dec>";
+        }
+        for (i = 0U; (err == NULL) && (i < 4U); i++)
+        {
+            if (!ParseFloat(tok[2U + i], &op->value[i]))
+            {
+                err = "expected: motion <axis> <pos> <vel> <acc> <dec>";
+            }
+            else if (!CheckValue(op->axis, MOTION_IDS[i], &op->value[i], line))
+            {
+                err = "value refused";
+            }
+            else
+            {
+                op->data[i] = Encode(MOTION_IDS[i], op->value[i]);
+            }
+        }
+        op->addr = (err == NULL) ? AXIS_Reg(op->axis, REG_PAN_POSITION) : 0U;
+    }
+    else if (SameWord(tok[0], "read") || SameWord(tok[0], "expect"))
+    {
+        bool expect = SameWord(tok[0], "expect");
+
+        op->kind = (uint8_t)(expect ? SOP_EXPECT : SOP_READ);
+        op->word = expect ? "expect" : "read";
+        if ((n < 3U) || !ParseAxis(tok[1], &op->axis) || !ParseRegister(tok[2], &op->id) ||
+            (!expect && (n != 3U)) ||
+            (expect && ((n < 4U) || (n > 5U) || !ParseFloat(tok[3], &op->value[0]) ||
+                        ((n == 5U) && !ParseFloat(tok[4], &op->tol)))))
+        {
+            err = expect ? "expected: expect <axis> <register> <value> [tol]"
+                         : "expected: read <axis> <register>";
+        }
+        else if (REG_TABLE[op->id].access == REG_ACCESS_WO)
+        {
+            err = "register is write-only";
+        }
+        else
+        {
+            op->addr = AXIS_Reg(op->axis, REG_TABLE[op->id].pan_addr);
+            op->tol  = fabsf(op->tol);
+        }
+    }
+    else if (SameWord(tok[0], "wait"))
+    {
+        op->kind = (uint8_t)SOP_WAIT;
+        op->word = "wait";
+        op->ms = SCRIPT_WAIT_MS;
+        if ((n < 2U) || (n > 3U) || !ParseAxis(tok[1], &op->axis) ||
+            ((n == 3U) && !ParseUint(tok[2], &op->ms)))
+        {
+            err = "expected: wait <axis> [timeout_ms]";
+        }
+    }
+    else if (SameWord(tok[0], "sleep"))
+    {
+        op->kind = (uint8_t)SOP_SLEEP;
+        op->word = "sleep";
+        if ((n != 2U) || !ParseUint(tok[1], &op->ms))
+        {
+            err = "expected: sleep <ms>";
+        }
+    }
+    else if (SameWord(tok[0], "snapshot"))
+    {
+        op->kind = (uint8_t)SOP_SNAPSHOT;
+        op->word = "snapshot";
+        if ((n > 2U) || ((n == 2U) && !ParseAxis(tok[1], &op->axis)))
+        {
+            err = "expected: snapshot [axis]";
+        }
+    }
+    else
+    {
+        err = "unknown command";
+    }
+
+    if (err != NULL)
+    {
+        printf("line %lu: %s\n", (unsigned long)line, err);
+        return -1;
+    }
+    return 1;
+}
+
+/*----------------------------------------------------------
+ * Batches
+ *----------------------------------------------------------*/
+
+/* Helper: report one finished request; false = drive error */
+static bool Report(const ScriptOp_t *op, ModbusReq_t *req, ScriptResult_t *res)
+{
+    const char *axis = AXIS_Get(op->axis)->name;
+    uint8_t ex = 0U;
+    float got;
+    bool pass;
+
+    if (req->view.status != MODBUS_OK)
+    {
+        ex = req->view.ex_code;
+        printf("%4lu  ERROR %s %s: %s (exception %u)\n", (unsigned long)op->line, op->word, axis,
+               MODBUS_StatusText(req->view.status), (unsigned)ex);
+        return false;
+    }
+
+    switch (op->kind)
+    {
+        case SOP_CMD:
+            printf("%4lu  OK    %s %s\n", (unsigned long)op->line, op->word, axis);
+            break;
+
+        case SOP_WRITE:
+            printf("%4lu  OK    set %s %s = %.2f\n", (unsigned long)op->line, axis,
+                   REG_TABLE[op->id].name, (double)op->value[0]);
+            break;
+
+        case SOP_MOTION:
+            printf("%4lu  OK    motion %s pos %.2f vel %.2f acc %.2f dec %.2f\n",
+                   (unsigned long)op->line, axis, (double)op->value[0], (double)op->value[1],
+                   (double)op->value[2], (double)op->value[3]);
+            break;
+
+        default:                        /* read / expect */
+            got = Decode(op->id, MODBUS_ViewReg(&req->view, 0U));
+            MODBUS_ViewRelease(&req->view);
+            if (op->kind == (uint8_t)SOP_READ)
+            {
+                printf("%4lu  OK    %s %s = %.2f\n", (unsigned long)op->line, axis,
+                       REG_TABLE[op->id].name, (double)got);
+                break;
+            }
+            pass = fabsf(got - op->value[0]) <= op->tol;
+            res->failed += pass ? 0U : 1U;
+            printf("%4lu  %s  %s %s = %.2f (expected %.2f +/- %.2f)\n", (unsigned long)op->line,
+                   pass ? "PASS" : "FAIL", axis, REG_TABLE[op->id].name, (double)got,
+                   (double)op->value[0], (double)op->tol);
+            break;
+    }
+    return true;
+}
+
+/* Send the open batch as one pipelined transaction */
+static bool Flush(ScriptResult_t *res)
+{
+    bool ok = true;
+    uint32_t i;
+
+    if (batch.n == 0U)
+    {
+        return true;
+    }
+
+    (void)TRANSPORT_Transact(&batch.t, batch.ptr, batch.n);
+    res->batches++;
+    res->requests += batch.n;
+
+    for (i = 0U; i < batch.n; i++)
+    {
+        if (!Report(batch.op[i], &batch.req[i], res))
+        {
+            ok = false;
+        }
+        else
+        {
+            res->ops++;
+        }
+    }
+
+    /* Views of reads left unreported (after an error) go back too */
+    for (i = 0U; i < batch.n; i++)
+    {
+        if ((batch.req[i].view.status == MODBUS_OK) && (batch.req[i].view.frame != NULL))
+        {
+            MODBUS_ViewRelease(&batch.req[i].view);
+        }
+    }
+
+    batch.n = 0U;
+    (void)memset(batch.touched, 0, sizeof(batch.touched));
+    return ok;
+}
+
+/* Helper: does a write in the open batch hit a register op writes?
+ * Pipelined requests may land in any order, so the later value could
+ * be overwritten by the earlier one */
+static bool Overwrites(const ScriptOp_t *op)
+{
+    uint32_t i;
+
+    for (i = 0U; i < batch.n; i++)
+    {
+        const ScriptOp_t *o = batch.op[i];
+
+        if ((o->axis == op->axis) &&
+            ((o->kind == (uint8_t)SOP_WRITE) || (o->kind == (uint8_t)SOP_MOTION)) &&
+            (op->addr < (o->addr + o->count)) && (o->addr < (op->addr + op->count)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Helper: does op have to wait for the open batch? */
+static bool Conflicts(const ScriptOp_t *op)
+{
+    uint8_t t = batch.touched[op->axis];
+
+    switch (op->kind)
+    {
+        case SOP_CMD:    return t != 0U;
+        case SOP_WRITE:
+        case SOP_MOTION: return ((t & (TOUCH_READ | TOUCH_CMD)) != 0U) ||
+                                (((t & TOUCH_WRITE) != 0U) && Overwrites(op));
+        default:         return (t & (TOUCH_WRITE | TOUCH_CMD)) != 0U;
+    }
+}
+
+static bool Queue(ScriptOp_t *op, ScriptResult_t *res)
+{
+    ModbusReq_t *req;
+    uint8_t func;
+
+    if ((batch.n == SCRIPT_BATCH_MAX) || Conflicts(op))
+    {
+        if (!Flush(res))
+        {
+            return false;
+        }
+    }
+
+    req = &batch.req[batch.n];
+    if ((op->kind == (uint8_t)SOP_READ) || (op->kind == (uint8_t)SOP_EXPECT))
+    {
+        func = (REG_TABLE[op->id].area == REG_AREA_INPUT) ? MODBUS_FUNC_READ_INPUT
+                                                          : MODBUS_FUNC_READ_HOLDING;
+        TRANSPORT_ReqRead(req, AXIS_UnitId(op->axis), func, op->addr, 1U);
+        batch.touched[op->axis] |= TOUCH_READ;
+    }
+    else
+    {
+        TRANSPORT_ReqWrite(req, AXIS_UnitId(op->axis), op->addr, op->count, op->data);
+        batch.touched[op->axis] |= (op->kind == (uint8_t)SOP_CMD) ? TOUCH_CMD : TOUCH_WRITE;
+    }
+    batch.ptr[batch.n] = req;
+    batch.op[batch.n]  = op;
+    batch.n++;
+    return true;
+}
+
+/*----------------------------------------------------------
+ * Commands that run on their own
+ *----------------------------------------------------------*/
+static bool WaitMotion(const ScriptOp_t *op, ScriptResult_t *res)
+{
+    ModbusReq_t *req = &batch.req[0];
+    uint64_t t0 = TIME_NowUs();
+    uint64_t deadline = t0 + ((uint64_t)op->ms * 1000U);
+    uint16_t status;
+
+    batch.ptr[0] = req;
+    for (;;)
+    {
+        TRANSPORT_ReqRead(req, AXIS_UnitId(op->axis), MODBUS_FUNC_READ_INPUT,
+                          AXIS_Reg(op->axis, REG_PAN_FAULT_STATUS), 1U);
+        (void)TRANSPORT_Transact(&batch.t, batch.ptr, 1U);
+        res->requests++;
+        if (req->view.status != MODBUS_OK)
+        {
+            printf("%4lu  ERROR wait %s: %s\n", (unsigned long)op->line,
+                   AXIS_Get(op->axis)->name, MODBUS_StatusText(req->view.status));
+            return false;
+        }
+        status = MODBUS_ViewReg(&req->view, 0U);
+        MODBUS_ViewRelease(&req->view);
+
+        if ((status & FAULT_MOTION_COMPLETE) != 0U)
+        {
+            printf("%4lu  OK    wait %s: complete after %.1f ms\n", (unsigned long)op->line,
+                   AXIS_Get(op->axis)->name, (double)(TIME_NowUs() - t0) / 1000.0);
+            return true;
+        }
+        if (TIME_NowUs() >= deadline)
+        {
+            printf("%4lu  ERROR wait %s: not complete after %lu ms\n", (unsigned long)op->line,
+                   AXIS_Get(op->axis)->name, (unsigned long)op->ms);
+            return false;
+        }
+        TIME_SleepUs(SCRIPT_WAIT_POLL_US);
+    }
+}
+
+static bool Snapshot(const ScriptOp_t *op, ScriptResult_t *res)
+{
+    uint32_t n = 0U;
+    uint32_t i;
+    bool ok = true;
+
+    for (i = 1U; i <= AXIS_COUNT; i++)
+    {
+        if ((op->axis == 0U) || (op->axis == (Axis_t)i))
+        {
+            TRANSPORT_ReqRead(&batch.req[n], AXIS_UnitId((Axis_t)i), MODBUS_FUNC_READ_INPUT,
+                              AXIS_Reg((Axis_t)i, AXIS_BLOCK_FIRST), AXIS_BLOCK_REGS);
+            batch.ptr[n] = &batch.req[n];
+            n++;
+        }
+    }
+    (void)TRANSPORT_Transact(&batch.t, batch.ptr, n);
+    res->batches++;
+    res->requests += n;
+
+    n = 0U;
+    for (i = 1U; i <= AXIS_COUNT; i++)
+    {
+        if ((op->axis != 0U) && (op->axis != (Axis_t)i))
+        {
+            continue;
+        }
+        if (batch.req[n].view.status != MODBUS_OK)
+        {
+            printf("%4lu  ERROR snapshot %s: %s\n", (unsigned long)op->line,
+                   AXIS_Get((Axis_t)i)->name, MODBUS_StatusText(batch.req[n].view.status));
+            ok = false;
+        }
+        else
+        {
+            AXIS_STATE_Decode(&snap, i - 1U, batch.req[n].view.regs);
+            MODBUS_ViewRelease(&batch.req[n].view);
+        }
+        n++;
+    }
+    AXIS_STATE_Convert(&snap);
+
+    for (i = 1U; ok && (i <= AXIS_COUNT); i++)
+    {
+        uint32_t k = i - 1U;
+
+        if ((op->axis != 0U) && (op->axis != (Axis_t)i))
+        {
+            continue;
+        }
+        printf("%4lu  OK    snapshot %s: %.2f deg %.2f mm | vel %.2f rpm %.2f | %.2f A %.1f V %.1f C | "
+               "faults 0x%04X io 0x%04X sys 0x%04X code %u\n",
+               (unsigned long)op->line, AXIS_Get((Axis_t)i)->name,
+               (double)FIX_ToFloat(snap.position_deg[k]), (double)FIX_ToFloat(snap.position_mm[k]),
+               (double)FIX_ToFloat(snap.velocity[k]), (double)FIX_ToFloat(snap.rpm[k]),
+               (double)FIX_ToFloat(snap.current[k]), (double)FIX_ToFloat(snap.dcbus[k]),
+               (double)FIX_ToFloat(snap.temperature[k]), (unsigned)snap.fault_bits[k],
+               (unsigned)snap.io_status[k], (unsigned)snap.sys_status[k],
+               (unsigned)snap.fault_code[k]);
+    }
+    return ok;
+}
+
+/*----------------------------------------------------------
+ * Run
+ *----------------------------------------------------------*/
+static bool Execute(uint32_t n_ops, ScriptResult_t *res)
+{
+    uint32_t i;
+    bool ok = true;
+
+    for (i = 0U; ok && (i < n_ops); i++)
+    {
+        ScriptOp_t *op = &ops[i];
+
+        switch (op->kind)
+        {
+            case SOP_WAIT:
+            case SOP_SLEEP:
+            case SOP_SNAPSHOT:
+                ok = Flush(res);
+                if (ok)
+                {
+                    if (op->kind == (uint8_t)SOP_SLEEP)
+                    {
+                        TIME_SleepUs(op->ms * 1000U);
+                        printf("%4lu  OK    sleep %lu ms\n", (unsigned long)op->line,
+                               (unsigned long)op->ms);
+                    }
+                    else
+                    {
+                        ok = (op->kind == (uint8_t)SOP_WAIT) ? WaitMotion(op, res) : Snapshot(op, res);
+                    }
+                    res->ops += ok ? 1U : 0U;
+                }
+                break;
+
+            default:
+                ok = Queue(op, res);
+                break;
+        }
+    }
+    return ok && Flush(res);
+}
+
+static int32_t Load(const char *path, uint32_t *n_ops)
+{
+    char     text[SCRIPT_LINE_MAX];
+    FILE    *f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    uint32_t line = 0U;
+    int32_t  errors = 0;
+    int32_t  rc;
+
+    *n_ops = 0U;
+    if (f == NULL)
+    {
+        printf("Script: cannot open %s\n", path);
+        return -1;
+    }
+
+    while (fgets(text, (int)sizeof(text), f) != NULL)
+    {
+        line++;
+        if ((strchr(text, '\n') == NULL) && !feof(f))
+        {
+            printf("line %lu: longer than %u characters\n", (unsigned long)line,
+                   (unsigned)(SCRIPT_LINE_MAX - 2U));
+            errors++;
+            break;
+        }
+        if (*n_ops == SCRIPT_MAX_OPS)
+        {
+            printf("line %lu: more than %u commands\n", (unsigned long)line, (unsigned)SCRIPT_MAX_OPS);
+            errors++;
+            break;
+        }
+        rc = ParseLine(text, line, &ops[*n_ops]);
+        if (rc > 0)
+        {
+            (*n_ops)++;
+        }
+        errors += (rc < 0) ? 1 : 0;
+    }
+
+    if (f != stdin)
+    {
+        (void)fclose(f);
+    }
+    return (errors == 0) ? 0 : -1;
+}
+
+int32_t SCRIPT_RunFile(const char *path, uint8_t kind, ScriptResult_t *result)
+{
+    ScriptResult_t res;
+    uint32_t n_ops = 0U;
+    const AxisDescriptor_t *pan = AXIS_Get(AXIS_PAN);
+    uint16_t port = (kind == TRANSPORT_MBAP_TCP) ? (uint16_t)DRIVE_PORT_TCP : pan->port;
+    uint64_t t0;
+    bool ok;
+
+    (void)memset(&res, 0, sizeof(res));
+    (void)memset(batch.touched, 0, sizeof(batch.touched));
+    batch.n = 0U;
+
+    /* Nothing is sent unless the whole script is valid */
+    if (Load(path, &n_ops) != 0)
+    {
+        printf("Script: not run\n");
+        res.aborted = true;
+    }
+    else if (!AXIS_SharedEndpoint())
+    {
+        /* One transport carries every axis */
+        printf("Script: axes on different endpoints, not run\n");
+        res.aborted = true;
+    }
+    else if (TRANSPORT_Open(&batch.t, kind, pan->ip_addr, port) != 0)
+    {
+        printf("Script: cannot reach %s:%u\n", pan->ip_addr, (unsigned)port);
+        res.aborted = true;
+    }
+    else
+    {
+        AXIS_STATE_Init(&snap, AXIS_COUNT);
+        t0 = TIME_NowUs();
+        ok = Execute(n_ops, &res);
+        res.elapsed_us = TIME_NowUs() - t0;
+        res.aborted = !ok;
+        TRANSPORT_Close(&batch.t);
+
+        printf("\n====== SCRIPT %s ======\n", path);
+        printf("  commands   : %lu of %lu run%s\n", (unsigned long)res.ops,
+               (unsigned long)n_ops, res.aborted ? " (stopped on error)" : "");
+        printf("  requests   : %lu in %lu pipelined batches\n",
+               (unsigned long)res.requests, (unsigned long)res.batches);
+        printf("  expects    : %lu failed\n", (unsigned long)res.failed);
+        printf("  elapsed    : %.2f ms\n", (double)res.elapsed_us / 1000.0);
+    }
+
+    if (result != NULL)
+    {
+        *result = res;
+    }
+    return (res.aborted || (res.failed > 0U)) ? 1 : 0;
+}
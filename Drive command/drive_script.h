@@ -0,0 +1,80 @@
+#ifndef DRIVE_SCRIPT_H
+#define DRIVE_SCRIPT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_table.h"
+#include "frame_pool.h"
+
+/*===========================================================
+ * Batch Command Scripts
+ *===========================================================*/
+/* Runs a command script without prompts, for commissioning and
+ * end-of-line tests. Script syntax is one command per line; '#'
+ * starts a comment. Axes are given by name (PAN, TILT) or number,
+ * and registers by their table name (VELOCITY, POS_DEG, ...):
+ *
+ *   enable|reset|halt|estop|move|move_deg|home|vel_fwd|vel_rev <axis>
+ *   set      <axis> <register> <value>       CMD_* / Set_* equivalents
+ *   motion   <axis> <pos> <vel> <acc> <dec>  Set_MotionParameters (0x10)
+ *   read     <axis> <register>               print the value
+ *   expect   <axis> <register> <value> [tol] fail if |read - value| > tol
+ *   wait     <axis> [timeout_ms]             until FAULT_MOTION_COMPLETE
+ *   sleep    <ms>
+ *   snapshot [axis]                          state block of one / all axes
+ *
+ * The whole script is parsed and checked before anything is sent.
+ * Values get the same checks as Set_* (velocity and acceleration
+ * clamped to the axis maxima; DEG_POS and the POSITION setpoint, both
+ * in degrees, inside the software limits; read-only registers such as POS_MM
+ * cannot be set). Positions are absolute; Set_Position / Set_DegPosition
+ * move relative to the current position.
+ *
+ * Consecutive independent commands are sent together as one pipelined
+ * batch (TRANSPORT_Transact). A command on an axis waits for
+ * everything earlier on that axis. A read waits for earlier writes
+ * and commands on its axis, and a write waits for earlier reads and
+ * commands on its axis, and for earlier writes to the same register.
+ * wait, sleep and snapshot run on their own.
+ * A failed drive request stops the script. A failed expect is
+ * reported and the script goes on. */
+
+#ifndef SCRIPT_MAX_OPS
+    #define SCRIPT_MAX_OPS        (512U)
+#endif
+#ifndef SCRIPT_BATCH_MAX
+    #define SCRIPT_BATCH_MAX      (FRAME_POOL_COUNT)  /* Requests per batch */
+#endif
+#ifndef SCRIPT_WAIT_MS
+    #define SCRIPT_WAIT_MS        (10000U)   /* Default wait timeout */
+#endif
+#ifndef SCRIPT_WAIT_POLL_US
+    #define SCRIPT_WAIT_POLL_US   (1000U)
+#endif
+
+/**
+ * @brief Outcome of a run
+ */
+typedef struct
+{
+    uint32_t ops;            /**< Commands executed */
+    uint32_t requests;       /**< Modbus requests sent */
+    uint32_t batches;        /**< Pipelined batches */
+    uint32_t failed;         /**< Failed expects */
+    bool     aborted;        /**< Stopped on a parse or drive error */
+    uint64_t elapsed_us;
+} ScriptResult_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Parse and run a script ("-" = stdin) over a transport of the
+ *         given kind (TRANSPORT_*) to the endpoint all axes share
+ * @return 0 if every command succeeded and every expect passed, else 1
+ */
+int32_t SCRIPT_RunFile(const char *path, uint8_t kind, ScriptResult_t *result);
+
+#endif /* DRIVE_SCRIPT_H */
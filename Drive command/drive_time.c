@@ -0,0 +1,53 @@
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "drive_time.h"
+#include <stdint.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/*----------------------------------------------------------
+ * Monotonic timestamp (us)
+ *----------------------------------------------------------*/
+uint64_t TIME_NowUs(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER now;
+
+    if (freq.QuadPart == 0)
+    {
+        (void)QueryPerformanceFrequency(&freq);
+    }
+    (void)QueryPerformanceCounter(&now);
+
+    return (uint64_t)((now.QuadPart / freq.QuadPart) * 1000000LL) +
+           (uint64_t)(((now.QuadPart % freq.QuadPart) * 1000000LL) / freq.QuadPart);
+#else
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+#endif
+}
+
+/*----------------------------------------------------------
+ * Sleep (us)
+ *----------------------------------------------------------*/
+void TIME_SleepUs(uint32_t us)
+{
+#ifdef _WIN32
+    /* Sleep() has millisecond granularity; round up */
+    Sleep((DWORD)((us + 999U) / 1000U));
+#else
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(us / 1000000U);
+    ts.tv_nsec = (long)((us % 1000000U) * 1000U);
+    (void)nanosleep(&ts, NULL);
+#endif
+}
@@ -0,0 +1,30 @@
+#ifndef DRIVE_TIME_H
+#define DRIVE_TIME_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * Monotonic Time Helpers
+ *===========================================================*/
+
+/**
+ * @brief  Monotonic timestamp in microseconds
+ * @return Microseconds since an arbitrary fixed point
+ */
+uint64_t TIME_NowUs(void);
+
+/**
+ * @brief  Block the calling thread for at least the given time
+ * @param  us  Delay in microseconds
+ */
+void TIME_SleepUs(uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVE_TIME_H */
@@ -0,0 +1,273 @@
+#include "config.h"
+#include "drive_tracking.h"
+#include "drive_feedback.h"
+#include "drive_parameters.h"
+#include "drive_command.h"
+#include "modbus_functions.h"
+#include "register_access.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+static float Clamp(float v, float lo, float hi)
+{
+    return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+void TRACK_DefaultGains(TrackGains_t *gains)
+{
+    gains->kp            = 5.0F;
+    gains->ki            = 2.0F;
+    gains->kff           = 1.0F;
+    gains->deadband_deg  = 0.0F;
+    gains->vel_per_deg_s = TRACK_VEL_PER_DEG_S;
+}
+
+void TRACK_Init(TrackAxis_t *c, Axis_t axis, const TrackGains_t *gains)
+{
+    const AxisDescriptor_t *desc = AXIS_Get(axis);
+
+    (void)memset(c, 0, sizeof(*c));
+    c->axis = axis;
+    if (gains != NULL)
+    {
+        c->gains = *gains;
+    }
+    else
+    {
+        TRACK_DefaultGains(&c->gains);
+    }
+    PRED_Init(&c->pred, NULL);
+
+    if (c->gains.vel_per_deg_s <= 0.0F)
+    {
+        c->gains.vel_per_deg_s = 1.0F / Compute_DegPerMm(axis);
+    }
+    c->vmax = Compute_MaxVelocityDeg(axis);
+    c->amax = Compute_MaxAccelerationDeg(axis);
+    c->limit_min = desc->limit_min_deg;
+    c->limit_max = desc->limit_max_deg;
+}
+
+void TRACK_SetTarget(TrackAxis_t *c, float pos_deg, float vel_deg_s, uint64_t t_us)
+{
+    c->target_pos = pos_deg;
+    c->target_vel = vel_deg_s;
+    c->target_us  = t_us;
+    c->has_target = true;
+}
+
+/*----------------------------------------------------------
+ * Control law
+ *----------------------------------------------------------*/
+float TRACK_Compute(TrackAxis_t *c, uint64_t now_us)
+{
+    float    dt = 0.0F;
+    float    v_ff;
+    float    pos;
+    float    tgt;
+    float    e;
+    float    v_unsat;
+    float    v;
+    bool     saturated;
+    uint64_t age;
+
+    if ((c->last_us != 0U) && (now_us > c->last_us))
+    {
+        dt = (float)(now_us - c->last_us) * 1e-6F;
+    }
+    c->last_us = now_us;
+
+    if (!c->has_target || !c->pred.valid)
+    {
+        c->integ = 0.0F;
+        c->v_cmd = 0.0F;
+        return 0.0F;
+    }
+
+    /* Target and position, both at now */
+    age  = (now_us > c->target_us) ? (now_us - c->target_us) : 0U;
+    v_ff = c->gains.kff * c->target_vel;
+    if (age > TRACK_TARGET_HORIZON_US)
+    {
+        age  = TRACK_TARGET_HORIZON_US;  /* stale: hold where it was heading */
+        v_ff = 0.0F;
+    }
+    tgt = c->target_pos + (c->target_vel * ((float)age * 1e-6F));
+    if ((tgt <= c->limit_min) || (tgt >= c->limit_max))
+    {
+        tgt  = Clamp(tgt, c->limit_min, c->limit_max);
+        v_ff = 0.0F;
+    }
+    pos = PRED_Position(&c->pred, now_us);
+
+    e = tgt - pos;
+    c->stats.tracked++;
+    c->stats.err_sq_sum += e * e;
+    c->stats.err_max = (fabsf(e) > c->stats.err_max) ? fabsf(e) : c->stats.err_max;
+    if (fabsf(e) < c->gains.deadband_deg)
+    {
+        e = 0.0F;
+    }
+
+    /* PI + feed-forward, saturated in speed and in acceleration */
+    v_unsat = v_ff + (c->gains.kp * e) + c->integ;
+    v = Clamp(v_unsat, -c->vmax, c->vmax);
+    v = Clamp(v, c->v_cmd - (c->amax * dt), c->v_cmd + (c->amax * dt));
+    saturated = (v != v_unsat);
+
+    /* Anti-windup: integrate only while the output follows the law,
+     * or when the error would pull it back out of saturation */
+    if (!saturated || ((e * v_unsat) < 0.0F))
+    {
+        c->integ = Clamp(c->integ + (c->gains.ki * e * dt), -c->vmax, c->vmax);
+    }
+
+    /* Never drive further past a software limit */
+    if (((pos >= c->limit_max) && (v > 0.0F)) || ((pos <= c->limit_min) && (v < 0.0F)))
+    {
+        v = 0.0F;
+        c->integ = 0.0F;
+    }
+
+    c->stats.saturated += saturated ? 1U : 0U;
+    c->v_cmd = v;
+    return v;
+}
+
+/*----------------------------------------------------------
+ * Helper: velocity mode direction (as WriteCommand in
+ * drive_command.c, without the console line per cycle)
+ *----------------------------------------------------------*/
+static int32_t WriteDirection(Axis_t axis, int8_t dir)
+{
+    uint16_t reg = (dir > 0) ? (uint16_t)REG_CMD_VEL_FWD : (uint16_t)REG_CMD_VEL_REV;
+
+    return MODBUS_WriteSingle(AXIS_UnitId(axis), reg, (uint16_t)axis);
+}
+
+bool TRACK_Observe(TrackAxis_t *c)
+{
+    FeedbackSample_t s;
+    uint32_t idx = (uint32_t)c->axis - 1U;
+
+    c->stats.cycles++;
+    if (c->image != NULL)
+    {
+        /* Polled this cycle; a sample already seen is ignored */
+        if ((idx >= c->image->count) || (c->image->sample_us[idx] == 0U))
+        {
+            c->stats.read_errors++;
+            return false;
+        }
+        return PRED_Update(&c->pred, c->image->sample_us[idx],
+                           FIX_ToFloat(c->image->position_deg[idx]), 0.0F);
+    }
+    if (Read_Position_Deg_Sample(c->axis, &s) < 0)
+    {
+        c->stats.read_errors++;         /* carry on from the prediction */
+        return false;
+    }
+    return PRED_Update(&c->pred, s.sample_us, s.value, 0.0F);
+}
+
+int32_t TRACK_Command(TrackAxis_t *c)
+{
+    float   v = TRACK_Compute(c, TIME_NowUs());
+    int8_t  dir;
+    int32_t rc = 0;
+
+    if (!c->has_target)
+    {
+        return 0;
+    }
+
+    /* Direction before speed, or the drive runs the new speed the old
+     * way until the direction lands; if it fails, command zero */
+    dir = (v > 0.0F) ? (int8_t)1 : ((v < 0.0F) ? (int8_t)-1 : c->dir);
+    if ((dir != 0) && (dir != c->dir))
+    {
+        if (WriteDirection(c->axis, dir) < 0)
+        {
+            rc = -1;
+            v  = 0.0F;
+        }
+        else
+        {
+            c->dir = dir;
+            c->stats.reversals++;
+        }
+    }
+
+    if (REG_Set_VELOCITY(c->axis, FIX_FromFloat(fabsf(v) * c->gains.vel_per_deg_s)) < 0)
+    {
+        rc = -1;
+    }
+
+    c->stats.write_errors += (rc < 0) ? 1U : 0U;
+    return rc;
+}
+
+int32_t TRACK_Step(TrackAxis_t *c)
+{
+    (void)TRACK_Observe(c);
+    return TRACK_Command(c);
+}
+
+void TRACK_Task(void *arg)
+{
+    (void)TRACK_Step((TrackAxis_t *)arg);
+}
+
+void TRACK_PredictTask(void *arg)
+{
+    (void)TRACK_Observe((TrackAxis_t *)arg);
+}
+
+void TRACK_CommandTask(void *arg)
+{
+    (void)TRACK_Command((TrackAxis_t *)arg);
+}
+
+void TRACK_Stop(TrackAxis_t *c)
+{
+    (void)REG_Set_VELOCITY(c->axis, 0);
+    CMD_Halt(c->axis);
+
+    c->has_target = false;
+    c->integ = 0.0F;
+    c->v_cmd = 0.0F;
+    c->dir = 0;
+    c->last_us = 0U;
+}
+
+void TRACK_ResetStats(TrackAxis_t *c)
+{
+    (void)memset(&c->stats, 0, sizeof(c->stats));
+    PRED_ResetStats(&c->pred);
+}
+
+void TRACK_PrintStats(const TrackAxis_t *c)
+{
+    const TrackStats_t *s = &c->stats;
+    const char *name = AXIS_Get(c->axis)->name;
+
+    printf("\n====== TRACKING %s ======\n", name);
+    if (s->tracked == 0U)
+    {
+        printf("  no target tracked\n");
+        return;
+    }
+    printf("  cycles     : %llu | read errors %llu | write errors %llu\n",
+           (unsigned long long)s->cycles, (unsigned long long)s->read_errors,
+           (unsigned long long)s->write_errors);
+    printf("  error      : rms %.4f deg | max %.4f deg\n",
+           (double)sqrtf(s->err_sq_sum / (float)s->tracked), (double)s->err_max);
+    printf("  saturated  : %llu cycles | reversals %llu | command %.2f deg/s\n",
+           (unsigned long long)s->saturated, (unsigned long long)s->reversals,
+           (double)c->v_cmd);
+    PRED_PrintStats(&c->pred, name);
+}
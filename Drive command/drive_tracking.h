@@ -0,0 +1,169 @@
+#ifndef DRIVE_TRACKING_H
+#define DRIVE_TRACKING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_table.h"
+#include "axis_predictor.h"
+#include "axis_state.h"
+
+/*===========================================================
+ * Continuous Tracking Controller (host side)
+ *===========================================================*/
+/* Outer position loop of a cascade whose velocity loop runs in the
+ * drive. Every cycle it reads the axis position (or takes it from the
+ * poll task's image), and the predictor moves it to the present (half
+ * a round trip of latency removed). It computes
+ *
+ *   v = kff * v_target + kp * e + ki * integral(e)     e = target - pos
+ *
+ * and writes v to the axis velocity register (REG_PAN_VELOCITY /
+ * REG_TILT_VELOCITY), with the direction set by CMD_VEL_FWD / REV
+ * when the sign changes; the direction goes out before the new speed,
+ * so the drive never runs the new speed the old way. v is saturated
+ * at Compute_MaxVelocityDeg(), and its change per cycle at
+ * Compute_MaxAccelerationDeg(). The integral
+ * stops while the output is saturated (anti-windup). Targets beyond
+ * the software limits are clamped to them, and motion further past a
+ * limit is never commanded.
+ *
+ * Velocities inside the loop are deg/s; vel_per_deg_s converts them
+ * to the drive's speed units (those of Compute_MaxVelocity). The
+ * default 0 takes it from the axis: 1 / Compute_DegPerMm().
+ *
+ * In the cyclic executive the loop runs as two tasks per axis after
+ * the poll task: TRACK_PredictTask feeds the predictor from the
+ * image, TRACK_CommandTask writes the setpoint. TRACK_Task does both
+ * and reads the drive itself. */
+
+#ifndef TRACK_VEL_PER_DEG_S
+    #define TRACK_VEL_PER_DEG_S     (0.0F)     /* 0 = from the axis */
+#endif
+#ifndef TRACK_TARGET_HORIZON_US
+    #define TRACK_TARGET_HORIZON_US (500000U)  /* Target older: hold it */
+#endif
+
+/**
+ * @brief Loop tuning
+ */
+typedef struct
+{
+    float kp;                /**< deg/s per deg of error (1/s) */
+    float ki;                /**< deg/s per deg*s (1/s^2) */
+    float kff;               /**< Target velocity feed-forward, 1 = full */
+    float deadband_deg;      /**< Errors below this count as zero */
+    float vel_per_deg_s;     /**< Drive speed units per deg/s; 0 = axis */
+} TrackGains_t;
+
+/**
+ * @brief Tracking statistics
+ */
+typedef struct
+{
+    uint64_t cycles;
+    uint64_t tracked;        /**< Cycles with a target */
+    uint64_t read_errors;    /**< Cycles run on prediction alone */
+    uint64_t write_errors;
+    uint64_t saturated;      /**< Cycles at the velocity limit */
+    uint64_t reversals;      /**< Direction commands sent */
+    float    err_sq_sum;     /**< Tracking error (deg^2), for the RMS */
+    float    err_max;
+} TrackStats_t;
+
+/**
+ * @brief One tracked axis
+ */
+typedef struct
+{
+    Axis_t          axis;
+    TrackGains_t    gains;
+    AxisPredictor_t pred;
+    const AxisStateStore_t *image;  /**< Poll-task image; NULL = read the drive */
+
+    /* Target: position at target_us, moving at target_vel */
+    float    target_pos;     /**< deg */
+    float    target_vel;     /**< deg/s */
+    uint64_t target_us;
+    bool     has_target;
+
+    /* Loop state */
+    float    vmax;           /**< deg/s, from Compute_MaxVelocityDeg */
+    float    amax;           /**< deg/s^2, from Compute_MaxAccelerationDeg */
+    float    limit_min;      /**< Software limits (deg) */
+    float    limit_max;
+    float    integ;          /**< Integral term (deg/s) */
+    float    v_cmd;          /**< Last command (deg/s) */
+    int8_t   dir;            /**< Direction last commanded: 1, -1, 0 none */
+    uint64_t last_us;        /**< Time of the last step, 0 = none */
+
+    TrackStats_t stats;
+} TrackAxis_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief Conservative defaults (kp 5/s, ki 2/s^2, full feed-forward)
+ */
+void TRACK_DefaultGains(TrackGains_t *gains);
+
+/**
+ * @brief Set up an axis (gains NULL = defaults); limits and the
+ *        velocity / acceleration caps come from the axis table
+ */
+void TRACK_Init(TrackAxis_t *c, Axis_t axis, const TrackGains_t *gains);
+
+/**
+ * @brief New target: at time t_us at pos_deg, moving at vel_deg_s.
+ *        Between updates it is extrapolated along its velocity.
+ */
+void TRACK_SetTarget(TrackAxis_t *c, float pos_deg, float vel_deg_s, uint64_t t_us);
+
+/**
+ * @brief Control law only (no I/O): velocity command for the
+ *        predicted position at now_us
+ * @return Command in deg/s (0 without a target)
+ */
+float TRACK_Compute(TrackAxis_t *c, uint64_t now_us);
+
+/**
+ * @brief Feed the predictor: from c->image when set, else read the
+ *        position from the drive
+ * @return false if no new sample arrived (prediction carries on)
+ */
+bool TRACK_Observe(TrackAxis_t *c);
+
+/**
+ * @brief Compute and write the velocity setpoint (direction first)
+ * @return 0, or -1 if a write failed
+ */
+int32_t TRACK_Command(TrackAxis_t *c);
+
+/**
+ * @brief One cycle: TRACK_Observe() then TRACK_Command()
+ * @return As TRACK_Command()
+ */
+int32_t TRACK_Step(TrackAxis_t *c);
+
+/**
+ * @brief CyclicTaskFn_t wrappers, arg is a TrackAxis_t *: the whole
+ *        step, or its two halves for the poll-task pipeline
+ */
+void TRACK_Task(void *arg);
+void TRACK_PredictTask(void *arg);
+void TRACK_CommandTask(void *arg);
+
+/**
+ * @brief Zero the setpoint and halt the axis; the target is dropped
+ */
+void TRACK_Stop(TrackAxis_t *c);
+
+/**
+ * @brief Tracking statistics
+ */
+void TRACK_ResetStats(TrackAxis_t *c);
+void TRACK_PrintStats(const TrackAxis_t *c);
+
+#endif /* DRIVE_TRACKING_H */
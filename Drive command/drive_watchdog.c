@@ -0,0 +1,141 @@
+#include "config.h"
+#include "drive_watchdog.h"
+#include "axis_table.h"
+#include "drive_command.h"
+#include "cyclic_exec.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+void WDOG_Init(Watchdog_t *w, const AxisStateStore_t *store)
+{
+    (void)memset(w, 0, sizeof(*w));
+    w->store         = store;
+    w->stale_us      = WDOG_STALE_US;
+    w->overrun_limit = WDOG_OVERRUN_LIMIT;
+    w->start_us      = TIME_NowUs();
+}
+
+/*----------------------------------------------------------
+ * Checks: image age, faults, limits, executive overruns
+ *----------------------------------------------------------*/
+uint32_t WDOG_Check(Watchdog_t *w, uint64_t now_us)
+{
+    const AxisStateStore_t *s = w->store;
+    uint32_t reason = 0U;
+    uint32_t n_stale = 0U;
+    uint32_t limit_any = 0U;
+    uint32_t n_faults;
+    AxisMask_t stale;
+    AxisMask_t faults;
+    AxisMask_t limits;
+    uint32_t i;
+
+    w->checks++;
+    (void)memset(&stale, 0, sizeof(stale));
+    for (i = 0U; i < s->count; i++)
+    {
+        /* An axis never read is stale once the grace from start runs out */
+        uint64_t last = (s->sample_us[i] != 0U) ? s->sample_us[i] : w->start_us;
+
+        if ((now_us > last) && ((now_us - last) > w->stale_us))
+        {
+            stale.word[i / 32U] |= (1UL << (i % 32U));
+            n_stale++;
+        }
+    }
+    n_faults = AXIS_STATE_ScanFaults(s, &faults);
+    (void)AXIS_STATE_CheckLimits(s, &limits);
+    for (i = 0U; i < AXIS_MASK_WORDS; i++)
+    {
+        limits.word[i] &= ~stale.word[i];          /* old data proves nothing */
+        limit_any |= limits.word[i];
+    }
+
+    reason |= (n_stale != 0U)  ? WDOG_TRIP_STALE : 0U;
+    reason |= (n_faults != 0U) ? WDOG_TRIP_FAULT : 0U;
+    reason |= (limit_any != 0U) ? WDOG_TRIP_LIMIT : 0U;
+    if ((w->overrun_limit != 0U) && (CYCLIC_GetStats()->overrun_streak >= w->overrun_limit))
+    {
+        reason |= WDOG_TRIP_OVERRUN;
+    }
+
+    if ((reason != 0U) && (w->tripped == 0U))
+    {
+        for (i = 0U; i < AXIS_MASK_WORDS; i++)
+        {
+            w->axes.word[i] = stale.word[i] | faults.word[i] | limits.word[i];
+        }
+    }
+    return reason;
+}
+
+/*----------------------------------------------------------
+ * Helper: list the axes behind the trip by number
+ *----------------------------------------------------------*/
+static void PrintAxes(const Watchdog_t *w)
+{
+    uint32_t i;
+
+    for (i = 0U; i < w->store->count; i++)
+    {
+        if (AXIS_MASK_Test(&w->axes, i))
+        {
+            printf(" %lu", (unsigned long)(i + 1U));
+        }
+    }
+}
+
+/*----------------------------------------------------------
+ * Trip: halt everything once, then stop the loop
+ *----------------------------------------------------------*/
+void WDOG_Trip(Watchdog_t *w, uint32_t reason)
+{
+    uint32_t i;
+
+    if (w->tripped != 0U)
+    {
+        return;
+    }
+    w->tripped = reason;
+    printf("[WATCHDOG] Trip 0x%02lX (axes", (unsigned long)reason);
+    PrintAxes(w);
+    printf("): halting all axes\n");
+
+    for (i = 1U; i <= AXIS_COUNT; i++)
+    {
+        CMD_Halt((Axis_t)i);
+    }
+    CYCLIC_Stop();
+}
+
+void WDOG_Task(void *arg)
+{
+    Watchdog_t *w = (Watchdog_t *)arg;
+    uint32_t reason = WDOG_Check(w, TIME_NowUs());
+
+    if (reason != 0U)
+    {
+        WDOG_Trip(w, reason);
+    }
+}
+
+void WDOG_PrintStats(const Watchdog_t *w)
+{
+    printf("\n====== WATCHDOG ======\n");
+    printf("  checks     : %llu\n", (unsigned long long)w->checks);
+    if (w->tripped == 0U)
+    {
+        printf("  state      : ok\n");
+        return;
+    }
+    printf("  tripped    :%s%s%s%s (axes",
+           ((w->tripped & WDOG_TRIP_STALE) != 0U) ? " stale feedback" : "",
+           ((w->tripped & WDOG_TRIP_FAULT) != 0U) ? " drive fault" : "",
+           ((w->tripped & WDOG_TRIP_LIMIT) != 0U) ? " software limit" : "",
+           ((w->tripped & WDOG_TRIP_OVERRUN) != 0U) ? " overruns" : "");
+    PrintAxes(w);
+    printf(")\n");
+}
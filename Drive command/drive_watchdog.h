@@ -0,0 +1,74 @@
+#ifndef DRIVE_WATCHDOG_H
+#define DRIVE_WATCHDOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_state.h"
+
+/*===========================================================
+ * Cyclic Watchdog
+ *===========================================================*/
+/* Runs as a task of the cyclic executive after the poll task. It
+ * checks that the polled image is fresh, that no axis is faulted or
+ * outside its software limits, and that the executive is keeping its
+ * deadlines. On the first failed check it halts every axis once,
+ * latches the reason and stops the executive, so no control task
+ * keeps writing setpoints from stale data. */
+
+#ifndef WDOG_STALE_US
+    #define WDOG_STALE_US         (200000U)  /* Oldest feedback accepted */
+#endif
+#ifndef WDOG_OVERRUN_LIMIT
+    #define WDOG_OVERRUN_LIMIT    (10U)      /* Consecutive overrun cycles */
+#endif
+
+/* Trip reasons (Watchdog_t.tripped) */
+#define WDOG_TRIP_STALE           (0x01U)
+#define WDOG_TRIP_FAULT           (0x02U)
+#define WDOG_TRIP_LIMIT           (0x04U)
+#define WDOG_TRIP_OVERRUN         (0x08U)
+
+/**
+ * @brief Watchdog state (caller-owned)
+ */
+typedef struct
+{
+    const AxisStateStore_t *store;    /**< Image filled by the poll task */
+    uint32_t stale_us;
+    uint32_t overrun_limit;           /**< 0 = overruns not checked */
+    uint64_t start_us;                /**< Grace for axes not yet read */
+    uint32_t tripped;                 /**< WDOG_TRIP_* bits, latched */
+    AxisMask_t axes;                  /**< Axes behind the trip */
+    uint64_t checks;
+} Watchdog_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Watch a store with the default limits above
+ */
+void WDOG_Init(Watchdog_t *w, const AxisStateStore_t *store);
+
+/**
+ * @brief  Run the checks only (no I/O)
+ * @return WDOG_TRIP_* bits of the checks that failed, 0 if all passed
+ */
+uint32_t WDOG_Check(Watchdog_t *w, uint64_t now_us);
+
+/**
+ * @brief  Latch reason, halt every axis and stop the executive; only
+ *         the first trip acts
+ */
+void WDOG_Trip(Watchdog_t *w, uint32_t reason);
+
+/**
+ * @brief  CyclicTaskFn_t wrapper: arg is a Watchdog_t *
+ */
+void WDOG_Task(void *arg);
+
+void WDOG_PrintStats(const Watchdog_t *w);
+
+#endif /* DRIVE_WATCHDOG_H */
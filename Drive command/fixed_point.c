@@ -0,0 +1,114 @@
+#include "config.h"
+#include "fixed_point.h"
+#include <stdint.h>
+
+/*
+ * Engineering values are Q16.16 (range +/-32768, resolution 1/65536).
+ * Decoding multiplies by a precomputed reciprocal instead of dividing,
+ * so the cyclic path needs no FPU and no hardware divider; a 32x32->64
+ * multiply is a single instruction on Cortex-M3/M4 and x86.
+ */
+#define FIX_SCALE_INIT(c)   { (c), ((((int64_t)1 << 32) + ((c) / 2)) / (c)) }
+
+const FixScale_t FIX_SCALE_POSITION = FIX_SCALE_INIT(SCALE_POSITION);
+const FixScale_t FIX_SCALE_VELOCITY = FIX_SCALE_INIT(SCALE_VELOCITY);
+const FixScale_t FIX_SCALE_ACCEL    = FIX_SCALE_INIT(SCALE_ACCEL);
+const FixScale_t FIX_SCALE_CURRENT  = FIX_SCALE_INIT(SCALE_CURRENT);
+const FixScale_t FIX_SCALE_TEMP     = FIX_SCALE_INIT(SCALE_TEMP);
+const FixScale_t FIX_SCALE_UNITY    = FIX_SCALE_INIT(SCALE_UNITY);
+
+/*----------------------------------------------------------
+ * Helper: clamp a 64-bit intermediate to Q16.16
+ *----------------------------------------------------------*/
+static fix16_t Saturate32(int64_t v)
+{
+    if (v > (int64_t)FIX16_MAX) { return FIX16_MAX; }
+    if (v < (int64_t)FIX16_MIN) { return FIX16_MIN; }
+    return (fix16_t)v;
+}
+
+/*----------------------------------------------------------
+ * Helper: drop 16 fraction bits, rounded half away from zero.
+ * The one rounding rule of both encode and decode, so a value
+ * and its negation always map to opposite results.
+ *----------------------------------------------------------*/
+static int64_t RoundShift(int64_t prod)
+{
+    int64_t half = (int64_t)1 << (FIX16_SHIFT - 1);
+
+    /* Shifted magnitude only: >> of a negative value is not portable */
+    return (prod >= 0) ? ((prod + half) >> FIX16_SHIFT)
+                       : -((-prod + half) >> FIX16_SHIFT);
+}
+
+/*----------------------------------------------------------
+ * Helper: Q16.16 value to register counts, rounded to nearest
+ *----------------------------------------------------------*/
+static int64_t ToCounts(fix16_t value, const FixScale_t *scale)
+{
+    return RoundShift((int64_t)value * scale->counts);
+}
+
+/*----------------------------------------------------------
+ * Decode
+ *----------------------------------------------------------*/
+fix16_t FIX_DecodeS16(uint16_t raw, const FixScale_t *scale)
+{
+    /* (raw << 16) / counts == (raw * 2^32 / counts) >> 16 */
+    return Saturate32(RoundShift((int64_t)(int16_t)raw * scale->recip));
+}
+
+fix16_t FIX_DecodeU16(uint16_t raw, const FixScale_t *scale)
+{
+    return Saturate32(RoundShift((int64_t)raw * scale->recip));
+}
+
+/*----------------------------------------------------------
+ * Encode (saturating)
+ *----------------------------------------------------------*/
+uint16_t FIX_EncodeS16(fix16_t value, const FixScale_t *scale)
+{
+    int64_t counts = ToCounts(value, scale);
+
+    if (counts > INT16_MAX) { counts = INT16_MAX; }
+    if (counts < INT16_MIN) { counts = INT16_MIN; }
+    return (uint16_t)(int16_t)counts;
+}
+
+uint16_t FIX_EncodeU16(fix16_t value, const FixScale_t *scale)
+{
+    int64_t counts = ToCounts(value, scale);
+
+    if (counts > (int64_t)UINT16_MAX) { counts = UINT16_MAX; }
+    if (counts < 0) { counts = 0; }
+    return (uint16_t)counts;
+}
+
+/*----------------------------------------------------------
+ * Float facade
+ *----------------------------------------------------------*/
+fix16_t FIX_FromFloat(float value)
+{
+    float scaled = value * (float)FIX16_ONE;
+
+    /* NaN compares false on both sides and maps to 0 */
+    if (scaled >= 2147483647.0F)  { return FIX16_MAX; }
+    if (scaled <= -2147483648.0F) { return FIX16_MIN; }
+    if (!(scaled == scaled))      { return 0; }
+    return (fix16_t)((scaled >= 0.0F) ? (scaled + 0.5F) : (scaled - 0.5F));
+}
+
+float FIX_ToFloat(fix16_t value)
+{
+    return (float)value * (1.0F / (float)FIX16_ONE);
+}
+
+uint16_t FIX_FloatToReg(float value, const FixScale_t *scale)
+{
+    return FIX_EncodeS16(FIX_FromFloat(value), scale);
+}
+
+float FIX_RegToFloat(uint16_t raw, const FixScale_t *scale)
+{
+    return FIX_ToFloat(FIX_DecodeS16(raw, scale));
+}
@@ -0,0 +1,81 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+/*===========================================================
+ * Q16.16 Engineering Values
+ *===========================================================*/
+typedef int32_t fix16_t;
+
+#define FIX16_SHIFT      (16)
+#define FIX16_ONE        ((fix16_t)0x00010000)
+#define FIX16_MAX        ((fix16_t)INT32_MAX)
+#define FIX16_MIN        ((fix16_t)INT32_MIN)
+
+/* Integer literal to Q16.16 (compile-time) */
+#define FIX16_FROM_INT(x)   ((fix16_t)((x) * FIX16_ONE))
+
+/**
+ * @brief Register scale: counts per engineering unit and the
+ *        reciprocal used for division-free decoding
+ */
+typedef struct
+{
+    int32_t counts;       /**< Register counts per unit (SCALE_* in config.h) */
+    int64_t recip;        /**< round(2^32 / counts)                           */
+} FixScale_t;
+
+/* One scale object per SCALE_* define */
+extern const FixScale_t FIX_SCALE_POSITION;
+extern const FixScale_t FIX_SCALE_VELOCITY;
+extern const FixScale_t FIX_SCALE_ACCEL;
+extern const FixScale_t FIX_SCALE_CURRENT;
+extern const FixScale_t FIX_SCALE_TEMP;
+extern const FixScale_t FIX_SCALE_UNITY;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief Signed register word to Q16.16 engineering value
+ *        (rounded to nearest, half away from zero, as the encoders)
+ */
+fix16_t FIX_DecodeS16(uint16_t raw, const FixScale_t *scale);
+
+/**
+ * @brief Unsigned register word to Q16.16 engineering value
+ *        (rounded to nearest, saturated to FIX16_MAX)
+ */
+fix16_t FIX_DecodeU16(uint16_t raw, const FixScale_t *scale);
+
+/**
+ * @brief Q16.16 engineering value to signed register word
+ *        (rounded to nearest, saturated to -32768..32767)
+ */
+uint16_t FIX_EncodeS16(fix16_t value, const FixScale_t *scale);
+
+/**
+ * @brief Q16.16 engineering value to unsigned register word
+ *        (rounded to nearest, saturated to 0..65535)
+ */
+uint16_t FIX_EncodeU16(fix16_t value, const FixScale_t *scale);
+
+/**
+ * @brief Saturating float <-> Q16.16 conversion
+ */
+fix16_t FIX_FromFloat(float value);
+float   FIX_ToFloat(fix16_t value);
+
+/**
+ * @brief Float facade: engineering value to signed register word (saturating)
+ */
+uint16_t FIX_FloatToReg(float value, const FixScale_t *scale);
+
+/**
+ * @brief Float facade: signed register word to engineering value
+ */
+float FIX_RegToFloat(uint16_t raw, const FixScale_t *scale);
+
+#endif /* FIXED_POINT_H */
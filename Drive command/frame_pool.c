@@ -0,0 +1,77 @@
+#include "config.h"
+#include "frame_pool.h"
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Free list kept as a stack of slot indices: acquire and release are
+ * O(1) and never touch the heap. The client is single threaded; a
+ * threaded user must serialise access to the pool.
+ */
+static Frame_t  frame_pool[FRAME_POOL_COUNT];
+static uint16_t free_stack[FRAME_POOL_COUNT];
+static uint32_t free_top = 0U;
+static uint8_t  pool_ready = 0U;
+
+#if (FRAME_POOL_COUNT > 65535U) || (FRAME_POOL_COUNT < 1U)
+    #error "FRAME_POOL_COUNT must be between 1 and 65535"
+#endif
+
+/*----------------------------------------------------------
+ * Helper: lazy initialisation on first use
+ *----------------------------------------------------------*/
+static void PoolInit(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < FRAME_POOL_COUNT; i++)
+    {
+        frame_pool[i].index  = (uint16_t)i;
+        frame_pool[i].in_use = 0U;
+        frame_pool[i].len    = 0U;
+        free_stack[i] = (uint16_t)((FRAME_POOL_COUNT - 1U) - i);
+    }
+    free_top = FRAME_POOL_COUNT;
+    pool_ready = 1U;
+}
+
+Frame_t *FRAME_Acquire(void)
+{
+    Frame_t *frame;
+
+    if (pool_ready == 0U)
+    {
+        PoolInit();
+    }
+
+    if (free_top == 0U)
+    {
+        printf("[ERROR] Frame pool exhausted (%u in use)\n", (unsigned)FRAME_POOL_COUNT);
+        return NULL;
+    }
+
+    free_top--;
+    frame = &frame_pool[free_stack[free_top]];
+    frame->in_use = 1U;
+    frame->len = 0U;
+    frame->rx_us = 0U;
+    frame->rx_src = 0U;
+    return frame;
+}
+
+void FRAME_Release(Frame_t *frame)
+{
+    if ((frame == NULL) || (frame->in_use == 0U))
+    {
+        return;                         /* NULL or double release */
+    }
+
+    frame->in_use = 0U;
+    free_stack[free_top] = frame->index;
+    free_top++;
+}
+
+uint32_t FRAME_InUse(void)
+{
+    return (pool_ready == 0U) ? 0U : (FRAME_POOL_COUNT - free_top);
+}
@@ -0,0 +1,60 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * Receive Frame Pool
+ *===========================================================*/
+/* Fixed set of full-size receive buffers shared by all request paths.
+ * Enough for every response that can be held at once: the pipelined
+ * paths keep at most one per outstanding request. Fleet gateways on
+ * the io_uring backend raise it to cover URING_RX_FRAMES plus the
+ * views they hold. */
+#ifndef FRAME_POOL_COUNT
+    #define FRAME_POOL_COUNT   (16U)
+#endif
+
+/**
+ * @brief One receive buffer; len is the datagram size
+ */
+typedef struct
+{
+    uint8_t  data[MODBUS_MAX_RESP];
+    uint16_t len;
+    uint16_t index;           /**< Slot in the pool */
+    uint8_t  in_use;
+    uint8_t  rx_src;          /**< TSTAMP_SRC_* of rx_us */
+    uint64_t rx_us;           /**< Receive time (monotonic us), 0 if unknown */
+} Frame_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Take a free buffer from the pool
+ * @return Buffer, or NULL when all FRAME_POOL_COUNT are in use
+ */
+Frame_t *FRAME_Acquire(void);
+
+/**
+ * @brief  Return a buffer to the pool (NULL is ignored)
+ */
+void FRAME_Release(Frame_t *frame);
+
+/**
+ * @brief  Buffers currently handed out (leak check)
+ */
+uint32_t FRAME_InUse(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_POOL_H */
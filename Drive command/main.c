@@ -1,12 +1,24 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+#include <signal.h>
 #include "config.h"
 #include "modbus_functions.h"
 #include "drive_feedback.h"
 #include "drive_parameters.h"
 #include "drive_command.h"
 #include "drive_fault.h"
+#include "drive_motion.h"
+#include "drive_daemon.h"
+#include "drive_script.h"
+#include "modbus_transport.h"
+#include "cyclic_exec.h"
+#include "axis_state.h"
+#include "drive_watchdog.h"
+#include "drive_tracking.h"
+#include "target_ingest.h"
 
 /*----------------------------------------------------------
  * Menu Helper Functions
@@ -21,7 +33,8 @@ static void PrintMainMenu(void)
     printf("4. Send Drive Command (0x06)\n");
     printf("5. Read Fault / Temperature / Fault Code\n");
     printf("6. Read IO Status (Inputs & Outputs)\n");
-    printf("7. Exit\n");
+    printf("7. Coordinated PAN/TILT Move\n");
+    printf("8. Exit\n");
     printf("==================================================\n");
     printf("Enter choice: ");
 }
@@ -29,13 +42,22 @@ static void PrintMainMenu(void)
 static Axis_t SelectAxis(void)
 {
     int input = 0;
-    printf("Select Axis (1=PAN, 2=TILT): ");
+    uint32_t i;
+
+    printf("Select Axis (");
+    for (i = 1U; i <= AXIS_COUNT; i++)
+    {
+        printf("%s%lu=%s", (i > 1U) ? ", " : "", (unsigned long)i,
+               AXIS_Get((Axis_t)i)->name);
+    }
+    printf("): ");
     (void)scanf("%d", &input);
-    if (input == 2)
+
+    if (!AXIS_IsValid((Axis_t)input))
     {
-        return AXIS_TILT;
+        return AXIS_PAN;
     }
-    return AXIS_PAN;
+    return (Axis_t)input;
 }
 
 /*----------------------------------------------------------
@@ -162,14 +184,242 @@ static void Menu_ReadFault(void)
            status.under_volt, status.lock_rotor, status.motion_complete);
 }
 
+/*----------------------------------------------------------
+ * Menu 7: Coordinated PAN/TILT Move
+ *----------------------------------------------------------*/
+static void Menu_CoordinatedMove(void)
+{
+    CoordinatedMove_t move;
+    float pan = 0.0F, tilt = 0.0F;
+
+    printf("\n--- Coordinated Move ---\n");
+    printf("Enter PAN target (deg): ");
+    (void)scanf("%f", &pan);
+    printf("Enter TILT target (deg): ");
+    (void)scanf("%f", &tilt);
+
+    (void)Drive_CoordinatedMove(pan, tilt, &move);
+}
+
+/*----------------------------------------------------------
+ * Daemon mode: serve local clients until SIGINT / SIGTERM
+ *----------------------------------------------------------*/
+static Daemon_t daemon_state;
+
+static void OnSignal(int sig)
+{
+    (void)sig;
+    DAEMON_Stop(&daemon_state);
+}
+
+static int RunDaemon(const char *path)
+{
+    if (DAEMON_Open(&daemon_state, path) != 0)
+    {
+        MODBUS_Close();
+        return 1;
+    }
+    (void)TELEM_Create(&daemon_state.telem, NULL, AXIS_COUNT);   /* optional */
+    (void)signal(SIGINT, OnSignal);
+    (void)signal(SIGTERM, OnSignal);
+
+    DAEMON_Run(&daemon_state, 0U);
+
+    DAEMON_PrintStats(&daemon_state);
+    DAEMON_Close(&daemon_state);
+    MODBUS_Close();
+    return 0;
+}
+
+/*----------------------------------------------------------
+ * Cyclic mode: poll and watchdog tasks on the executive
+ * until SIGINT / SIGTERM or a watchdog trip. Tracking mode
+ * adds ingest -> predict -> track between them:
+ *   poll, ingest, predict PAN/TILT, track PAN/TILT, watchdog
+ *----------------------------------------------------------*/
+#ifndef RUN_PERIOD_US
+    #define RUN_PERIOD_US   (10000U)   /* 100 Hz: one poll per cycle */
+#endif
+
+static AxisStateStore_t run_image;
+static Watchdog_t       run_wdog;
+static TargetIngest_t   run_ingest;
+static IngestFeed_t     run_feed;
+static TrackAxis_t      run_pan;
+static TrackAxis_t      run_tilt;
+
+static void OnCyclicSignal(int sig)
+{
+    (void)sig;
+    CYCLIC_Stop();
+}
+
+static int32_t AddTracking(void)
+{
+    if (INGEST_OpenUnix(&run_ingest, NULL) == 0)
+    {
+        printf("Targets on %s\n", INGEST_UNIX_PATH);
+    }
+    else if (INGEST_OpenUdp(&run_ingest, 0U) == 0)
+    {
+        printf("Targets on udp 127.0.0.1:%u\n", (unsigned)INGEST_PORT_UDP);
+    }
+    else
+    {
+        printf("No target socket\n");
+        return -1;
+    }
+
+    TRACK_Init(&run_pan, AXIS_PAN, NULL);
+    TRACK_Init(&run_tilt, AXIS_TILT, NULL);
+    run_pan.image  = &run_image;
+    run_tilt.image = &run_image;
+    run_feed.ing   = &run_ingest;
+    run_feed.pan   = &run_pan;
+    run_feed.tilt  = &run_tilt;
+    run_feed.poll  = true;
+
+    (void)CYCLIC_AddTask("ingest", INGEST_FeedTask, &run_feed, 1U);
+    (void)CYCLIC_AddTask("predict PAN", TRACK_PredictTask, &run_pan, 1U);
+    (void)CYCLIC_AddTask("predict TILT", TRACK_PredictTask, &run_tilt, 1U);
+    (void)CYCLIC_AddTask("track PAN", TRACK_CommandTask, &run_pan, 1U);
+    (void)CYCLIC_AddTask("track TILT", TRACK_CommandTask, &run_tilt, 1U);
+    return 0;
+}
+
+static int RunCyclic(int argc, char *argv[], bool track)
+{
+    CyclicConfig_t cfg = { RUN_PERIOD_US, 0, -1, false };
+
+    cfg.period_us   = (argc > 2) ? (uint32_t)atoi(argv[2]) : cfg.period_us;
+    cfg.cpu         = (argc > 3) ? (int32_t)atoi(argv[3]) : cfg.cpu;
+    cfg.rt_priority = (argc > 4) ? (int32_t)atoi(argv[4]) : cfg.rt_priority;
+    cfg.lock_memory = (cfg.rt_priority > 0);
+
+    if (cfg.period_us == 0U)
+    {
+        printf("Invalid period\n");
+        MODBUS_Close();
+        return 2;
+    }
+    (void)CYCLIC_Init(&cfg);            /* runs unprivileged, reports what failed */
+
+    AXIS_STATE_Init(&run_image, AXIS_COUNT);
+    WDOG_Init(&run_wdog, &run_image);
+    (void)CYCLIC_AddTask("poll", AXIS_STATE_PollTask, &run_image, 1U);
+    if (track && (AddTracking() != 0))
+    {
+        MODBUS_Close();
+        return 1;
+    }
+    (void)CYCLIC_AddTask("watchdog", WDOG_Task, &run_wdog, 1U);
+
+    (void)signal(SIGINT, OnCyclicSignal);
+    (void)signal(SIGTERM, OnCyclicSignal);
+    CYCLIC_Run(0U);
+
+    if (track)
+    {
+        TRACK_Stop(&run_pan);
+        TRACK_Stop(&run_tilt);
+        INGEST_Close(&run_ingest);
+    }
+    CYCLIC_PrintStats();
+    WDOG_PrintStats(&run_wdog);
+    if (track)
+    {
+        INGEST_PrintStats(&run_ingest);
+        TRACK_PrintStats(&run_pan);
+        TRACK_PrintStats(&run_tilt);
+    }
+    MODBUS_Close();
+    return (run_wdog.tripped != 0U) ? 1 : 0;
+}
+
+/*----------------------------------------------------------
+ * Batch mode: run a command script without prompts
+ *----------------------------------------------------------*/
+static int RunBatch(const char *path, const char *transport)
+{
+    uint8_t kind = TRANSPORT_RTU_UDP;
+    int32_t rc;
+
+    if (transport != NULL)
+    {
+        kind = TRANSPORT_KindFromName(transport);
+        if (kind >= TRANSPORT_KIND_COUNT)
+        {
+            printf("Unknown transport '%s' (rtu-udp, mbap-udp, mbap-tcp)\n", transport);
+            MODBUS_Close();
+            return 2;
+        }
+    }
+    rc = SCRIPT_RunFile(path, kind, NULL);
+
+    MODBUS_Close();
+    return (int)rc;
+}
+
+/*----------------------------------------------------------
+ * Usage: unknown arguments exit instead of opening the menu
+ *----------------------------------------------------------*/
+static int Usage(const char *prog)
+{
+    static const char *const MODES[][2] =
+    {
+        { "",                                 "interactive menu" },
+        { "--daemon [socket]",                "control socket daemon" },
+        { "--batch <script|-> [kind]",        "command script (rtu-udp, mbap-udp, mbap-tcp)" },
+        { "--cyclic [period_us [cpu [prio]]]", "cyclic executive" },
+        { "--track [period_us [cpu [prio]]]",  "cyclic executive with target tracking" }
+    };
+    uint32_t i;
+
+    for (i = 0U; i < (sizeof(MODES) / sizeof(MODES[0])); i++)
+    {
+        printf("%s %s %-34s %s\n", (i == 0U) ? "Usage:" : "      ", prog, MODES[i][0], MODES[i][1]);
+    }
+    return 2;
+}
+
 /*----------------------------------------------------------
  * Main Function
+ *   drive_control                             interactive menu
+ *   drive_control --daemon [socket]           control socket daemon
+ *   drive_control --batch <script|-> [kind]   command script
+ *   drive_control --cyclic [period_us [cpu [prio]]]  cyclic executive
+ *   drive_control --track [period_us [cpu [prio]]]   cyclic + target tracking
  *----------------------------------------------------------*/
-int main(void)
+int main(int argc, char *argv[])
 {
     int choice = 0;
 
+    if ((argc > 1) &&
+        !((strcmp(argv[1], "--daemon") == 0) || (strcmp(argv[1], "--cyclic") == 0) ||
+          (strcmp(argv[1], "--track") == 0) ||
+          ((argc > 2) && (strcmp(argv[1], "--batch") == 0))))
+    {
+        return Usage(argv[0]);
+    }
+
     MODBUS_Init();
+    if ((argc > 1) && (strcmp(argv[1], "--daemon") == 0))
+    {
+        return RunDaemon((argc > 2) ? argv[2] : NULL);
+    }
+    if ((argc > 1) && (strcmp(argv[1], "--cyclic") == 0))
+    {
+        return RunCyclic(argc, argv, false);
+    }
+    if ((argc > 1) && (strcmp(argv[1], "--track") == 0))
+    {
+        return RunCyclic(argc, argv, true);
+    }
+    if ((argc > 2) && (strcmp(argv[1], "--batch") == 0))
+    {
+        return RunBatch(argv[2], (argc > 3) ? argv[3] : NULL);
+    }
+
     printf("==================================================\n");
     printf("   Dual Axis Drive Control via UDP Modbus (C)    \n");
     printf("==================================================\n");
@@ -186,18 +436,12 @@ int main(void)
             case 3: Menu_SetMultiParameter(); break;
             case 4: Menu_SendCommand(); break;
             case 5: Menu_ReadFault(); break;
-            case 6:
-                {
-                printf("Select Axis (1=PAN, 2=TILT): ");
-                int ax;
-                scanf("%d", &ax);
-                Read_IO_Status((ax == 1) ? AXIS_PAN : AXIS_TILT);
-                break;
-                }
-            case 7: printf("Closing connection...\n"); break;
+            case 6: Read_IO_Status(SelectAxis()); break;
+            case 7: Menu_CoordinatedMove(); break;
+            case 8: printf("Closing connection...\n"); break;
             default: printf("Invalid selection.\n"); break;
         }
-    } while (choice != 7);
+    } while (choice != 8);
 
     MODBUS_Close();
     printf("Drive Control Program Terminated.\n");
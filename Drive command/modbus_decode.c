@@ -0,0 +1,184 @@
+#include "modbus_decode.h"
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * The SIMD path is chosen once at run time from CPUID: the vector
+ * functions are compiled for their own target, so one binary runs on
+ * any x86 CPU and uses AVX2 or SSSE3 where present. Other compilers and
+ * architectures use the scalar loop, which is also the tail handler of
+ * the vector paths.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #include <immintrin.h>
+    #define DECODE_DISPATCH
+    #define TARGET_AVX2    __attribute__((target("avx2")))
+    #define TARGET_SSSE3   __attribute__((target("ssse3")))
+#endif
+
+typedef void (*DecodeWordsFn_t)(const uint8_t *src, uint16_t *dst, uint32_t count);
+typedef void (*DecodeScaledFn_t)(const uint8_t *src, float *dst, uint32_t count, float scale);
+
+/*----------------------------------------------------------
+ * Scalar reference
+ *----------------------------------------------------------*/
+static void DecodeWords_Scalar(const uint8_t *src, uint16_t *dst, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0U; i < count; i++)
+    {
+        dst[i] = (uint16_t)(((uint16_t)src[2U * i] << 8U) | src[(2U * i) + 1U]);
+    }
+}
+
+static void DecodeScaled_Scalar(const uint8_t *src, float *dst, uint32_t count, float scale)
+{
+    uint32_t i;
+
+    for (i = 0U; i < count; i++)
+    {
+        int16_t raw = (int16_t)(((uint16_t)src[2U * i] << 8U) | src[(2U * i) + 1U]);
+        dst[i] = (float)raw * scale;
+    }
+}
+
+#ifdef DECODE_DISPATCH
+/*----------------------------------------------------------
+ * AVX2: 16 words / 8 scaled values per step
+ *----------------------------------------------------------*/
+TARGET_AVX2 static void DecodeWords_Avx2(const uint8_t *src, uint16_t *dst, uint32_t count)
+{
+    uint32_t i = 0U;
+    const __m256i swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    for (; (i + 16U) <= count; i += 16U)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(const void *)&src[2U * i]);
+        _mm256_storeu_si256((__m256i *)(void *)&dst[i], _mm256_shuffle_epi8(v, swap));
+    }
+
+    DecodeWords_Scalar(&src[2U * i], &dst[i], count - i);
+}
+
+TARGET_AVX2 static void DecodeScaled_Avx2(const uint8_t *src, float *dst, uint32_t count, float scale)
+{
+    uint32_t i = 0U;
+    const __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m256 k = _mm256_set1_ps(scale);
+    for (; (i + 8U) <= count; i += 8U)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)&src[2U * i]);
+        __m256i w = _mm256_cvtepi16_epi32(_mm_shuffle_epi8(v, swap));
+        _mm256_storeu_ps(&dst[i], _mm256_mul_ps(_mm256_cvtepi32_ps(w), k));
+    }
+
+    DecodeScaled_Scalar(&src[2U * i], &dst[i], count - i, scale);
+}
+
+/*----------------------------------------------------------
+ * SSSE3: 8 words / 8 scaled values per step
+ *----------------------------------------------------------*/
+TARGET_SSSE3 static void DecodeWords_Ssse3(const uint8_t *src, uint16_t *dst, uint32_t count)
+{
+    uint32_t i = 0U;
+    const __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    for (; (i + 8U) <= count; i += 8U)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)&src[2U * i]);
+        _mm_storeu_si128((__m128i *)(void *)&dst[i], _mm_shuffle_epi8(v, swap));
+    }
+
+    DecodeWords_Scalar(&src[2U * i], &dst[i], count - i);
+}
+
+TARGET_SSSE3 static void DecodeScaled_Ssse3(const uint8_t *src, float *dst, uint32_t count, float scale)
+{
+    uint32_t i = 0U;
+    const __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const __m128 k = _mm_set1_ps(scale);
+    for (; (i + 8U) <= count; i += 8U)
+    {
+        __m128i v  = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&src[2U * i]), swap);
+        /* sign extend: interleave with itself, arithmetic shift right 16 */
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(&dst[i],      _mm_mul_ps(_mm_cvtepi32_ps(lo), k));
+        _mm_storeu_ps(&dst[i + 4U], _mm_mul_ps(_mm_cvtepi32_ps(hi), k));
+    }
+
+    DecodeScaled_Scalar(&src[2U * i], &dst[i], count - i, scale);
+}
+#endif /* DECODE_DISPATCH */
+
+/*----------------------------------------------------------
+ * Dispatch: resolved on first use, then one indirect call
+ *----------------------------------------------------------*/
+static DecodeWordsFn_t  decode_words  = NULL;
+static DecodeScaledFn_t decode_scaled = NULL;
+static const char      *decode_impl   = "scalar";
+
+static void Select(void)
+{
+    DecodeWordsFn_t  words  = DecodeWords_Scalar;
+    DecodeScaledFn_t scaled = DecodeScaled_Scalar;
+    const char      *impl   = "scalar";
+
+#ifdef DECODE_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        words  = DecodeWords_Avx2;
+        scaled = DecodeScaled_Avx2;
+        impl   = "avx2";
+    }
+    else if (__builtin_cpu_supports("ssse3"))
+    {
+        words  = DecodeWords_Ssse3;
+        scaled = DecodeScaled_Ssse3;
+        impl   = "ssse3";
+    }
+    else
+    {
+        /* scalar */
+    }
+#endif
+
+    /* Every caller selects the same functions: a race only repeats this */
+    decode_impl   = impl;
+    decode_scaled = scaled;
+    decode_words  = words;
+}
+
+/*----------------------------------------------------------
+ * Byte swap of a whole block
+ *----------------------------------------------------------*/
+void MODBUS_DecodeWords(const uint8_t *src, uint16_t *dst, uint32_t count)
+{
+    if (decode_words == NULL)
+    {
+        Select();
+    }
+    decode_words(src, dst, count);
+}
+
+/*----------------------------------------------------------
+ * Byte swap + sign extend + scale of a whole block
+ *----------------------------------------------------------*/
+void MODBUS_DecodeScaled(const uint8_t *src, float *dst, uint32_t count, float scale)
+{
+    if (decode_scaled == NULL)
+    {
+        Select();
+    }
+    decode_scaled(src, dst, count, scale);
+}
+
+const char *MODBUS_DecodeImpl(void)
+{
+    if (decode_words == NULL)
+    {
+        Select();
+    }
+    return decode_impl;
+}
@@ -0,0 +1,39 @@
+#ifndef MODBUS_DECODE_H
+#define MODBUS_DECODE_H
+
+#include <stdint.h>
+
+/*===========================================================
+ * Bulk Register Decode
+ *===========================================================*/
+#define MODBUS_MAX_READ_REGS   (125U)   /* 0x03 / 0x04 limit */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Byte-swap a block of big-endian register words to host order
+ * @param  src    Register data as received (2 x count bytes)
+ * @param  dst    Output words
+ * @param  count  Number of registers (any size; <= 125 per frame)
+ */
+void MODBUS_DecodeWords(const uint8_t *src, uint16_t *dst, uint32_t count);
+
+/**
+ * @brief  Decode signed big-endian registers and scale to float in one pass
+ *         dst[i] = (int16_t)reg[i] * scale
+ */
+void MODBUS_DecodeScaled(const uint8_t *src, float *dst, uint32_t count, float scale);
+
+/**
+ * @brief  Name of the decoder selected for this CPU at run time
+ *         ("avx2", "ssse3", "scalar")
+ */
+const char *MODBUS_DecodeImpl(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODBUS_DECODE_H */
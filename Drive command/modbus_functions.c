@@ -1,70 +1,695 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* SO_BUSY_POLL */
+#endif
+
 #include "config.h"
 #include "modbus_functions.h"
+#include "axis_table.h"
+#include "frame_pool.h"
+#include "drive_time.h"
+#include "net_timestamp.h"
 #include <stdio.h>
 #include <string.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
 #include <stdint.h>
 
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+
+    typedef int SOCKET;
+    #define INVALID_SOCKET   (-1)
+    #define closesocket      close
+#endif
+
+#ifdef _WIN32
+    #define ERR_WOULDBLOCK() (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+    #define ERR_WOULDBLOCK() ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+#endif
+
+/* Receive after select(): never block (Windows: select said a
+ * datagram is queued, there is no error queue to wake it) */
+#ifdef _WIN32
+    #define RECV_NOWAIT      (0)
+#else
+    #define RECV_NOWAIT      (MSG_DONTWAIT)
+#endif
+
 /*----------------------------------------------------------
- * CRC16 Calculation (Modbus RTU)
+ * CRC16 Calculation (Modbus RTU, reflected poly 0xA001)
+ * One table lookup per byte instead of eight shift/xor steps
  *----------------------------------------------------------*/
-static uint16_t MODBUS_CRC16(const uint8_t *buffer, uint16_t length)
+static const uint16_t crc16_table[256U] =
+{
+    0x0000U, 0xC0C1U, 0xC181U, 0x0140U, 0xC301U, 0x03C0U, 0x0280U, 0xC241U,
+    0xC601U, 0x06C0U, 0x0780U, 0xC741U, 0x0500U, 0xC5C1U, 0xC481U, 0x0440U,
+    0xCC01U, 0x0CC0U, 0x0D80U, 0xCD41U, 0x0F00U, 0xCFC1U, 0xCE81U, 0x0E40U,
+    0x0A00U, 0xCAC1U, 0xCB81U, 0x0B40U, 0xC901U, 0x09C0U, 0x0880U, 0xC841U,
+    0xD801U, 0x18C0U, 0x1980U, 0xD941U, 0x1B00U, 0xDBC1U, 0xDA81U, 0x1A40U,
+    0x1E00U, 0xDEC1U, 0xDF81U, 0x1F40U, 0xDD01U, 0x1DC0U, 0x1C80U, 0xDC41U,
+    0x1400U, 0xD4C1U, 0xD581U, 0x1540U, 0xD701U, 0x17C0U, 0x1680U, 0xD641U,
+    0xD201U, 0x12C0U, 0x1380U, 0xD341U, 0x1100U, 0xD1C1U, 0xD081U, 0x1040U,
+    0xF001U, 0x30C0U, 0x3180U, 0xF141U, 0x3300U, 0xF3C1U, 0xF281U, 0x3240U,
+    0x3600U, 0xF6C1U, 0xF781U, 0x3740U, 0xF501U, 0x35C0U, 0x3480U, 0xF441U,
+    0x3C00U, 0xFCC1U, 0xFD81U, 0x3D40U, 0xFF01U, 0x3FC0U, 0x3E80U, 0xFE41U,
+    0xFA01U, 0x3AC0U, 0x3B80U, 0xFB41U, 0x3900U, 0xF9C1U, 0xF881U, 0x3840U,
+    0x2800U, 0xE8C1U, 0xE981U, 0x2940U, 0xEB01U, 0x2BC0U, 0x2A80U, 0xEA41U,
+    0xEE01U, 0x2EC0U, 0x2F80U, 0xEF41U, 0x2D00U, 0xEDC1U, 0xEC81U, 0x2C40U,
+    0xE401U, 0x24C0U, 0x2580U, 0xE541U, 0x2700U, 0xE7C1U, 0xE681U, 0x2640U,
+    0x2200U, 0xE2C1U, 0xE381U, 0x2340U, 0xE101U, 0x21C0U, 0x2080U, 0xE041U,
+    0xA001U, 0x60C0U, 0x6180U, 0xA141U, 0x6300U, 0xA3C1U, 0xA281U, 0x6240U,
+    0x6600U, 0xA6C1U, 0xA781U, 0x6740U, 0xA501U, 0x65C0U, 0x6480U, 0xA441U,
+    0x6C00U, 0xACC1U, 0xAD81U, 0x6D40U, 0xAF01U, 0x6FC0U, 0x6E80U, 0xAE41U,
+    0xAA01U, 0x6AC0U, 0x6B80U, 0xAB41U, 0x6900U, 0xA9C1U, 0xA881U, 0x6840U,
+    0x7800U, 0xB8C1U, 0xB981U, 0x7940U, 0xBB01U, 0x7BC0U, 0x7A80U, 0xBA41U,
+    0xBE01U, 0x7EC0U, 0x7F80U, 0xBF41U, 0x7D00U, 0xBDC1U, 0xBC81U, 0x7C40U,
+    0xB401U, 0x74C0U, 0x7580U, 0xB541U, 0x7700U, 0xB7C1U, 0xB681U, 0x7640U,
+    0x7200U, 0xB2C1U, 0xB381U, 0x7340U, 0xB101U, 0x71C0U, 0x7080U, 0xB041U,
+    0x5000U, 0x90C1U, 0x9181U, 0x5140U, 0x9301U, 0x53C0U, 0x5280U, 0x9241U,
+    0x9601U, 0x56C0U, 0x5780U, 0x9741U, 0x5500U, 0x95C1U, 0x9481U, 0x5440U,
+    0x9C01U, 0x5CC0U, 0x5D80U, 0x9D41U, 0x5F00U, 0x9FC1U, 0x9E81U, 0x5E40U,
+    0x5A00U, 0x9AC1U, 0x9B81U, 0x5B40U, 0x9901U, 0x59C0U, 0x5880U, 0x9841U,
+    0x8801U, 0x48C0U, 0x4980U, 0x8941U, 0x4B00U, 0x8BC1U, 0x8A81U, 0x4A40U,
+    0x4E00U, 0x8EC1U, 0x8F81U, 0x4F40U, 0x8D01U, 0x4DC0U, 0x4C80U, 0x8C41U,
+    0x4400U, 0x84C1U, 0x8581U, 0x4540U, 0x8701U, 0x47C0U, 0x4680U, 0x8641U,
+    0x8201U, 0x42C0U, 0x4380U, 0x8341U, 0x4100U, 0x81C1U, 0x8081U, 0x4040U
+};
+
+uint16_t MODBUS_CRC16(const uint8_t *buffer, uint16_t length)
 {
     uint16_t crc = 0xFFFFU;
-    uint16_t i, j;
+    uint16_t i;
 
     for (i = 0U; i < length; i++)
     {
-        crc ^= buffer[i];
-        for (j = 0U; j < 8U; j++)
+        crc = (uint16_t)((crc >> 8U) ^ crc16_table[(crc ^ buffer[i]) & 0xFFU]);
+    }
+    return crc;
+}
+
+/*----------------------------------------------------------
+ * Response validation
+ *----------------------------------------------------------*/
+static ModbusStatus_t last_status = MODBUS_OK;
+static uint8_t        last_exception = 0U;
+
+ModbusStatus_t MODBUS_CheckPdu(const uint8_t *frame, int32_t len,
+                               uint8_t slave_id, uint8_t func,
+                               uint16_t num_regs, uint8_t *ex_code)
+{
+    int32_t expect;
+
+    *ex_code = 0U;
+
+    /* Cheapest rejections first */
+    if (len < 0)
+    {
+        return MODBUS_ERR_IO;
+    }
+    if (len < 3)
+    {
+        return MODBUS_ERR_LENGTH;
+    }
+    if (frame[0] != slave_id)
+    {
+        return MODBUS_ERR_UNIT;
+    }
+
+    if (frame[1] == (uint8_t)(func | 0x80U))
+    {
+        /* unit | func|0x80 | code */
+        if (len != 3)
         {
-            if ((crc & 0x0001U) != 0U)
-            {
-                crc = (crc >> 1U) ^ 0xA001U;
-            }
-            else
-            {
-                crc >>= 1U;
-            }
+            return MODBUS_ERR_LENGTH;
         }
+        *ex_code = frame[2];
+        return MODBUS_ERR_EXCEPTION;
+    }
+    if (frame[1] != func)
+    {
+        return MODBUS_ERR_FUNC;
+    }
+
+    if ((func == MODBUS_FUNC_READ_HOLDING) || (func == MODBUS_FUNC_READ_INPUT))
+    {
+        /* unit | func | byte count | data ... */
+        expect = 3 + (2 * (int32_t)num_regs);
+        if (frame[2] != (uint8_t)(2U * num_regs))
+        {
+            return MODBUS_ERR_LENGTH;
+        }
+    }
+    else
+    {
+        expect = 6;                     /* 0x06 / 0x10 echo */
+    }
+
+    return (len == expect) ? MODBUS_OK : MODBUS_ERR_LENGTH;
+}
+
+ModbusStatus_t MODBUS_CheckResponse(const uint8_t *frame, int32_t len,
+                                    uint8_t slave_id, uint8_t func,
+                                    uint16_t num_regs, uint8_t *ex_code)
+{
+    ModbusStatus_t status;
+
+    *ex_code = 0U;
+    if (len < 0)
+    {
+        return MODBUS_ERR_IO;
+    }
+    if (len < 5)
+    {
+        return MODBUS_ERR_LENGTH;
+    }
+
+    /* The CRC is only run on a frame whose header and length
+     * already match the request. */
+    status = MODBUS_CheckPdu(frame, len - 2, slave_id, func, num_regs, ex_code);
+
+    /* CRC over data + transmitted CRC leaves a zero residue */
+    if (((status == MODBUS_OK) || (status == MODBUS_ERR_EXCEPTION)) &&
+        (MODBUS_CRC16(frame, (uint16_t)len) != 0U))
+    {
+        *ex_code = 0U;
+        status = MODBUS_ERR_CRC;
+    }
+    return status;
+}
+
+/*----------------------------------------------------------
+ * Helper: record and report the outcome of a blocking call
+ *----------------------------------------------------------*/
+static ModbusStatus_t Track(ModbusStatus_t status, uint8_t ex_code)
+{
+    last_status = status;
+    last_exception = ex_code;
+
+    if (status == MODBUS_ERR_EXCEPTION)
+    {
+        printf("[MODBUS] Exception 0x%02X (%s)\n", ex_code, MODBUS_ExceptionText(ex_code));
+    }
+    else if (status != MODBUS_OK)
+    {
+        printf("[MODBUS] Rejected response: %s\n", MODBUS_StatusText(status));
+    }
+    else
+    {
+        /* accepted */
+    }
+    return status;
+}
+
+ModbusStatus_t MODBUS_LastStatus(uint8_t *ex_code)
+{
+    if (ex_code != NULL)
+    {
+        *ex_code = last_exception;
+    }
+    return last_status;
+}
+
+const char *MODBUS_StatusText(ModbusStatus_t status)
+{
+    switch (status)
+    {
+        case MODBUS_OK:            return "ok";
+        case MODBUS_ERR_IO:        return "no response";
+        case MODBUS_ERR_LENGTH:    return "bad length";
+        case MODBUS_ERR_UNIT:      return "unit ID mismatch";
+        case MODBUS_ERR_FUNC:      return "function code mismatch";
+        case MODBUS_ERR_CRC:       return "CRC error";
+        case MODBUS_ERR_EXCEPTION: return "exception response";
+        default:                   return "unknown";
+    }
+}
+
+const char *MODBUS_ExceptionText(uint8_t ex_code)
+{
+    switch (ex_code)
+    {
+        case MODBUS_EX_ILLEGAL_FUNCTION:  return "illegal function";
+        case MODBUS_EX_ILLEGAL_ADDRESS:   return "illegal data address";
+        case MODBUS_EX_ILLEGAL_VALUE:     return "illegal data value";
+        case MODBUS_EX_DEVICE_FAILURE:    return "server device failure";
+        case MODBUS_EX_ACKNOWLEDGE:       return "acknowledge";
+        case MODBUS_EX_DEVICE_BUSY:       return "server device busy";
+        case MODBUS_EX_GATEWAY_PATH:      return "gateway path unavailable";
+        case MODBUS_EX_GATEWAY_TARGET:    return "gateway target failed to respond";
+        default:                          return "unknown exception";
     }
-    return crc;
 }
 
 /*----------------------------------------------------------
  * UDP Globals
  *----------------------------------------------------------*/
 static SOCKET modbus_socket = INVALID_SOCKET;
-static struct sockaddr_in modbus_target;
-static int modbus_target_len = sizeof(modbus_target);
+
+static ModbusLowLatency_t low_latency = { 0U, 0U };
+static ModbusRxStats_t    rx_stats = { 0U, 0U, 0U, 0U, 0U, 0U, UINT32_MAX, 0U };
+static uint64_t           tx_time_us = 0U;   /* Send time of the request received */
+
+static uint8_t            stamp_src = TSTAMP_SRC_USER;
+static uint32_t           tx_count = 0U;     /* Datagram ID of the next send */
+static ModbusStamp_t      last_stamp;
+static uint32_t           last_id = 0U;      /* Datagram ID last_stamp belongs to */
+
+/*----------------------------------------------------------
+ * Requests sent and not yet received, oldest first. The
+ * drive answers in send order, so a receive belongs to the
+ * oldest: its send time bounds the wait and its stamp goes
+ * to last_stamp. A later split send leaves it untouched.
+ *----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t id;                /* Datagram ID */
+    uint64_t sent_us;           /* User-space send time (timeout) */
+    uint64_t tx_us;             /* Send stamp, kernel if it came */
+    uint8_t  tx_src;
+} Pending_t;
+
+static Pending_t          pending[MODBUS_PIPELINE_DEPTH];
+static uint32_t           pending_head = 0U;
+static uint32_t           pending_n = 0U;
+
+/*----------------------------------------------------------
+ * Routes: a request goes to the endpoint of the axis that
+ * owns its unit ID (axis table); the first axis is the default
+ *----------------------------------------------------------*/
+typedef struct
+{
+    uint8_t            unit_id;
+    struct sockaddr_in addr;
+} ModbusRoute_t;
+
+static ModbusRoute_t routes[AXIS_MAX_COUNT];
+static uint32_t      route_count = 0U;
+
+static void BuildRoutes(void)
+{
+    uint32_t i;
+    uint32_t r;
+
+    route_count = 0U;
+    for (i = 1U; i <= AXIS_COUNT; i++)
+    {
+        const AxisDescriptor_t *d = AXIS_Get((Axis_t)i);
+        struct sockaddr_in addr;
+
+        (void)memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(d->port);
+        addr.sin_addr.s_addr = inet_addr(d->ip_addr);
+
+        for (r = 0U; (r < route_count) && (routes[r].unit_id != d->unit_id); r++)
+        {
+        }
+        if (r == route_count)
+        {
+            routes[route_count].unit_id = d->unit_id;
+            routes[route_count].addr = addr;
+            route_count++;
+        }
+        else if ((routes[r].addr.sin_addr.s_addr != addr.sin_addr.s_addr) ||
+                 (routes[r].addr.sin_port != addr.sin_port))
+        {
+            printf("[MODBUS] Axis %s: unit %u already routed to another endpoint, %s:%u ignored\n",
+                   d->name, (unsigned)d->unit_id, d->ip_addr, (unsigned)d->port);
+        }
+        else
+        {
+            /* same controller, another axis */
+        }
+    }
+}
+
+static const struct sockaddr_in *Route(uint8_t unit_id)
+{
+    uint32_t r;
+
+    if (route_count == 0U)
+    {
+        BuildRoutes();
+    }
+    for (r = 1U; r < route_count; r++)
+    {
+        if (routes[r].unit_id == unit_id)
+        {
+            return &routes[r].addr;
+        }
+    }
+    return &routes[0].addr;
+}
 
 /*----------------------------------------------------------
  * Initialize UDP connection
  *----------------------------------------------------------*/
 void MODBUS_Init(void)
 {
+#ifdef _WIN32
     WSADATA wsaData;
     (void)WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
 
     modbus_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    (void)memset(&modbus_target, 0, sizeof(modbus_target));
-    modbus_target.sin_family = AF_INET;
-    modbus_target.sin_port = htons(DRIVE_PORT_UDP);
-    modbus_target.sin_addr.s_addr = inet_addr(DRIVE_IP_ADDR);
+    BuildRoutes();
+
+    tx_count = 0U;
+    pending_head = 0U;
+    pending_n = 0U;
+    stamp_src = (modbus_socket != INVALID_SOCKET) ?
+                TSTAMP_Enable((uintptr_t)modbus_socket) : TSTAMP_SRC_USER;
 }
 
 /*----------------------------------------------------------
- * 1) Read Holding Registers (0x03)
+ * Low-latency mode: spin on the non-blocking socket, then
+ * block until the reply arrives
  *----------------------------------------------------------*/
-int32_t MODBUS_ReadHolding(uint8_t slave_id, uint16_t start_addr,
-                           uint16_t num_regs, uint8_t *rx_buf)
+int32_t MODBUS_SetLowLatency(const ModbusLowLatency_t *cfg)
+{
+    int32_t rc = 0;
+
+    if (modbus_socket == INVALID_SOCKET)
+    {
+        return -1;
+    }
+    low_latency = *cfg;
+
+#ifdef _WIN32
+    {
+        u_long nb = (cfg->spin_budget_us > 0U) ? 1UL : 0UL;
+        (void)ioctlsocket(modbus_socket, FIONBIO, &nb);
+    }
+#else
+    {
+        int flags = fcntl(modbus_socket, F_GETFL, 0);
+        flags = (cfg->spin_budget_us > 0U) ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+        (void)fcntl(modbus_socket, F_SETFL, flags);
+    }
+#endif
+
+    if (cfg->busy_poll_us > 0U)
+    {
+#if defined(SO_BUSY_POLL)
+        /* Poll the device queue from recv(); above the
+         * net.core.busy_read limit this needs CAP_NET_ADMIN */
+        int us = (int)cfg->busy_poll_us;
+        if (setsockopt(modbus_socket, SOL_SOCKET, SO_BUSY_POLL, &us, sizeof(us)) != 0)
+        {
+            printf("[MODBUS] SO_BUSY_POLL %u us refused (errno %d)\n",
+                   (unsigned)cfg->busy_poll_us, errno);
+            rc = -1;
+        }
+#else
+        printf("[MODBUS] SO_BUSY_POLL not supported on this platform\n");
+        rc = -1;
+#endif
+    }
+    return rc;
+}
+
+/*----------------------------------------------------------
+ * Helper: take kernel send stamps off the error queue; each
+ * replaces the user-space send time of its request
+ *----------------------------------------------------------*/
+static void CollectTxStamp(void)
+{
+    uint32_t ids[4U];
+    uint64_t us[4U];
+    uint8_t  src[4U];
+    uint32_t n;
+    uint32_t i;
+
+    if (stamp_src < TSTAMP_SRC_SOFTWARE)
+    {
+        return;
+    }
+    do
+    {
+        n = TSTAMP_ReadTx((uintptr_t)modbus_socket, ids, us, src, 4U);
+        for (i = 0U; i < n; i++)
+        {
+            uint32_t k;
+
+            for (k = 0U; k < pending_n; k++)
+            {
+                Pending_t *p = &pending[(pending_head + k) % MODBUS_PIPELINE_DEPTH];
+
+                if (p->id == ids[i])
+                {
+                    p->tx_us  = us[i];
+                    p->tx_src = src[i];
+                }
+            }
+            if ((ids[i] == last_id) && (last_stamp.tx_src != TSTAMP_SRC_NONE))
+            {
+                last_stamp.tx_us  = us[i];      /* stamp after the reply */
+                last_stamp.tx_src = src[i];
+            }
+        }
+    } while (n == 4U);
+}
+
+/*----------------------------------------------------------
+ * Helper: drop a late reply to a request that already
+ * timed out, so it is not taken for the next one's. Only
+ * with nothing outstanding: a queued reply may otherwise
+ * answer an earlier split send.
+ *----------------------------------------------------------*/
+static void DropStale(void)
+{
+    uint8_t stale[MODBUS_MAX_RESP];
+#ifdef _WIN32
+    u_long avail = 0U;
+
+    while ((ioctlsocket(modbus_socket, FIONREAD, &avail) == 0) && (avail > 0U) &&
+           (recv(modbus_socket, (char *)stale, (int)sizeof(stale), 0) > 0))
+    {
+    }
+#else
+    while (recv(modbus_socket, stale, sizeof(stale), MSG_DONTWAIT) > 0)
+    {
+    }
+#endif
+}
+
+static int32_t ControlSend(const uint8_t *tx_buf, uint16_t len)
+{
+    int32_t   sent;
+    uint64_t  now;
+    Pending_t *p;
+
+    if (pending_n == 0U)
+    {
+        DropStale();
+    }
+    now = TIME_NowUs();
+
+    sent = (int32_t)sendto(modbus_socket, (const char *)tx_buf, (int)len, 0,
+                           (const struct sockaddr *)Route(tx_buf[0]),
+                           (int)sizeof(struct sockaddr_in));
+    if (sent >= 0)
+    {
+        if (pending_n == MODBUS_PIPELINE_DEPTH)
+        {
+            /* Never received: forget the oldest */
+            pending_head = (pending_head + 1U) % MODBUS_PIPELINE_DEPTH;
+            pending_n--;
+        }
+        p = &pending[(pending_head + pending_n) % MODBUS_PIPELINE_DEPTH];
+        p->id      = tx_count;
+        p->sent_us = now;
+        p->tx_us   = now;
+        p->tx_src  = TSTAMP_SRC_USER;
+        pending_n++;
+        tx_count++;
+        /* Software stamps are usually queued by now; draining also
+         * keeps the error queue from waking the select() below */
+        CollectTxStamp();
+    }
+    return sent;
+}
+
+static int32_t ControlRecvOnce(uint8_t *rx_buf, uint16_t buf_len, int32_t flags)
+{
+    return TSTAMP_Recv((uintptr_t)modbus_socket, rx_buf, buf_len, flags,
+                       &last_stamp.rx_us, &last_stamp.rx_src);
+}
+
+/*----------------------------------------------------------
+ * Helper: wait for the reply until the request times out.
+ * A late send stamp also wakes select(): collect it, wait
+ * on. A signal ends the wait (-1), so callers can stop.
+ *----------------------------------------------------------*/
+static int32_t ControlWait(uint8_t *rx_buf, uint16_t buf_len, uint64_t *now)
+{
+    uint64_t deadline = tx_time_us + ((uint64_t)MODBUS_TIMEOUT_SEC * 1000000U);
+    int32_t  len = -1;
+    int      ready;
+    fd_set   rd;
+    struct timeval tv;
+
+    do
+    {
+        CollectTxStamp();
+        if (*now >= deadline)
+        {
+            rx_stats.timeouts++;
+            break;
+        }
+        tv.tv_sec  = (long)((deadline - *now) / 1000000U);
+        tv.tv_usec = (long)((deadline - *now) % 1000000U);
+        FD_ZERO(&rd);
+        FD_SET(modbus_socket, &rd);
+        ready = select((int)modbus_socket + 1, &rd, NULL, NULL, &tv);
+        *now = TIME_NowUs();
+        if (ready < 0)
+        {
+            break;
+        }
+        if (ready > 0)
+        {
+            len = ControlRecvOnce(rx_buf, buf_len, RECV_NOWAIT);
+        }
+    } while ((len < 0) && ((ready == 0) || ERR_WOULDBLOCK()));
+    return len;
+}
+
+/*----------------------------------------------------------
+ * Helper: the oldest outstanding request is answered or
+ * given up; its stamp becomes last_stamp
+ *----------------------------------------------------------*/
+static void ControlRetire(void)
+{
+    const Pending_t *p = &pending[pending_head];
+
+    if (pending_n == 0U)
+    {
+        last_stamp.tx_us  = 0U;
+        last_stamp.tx_src = TSTAMP_SRC_NONE;
+        return;
+    }
+    last_id           = p->id;
+    last_stamp.tx_us  = p->tx_us;
+    last_stamp.tx_src = p->tx_src;
+    pending_head = (pending_head + 1U) % MODBUS_PIPELINE_DEPTH;
+    pending_n--;
+}
+
+static int32_t ControlRecv(uint8_t *rx_buf, uint16_t buf_len)
+{
+    int32_t  len;
+    uint64_t now = TIME_NowUs();
+
+    /* Nothing outstanding (the send failed): wait from now */
+    tx_time_us = (pending_n > 0U) ? pending[pending_head].sent_us : now;
+
+    if (low_latency.spin_budget_us == 0U)
+    {
+        len = ControlWait(rx_buf, buf_len, &now);
+    }
+    else
+    {
+        uint64_t start = now;
+        uint64_t until = start + low_latency.spin_budget_us;
+
+        do
+        {
+            len = ControlRecvOnce(rx_buf, buf_len, 0);
+            now = TIME_NowUs();
+        } while ((len < 0) && ERR_WOULDBLOCK() && (now < until));
+        rx_stats.spin_us += now - start;
+
+        if (len >= 0)
+        {
+            rx_stats.spin_hits++;
+        }
+        else if (ERR_WOULDBLOCK())
+        {
+            rx_stats.fallbacks++;       /* budget spent: wait for the reply */
+            len = ControlWait(rx_buf, buf_len, &now);
+        }
+    }
+
+    if (len > 0)
+    {
+        uint32_t rtt = (uint32_t)(now - tx_time_us);
+
+        CollectTxStamp();               /* hardware / late software stamp */
+        ControlRetire();
+
+        rx_stats.receives++;
+        rx_stats.rtt_sum_us += rtt;
+        rx_stats.rtt_min_us = (rtt < rx_stats.rtt_min_us) ? rtt : rx_stats.rtt_min_us;
+        rx_stats.rtt_max_us = (rtt > rx_stats.rtt_max_us) ? rtt : rx_stats.rtt_max_us;
+    }
+    else
+    {
+        ControlRetire();
+        last_stamp.rx_us  = 0U;
+        last_stamp.rx_src = TSTAMP_SRC_NONE;
+    }
+    return len;
+}
+
+void MODBUS_LastStamp(ModbusStamp_t *stamp)
+{
+    *stamp = last_stamp;
+}
+
+const ModbusRxStats_t *MODBUS_GetRxStats(void)
+{
+    return &rx_stats;
+}
+
+void MODBUS_ResetRxStats(void)
+{
+    (void)memset(&rx_stats, 0, sizeof(rx_stats));
+    rx_stats.rtt_min_us = UINT32_MAX;
+}
+
+void MODBUS_PrintRxStats(void)
+{
+    const ModbusRxStats_t *s = &rx_stats;
+
+    printf("\n====== CONTROL SOCKET (spin %lu us) ======\n",
+           (unsigned long)low_latency.spin_budget_us);
+    if (s->receives == 0U)
+    {
+        printf("  no replies (%llu timed out)\n", (unsigned long long)s->timeouts);
+        return;
+    }
+    printf("  round trip : min %lu us | avg %lu us | max %lu us (%llu replies)\n",
+           (unsigned long)s->rtt_min_us, (unsigned long)(s->rtt_sum_us / s->receives),
+           (unsigned long)s->rtt_max_us, (unsigned long long)s->receives);
+    if (low_latency.spin_budget_us > 0U)
+    {
+        printf("  spin hits  : %llu | fallbacks: %llu | spun %llu us (%lu us per reply)\n",
+               (unsigned long long)s->spin_hits, (unsigned long long)s->fallbacks,
+               (unsigned long long)s->spin_us,
+               (unsigned long)(s->spin_us / s->receives));
+        printf("  timeouts   : %llu\n", (unsigned long long)s->timeouts);
+    }
+}
+
+/*----------------------------------------------------------
+ * Frame builder: Read Holding / Input Registers (0x03 / 0x04)
+ *----------------------------------------------------------*/
+static uint16_t BuildRead(uint8_t *tx_buf, uint8_t slave_id, uint8_t func,
+                          uint16_t start_addr, uint16_t num_regs)
 {
-    uint8_t tx_buf[8U];
     uint16_t crc;
 
     tx_buf[0] = slave_id;
-    tx_buf[1] = MODBUS_FUNC_READ_HOLDING;
+    tx_buf[1] = func;
     tx_buf[2] = (uint8_t)(start_addr >> 8U);
     tx_buf[3] = (uint8_t)(start_addr & 0xFFU);
     tx_buf[4] = (uint8_t)(num_regs >> 8U);
@@ -74,10 +699,79 @@ int32_t MODBUS_ReadHolding(uint8_t slave_id, uint16_t start_addr,
     tx_buf[6] = (uint8_t)(crc & 0xFFU);
     tx_buf[7] = (uint8_t)(crc >> 8U);
 
-    (void)sendto(modbus_socket, (const char *)tx_buf, 8, 0,
-                 (struct sockaddr *)&modbus_target, modbus_target_len);
+    return 8U;
+}
+
+/*----------------------------------------------------------
+ * Helper: send a read request, receive into a pooled frame
+ *----------------------------------------------------------*/
+static Frame_t *ReadIntoFrame(uint8_t slave_id, uint8_t func,
+                              uint16_t start_addr, uint16_t num_regs)
+{
+    uint8_t tx_buf[8U];
+    Frame_t *frame = FRAME_Acquire();
+    int32_t len;
+
+    if (frame == NULL)
+    {
+        return NULL;
+    }
+
+    (void)BuildRead(tx_buf, slave_id, func, start_addr, num_regs);
+    (void)ControlSend(tx_buf, 8U);
+
+    /* Always the full-size buffer: an oversized datagram cannot overrun */
+    len = ControlRecv(frame->data, (uint16_t)sizeof(frame->data));
+    frame->len = (len > 0) ? (uint16_t)len : 0U;
+    frame->rx_us = (len > 0) ? last_stamp.rx_us : 0U;
+    frame->rx_src = (len > 0) ? last_stamp.rx_src : TSTAMP_SRC_NONE;
+    return frame;
+}
+
+/*----------------------------------------------------------
+ * Helper: validate a received frame against its request
+ *----------------------------------------------------------*/
+static ModbusStatus_t CheckFrame(const Frame_t *frame, uint8_t slave_id, uint8_t func,
+                                 uint16_t num_regs, uint8_t *ex_code)
+{
+    *ex_code = 0U;
+    if ((frame == NULL) || (frame->len == 0U))
+    {
+        return MODBUS_ERR_IO;
+    }
+    return MODBUS_CheckResponse(frame->data, (int32_t)frame->len, slave_id, func,
+                                num_regs, ex_code);
+}
+
+/*----------------------------------------------------------
+ * Helper: validate, then copy out the expected response
+ *----------------------------------------------------------*/
+static int32_t CopyOut(Frame_t *frame, uint8_t slave_id, uint8_t func,
+                       uint16_t num_regs, uint8_t *rx_buf)
+{
+    uint8_t        ex_code;
+    int32_t        len = -1;
+    ModbusStatus_t status = CheckFrame(frame, slave_id, func, num_regs, &ex_code);
+
+    if (Track(status, ex_code) == MODBUS_OK)
+    {
+        len = (int32_t)frame->len;
+        (void)memcpy(rx_buf, frame->data, frame->len);
+    }
+    FRAME_Release(frame);
+    return len;
+}
+
+/*----------------------------------------------------------
+ * 1) Read Holding Registers (0x03)
+ *    rx_buf must hold 5 + 2 x num_regs bytes
+ *----------------------------------------------------------*/
+int32_t MODBUS_ReadHolding(uint8_t slave_id, uint16_t start_addr,
+                           uint16_t num_regs, uint8_t *rx_buf)
+{
+    Frame_t *frame = ReadIntoFrame(slave_id, MODBUS_FUNC_READ_HOLDING, start_addr, num_regs);
 
-    return recvfrom(modbus_socket, (char *)rx_buf, 256, 0, NULL, NULL);
+    return CopyOut(frame, slave_id, MODBUS_FUNC_READ_HOLDING, num_regs, rx_buf);
 }
 
 /*----------------------------------------------------------
@@ -86,35 +780,62 @@ int32_t MODBUS_ReadHolding(uint8_t slave_id, uint16_t start_addr,
 int32_t MODBUS_ReadInput(uint8_t slave_id, uint16_t start_addr,
                          uint16_t num_regs, uint8_t *rx_buf)
 {
-    uint8_t tx_buf[8U];
-    uint16_t crc;
+    Frame_t *frame = ReadIntoFrame(slave_id, MODBUS_FUNC_READ_INPUT, start_addr, num_regs);
+    const struct sockaddr_in *to = Route(slave_id);
 
-    tx_buf[0] = slave_id;
-    tx_buf[1] = MODBUS_FUNC_READ_INPUT;
-    tx_buf[2] = (uint8_t)(start_addr >> 8U);
-    tx_buf[3] = (uint8_t)(start_addr & 0xFFU);
-    tx_buf[4] = (uint8_t)(num_regs >> 8U);
-    tx_buf[5] = (uint8_t)(num_regs & 0xFFU);
+    printf("[MODBUS] Sending to %s:%u | Function 0x%02X | Addr: %u | Count: %u\n",
+       inet_ntoa(to->sin_addr), (unsigned)ntohs(to->sin_port), MODBUS_FUNC_READ_INPUT,
+       start_addr, num_regs);
 
-    crc = MODBUS_CRC16(tx_buf, 6U);
-    tx_buf[6] = (uint8_t)(crc & 0xFFU);
-    tx_buf[7] = (uint8_t)(crc >> 8U);
+    return CopyOut(frame, slave_id, MODBUS_FUNC_READ_INPUT, num_regs, rx_buf);
+}
+
+/*----------------------------------------------------------
+ * Zero-copy read: validated view into a pooled frame
+ *----------------------------------------------------------*/
+int32_t MODBUS_ReadView(uint8_t slave_id, uint8_t func, uint16_t start_addr,
+                        uint16_t num_regs, ModbusView_t *view)
+{
+    Frame_t *frame = ReadIntoFrame(slave_id, func, start_addr, num_regs);
+
+    (void)memset(view, 0, sizeof(*view));
+
+    view->status = CheckFrame(frame, slave_id, func, num_regs, &view->ex_code);
+    if (Track(view->status, view->ex_code) != MODBUS_OK)
+    {
+        FRAME_Release(frame);
+        return -1;
+    }
 
-    (void)sendto(modbus_socket, (const char *)tx_buf, 8, 0,
-                 (struct sockaddr *)&modbus_target, modbus_target_len);
-    printf("[MODBUS] Sending to %s:%d | Function 0x%02X | Addr: %u | Count: %u\n",
-       DRIVE_IP_ADDR, DRIVE_PORT_UDP, tx_buf[1], start_addr, num_regs);
+    view->frame      = frame;
+    view->unit_id    = frame->data[0];
+    view->func       = frame->data[1];
+    view->byte_count = frame->data[2];
+    view->regs       = &frame->data[3];
+    view->reg_count  = num_regs;
+    view->stamp      = last_stamp;
+    return (int32_t)frame->len;
+}
 
-    return recvfrom(modbus_socket, (char *)rx_buf, 256, 0, NULL, NULL);  
+uint16_t MODBUS_ViewReg(const ModbusView_t *view, uint16_t index)
+{
+    return (uint16_t)(((uint16_t)view->regs[2U * index] << 8U) | view->regs[(2U * index) + 1U]);
+}
+
+void MODBUS_ViewRelease(ModbusView_t *view)
+{
+    FRAME_Release(view->frame);
+    view->frame = NULL;
+    view->regs = NULL;
+    view->reg_count = 0U;
 }
 
 /*----------------------------------------------------------
- * 3) Write Single Register (0x06)
+ * Frame builder: Write Single Register (0x06)
  *----------------------------------------------------------*/
-int32_t MODBUS_WriteSingle(uint8_t slave_id, uint16_t reg_addr,
-                           uint16_t value)
+static uint16_t BuildWriteSingle(uint8_t *tx_buf, uint8_t slave_id,
+                                 uint16_t reg_addr, uint16_t value)
 {
-    uint8_t tx_buf[8U];
     uint16_t crc;
 
     tx_buf[0] = slave_id;
@@ -128,19 +849,16 @@ int32_t MODBUS_WriteSingle(uint8_t slave_id, uint16_t reg_addr,
     tx_buf[6] = (uint8_t)(crc & 0xFFU);
     tx_buf[7] = (uint8_t)(crc >> 8U);
 
-    (void)sendto(modbus_socket, (const char *)tx_buf, 8, 0,
-                 (struct sockaddr *)&modbus_target, modbus_target_len);
-
-    return recvfrom(modbus_socket, (char *)tx_buf, 256, 0, NULL, NULL);
+    return 8U;
 }
 
 /*----------------------------------------------------------
- * 4) Write Multiple Registers (0x10)
+ * Frame builder: Write Multiple Registers (0x10)
  *----------------------------------------------------------*/
-int32_t MODBUS_WriteMultiple(uint8_t slave_id, uint16_t start_addr,
-                             uint16_t num_regs, const uint16_t *data)
+static uint16_t BuildWriteMultiple(uint8_t *tx_buf, uint8_t slave_id,
+                                   uint16_t start_addr, uint16_t num_regs,
+                                   const uint16_t *data)
 {
-    uint8_t tx_buf[260U];
     uint16_t i;
     uint16_t crc;
     uint16_t idx = 7U;
@@ -163,10 +881,254 @@ int32_t MODBUS_WriteMultiple(uint8_t slave_id, uint16_t start_addr,
     tx_buf[idx++] = (uint8_t)(crc & 0xFFU);
     tx_buf[idx++] = (uint8_t)(crc >> 8U);
 
-    (void)sendto(modbus_socket, (const char *)tx_buf, idx, 0,
-                 (struct sockaddr *)&modbus_target, modbus_target_len);
+    return idx;
+}
+
+/*----------------------------------------------------------
+ * 3) Write Single Register (0x06)
+ *----------------------------------------------------------*/
+int32_t MODBUS_WriteSingle(uint8_t slave_id, uint16_t reg_addr,
+                           uint16_t value)
+{
+    (void)MODBUS_SendWriteSingle(slave_id, reg_addr, value);
+
+    return MODBUS_ReceiveExpect(slave_id, MODBUS_FUNC_WRITE_SINGLE, 0U);
+}
+
+/*----------------------------------------------------------
+ * 4) Write Multiple Registers (0x10)
+ *----------------------------------------------------------*/
+int32_t MODBUS_WriteMultiple(uint8_t slave_id, uint16_t start_addr,
+                             uint16_t num_regs, const uint16_t *data)
+{
+    (void)MODBUS_SendWriteMultiple(slave_id, start_addr, num_regs, data);
+
+    return MODBUS_ReceiveExpect(slave_id, MODBUS_FUNC_WRITE_MULTIPLE, 0U);
+}
+
+/*----------------------------------------------------------
+ * 5) Send-only Write Single (0x06) - response collected later
+ *----------------------------------------------------------*/
+int32_t MODBUS_SendWriteSingle(uint8_t slave_id, uint16_t reg_addr,
+                               uint16_t value)
+{
+    uint8_t tx_buf[8U];
+    uint16_t len = BuildWriteSingle(tx_buf, slave_id, reg_addr, value);
+
+    return ControlSend(tx_buf, len);
+}
+
+/*----------------------------------------------------------
+ * 6) Send-only Write Multiple (0x10) - response collected later
+ *----------------------------------------------------------*/
+int32_t MODBUS_SendWriteMultiple(uint8_t slave_id, uint16_t start_addr,
+                                 uint16_t num_regs, const uint16_t *data)
+{
+    uint8_t tx_buf[260U];
+    uint16_t len = BuildWriteMultiple(tx_buf, slave_id, start_addr,
+                                      num_regs, data);
+
+    return ControlSend(tx_buf, len);
+}
+
+/*----------------------------------------------------------
+ * 7) Receive one pending response frame
+ *----------------------------------------------------------*/
+int32_t MODBUS_ReceiveResponse(uint8_t *rx_buf, uint16_t buf_len)
+{
+    return ControlRecv(rx_buf, buf_len);
+}
+
+/*----------------------------------------------------------
+ * 8) Receive one pending response and validate it
+ *----------------------------------------------------------*/
+int32_t MODBUS_ReceiveExpect(uint8_t slave_id, uint8_t func, uint16_t num_regs)
+{
+    Frame_t       *frame = FRAME_Acquire();
+    uint8_t        ex_code;
+    int32_t        len;
+    ModbusStatus_t status;
+
+    if (frame == NULL)
+    {
+        return -1;
+    }
+
+    len = MODBUS_ReceiveResponse(frame->data, (uint16_t)sizeof(frame->data));
+    frame->len = (len > 0) ? (uint16_t)len : 0U;
+
+    status = CheckFrame(frame, slave_id, func, num_regs, &ex_code);
+    if (Track(status, ex_code) != MODBUS_OK)
+    {
+        len = -1;
+    }
+    FRAME_Release(frame);
+    return len;
+}
+
+/*----------------------------------------------------------
+ * Non-blocking channels
+ *----------------------------------------------------------*/
+#define CHANNEL_SOCK(ch)   ((SOCKET)(ch)->sock)
+
+int32_t MODBUS_ChannelOpen(ModbusChannel_t *ch)
+{
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    ch->sock = (uintptr_t)INVALID_SOCKET;
+    ch->busy = 0U;
+    ch->unit_id = AXIS_UnitId(AXIS_PAN);
+
+    if (s == INVALID_SOCKET)
+    {
+        return -1;
+    }
+
+    /* Connected: only the drive's datagrams reach this socket */
+    if (connect(s, (const struct sockaddr *)Route(ch->unit_id), sizeof(struct sockaddr_in)) != 0)
+    {
+        (void)closesocket(s);
+        return -1;
+    }
+
+#ifdef _WIN32
+    {
+        u_long nb = 1UL;
+        (void)ioctlsocket(s, FIONBIO, &nb);
+    }
+#else
+    (void)fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    ch->sock = (uintptr_t)s;
+    return 0;
+}
+
+void MODBUS_ChannelClose(ModbusChannel_t *ch)
+{
+    if (CHANNEL_SOCK(ch) != INVALID_SOCKET)
+    {
+        (void)closesocket(CHANNEL_SOCK(ch));
+        ch->sock = (uintptr_t)INVALID_SOCKET;
+    }
+    ch->busy = 0U;
+}
+
+static int32_t ChannelSend(ModbusChannel_t *ch, const uint8_t *tx_buf, uint16_t len)
+{
+    int32_t sent;
+    uint8_t stale[MODBUS_MAX_RESP];
+
+    /* Re-connect when the unit is served from another endpoint */
+    if ((tx_buf[0] != ch->unit_id) &&
+        (connect(CHANNEL_SOCK(ch), (const struct sockaddr *)Route(tx_buf[0]),
+                 sizeof(struct sockaddr_in)) != 0))
+    {
+        ch->busy = 0U;
+        return -1;
+    }
+    ch->unit_id = tx_buf[0];
+
+    /* Drop a late reply to a request that already timed out */
+    while (recv(CHANNEL_SOCK(ch), (char *)stale, (int)sizeof(stale), 0) > 0)
+    {
+    }
+
+    sent = (int32_t)send(CHANNEL_SOCK(ch), (const char *)tx_buf, (int)len, 0);
+    ch->busy = (uint8_t)(sent == (int32_t)len);
+    return (sent == (int32_t)len) ? sent : -1;
+}
+
+int32_t MODBUS_ChannelSendRead(ModbusChannel_t *ch, uint8_t slave_id, uint8_t func,
+                               uint16_t start_addr, uint16_t num_regs)
+{
+    uint8_t tx_buf[8U];
+    uint16_t len = BuildRead(tx_buf, slave_id, func, start_addr, num_regs);
+
+    return ChannelSend(ch, tx_buf, len);
+}
+
+int32_t MODBUS_ChannelSendWriteSingle(ModbusChannel_t *ch, uint8_t slave_id,
+                                      uint16_t reg_addr, uint16_t value)
+{
+    uint8_t tx_buf[8U];
+    uint16_t len = BuildWriteSingle(tx_buf, slave_id, reg_addr, value);
+
+    return ChannelSend(ch, tx_buf, len);
+}
+
+int32_t MODBUS_ChannelSendWriteMultiple(ModbusChannel_t *ch, uint8_t slave_id,
+                                        uint16_t start_addr, uint16_t num_regs,
+                                        const uint16_t *data)
+{
+    uint8_t tx_buf[260U];
+    uint16_t len;
+
+    if (num_regs > 123U)
+    {
+        return -1;
+    }
+    len = BuildWriteMultiple(tx_buf, slave_id, start_addr, num_regs, data);
+    return ChannelSend(ch, tx_buf, len);
+}
+
+int32_t MODBUS_ChannelRecv(ModbusChannel_t *ch, uint8_t *rx_buf, uint16_t buf_len)
+{
+    int32_t len = (int32_t)recv(CHANNEL_SOCK(ch), (char *)rx_buf, (int)buf_len, 0);
+
+    if (len > 0)
+    {
+        ch->busy = 0U;
+        return len;
+    }
+
+#ifdef _WIN32
+    if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+#endif
+    {
+        return 0;
+    }
+
+    ch->busy = 0U;
+    return -1;
+}
+
+int32_t MODBUS_ChannelWait(ModbusChannel_t *const *chs, uint32_t count, uint32_t timeout_us)
+{
+    fd_set rd;
+    struct timeval tv;
+    SOCKET max_fd = 0;
+    uint32_t i;
+    uint32_t armed = 0U;
+
+    FD_ZERO(&rd);
+    for (i = 0U; i < count; i++)
+    {
+        if ((chs[i]->busy != 0U) && (CHANNEL_SOCK(chs[i]) != INVALID_SOCKET))
+        {
+            FD_SET(CHANNEL_SOCK(chs[i]), &rd);
+            max_fd = (CHANNEL_SOCK(chs[i]) > max_fd) ? CHANNEL_SOCK(chs[i]) : max_fd;
+            armed++;
+        }
+    }
+
+    tv.tv_sec  = (long)(timeout_us / 1000000U);
+    tv.tv_usec = (long)(timeout_us % 1000000U);
+
+    if (armed == 0U)
+    {
+        /* Nothing in flight: plain sleep until the next timer */
+#ifdef _WIN32
+        Sleep((DWORD)((timeout_us + 999U) / 1000U));
+        return 0;
+#else
+        return (int32_t)select(0, NULL, NULL, NULL, &tv);
+#endif
+    }
 
-    return recvfrom(modbus_socket, (char *)tx_buf, 256, 0, NULL, NULL);
+    return (int32_t)select((int)max_fd + 1, &rd, NULL, NULL, &tv);
 }
 
 /*----------------------------------------------------------
@@ -178,6 +1140,8 @@ void MODBUS_Close(void)
     {
         (void)closesocket(modbus_socket);
         modbus_socket = INVALID_SOCKET;
+#ifdef _WIN32
         (void)WSACleanup();
+#endif
     }
 }
@@ -2,13 +2,115 @@
 #define MODBUS_FUNCTIONS_H
 
 #include <stdint.h>
+#include "frame_pool.h"
+#include "net_timestamp.h"
+
+/*===========================================================
+ * Response Status
+ *===========================================================*/
+/* Outcome of validating a response against its request */
+typedef enum
+{
+    MODBUS_OK = 0,
+    MODBUS_ERR_IO,              /**< Nothing received / socket error     */
+    MODBUS_ERR_LENGTH,          /**< Size or byte count does not match   */
+    MODBUS_ERR_UNIT,            /**< Unit ID differs (stray packet)      */
+    MODBUS_ERR_FUNC,            /**< Function code differs (late packet) */
+    MODBUS_ERR_CRC,             /**< CRC16 check failed                  */
+    MODBUS_ERR_EXCEPTION        /**< Valid exception response (func|0x80) */
+} ModbusStatus_t;
+
+/* Exception codes carried by an exception response */
+#define MODBUS_EX_ILLEGAL_FUNCTION   (0x01U)
+#define MODBUS_EX_ILLEGAL_ADDRESS    (0x02U)
+#define MODBUS_EX_ILLEGAL_VALUE      (0x03U)
+#define MODBUS_EX_DEVICE_FAILURE     (0x04U)
+#define MODBUS_EX_ACKNOWLEDGE        (0x05U)
+#define MODBUS_EX_DEVICE_BUSY        (0x06U)
+#define MODBUS_EX_GATEWAY_PATH       (0x0AU)
+#define MODBUS_EX_GATEWAY_TARGET     (0x0BU)
+
+/*===========================================================
+ * Frame Views
+ *===========================================================*/
+/* Read-only view of a validated read response. The register words
+ * stay in the pooled frame; release the view to return the frame. */
+typedef struct
+{
+    Frame_t       *frame;        /**< Pooled buffer; NULL if invalid */
+    uint8_t        unit_id;
+    uint8_t        func;
+    uint8_t        byte_count;
+    const uint8_t *regs;         /**< Big-endian words, in place */
+    uint16_t       reg_count;
+    ModbusStatus_t status;       /**< Why the read failed, if it did */
+    uint8_t        ex_code;      /**< Exception code when status is EXCEPTION */
+    ModbusStamp_t  stamp;        /**< Request sent / reply received */
+} ModbusView_t;
+
+/*===========================================================
+ * Low-Latency Receive (control socket)
+ *===========================================================*/
+/* Opt-in busy polling for the blocking MODBUS_* calls of a fast
+ * cyclic loop. A receive spins on the non-blocking socket for up to
+ * spin_budget_us, so a reply that arrives within the budget is taken
+ * without a scheduler wake-up; after that it blocks as before, for at
+ * most MODBUS_TIMEOUT_SEC from the send. The
+ * spin burns its core: enable it only on a core the executive owns
+ * (CyclicConfig_t.cpu). */
+#ifndef MODBUS_SPIN_BUDGET_US
+    #define MODBUS_SPIN_BUDGET_US   (200U)
+#endif
+
+/**
+ * @brief Busy-poll settings
+ */
+typedef struct
+{
+    uint32_t spin_budget_us;     /**< Spin before blocking, 0 = off */
+    uint32_t busy_poll_us;       /**< SO_BUSY_POLL (Linux), 0 = leave */
+} ModbusLowLatency_t;
+
+/**
+ * @brief Control socket receive statistics
+ */
+typedef struct
+{
+    uint64_t receives;
+    uint64_t spin_hits;          /**< Reply taken while spinning */
+    uint64_t fallbacks;          /**< Budget spent, then blocked */
+    uint64_t timeouts;           /**< No reply within MODBUS_TIMEOUT_SEC */
+    uint64_t spin_us;            /**< Time spun: the CPU cost */
+    uint64_t rtt_sum_us;         /**< Request sent to reply taken */
+    uint32_t rtt_min_us;
+    uint32_t rtt_max_us;
+} ModbusRxStats_t;
+
+/*===========================================================
+ * Non-blocking Channels
+ *===========================================================*/
+/* A channel is a private UDP socket connected to the drive with at
+ * most one request in flight, so a response always belongs to the
+ * request last sent on that channel. Open one per concurrent
+ * sequence; MODBUS_ChannelWait multiplexes them on one thread. */
+typedef struct
+{
+    uintptr_t sock;          /**< Socket handle (SOCKET / int)   */
+    uint8_t   busy;          /**< Request sent, response pending */
+    uint8_t   unit_id;       /**< Unit whose endpoint it is connected to */
+} ModbusChannel_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*===========================================================
  * Function Prototypes
  *===========================================================*/
 
 /**
- * @brief  Initialize UDP socket for Modbus communication
+ * @brief  Initialize UDP socket for Modbus communication; requests
+ *         go to the endpoint of the axis owning their unit ID
  */
 void MODBUS_Init(void);
 
@@ -17,25 +119,111 @@ void MODBUS_Init(void);
  */
 void MODBUS_Close(void);
 
+/**
+ * @brief  Enable or disable busy polling on the control socket
+ *         (after MODBUS_Init)
+ * @return 0 if every setting was applied, -1 if SO_BUSY_POLL was
+ *         refused (spinning still applies) or there is no socket
+ */
+int32_t MODBUS_SetLowLatency(const ModbusLowLatency_t *cfg);
+
+/**
+ * @brief  Send and receive time of the last control socket
+ *         transaction (kernel stamps where available); the sample
+ *         time of its values is TSTAMP_Midpoint()
+ */
+void MODBUS_LastStamp(ModbusStamp_t *stamp);
+
+/**
+ * @brief  Receive statistics of the control socket
+ */
+const ModbusRxStats_t *MODBUS_GetRxStats(void);
+void MODBUS_ResetRxStats(void);
+void MODBUS_PrintRxStats(void);
+
+/**
+ * @brief  Modbus RTU CRC16 (table driven); a frame followed by its
+ *         CRC (low byte first) yields 0
+ */
+uint16_t MODBUS_CRC16(const uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief  Validate a response in one pass: length, unit ID, function
+ *         code (or exception), byte count, then CRC16
+ * @param  frame     Received bytes
+ * @param  len       Bytes received (negative = receive error)
+ * @param  slave_id  Unit ID the request was sent to
+ * @param  func      Function code of the request
+ * @param  num_regs  Registers requested (0x03 / 0x04 only)
+ * @param  ex_code   Set to the exception code for MODBUS_ERR_EXCEPTION, else 0
+ * @return MODBUS_OK if the frame answers the request
+ */
+ModbusStatus_t MODBUS_CheckResponse(const uint8_t *frame, int32_t len,
+                                    uint8_t slave_id, uint8_t func,
+                                    uint16_t num_regs, uint8_t *ex_code);
+
+/**
+ * @brief  As MODBUS_CheckResponse for a frame without CRC
+ *         (unit | PDU, e.g. a Modbus/TCP ADU minus its MBAP header)
+ */
+ModbusStatus_t MODBUS_CheckPdu(const uint8_t *frame, int32_t len,
+                               uint8_t slave_id, uint8_t func,
+                               uint16_t num_regs, uint8_t *ex_code);
+
+/**
+ * @brief  Status of the last blocking read / write / receive
+ * @param  ex_code  Optional; receives the exception code
+ */
+ModbusStatus_t MODBUS_LastStatus(uint8_t *ex_code);
+
+/**
+ * @brief  Short description of a status / exception code
+ */
+const char *MODBUS_StatusText(ModbusStatus_t status);
+const char *MODBUS_ExceptionText(uint8_t ex_code);
+
 /**
  * @brief  Read Holding Registers  (Function Code 0x03)
  * @param  slave_id   Modbus device address
  * @param  start_addr First register address
  * @param  num_regs   Number of registers to read
- * @param  rx_buf     Pointer to buffer for response
- * @return Number of bytes received or -1 on error
+ * @param  rx_buf     Response buffer, at least 5 + 2 x num_regs bytes
+ * @return Bytes copied to rx_buf (5 + 2 x num_regs) or -1 if the response
+ *         failed validation (see MODBUS_LastStatus)
  */
 int32_t MODBUS_ReadHolding(uint8_t slave_id, uint16_t start_addr,
                            uint16_t num_regs, uint8_t *rx_buf);
 
 /**
  * @brief  Read Input Registers  (Function Code 0x04)
+ *         (same buffer contract as MODBUS_ReadHolding)
  */
 int32_t MODBUS_ReadInput(uint8_t slave_id, uint16_t start_addr,
                          uint16_t num_regs, uint8_t *rx_buf);
 
+/**
+ * @brief  Read registers (func 0x03 / 0x04) into a pooled frame and
+ *         validate it with MODBUS_CheckResponse
+ * @param  view  Filled on success; release with MODBUS_ViewRelease
+ * @return Frame length, or -1 (view->status says why; view->frame is
+ *         NULL, nothing to release)
+ */
+int32_t MODBUS_ReadView(uint8_t slave_id, uint8_t func, uint16_t start_addr,
+                        uint16_t num_regs, ModbusView_t *view);
+
+/**
+ * @brief  Register word i of a view (host order)
+ */
+uint16_t MODBUS_ViewReg(const ModbusView_t *view, uint16_t index);
+
+/**
+ * @brief  Return the view's frame to the pool (safe on an empty view)
+ */
+void MODBUS_ViewRelease(ModbusView_t *view);
+
 /**
  * @brief  Write Single Register (Function Code 0x06)
+ * @return Echo length, or -1 if the echo failed validation
  */
 int32_t MODBUS_WriteSingle(uint8_t slave_id, uint16_t reg_addr,
                            uint16_t value);
@@ -46,4 +234,92 @@ int32_t MODBUS_WriteSingle(uint8_t slave_id, uint16_t reg_addr,
 int32_t MODBUS_WriteMultiple(uint8_t slave_id, uint16_t start_addr,
                              uint16_t num_regs, const uint16_t *data);
 
+/*-----------------------------------------------------------
+ * Split send / receive (pipelining several frames per RTT)
+ *-----------------------------------------------------------*/
+/* Each receive takes the reply to the oldest request not yet
+ * received, bounded by MODBUS_TIMEOUT_SEC from that request's send.
+ * Up to MODBUS_PIPELINE_DEPTH sends may be outstanding; a further
+ * send forgets the oldest. */
+#ifndef MODBUS_PIPELINE_DEPTH
+    #define MODBUS_PIPELINE_DEPTH   (8U)
+#endif
+
+/**
+ * @brief  Send Write Single Register (0x06) without waiting for the echo
+ * @return Number of bytes sent or -1 on error
+ */
+int32_t MODBUS_SendWriteSingle(uint8_t slave_id, uint16_t reg_addr,
+                               uint16_t value);
+
+/**
+ * @brief  Send Write Multiple Registers (0x10) without waiting for the reply
+ * @return Number of bytes sent or -1 on error
+ */
+int32_t MODBUS_SendWriteMultiple(uint8_t slave_id, uint16_t start_addr,
+                                 uint16_t num_regs, const uint16_t *data);
+
+/**
+ * @brief  Receive the next response frame for a previously sent request
+ * @param  rx_buf   Buffer for the response
+ * @param  buf_len  Size of rx_buf in bytes
+ * @return Number of bytes received or -1 on error
+ */
+int32_t MODBUS_ReceiveResponse(uint8_t *rx_buf, uint16_t buf_len);
+
+/**
+ * @brief  Receive the next response and validate it against the request
+ *         (num_regs for 0x03 / 0x04, 0 for writes)
+ * @return Bytes received, or -1 if missing or invalid (see MODBUS_LastStatus)
+ */
+int32_t MODBUS_ReceiveExpect(uint8_t slave_id, uint8_t func, uint16_t num_regs);
+
+/**
+ * @brief  Open a non-blocking channel to the endpoint of axis 1; a
+ *         send to a unit served elsewhere re-connects the channel
+ * @return 0 on success, -1 on error
+ */
+int32_t MODBUS_ChannelOpen(ModbusChannel_t *ch);
+
+/**
+ * @brief  Close a channel (safe on a closed channel)
+ */
+void MODBUS_ChannelClose(ModbusChannel_t *ch);
+
+/**
+ * @brief  Send a read request (func = 0x03 or 0x04) without waiting
+ * @return Number of bytes sent or -1 on error
+ */
+int32_t MODBUS_ChannelSendRead(ModbusChannel_t *ch, uint8_t slave_id, uint8_t func,
+                               uint16_t start_addr, uint16_t num_regs);
+
+/**
+ * @brief  Send Write Single Register (0x06) without waiting
+ */
+int32_t MODBUS_ChannelSendWriteSingle(ModbusChannel_t *ch, uint8_t slave_id,
+                                      uint16_t reg_addr, uint16_t value);
+
+/**
+ * @brief  Send Write Multiple Registers (0x10) without waiting
+ */
+int32_t MODBUS_ChannelSendWriteMultiple(ModbusChannel_t *ch, uint8_t slave_id,
+                                        uint16_t start_addr, uint16_t num_regs,
+                                        const uint16_t *data);
+
+/**
+ * @brief  Collect the response of a busy channel if it has arrived
+ * @return Bytes received, 0 if nothing yet, -1 on error
+ */
+int32_t MODBUS_ChannelRecv(ModbusChannel_t *ch, uint8_t *rx_buf, uint16_t buf_len);
+
+/**
+ * @brief  Wait until any busy channel is readable or the timeout expires
+ * @return Number of readable channels, 0 on timeout, -1 on error
+ */
+int32_t MODBUS_ChannelWait(ModbusChannel_t *const *chs, uint32_t count, uint32_t timeout_us);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* MODBUS_FUNCTIONS_H */
@@ -0,0 +1,664 @@
+#include "config.h"
+#include "modbus_tcp.h"
+#include "frame_pool.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+
+    #define SOCK_ERR()           WSAGetLastError()
+    #define ERR_WOULDBLOCK(e)    ((e) == WSAEWOULDBLOCK)
+    #define ERR_INPROGRESS(e)    ((e) == WSAEWOULDBLOCK)
+#else
+    #include <arpa/inet.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+
+    typedef int SOCKET;
+    #define INVALID_SOCKET       (-1)
+    #define closesocket          close
+    #define SOCK_ERR()           errno
+    #define ERR_WOULDBLOCK(e)    (((e) == EAGAIN) || ((e) == EWOULDBLOCK))
+    #define ERR_INPROGRESS(e)    ((e) == EINPROGRESS)
+#endif
+
+/* A peer reset must surface as an error, not SIGPIPE */
+#ifdef MSG_NOSIGNAL
+    #define SEND_FLAGS           MSG_NOSIGNAL
+#else
+    #define SEND_FLAGS           0
+#endif
+
+#define CONN_SOCK(c)             ((SOCKET)(c)->sock)
+#define REQUEST_TIMEOUT_US       ((uint64_t)MODBUS_TIMEOUT_SEC * 1000000U)
+
+static uint16_t Be16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8U) | p[1]);
+}
+
+/*----------------------------------------------------------
+ * Helper: wait until the socket is readable / writable
+ *----------------------------------------------------------*/
+static int32_t WaitSocket(SOCKET s, uint8_t for_write, uint32_t timeout_us)
+{
+    fd_set set;
+    struct timeval tv;
+
+    FD_ZERO(&set);
+    FD_SET(s, &set);
+    tv.tv_sec  = (long)(timeout_us / 1000000U);
+    tv.tv_usec = (long)(timeout_us % 1000000U);
+
+    return (int32_t)select((int)s + 1, (for_write != 0U) ? NULL : &set,
+                           (for_write != 0U) ? &set : NULL, NULL, &tv);
+}
+
+/*----------------------------------------------------------
+ * Helper: drop the link; outstanding requests stay queued
+ *----------------------------------------------------------*/
+static void LinkDown(MbTcpConn_t *conn)
+{
+    if (CONN_SOCK(conn) != INVALID_SOCKET)
+    {
+        (void)closesocket(CONN_SOCK(conn));
+        conn->sock = (uintptr_t)INVALID_SOCKET;
+    }
+    conn->rx_len = 0U;
+}
+
+/*----------------------------------------------------------
+ * Helper: connect with a bounded wait
+ *----------------------------------------------------------*/
+static int32_t Connect(MbTcpConn_t *conn)
+{
+    SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in target;
+    int one = 1;
+    int err = 0;
+    socklen_t err_len = (socklen_t)sizeof(err);
+
+    if (s == INVALID_SOCKET)
+    {
+        return -1;
+    }
+
+    /* Small request frames must leave immediately, not wait for Nagle */
+    (void)setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, (int)sizeof(one));
+    (void)setsockopt(s, SOL_SOCKET, SO_KEEPALIVE, (const char *)&one, (int)sizeof(one));
+
+#ifdef _WIN32
+    {
+        u_long nb = 1UL;
+        (void)ioctlsocket(s, FIONBIO, &nb);
+    }
+#else
+    (void)fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    (void)memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(conn->port);
+    target.sin_addr.s_addr = inet_addr(conn->ip);
+
+    if (connect(s, (struct sockaddr *)&target, sizeof(target)) != 0)
+    {
+        if (!ERR_INPROGRESS(SOCK_ERR()) ||
+            (WaitSocket(s, 1U, MBTCP_CONNECT_TIMEOUT_MS * 1000U) <= 0) ||
+            (getsockopt(s, SOL_SOCKET, SO_ERROR, (char *)&err, &err_len) != 0) ||
+            (err != 0))
+        {
+            (void)closesocket(s);
+            conn->retry_at_us = TIME_NowUs() + ((uint64_t)MBTCP_RETRY_MS * 1000U);
+            return -1;
+        }
+    }
+
+    conn->sock = (uintptr_t)s;
+    conn->rx_len = 0U;
+    return 0;
+}
+
+/*----------------------------------------------------------
+ * Helper: send a whole ADU on the non-blocking socket
+ *----------------------------------------------------------*/
+static int32_t SendAll(MbTcpConn_t *conn, const uint8_t *buf, uint16_t len)
+{
+    uint16_t off = 0U;
+
+    while (off < len)
+    {
+        int32_t n = (int32_t)send(CONN_SOCK(conn), (const char *)&buf[off],
+                                  (int)(len - off), SEND_FLAGS);
+        if (n > 0)
+        {
+            off = (uint16_t)(off + (uint16_t)n);
+        }
+        else if ((n < 0) && ERR_WOULDBLOCK(SOCK_ERR()) &&
+                 (WaitSocket(CONN_SOCK(conn), 1U, MBTCP_CONNECT_TIMEOUT_MS * 1000U) > 0))
+        {
+            /* send buffer drained, retry */
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    return (int32_t)len;
+}
+
+/*----------------------------------------------------------
+ * Helper: re-connect and replay every unanswered request
+ *----------------------------------------------------------*/
+static int32_t Reconnect(MbTcpConn_t *conn)
+{
+    uint32_t i;
+    uint64_t now = TIME_NowUs();
+
+    if ((now < conn->retry_at_us) || (Connect(conn) != 0))
+    {
+        return -1;
+    }
+    conn->reconnects++;
+
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        MbTcpSlot_t *slot = &conn->slot[i];
+
+        if (slot->state == MBTCP_SLOT_PENDING)
+        {
+            if (SendAll(conn, slot->tx, slot->tx_len) < 0)
+            {
+                LinkDown(conn);
+                return -1;
+            }
+            slot->deadline_us = now + REQUEST_TIMEOUT_US;
+            slot->tx_us = now;
+            conn->replays++;
+        }
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------
+ * Helper: queue one request (unit | PDU) and send it
+ *----------------------------------------------------------*/
+static int32_t Submit(MbTcpConn_t *conn, uint8_t slave_id, uint16_t num_regs,
+                      const uint8_t *pdu, uint16_t pdu_len)
+{
+    MbTcpSlot_t *slot = NULL;
+    uint32_t i;
+
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        if (conn->slot[i].state == MBTCP_SLOT_FREE)
+        {
+            slot = &conn->slot[i];
+            break;
+        }
+    }
+    if ((slot == NULL) || ((uint32_t)pdu_len + MBTCP_MBAP_LEN > MBTCP_MAX_ADU))
+    {
+        return -1;
+    }
+
+    slot->tid      = conn->next_tid++;
+    slot->unit_id  = slave_id;
+    slot->func     = pdu[0];
+    slot->num_regs = num_regs;
+    slot->resp     = NULL;
+    slot->status   = MODBUS_ERR_IO;
+    slot->ex_code  = 0U;
+
+    /* MBAP: transaction | protocol 0 | length (unit + PDU) | unit */
+    slot->tx[0] = (uint8_t)(slot->tid >> 8U);
+    slot->tx[1] = (uint8_t)(slot->tid & 0xFFU);
+    slot->tx[2] = 0U;
+    slot->tx[3] = 0U;
+    slot->tx[4] = (uint8_t)((pdu_len + 1U) >> 8U);
+    slot->tx[5] = (uint8_t)((pdu_len + 1U) & 0xFFU);
+    slot->tx[6] = slave_id;
+    (void)memcpy(&slot->tx[MBTCP_MBAP_LEN], pdu, pdu_len);
+    slot->tx_len = (uint16_t)(MBTCP_MBAP_LEN + pdu_len);
+
+    slot->state = MBTCP_SLOT_PENDING;
+    slot->tx_us = TIME_NowUs();
+    slot->deadline_us = slot->tx_us + REQUEST_TIMEOUT_US;
+
+    /* A request that cannot go out now is sent with the replay on reconnect */
+    if (CONN_SOCK(conn) == INVALID_SOCKET)
+    {
+        (void)Reconnect(conn);
+    }
+    else if (SendAll(conn, slot->tx, slot->tx_len) < 0)
+    {
+        LinkDown(conn);
+        (void)Reconnect(conn);
+    }
+    else
+    {
+        /* sent */
+    }
+    return (int32_t)i;
+}
+
+/*----------------------------------------------------------
+ * Helper: hand a reply (unit | PDU) to its request
+ *----------------------------------------------------------*/
+static int32_t Deliver(MbTcpConn_t *conn, uint16_t tid, const uint8_t *adu, uint16_t len)
+{
+    uint32_t i;
+
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        MbTcpSlot_t *slot = &conn->slot[i];
+
+        if ((slot->state == MBTCP_SLOT_PENDING) && (slot->tid == tid))
+        {
+            slot->resp = FRAME_Acquire();
+            if (slot->resp != NULL)
+            {
+                (void)memcpy(slot->resp->data, adu, len);
+                slot->resp->len = len;
+                slot->resp->rx_us = TIME_NowUs();
+                slot->resp->rx_src = TSTAMP_SRC_USER;
+                slot->status = MODBUS_CheckPdu(slot->resp->data, (int32_t)len, slot->unit_id,
+                                               slot->func, slot->num_regs, &slot->ex_code);
+            }
+            slot->state = MBTCP_SLOT_DONE;
+            return 1;
+        }
+    }
+
+    return 0;                           /* reply to an expired request */
+}
+
+/*----------------------------------------------------------
+ * Helper: split the byte stream into ADUs
+ *----------------------------------------------------------*/
+static int32_t ParseStream(MbTcpConn_t *conn)
+{
+    uint16_t off = 0U;
+    int32_t  done = 0;
+
+    while ((uint16_t)(conn->rx_len - off) >= MBTCP_MBAP_LEN)
+    {
+        const uint8_t *p = &conn->rx[off];
+        uint16_t len = Be16(&p[4]);    /* unit + PDU */
+
+        if ((Be16(&p[2]) != 0U) || (len < 2U) || (len > (MBTCP_MAX_ADU - 6U)))
+        {
+            LinkDown(conn);             /* lost framing: resynchronise */
+            return done;
+        }
+        if ((uint16_t)(conn->rx_len - off) < (uint16_t)(6U + len))
+        {
+            break;
+        }
+
+        done += Deliver(conn, Be16(&p[0]), &p[6], len);
+        off = (uint16_t)(off + 6U + len);
+    }
+
+    (void)memmove(conn->rx, &conn->rx[off], (size_t)(conn->rx_len - off));
+    conn->rx_len = (uint16_t)(conn->rx_len - off);
+    return done;
+}
+
+/*----------------------------------------------------------
+ * Connection control
+ *----------------------------------------------------------*/
+int32_t MBTCP_ConnOpen(MbTcpConn_t *conn, const char *ip, uint16_t port)
+{
+    (void)memset(conn, 0, sizeof(*conn));
+    conn->sock = (uintptr_t)INVALID_SOCKET;
+    (void)strncpy(conn->ip, ip, sizeof(conn->ip) - 1U);
+    conn->port = port;
+    conn->next_tid = 1U;
+
+    return Connect(conn);
+}
+
+void MBTCP_ConnClose(MbTcpConn_t *conn)
+{
+    uint32_t i;
+
+    LinkDown(conn);
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        FRAME_Release(conn->slot[i].resp);
+        conn->slot[i].resp = NULL;
+        conn->slot[i].state = MBTCP_SLOT_FREE;
+    }
+}
+
+/*----------------------------------------------------------
+ * Request submission
+ *----------------------------------------------------------*/
+int32_t MBTCP_SubmitRead(MbTcpConn_t *conn, uint8_t slave_id, uint8_t func,
+                         uint16_t start_addr, uint16_t num_regs)
+{
+    uint8_t pdu[5U];
+
+    pdu[0] = func;
+    pdu[1] = (uint8_t)(start_addr >> 8U);
+    pdu[2] = (uint8_t)(start_addr & 0xFFU);
+    pdu[3] = (uint8_t)(num_regs >> 8U);
+    pdu[4] = (uint8_t)(num_regs & 0xFFU);
+
+    return Submit(conn, slave_id, num_regs, pdu, 5U);
+}
+
+int32_t MBTCP_SubmitWriteSingle(MbTcpConn_t *conn, uint8_t slave_id,
+                                uint16_t reg_addr, uint16_t value)
+{
+    uint8_t pdu[5U];
+
+    pdu[0] = MODBUS_FUNC_WRITE_SINGLE;
+    pdu[1] = (uint8_t)(reg_addr >> 8U);
+    pdu[2] = (uint8_t)(reg_addr & 0xFFU);
+    pdu[3] = (uint8_t)(value >> 8U);
+    pdu[4] = (uint8_t)(value & 0xFFU);
+
+    return Submit(conn, slave_id, 0U, pdu, 5U);
+}
+
+int32_t MBTCP_SubmitWriteMultiple(MbTcpConn_t *conn, uint8_t slave_id,
+                                  uint16_t start_addr, uint16_t num_regs,
+                                  const uint16_t *data)
+{
+    uint8_t  pdu[6U + (2U * 123U)];
+    uint16_t i;
+    uint16_t idx = 6U;
+
+    if ((num_regs == 0U) || (num_regs > 123U))
+    {
+        return -1;
+    }
+
+    pdu[0] = MODBUS_FUNC_WRITE_MULTIPLE;
+    pdu[1] = (uint8_t)(start_addr >> 8U);
+    pdu[2] = (uint8_t)(start_addr & 0xFFU);
+    pdu[3] = (uint8_t)(num_regs >> 8U);
+    pdu[4] = (uint8_t)(num_regs & 0xFFU);
+    pdu[5] = (uint8_t)(num_regs * 2U);
+
+    for (i = 0U; i < num_regs; i++)
+    {
+        pdu[idx++] = (uint8_t)(data[i] >> 8U);
+        pdu[idx++] = (uint8_t)(data[i] & 0xFFU);
+    }
+
+    return Submit(conn, slave_id, 0U, pdu, idx);
+}
+
+/*----------------------------------------------------------
+ * Progress: receive, match, expire, reconnect
+ *----------------------------------------------------------*/
+int32_t MBTCP_Poll(MbTcpConn_t *conn, uint32_t timeout_us)
+{
+    int32_t  done = 0;
+    uint32_t i;
+    uint64_t now;
+
+    if ((CONN_SOCK(conn) == INVALID_SOCKET) && (MBTCP_Pending(conn) != 0U))
+    {
+        (void)Reconnect(conn);
+    }
+
+    if (CONN_SOCK(conn) != INVALID_SOCKET)
+    {
+        if (WaitSocket(CONN_SOCK(conn), 0U, timeout_us) > 0)
+        {
+            int32_t n = (int32_t)recv(CONN_SOCK(conn), (char *)&conn->rx[conn->rx_len],
+                                      (int)(sizeof(conn->rx) - conn->rx_len), 0);
+            if (n > 0)
+            {
+                conn->rx_len = (uint16_t)(conn->rx_len + (uint16_t)n);
+                done += ParseStream(conn);
+            }
+            else if ((n == 0) || !ERR_WOULDBLOCK(SOCK_ERR()))
+            {
+                /* Peer closed or reset: reconnect now, replay the rest */
+                LinkDown(conn);
+                (void)Reconnect(conn);
+            }
+            else
+            {
+                /* spurious wake-up */
+            }
+        }
+    }
+    else if (timeout_us > 0U)
+    {
+        /* Link down: wait for the retry time instead of spinning */
+        now = TIME_NowUs();
+        if (conn->retry_at_us > now)
+        {
+            uint64_t gap = conn->retry_at_us - now;
+            TIME_SleepUs((gap < timeout_us) ? (uint32_t)gap : timeout_us);
+        }
+    }
+    else
+    {
+        /* non-blocking poll while down */
+    }
+
+    now = TIME_NowUs();
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        MbTcpSlot_t *slot = &conn->slot[i];
+
+        if ((slot->state == MBTCP_SLOT_PENDING) && (now >= slot->deadline_us))
+        {
+            slot->status = MODBUS_ERR_IO;
+            slot->state = MBTCP_SLOT_DONE;
+            done++;
+        }
+    }
+    return done;
+}
+
+uint32_t MBTCP_Pending(const MbTcpConn_t *conn)
+{
+    uint32_t i;
+    uint32_t n = 0U;
+
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        n += (conn->slot[i].state == MBTCP_SLOT_PENDING) ? 1U : 0U;
+    }
+    return n;
+}
+
+ModbusStatus_t MBTCP_Take(MbTcpConn_t *conn, int32_t slot, ModbusView_t *view)
+{
+    MbTcpSlot_t   *s;
+    ModbusStatus_t status;
+
+    if (view != NULL)
+    {
+        (void)memset(view, 0, sizeof(*view));
+        view->status = MODBUS_ERR_IO;
+    }
+    if ((slot < 0) || (slot >= (int32_t)MBTCP_WINDOW) ||
+        (conn->slot[slot].state != MBTCP_SLOT_DONE))
+    {
+        return MODBUS_ERR_IO;
+    }
+
+    s = &conn->slot[slot];
+    status = s->status;
+
+    if (view != NULL)
+    {
+        view->stamp.tx_us  = s->tx_us;
+        view->stamp.tx_src = TSTAMP_SRC_USER;
+        if (s->resp != NULL)
+        {
+            view->stamp.rx_us  = s->resp->rx_us;
+            view->stamp.rx_src = s->resp->rx_src;
+        }
+    }
+
+    if ((view != NULL) && (status == MODBUS_OK))
+    {
+        view->frame      = s->resp;
+        view->unit_id    = s->resp->data[0];
+        view->func       = s->resp->data[1];
+        view->byte_count = s->resp->data[2];
+        view->regs       = &s->resp->data[3];
+        view->reg_count  = ((s->func == MODBUS_FUNC_READ_HOLDING) ||
+                            (s->func == MODBUS_FUNC_READ_INPUT)) ? s->num_regs : 0U;
+    }
+    else
+    {
+        FRAME_Release(s->resp);
+    }
+
+    if (view != NULL)
+    {
+        view->status  = status;
+        view->ex_code = s->ex_code;
+    }
+
+    s->resp = NULL;
+    s->state = MBTCP_SLOT_FREE;
+    return status;
+}
+
+/*----------------------------------------------------------
+ * Blocking calls on the default connection
+ *----------------------------------------------------------*/
+static MbTcpConn_t tcp_default;
+
+MbTcpConn_t *MBTCP_Default(void)
+{
+    return &tcp_default;
+}
+
+void MBTCP_Init(void)
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    (void)WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    if (MBTCP_ConnOpen(&tcp_default, DRIVE_IP_ADDR, DRIVE_PORT_TCP) != 0)
+    {
+        printf("[MBTCP] Connect to %s:%u failed, retrying on use\n",
+               DRIVE_IP_ADDR, (unsigned)DRIVE_PORT_TCP);
+    }
+}
+
+void MBTCP_Close(void)
+{
+    MBTCP_ConnClose(&tcp_default);
+#ifdef _WIN32
+    (void)WSACleanup();
+#endif
+}
+
+/*----------------------------------------------------------
+ * Helper: run one request to completion
+ *----------------------------------------------------------*/
+static int32_t Complete(int32_t slot, ModbusView_t *view)
+{
+    ModbusStatus_t status;
+
+    if (slot < 0)
+    {
+        (void)memset(view, 0, sizeof(*view));
+        view->status = MODBUS_ERR_IO;
+        printf("[MBTCP] Request window full\n");
+        return -1;
+    }
+
+    while (tcp_default.slot[slot].state == MBTCP_SLOT_PENDING)
+    {
+        uint64_t now = TIME_NowUs();
+        uint64_t due = tcp_default.slot[slot].deadline_us;
+
+        (void)MBTCP_Poll(&tcp_default, (due > now) ? (uint32_t)(due - now) : 0U);
+    }
+
+    status = MBTCP_Take(&tcp_default, slot, view);
+    if (status == MODBUS_ERR_EXCEPTION)
+    {
+        printf("[MBTCP] Exception 0x%02X (%s)\n", view->ex_code,
+               MODBUS_ExceptionText(view->ex_code));
+        return -1;
+    }
+    if (status != MODBUS_OK)
+    {
+        printf("[MBTCP] Rejected response: %s\n", MODBUS_StatusText(status));
+        return -1;
+    }
+    return (int32_t)view->frame->len;
+}
+
+int32_t MBTCP_ReadView(uint8_t slave_id, uint8_t func, uint16_t start_addr,
+                       uint16_t num_regs, ModbusView_t *view)
+{
+    return Complete(MBTCP_SubmitRead(&tcp_default, slave_id, func, start_addr, num_regs),
+                    view);
+}
+
+/*----------------------------------------------------------
+ * Helper: blocking read, copied out in the RTU layout
+ *----------------------------------------------------------*/
+static int32_t ReadCopy(uint8_t slave_id, uint8_t func, uint16_t start_addr,
+                        uint16_t num_regs, uint8_t *rx_buf)
+{
+    ModbusView_t view;
+    int32_t len = MBTCP_ReadView(slave_id, func, start_addr, num_regs, &view);
+
+    if (len > 0)
+    {
+        (void)memcpy(rx_buf, view.frame->data, (size_t)len);
+    }
+    MODBUS_ViewRelease(&view);
+    return len;
+}
+
+int32_t MBTCP_ReadHolding(uint8_t slave_id, uint16_t start_addr,
+                          uint16_t num_regs, uint8_t *rx_buf)
+{
+    return ReadCopy(slave_id, MODBUS_FUNC_READ_HOLDING, start_addr, num_regs, rx_buf);
+}
+
+int32_t MBTCP_ReadInput(uint8_t slave_id, uint16_t start_addr,
+                        uint16_t num_regs, uint8_t *rx_buf)
+{
+    return ReadCopy(slave_id, MODBUS_FUNC_READ_INPUT, start_addr, num_regs, rx_buf);
+}
+
+int32_t MBTCP_WriteSingle(uint8_t slave_id, uint16_t reg_addr, uint16_t value)
+{
+    ModbusView_t view;
+    int32_t len = Complete(MBTCP_SubmitWriteSingle(&tcp_default, slave_id, reg_addr, value),
+                           &view);
+
+    MODBUS_ViewRelease(&view);
+    return len;
+}
+
+int32_t MBTCP_WriteMultiple(uint8_t slave_id, uint16_t start_addr,
+                            uint16_t num_regs, const uint16_t *data)
+{
+    ModbusView_t view;
+    int32_t len = Complete(MBTCP_SubmitWriteMultiple(&tcp_default, slave_id, start_addr,
+                                                     num_regs, data), &view);
+
+    MODBUS_ViewRelease(&view);
+    return len;
+}
@@ -0,0 +1,162 @@
+#ifndef MODBUS_TCP_H
+#define MODBUS_TCP_H
+
+#include <stdint.h>
+#include "config.h"
+#include "modbus_functions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * Modbus/TCP Transport
+ *===========================================================*/
+/* One persistent connection per endpoint (TCP_NODELAY, keep-alive).
+ * Up to MBTCP_WINDOW requests are in flight at once and matched to
+ * their replies by MBAP transaction ID. If the connection drops it is
+ * re-established at once and every unanswered request is re-sent
+ * with its original transaction ID. Only requests whose reply was
+ * lost are replayed; a Modbus write carries the absolute value, and
+ * a repeated drive command re-issues the same command. */
+#ifndef MBTCP_WINDOW
+    #define MBTCP_WINDOW              (8U)
+#endif
+#ifndef MBTCP_CONNECT_TIMEOUT_MS
+    #define MBTCP_CONNECT_TIMEOUT_MS  (500U)
+#endif
+#ifndef MBTCP_RETRY_MS
+    #define MBTCP_RETRY_MS            (100U)  /* between failed connects */
+#endif
+
+#define MBTCP_MBAP_LEN     (7U)                  /* tid | pid | len | unit */
+#define MBTCP_MAX_ADU      (MODBUS_MAX_RESP)     /* 7 + 253 byte PDU      */
+
+/* Slot states */
+#define MBTCP_SLOT_FREE     (0U)
+#define MBTCP_SLOT_PENDING  (1U)
+#define MBTCP_SLOT_DONE     (2U)
+
+/**
+ * @brief One request of the in-flight window
+ */
+typedef struct
+{
+    uint16_t       tid;                  /**< MBAP transaction ID */
+    uint8_t        state;                /**< MBTCP_SLOT_*        */
+    uint8_t        unit_id;
+    uint8_t        func;
+    uint16_t       num_regs;             /**< Reads: registers requested */
+    uint16_t       tx_len;
+    uint8_t        tx[MBTCP_MAX_ADU];    /**< Request ADU, kept for replay */
+    uint64_t       deadline_us;
+    uint64_t       tx_us;                /**< Last (re-)sent, user space */
+    Frame_t       *resp;                 /**< unit | PDU, once DONE */
+    ModbusStatus_t status;
+    uint8_t        ex_code;
+} MbTcpSlot_t;
+
+/**
+ * @brief Connection to one Modbus/TCP endpoint
+ */
+typedef struct
+{
+    uintptr_t   sock;                    /**< SOCKET / int, invalid if down */
+    char        ip[16];
+    uint16_t    port;
+    uint16_t    next_tid;
+    uint64_t    retry_at_us;             /**< Earliest next connect attempt */
+    uint32_t    reconnects;              /**< Successful re-connects */
+    uint32_t    replays;                 /**< Requests re-sent after one */
+    uint16_t    rx_len;
+    uint8_t     rx[2U * MBTCP_MAX_ADU];  /**< Stream reassembly */
+    MbTcpSlot_t slot[MBTCP_WINDOW];
+} MbTcpConn_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Connect to ip:port (TCP_NODELAY, non-blocking)
+ * @return 0 on success, -1 if the first connect failed (the
+ *         connection is still usable; it retries on use)
+ */
+int32_t MBTCP_ConnOpen(MbTcpConn_t *conn, const char *ip, uint16_t port);
+
+/**
+ * @brief  Close the connection and drop every outstanding request
+ */
+void MBTCP_ConnClose(MbTcpConn_t *conn);
+
+/**
+ * @brief  Queue a read (func 0x03 / 0x04) and send it (or with the
+ *         replay once the link is back)
+ * @return Slot index, or -1 if the window is full
+ */
+int32_t MBTCP_SubmitRead(MbTcpConn_t *conn, uint8_t slave_id, uint8_t func,
+                         uint16_t start_addr, uint16_t num_regs);
+
+/**
+ * @brief  Queue a Write Single Register (0x06) and send it
+ */
+int32_t MBTCP_SubmitWriteSingle(MbTcpConn_t *conn, uint8_t slave_id,
+                                uint16_t reg_addr, uint16_t value);
+
+/**
+ * @brief  Queue a Write Multiple Registers (0x10, up to 123) and send it
+ */
+int32_t MBTCP_SubmitWriteMultiple(MbTcpConn_t *conn, uint8_t slave_id,
+                                  uint16_t start_addr, uint16_t num_regs,
+                                  const uint16_t *data);
+
+/**
+ * @brief  Receive and match replies, expire requests, reconnect and
+ *         replay after a drop. Waits at most timeout_us for data.
+ * @return Requests completed by this call (replies and timeouts)
+ */
+int32_t MBTCP_Poll(MbTcpConn_t *conn, uint32_t timeout_us);
+
+/**
+ * @brief  Outstanding (sent, unanswered) requests
+ */
+uint32_t MBTCP_Pending(const MbTcpConn_t *conn);
+
+/**
+ * @brief  Collect a DONE slot and free it
+ * @param  view  Reads: validated view in the RTU layout (regs at
+ *               frame[3]); release with MODBUS_ViewRelease. May be
+ *               NULL to discard the reply. view->stamp holds send and
+ *               receive time, taken in user space (a TCP segment
+ *               has no per-reply kernel stamp).
+ * @return Slot status (MODBUS_ERR_IO if the request timed out)
+ */
+ModbusStatus_t MBTCP_Take(MbTcpConn_t *conn, int32_t slot, ModbusView_t *view);
+
+/*-----------------------------------------------------------
+ * Blocking calls on the default connection
+ * (DRIVE_IP_ADDR:DRIVE_PORT_TCP), same contracts as MODBUS_*;
+ * response frames are unit | PDU, i.e. the RTU layout without CRC
+ *-----------------------------------------------------------*/
+void    MBTCP_Init(void);
+void    MBTCP_Close(void);
+int32_t MBTCP_ReadHolding(uint8_t slave_id, uint16_t start_addr,
+                          uint16_t num_regs, uint8_t *rx_buf);
+int32_t MBTCP_ReadInput(uint8_t slave_id, uint16_t start_addr,
+                        uint16_t num_regs, uint8_t *rx_buf);
+int32_t MBTCP_ReadView(uint8_t slave_id, uint8_t func, uint16_t start_addr,
+                       uint16_t num_regs, ModbusView_t *view);
+int32_t MBTCP_WriteSingle(uint8_t slave_id, uint16_t reg_addr, uint16_t value);
+int32_t MBTCP_WriteMultiple(uint8_t slave_id, uint16_t start_addr,
+                            uint16_t num_regs, const uint16_t *data);
+
+/**
+ * @brief  The default connection (pipelining on the blocking link)
+ */
+MbTcpConn_t *MBTCP_Default(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODBUS_TCP_H */
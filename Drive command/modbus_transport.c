@@ -0,0 +1,829 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* sendmmsg */
+#endif
+
+#include "config.h"
+#include "modbus_transport.h"
+#include "frame_pool.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+
+    #define SOCK_ERR()           WSAGetLastError()
+    #define ERR_WOULDBLOCK(e)    ((e) == WSAEWOULDBLOCK)
+#else
+    #include <arpa/inet.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <sys/uio.h>
+    #include <netinet/in.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+
+    typedef int SOCKET;
+    #define INVALID_SOCKET       (-1)
+    #define closesocket          close
+    #define SOCK_ERR()           errno
+    #define ERR_WOULDBLOCK(e)    (((e) == EAGAIN) || ((e) == EWOULDBLOCK))
+#endif
+
+#define T_SOCK(t)                ((SOCKET)(t)->sock)
+#define REQUEST_TIMEOUT_US       ((uint64_t)MODBUS_TIMEOUT_SEC * 1000000U)
+
+static uint8_t IsRead(uint8_t func)
+{
+    return (uint8_t)((func == MODBUS_FUNC_READ_HOLDING) || (func == MODBUS_FUNC_READ_INPUT));
+}
+
+/*----------------------------------------------------------
+ * Helper: complete a request with a (pooled) response
+ *----------------------------------------------------------*/
+static void Finish(ModbusReq_t *req, Frame_t *frame, ModbusStatus_t status, uint8_t ex_code)
+{
+    if (frame != NULL)
+    {
+        req->stamp.rx_us  = frame->rx_us;
+        req->stamp.rx_src = frame->rx_src;
+    }
+
+    (void)memset(&req->view, 0, sizeof(req->view));
+    req->view.status  = status;
+    req->view.ex_code = ex_code;
+    req->view.stamp   = req->stamp;
+
+    if ((status == MODBUS_OK) && (frame != NULL) && (IsRead(req->func) != 0U))
+    {
+        /* unit | func | byte count | regs, whatever the wire format */
+        req->view.frame      = frame;
+        req->view.unit_id    = frame->data[0];
+        req->view.func       = frame->data[1];
+        req->view.byte_count = frame->data[2];
+        req->view.regs       = &frame->data[3];
+        req->view.reg_count  = req->count;
+    }
+    else
+    {
+        FRAME_Release(frame);           /* write echoes carry no data */
+    }
+    req->done = 1U;
+}
+
+/*----------------------------------------------------------
+ * Encoders
+ *----------------------------------------------------------*/
+static uint16_t BuildPdu(const ModbusReq_t *req, uint8_t *pdu)
+{
+    uint16_t i;
+    uint16_t idx = 5U;
+    uint16_t word = (IsRead(req->func) != 0U) ? req->count
+                  : ((req->func == MODBUS_FUNC_WRITE_SINGLE) ? req->data[0] : req->count);
+
+    pdu[0] = req->func;
+    pdu[1] = (uint8_t)(req->addr >> 8U);
+    pdu[2] = (uint8_t)(req->addr & 0xFFU);
+    pdu[3] = (uint8_t)(word >> 8U);
+    pdu[4] = (uint8_t)(word & 0xFFU);
+
+    if (req->func == MODBUS_FUNC_WRITE_MULTIPLE)
+    {
+        if ((req->count == 0U) || (req->count > 123U))
+        {
+            return 0U;
+        }
+        pdu[idx++] = (uint8_t)(req->count * 2U);
+        for (i = 0U; i < req->count; i++)
+        {
+            pdu[idx++] = (uint8_t)(req->data[i] >> 8U);
+            pdu[idx++] = (uint8_t)(req->data[i] & 0xFFU);
+        }
+    }
+    return idx;
+}
+
+#if TRANSPORT_HAS(TRANSPORT_RTU_UDP)
+/* unit | PDU | CRC16 (low byte first) */
+static int32_t EncodeRtu(const ModbusReq_t *req, uint16_t tid, uint8_t *out)
+{
+    uint16_t n = BuildPdu(req, &out[1]);
+    uint16_t crc;
+
+    (void)tid;
+    if (n == 0U)
+    {
+        return -1;
+    }
+    out[0] = req->unit_id;
+    crc = MODBUS_CRC16(out, (uint16_t)(n + 1U));
+    out[n + 1U] = (uint8_t)(crc & 0xFFU);
+    out[n + 2U] = (uint8_t)(crc >> 8U);
+    return (int32_t)n + 3;
+}
+#endif
+
+#if TRANSPORT_HAS(TRANSPORT_MBAP_UDP) || TRANSPORT_HAS(TRANSPORT_MBAP_TCP)
+/* transaction | protocol 0 | length (unit + PDU) | unit | PDU */
+static int32_t EncodeMbap(const ModbusReq_t *req, uint16_t tid, uint8_t *out)
+{
+    uint16_t n = BuildPdu(req, &out[MBTCP_MBAP_LEN]);
+
+    if (n == 0U)
+    {
+        return -1;
+    }
+    out[0] = (uint8_t)(tid >> 8U);
+    out[1] = (uint8_t)(tid & 0xFFU);
+    out[2] = 0U;
+    out[3] = 0U;
+    out[4] = (uint8_t)((n + 1U) >> 8U);
+    out[5] = (uint8_t)((n + 1U) & 0xFFU);
+    out[6] = req->unit_id;
+    return (int32_t)n + (int32_t)MBTCP_MBAP_LEN;
+}
+#endif
+
+/*----------------------------------------------------------
+ * In-flight window of the UDP kinds, oldest first
+ *----------------------------------------------------------*/
+typedef int32_t (*Encoder_t)(const ModbusReq_t *req, uint16_t tid, uint8_t *out);
+typedef int32_t (*Matcher_t)(Transport_t *t, Frame_t *frame);
+
+static void Retire(Transport_t *t, uint32_t idx)
+{
+    uint32_t i;
+
+    for (i = idx + 1U; i < t->inflight_n; i++)
+    {
+        t->inflight[i - 1U] = t->inflight[i];
+    }
+    t->inflight_n--;
+}
+
+/*----------------------------------------------------------
+ * Helper: true if an RTU reply to a could also answer b. An RTU
+ * reply carries no transaction ID, and an exception reply
+ * (unit | func|0x80 | code) neither address nor size, so any two
+ * requests with the same unit and function look alike.
+ *----------------------------------------------------------*/
+static bool RtuAmbiguous(const ModbusReq_t *a, const ModbusReq_t *b)
+{
+    return (a->unit_id == b->unit_id) && (a->func == b->func);
+}
+
+static int32_t TrackWith(Transport_t *t, ModbusReq_t *req, uint8_t *out,
+                         Encoder_t encode, uint64_t now)
+{
+    int32_t  len;
+    uint32_t i;
+
+    if (t->inflight_n >= TRANSPORT_WINDOW)
+    {
+        return -1;
+    }
+
+    /* RTU: at most one request per unit and function in flight; the
+     * next waits like a full window, so the batch keeps its order */
+    for (i = 0U; (t->kind == TRANSPORT_RTU_UDP) && (i < t->inflight_n); i++)
+    {
+        if (RtuAmbiguous(req, t->inflight[i]))
+        {
+            return -1;
+        }
+    }
+
+    req->done = 0U;
+    req->tid  = t->next_tid++;
+    (void)memset(&req->stamp, 0, sizeof(req->stamp));
+    req->stamp.tx_us  = now;            /* until the kernel stamp arrives */
+    req->stamp.tx_src = TSTAMP_SRC_USER;
+    len = encode(req, req->tid, out);
+    if (len < 0)
+    {
+        Finish(req, NULL, MODBUS_ERR_LENGTH, 0U);
+        return 0;
+    }
+    req->deadline_us = now + REQUEST_TIMEOUT_US;
+    t->inflight[t->inflight_n++] = req;
+    return len;
+}
+
+int32_t TRANSPORT_Track(Transport_t *t, ModbusReq_t *req, uint8_t *out)
+{
+    return TrackWith(t, req, out, t->ops->encode, TIME_NowUs());
+}
+
+void TRANSPORT_Abort(Transport_t *t, ModbusReq_t *req, ModbusStatus_t status)
+{
+    uint32_t i;
+
+    for (i = 0U; i < t->inflight_n; i++)
+    {
+        if (t->inflight[i] == req)
+        {
+            Finish(req, NULL, status, 0U);
+            Retire(t, i);
+            return;
+        }
+    }
+}
+
+int32_t TRANSPORT_Expire(Transport_t *t, uint64_t now_us)
+{
+    int32_t  done = 0;
+    uint32_t i;
+
+    for (i = 0U; i < t->inflight_n;)
+    {
+        if (now_us >= t->inflight[i]->deadline_us)
+        {
+            Finish(t->inflight[i], NULL, MODBUS_ERR_IO, 0U);
+            Retire(t, i);
+            done++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return done;
+}
+
+#if TRANSPORT_HAS(TRANSPORT_RTU_UDP) || TRANSPORT_HAS(TRANSPORT_MBAP_UDP)
+/*----------------------------------------------------------
+ * UDP transports: connected socket, bounded in-flight window
+ *----------------------------------------------------------*/
+
+static int32_t UdpOpen(Transport_t *t, const char *ip, uint16_t port)
+{
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    struct sockaddr_in target;
+
+    if (s == INVALID_SOCKET)
+    {
+        return -1;
+    }
+
+    (void)memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    target.sin_addr.s_addr = inet_addr(ip);
+
+    if (connect(s, (struct sockaddr *)&target, sizeof(target)) != 0)
+    {
+        (void)closesocket(s);
+        return -1;
+    }
+
+#ifdef _WIN32
+    {
+        u_long nb = 1UL;
+        (void)ioctlsocket(s, FIONBIO, &nb);
+    }
+#else
+    (void)fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    t->sock = (uintptr_t)s;
+    t->stamp_src = TSTAMP_Enable(t->sock);
+    return 0;
+}
+
+/*----------------------------------------------------------
+ * Helper: hand kernel send stamps to their requests. Run
+ * before replies are matched, so a request is stamped before
+ * it completes; also clears the error queue that would keep
+ * select() awake.
+ *----------------------------------------------------------*/
+static void UdpCollectTx(Transport_t *t)
+{
+    uint32_t ids[TRANSPORT_WINDOW];
+    uint64_t us[TRANSPORT_WINDOW];
+    uint8_t  src[TRANSPORT_WINDOW];
+    uint32_t n;
+    uint32_t i;
+    uint32_t k;
+
+    if (t->stamp_src < TSTAMP_SRC_SOFTWARE)
+    {
+        return;
+    }
+    do
+    {
+        n = TSTAMP_ReadTx(t->sock, ids, us, src, TRANSPORT_WINDOW);
+        for (i = 0U; i < n; i++)
+        {
+            for (k = 0U; k < t->inflight_n; k++)
+            {
+                if (t->inflight[k]->tx_id == ids[i])
+                {
+                    t->inflight[k]->stamp.tx_us  = us[i];
+                    t->inflight[k]->stamp.tx_src = src[i];
+                    break;
+                }
+            }
+        }
+    } while (n == TRANSPORT_WINDOW);
+}
+
+static void UdpClose(Transport_t *t)
+{
+    while (t->inflight_n > 0U)
+    {
+        Finish(t->inflight[0], NULL, MODBUS_ERR_IO, 0U);
+        Retire(t, 0U);
+    }
+    if (T_SOCK(t) != INVALID_SOCKET)
+    {
+        (void)closesocket(T_SOCK(t));
+        t->sock = (uintptr_t)INVALID_SOCKET;
+    }
+}
+
+static int32_t UdpSendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n,
+                            Encoder_t encode)
+{
+    uint8_t      tx[TRANSPORT_WINDOW][MBTCP_MAX_ADU];
+    uint16_t     tx_len[TRANSPORT_WINDOW];
+    ModbusReq_t *batch[TRANSPORT_WINDOW];
+    uint32_t     taken;
+    uint32_t     count = 0U;
+    uint32_t     sent = 0U;
+    uint32_t     k;
+    uint64_t     now = TIME_NowUs();
+
+    /* Encode everything that fits the window */
+    for (taken = 0U; taken < n; taken++)
+    {
+        int32_t len = TrackWith(t, reqs[taken], tx[count], encode, now);
+
+        if (len < 0)
+        {
+            break;                      /* window full */
+        }
+        if (len > 0)
+        {
+            tx_len[count] = (uint16_t)len;
+            batch[count] = reqs[taken];
+            count++;
+        }
+    }
+
+#if defined(__linux__)
+    /* One system call for the whole batch */
+    if (count > 0U)
+    {
+        struct mmsghdr msgs[TRANSPORT_WINDOW];
+        struct iovec   iov[TRANSPORT_WINDOW];
+        int            rc;
+
+        (void)memset(msgs, 0, sizeof(msgs));
+        for (k = 0U; k < count; k++)
+        {
+            iov[k].iov_base = tx[k];
+            iov[k].iov_len  = tx_len[k];
+            msgs[k].msg_hdr.msg_iov    = &iov[k];
+            msgs[k].msg_hdr.msg_iovlen = 1U;
+        }
+        rc = sendmmsg(T_SOCK(t), msgs, count, 0);
+        sent = (rc > 0) ? (uint32_t)rc : 0U;
+    }
+#else
+    for (k = 0U; k < count; k++)
+    {
+        if (send(T_SOCK(t), (const char *)tx[k], (int)tx_len[k], 0) != (int)tx_len[k])
+        {
+            break;
+        }
+        sent++;
+    }
+#endif
+
+    for (k = 0U; k < sent; k++)
+    {
+        batch[k]->tx_id = t->tx_count++;
+    }
+    for (k = sent; k < count; k++)
+    {
+        TRANSPORT_Abort(t, batch[k], MODBUS_ERR_IO);
+    }
+    UdpCollectTx(t);
+    return (int32_t)taken;
+}
+
+static int32_t UdpPoll(Transport_t *t, uint32_t timeout_us, Matcher_t match)
+{
+    int32_t  done = 0;
+    fd_set   rd;
+    struct timeval tv;
+
+    if (t->inflight_n == 0U)
+    {
+        return 0;
+    }
+
+    UdpCollectTx(t);
+    FD_ZERO(&rd);
+    FD_SET(T_SOCK(t), &rd);
+    tv.tv_sec  = (long)(timeout_us / 1000000U);
+    tv.tv_usec = (long)(timeout_us % 1000000U);
+
+    if (select((int)T_SOCK(t) + 1, &rd, NULL, NULL, &tv) > 0)
+    {
+        UdpCollectTx(t);
+
+        /* Drain every datagram that is already queued */
+        while (t->inflight_n > 0U)
+        {
+            Frame_t *frame = FRAME_Acquire();
+            int32_t  len;
+
+            if (frame == NULL)
+            {
+                break;
+            }
+            len = TSTAMP_Recv(t->sock, frame->data, (uint16_t)sizeof(frame->data), 0,
+                              &frame->rx_us, &frame->rx_src);
+            if (len <= 0)
+            {
+                FRAME_Release(frame);
+                break;
+            }
+            frame->len = (uint16_t)len;
+            done += match(t, frame);
+        }
+    }
+
+    return done + TRANSPORT_Expire(t, TIME_NowUs());
+}
+#endif
+
+#if TRANSPORT_HAS(TRANSPORT_RTU_UDP)
+/*----------------------------------------------------------
+ * RTU over UDP: no transaction ID, replies are matched to the
+ * request they answer (unit, function, size, write echo); the
+ * window holds no two requests a reply could both answer
+ *----------------------------------------------------------*/
+static bool RtuEchoMatches(const ModbusReq_t *req, const uint8_t *p)
+{
+    uint16_t addr = (uint16_t)(((uint16_t)p[2] << 8U) | p[3]);
+    uint16_t word = (uint16_t)(((uint16_t)p[4] << 8U) | p[5]);
+
+    if (IsRead(req->func) != 0U)
+    {
+        return true;
+    }
+    return (addr == req->addr) &&
+           (word == ((req->func == MODBUS_FUNC_WRITE_SINGLE) ? req->data[0] : req->count));
+}
+
+static int32_t MatchRtu(Transport_t *t, Frame_t *frame)
+{
+    uint32_t i;
+    uint8_t  ex_code;
+
+    /* One CRC pass per datagram, not per candidate */
+    if ((frame->len < 5U) || (MODBUS_CRC16(frame->data, frame->len) != 0U))
+    {
+        FRAME_Release(frame);
+        return 0;
+    }
+
+    for (i = 0U; i < t->inflight_n; i++)
+    {
+        ModbusReq_t *req = t->inflight[i];
+        ModbusStatus_t st = MODBUS_CheckPdu(frame->data, (int32_t)frame->len - 2,
+                                            req->unit_id, req->func,
+                                            (IsRead(req->func) != 0U) ? req->count : 0U,
+                                            &ex_code);
+        if (((st == MODBUS_OK) && RtuEchoMatches(req, frame->data)) ||
+            (st == MODBUS_ERR_EXCEPTION))
+        {
+            Finish(req, frame, st, ex_code);
+            Retire(t, i);
+            return 1;
+        }
+    }
+
+    FRAME_Release(frame);               /* stray or late */
+    return 0;
+}
+
+int32_t TRANSPORT_RtuUdp_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n)
+{
+    return UdpSendBatch(t, reqs, n, EncodeRtu);
+}
+
+int32_t TRANSPORT_RtuUdp_Poll(Transport_t *t, uint32_t timeout_us)
+{
+    return UdpPoll(t, timeout_us, MatchRtu);
+}
+
+static const TransportOps_t rtu_udp_ops =
+{
+    "rtu-udp", UdpOpen, UdpClose, EncodeRtu, MatchRtu,
+    TRANSPORT_RtuUdp_SendBatch, TRANSPORT_RtuUdp_Poll
+};
+#endif
+
+#if TRANSPORT_HAS(TRANSPORT_MBAP_UDP)
+/*----------------------------------------------------------
+ * MBAP over UDP: matched by transaction ID, no CRC
+ *----------------------------------------------------------*/
+static int32_t MatchMbap(Transport_t *t, Frame_t *frame)
+{
+    const uint8_t *p = frame->data;
+    uint16_t tid = (uint16_t)(((uint16_t)p[0] << 8U) | p[1]);
+    uint16_t len = (uint16_t)(((uint16_t)p[4] << 8U) | p[5]);
+    uint32_t i;
+    uint8_t  ex_code;
+
+    if ((frame->len < 9U) || (p[2] != 0U) || (p[3] != 0U) ||
+        (len != (uint16_t)(frame->len - 6U)))
+    {
+        FRAME_Release(frame);
+        return 0;
+    }
+
+    for (i = 0U; i < t->inflight_n; i++)
+    {
+        ModbusReq_t *req = t->inflight[i];
+
+        if (req->tid == tid)
+        {
+            ModbusStatus_t st;
+
+            /* Drop the header so the view sees unit | PDU */
+            (void)memmove(frame->data, &frame->data[6], len);
+            frame->len = len;
+            st = MODBUS_CheckPdu(frame->data, (int32_t)len, req->unit_id, req->func,
+                                 (IsRead(req->func) != 0U) ? req->count : 0U, &ex_code);
+            Finish(req, frame, st, ex_code);
+            Retire(t, i);
+            return 1;
+        }
+    }
+
+    FRAME_Release(frame);               /* reply to an expired request */
+    return 0;
+}
+
+int32_t TRANSPORT_MbapUdp_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n)
+{
+    return UdpSendBatch(t, reqs, n, EncodeMbap);
+}
+
+int32_t TRANSPORT_MbapUdp_Poll(Transport_t *t, uint32_t timeout_us)
+{
+    return UdpPoll(t, timeout_us, MatchMbap);
+}
+
+static const TransportOps_t mbap_udp_ops =
+{
+    "mbap-udp", UdpOpen, UdpClose, EncodeMbap, MatchMbap,
+    TRANSPORT_MbapUdp_SendBatch, TRANSPORT_MbapUdp_Poll
+};
+#endif
+
+#if TRANSPORT_HAS(TRANSPORT_MBAP_TCP)
+/*----------------------------------------------------------
+ * MBAP over TCP: the persistent connection of modbus_tcp.c
+ *----------------------------------------------------------*/
+static int32_t TcpOpen(Transport_t *t, const char *ip, uint16_t port)
+{
+    return MBTCP_ConnOpen(&t->tcp, ip, port);
+}
+
+static void TcpClose(Transport_t *t)
+{
+    uint32_t i;
+
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        if (t->tcp_req[i] != NULL)
+        {
+            Finish(t->tcp_req[i], NULL, MODBUS_ERR_IO, 0U);
+            t->tcp_req[i] = NULL;
+        }
+    }
+    MBTCP_ConnClose(&t->tcp);
+}
+
+int32_t TRANSPORT_MbapTcp_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n)
+{
+    uint32_t k;
+
+    for (k = 0U; k < n; k++)
+    {
+        ModbusReq_t *req = reqs[k];
+        int32_t slot;
+
+        if ((req->func == MODBUS_FUNC_WRITE_MULTIPLE) &&
+            ((req->count == 0U) || (req->count > 123U)))
+        {
+            Finish(req, NULL, MODBUS_ERR_LENGTH, 0U);
+            continue;
+        }
+
+        if (IsRead(req->func) != 0U)
+        {
+            slot = MBTCP_SubmitRead(&t->tcp, req->unit_id, req->func, req->addr, req->count);
+        }
+        else if (req->func == MODBUS_FUNC_WRITE_SINGLE)
+        {
+            slot = MBTCP_SubmitWriteSingle(&t->tcp, req->unit_id, req->addr, req->data[0]);
+        }
+        else
+        {
+            slot = MBTCP_SubmitWriteMultiple(&t->tcp, req->unit_id, req->addr,
+                                             req->count, req->data);
+        }
+
+        if (slot < 0)
+        {
+            break;                      /* window full */
+        }
+        req->done = 0U;
+        req->tid = t->tcp.slot[slot].tid;
+        t->tcp_req[slot] = req;
+    }
+    return (int32_t)k;
+}
+
+int32_t TRANSPORT_MbapTcp_Poll(Transport_t *t, uint32_t timeout_us)
+{
+    int32_t  done = 0;
+    uint32_t i;
+
+    (void)MBTCP_Poll(&t->tcp, timeout_us);
+
+    for (i = 0U; i < MBTCP_WINDOW; i++)
+    {
+        ModbusReq_t *req = t->tcp_req[i];
+
+        if ((req != NULL) && (t->tcp.slot[i].state == MBTCP_SLOT_DONE))
+        {
+            (void)MBTCP_Take(&t->tcp, (int32_t)i, &req->view);
+            if (IsRead(req->func) == 0U)
+            {
+                MODBUS_ViewRelease(&req->view);
+            }
+            req->done = 1U;
+            t->tcp_req[i] = NULL;
+            done++;
+        }
+    }
+    return done;
+}
+
+static const TransportOps_t mbap_tcp_ops =
+{
+    "mbap-tcp", TcpOpen, TcpClose, EncodeMbap, NULL,
+    TRANSPORT_MbapTcp_SendBatch, TRANSPORT_MbapTcp_Poll
+};
+#endif
+
+/*----------------------------------------------------------
+ * Endpoint selection
+ *----------------------------------------------------------*/
+static const TransportOps_t *const transport_table[TRANSPORT_KIND_COUNT] =
+{
+#if TRANSPORT_HAS(TRANSPORT_RTU_UDP)
+    &rtu_udp_ops,
+#else
+    NULL,
+#endif
+#if TRANSPORT_HAS(TRANSPORT_MBAP_UDP)
+    &mbap_udp_ops,
+#else
+    NULL,
+#endif
+#if TRANSPORT_HAS(TRANSPORT_MBAP_TCP)
+    &mbap_tcp_ops
+#else
+    NULL
+#endif
+};
+
+static const char *const transport_names[TRANSPORT_KIND_COUNT] =
+{
+    "rtu-udp", "mbap-udp", "mbap-tcp"
+};
+
+uint8_t TRANSPORT_KindFromName(const char *name)
+{
+    uint8_t k;
+
+    for (k = 0U; k < TRANSPORT_KIND_COUNT; k++)
+    {
+        if (strcmp(name, transport_names[k]) == 0)
+        {
+            return k;
+        }
+    }
+    return TRANSPORT_KIND_COUNT;
+}
+
+int32_t TRANSPORT_Open(Transport_t *t, uint8_t kind, const char *ip, uint16_t port)
+{
+    (void)memset(t, 0, sizeof(*t));
+    t->sock = (uintptr_t)INVALID_SOCKET;
+    t->next_tid = 1U;
+    t->kind = kind;
+
+    if ((kind >= TRANSPORT_KIND_COUNT) || (transport_table[kind] == NULL))
+    {
+        printf("[ERROR] Transport %u not available in this build\n", (unsigned)kind);
+        return -1;
+    }
+
+    t->ops = transport_table[kind];
+    return t->ops->open(t, ip, port);
+}
+
+void TRANSPORT_Close(Transport_t *t)
+{
+    if (t->ops != NULL)
+    {
+        t->ops->close(t);
+    }
+}
+
+/*----------------------------------------------------------
+ * Request helpers
+ *----------------------------------------------------------*/
+void TRANSPORT_ReqRead(ModbusReq_t *req, uint8_t unit_id, uint8_t func,
+                       uint16_t addr, uint16_t count)
+{
+    (void)memset(req, 0, sizeof(*req));
+    req->unit_id = unit_id;
+    req->func    = func;
+    req->addr    = addr;
+    req->count   = count;
+}
+
+void TRANSPORT_ReqWrite(ModbusReq_t *req, uint8_t unit_id, uint16_t addr,
+                        uint16_t count, const uint16_t *data)
+{
+    (void)memset(req, 0, sizeof(*req));
+    req->unit_id = unit_id;
+    req->func    = (count == 1U) ? (uint8_t)MODBUS_FUNC_WRITE_SINGLE
+                                 : (uint8_t)MODBUS_FUNC_WRITE_MULTIPLE;
+    req->addr    = addr;
+    req->count   = count;
+    req->data    = data;
+}
+
+uint32_t TRANSPORT_Transact(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n)
+{
+    uint32_t sent = 0U;
+    uint32_t ok = 0U;
+    uint32_t reads = 0U;
+    uint32_t pending;
+    uint32_t i;
+
+    /* Every read holds a pool frame until its view is released */
+    for (i = 0U; i < n; i++)
+    {
+        reads += IsRead(reqs[i]->func);
+    }
+    if (reads > FRAME_POOL_COUNT)
+    {
+        printf("[ERROR] Batch of %u reads exceeds the frame pool (%u)\n",
+               (unsigned)reads, (unsigned)FRAME_POOL_COUNT);
+        return 0U;
+    }
+
+    for (;;)
+    {
+        if (sent < n)
+        {
+            int32_t took = TRANSPORT_SendBatch(t, &reqs[sent], n - sent);
+            sent += (took > 0) ? (uint32_t)took : 0U;
+        }
+
+        pending = 0U;
+        for (i = 0U; i < sent; i++)
+        {
+            pending += (reqs[i]->done == 0U) ? 1U : 0U;
+        }
+        if ((sent == n) && (pending == 0U))
+        {
+            break;
+        }
+
+        /* Requests expire inside the poll, so this always ends */
+        (void)TRANSPORT_Poll(t, 10000U);
+    }
+
+    for (i = 0U; i < n; i++)
+    {
+        ok += (reqs[i]->view.status == MODBUS_OK) ? 1U : 0U;
+    }
+    return ok;
+}
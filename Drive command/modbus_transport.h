@@ -0,0 +1,216 @@
+#ifndef MODBUS_TRANSPORT_H
+#define MODBUS_TRANSPORT_H
+
+#include <stdint.h>
+#include "config.h"
+#include "modbus_functions.h"
+#include "modbus_tcp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * Transport Kinds
+ *===========================================================*/
+#define TRANSPORT_RTU_UDP    (0U)   /* unit | PDU | CRC16 over UDP (this drive)   */
+#define TRANSPORT_MBAP_UDP   (1U)   /* MBAP | PDU over UDP ("drive control old")  */
+#define TRANSPORT_MBAP_TCP   (2U)   /* Modbus/TCP, persistent connection          */
+#define TRANSPORT_KIND_COUNT (3U)
+
+/* Build with -DMODBUS_TRANSPORT_ONLY=TRANSPORT_xxx to compile a single
+ * transport: the dispatch below becomes direct calls and the other
+ * implementations are left out. */
+#ifdef MODBUS_TRANSPORT_ONLY
+    #define TRANSPORT_HAS(kind)   (MODBUS_TRANSPORT_ONLY == (kind))
+#else
+    #define TRANSPORT_HAS(kind)   (1)
+#endif
+
+#ifndef TRANSPORT_WINDOW
+    #define TRANSPORT_WINDOW      (8U)   /* UDP requests in flight per endpoint */
+#endif
+
+/*===========================================================
+ * Requests
+ *===========================================================*/
+/**
+ * @brief One Modbus request and, once done, its response
+ *
+ * The caller owns the request until done is set. On MODBUS_OK the
+ * view points into a pooled frame in the RTU layout (unit | func |
+ * byte count | regs) whatever the wire format; release it with
+ * MODBUS_ViewRelease. Writes hold no frame. view.status /
+ * view.ex_code report failures.
+ */
+typedef struct
+{
+    uint8_t         unit_id;
+    uint8_t         func;            /**< 0x03 / 0x04 / 0x06 / 0x10 */
+    uint16_t        addr;
+    uint16_t        count;           /**< Registers (reads and 0x10) */
+    const uint16_t *data;            /**< 0x06: data[0]; 0x10: count words */
+
+    uint8_t         done;
+    ModbusView_t    view;            /**< view.stamp: send / reply time */
+
+    uint16_t        tid;             /**< Transport private */
+    uint64_t        deadline_us;
+    uint32_t        tx_id;           /**< Datagram ID (send stamps) */
+    ModbusStamp_t   stamp;
+} ModbusReq_t;
+
+typedef struct Transport_s Transport_t;
+
+/**
+ * @brief Operations of one transport implementation
+ */
+typedef struct
+{
+    const char *name;
+    int32_t (*open)(Transport_t *t, const char *ip, uint16_t port);
+    void    (*close)(Transport_t *t);
+    /* Wire frame of a request; returns its length */
+    int32_t (*encode)(const ModbusReq_t *req, uint16_t tid, uint8_t *out);
+    /* Complete the request a received datagram answers (UDP kinds) */
+    int32_t (*match)(Transport_t *t, Frame_t *frame);
+    /* Send up to n requests; returns how many were accepted */
+    int32_t (*send_batch)(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n);
+    /* Receive and expire; returns requests completed by this call */
+    int32_t (*poll)(Transport_t *t, uint32_t timeout_us);
+} TransportOps_t;
+
+/**
+ * @brief One endpoint and the transport that reaches it
+ */
+struct Transport_s
+{
+    const TransportOps_t *ops;
+    uint8_t      kind;
+    uintptr_t    sock;                          /**< UDP kinds */
+    uint8_t      stamp_src;                     /**< Best TSTAMP_SRC_* of sock */
+    uint32_t     tx_count;                      /**< Datagrams sent (stamp IDs) */
+    uint16_t     next_tid;
+    uint32_t     inflight_n;
+    ModbusReq_t *inflight[TRANSPORT_WINDOW];    /**< UDP, oldest first */
+    MbTcpConn_t  tcp;                           /**< MBAP/TCP */
+    ModbusReq_t *tcp_req[MBTCP_WINDOW];         /**< By MBTCP slot */
+};
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Open a transport of the given kind to ip:port
+ * @return 0 on success, -1 on error (or kind not compiled in)
+ */
+int32_t TRANSPORT_Open(Transport_t *t, uint8_t kind, const char *ip, uint16_t port);
+
+/**
+ * @brief  Close; outstanding requests complete with MODBUS_ERR_IO
+ */
+void TRANSPORT_Close(Transport_t *t);
+
+/**
+ * @brief  Kind from "rtu-udp", "mbap-udp" or "mbap-tcp"
+ * @return Kind, or TRANSPORT_KIND_COUNT if unknown
+ */
+uint8_t TRANSPORT_KindFromName(const char *name);
+
+/**
+ * @brief  Fill a read request (func 0x03 / 0x04)
+ */
+void TRANSPORT_ReqRead(ModbusReq_t *req, uint8_t unit_id, uint8_t func,
+                       uint16_t addr, uint16_t count);
+
+/**
+ * @brief  Fill a write request: 0x06 for one register, else 0x10
+ */
+void TRANSPORT_ReqWrite(ModbusReq_t *req, uint8_t unit_id, uint16_t addr,
+                        uint16_t count, const uint16_t *data);
+
+/**
+ * @brief  Send a batch and poll until every request is done
+ *         (timed-out requests complete with MODBUS_ERR_IO). At most
+ *         FRAME_POOL_COUNT reads per batch.
+ * @return Requests that completed with MODBUS_OK
+ */
+uint32_t TRANSPORT_Transact(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n);
+
+/*-----------------------------------------------------------
+ * Request bookkeeping of the UDP kinds without the socket I/O,
+ * for other I/O backends (modbus_uring.c)
+ *-----------------------------------------------------------*/
+
+/**
+ * @brief  Encode a request into out and add it to the in-flight window
+ * @return Frame length; 0 if the request could not be encoded (it is
+ *         completed with MODBUS_ERR_LENGTH); -1 if the window is full
+ *         or (RTU) a request in flight has the same unit and function
+ */
+int32_t TRANSPORT_Track(Transport_t *t, ModbusReq_t *req, uint8_t *out);
+
+/**
+ * @brief  Complete an in-flight request with status (send failed)
+ */
+void TRANSPORT_Abort(Transport_t *t, ModbusReq_t *req, ModbusStatus_t status);
+
+/**
+ * @brief  Complete in-flight requests past their deadline with
+ *         MODBUS_ERR_IO
+ * @return Requests expired
+ */
+int32_t TRANSPORT_Expire(Transport_t *t, uint64_t now_us);
+
+/*-----------------------------------------------------------
+ * Implementation entry points (used by the dispatch below)
+ *-----------------------------------------------------------*/
+int32_t TRANSPORT_RtuUdp_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n);
+int32_t TRANSPORT_RtuUdp_Poll(Transport_t *t, uint32_t timeout_us);
+int32_t TRANSPORT_MbapUdp_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n);
+int32_t TRANSPORT_MbapUdp_Poll(Transport_t *t, uint32_t timeout_us);
+int32_t TRANSPORT_MbapTcp_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n);
+int32_t TRANSPORT_MbapTcp_Poll(Transport_t *t, uint32_t timeout_us);
+
+/*-----------------------------------------------------------
+ * Dispatch: through the endpoint's ops, or direct calls in a
+ * single-transport build
+ *-----------------------------------------------------------*/
+#ifdef MODBUS_TRANSPORT_ONLY
+    #if (MODBUS_TRANSPORT_ONLY == TRANSPORT_RTU_UDP)
+        #define TRANSPORT_IMPL(fn)   TRANSPORT_RtuUdp_##fn
+    #elif (MODBUS_TRANSPORT_ONLY == TRANSPORT_MBAP_UDP)
+        #define TRANSPORT_IMPL(fn)   TRANSPORT_MbapUdp_##fn
+    #elif (MODBUS_TRANSPORT_ONLY == TRANSPORT_MBAP_TCP)
+        #define TRANSPORT_IMPL(fn)   TRANSPORT_MbapTcp_##fn
+    #else
+        #error "MODBUS_TRANSPORT_ONLY must be one of the TRANSPORT_* kinds"
+    #endif
+
+static inline int32_t TRANSPORT_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n)
+{
+    return TRANSPORT_IMPL(SendBatch)(t, reqs, n);
+}
+
+static inline int32_t TRANSPORT_Poll(Transport_t *t, uint32_t timeout_us)
+{
+    return TRANSPORT_IMPL(Poll)(t, timeout_us);
+}
+#else
+static inline int32_t TRANSPORT_SendBatch(Transport_t *t, ModbusReq_t *const *reqs, uint32_t n)
+{
+    return t->ops->send_batch(t, reqs, n);
+}
+
+static inline int32_t TRANSPORT_Poll(Transport_t *t, uint32_t timeout_us)
+{
+    return t->ops->poll(t, timeout_us);
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODBUS_TRANSPORT_H */
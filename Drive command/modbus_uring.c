@@ -0,0 +1,603 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* syscall, MAP_ANONYMOUS */
+#endif
+
+#include "config.h"
+#include "modbus_uring.h"
+#include "frame_pool.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#if URING_AVAILABLE
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define URING_BGID          (1U)                /* provided buffer group */
+
+/* user_data: kind in the upper half, endpoint or send slot below */
+#define UD_SEND             (1ULL << 32)
+#define UD_RECV             (2ULL << 32)
+#define UD_KIND(ud)         ((ud) & 0xFFFFFFFF00000000ULL)
+#define UD_INDEX(ud)        ((uint32_t)((ud) & 0xFFFFFFFFULL))
+
+#if ((URING_SQ_ENTRIES & (URING_SQ_ENTRIES - 1U)) != 0U) || (URING_SQ_ENTRIES > 65536U)
+    #error "URING_SQ_ENTRIES must be a power of two up to 65536"
+#endif
+#if ((URING_RX_FRAMES & (URING_RX_FRAMES - 1U)) != 0U) || (URING_RX_FRAMES >= FRAME_POOL_COUNT)
+    #error "URING_RX_FRAMES must be a power of two below FRAME_POOL_COUNT"
+#endif
+
+/*----------------------------------------------------------
+ * Raw system calls (no liburing)
+ *----------------------------------------------------------*/
+static int32_t SysSetup(uint32_t entries, struct io_uring_params *p)
+{
+    return (int32_t)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int32_t SysEnter(int32_t fd, uint32_t submit, uint32_t min_complete, uint32_t flags,
+                        const void *arg, size_t argsz)
+{
+    return (int32_t)syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, arg, argsz);
+}
+
+static int32_t SysRegister(int32_t fd, uint32_t opcode, const void *arg, uint32_t nr)
+{
+    return (int32_t)syscall(__NR_io_uring_register, fd, opcode, arg, nr);
+}
+
+/*----------------------------------------------------------
+ * Submission side
+ *----------------------------------------------------------*/
+static int32_t Enter(UringRing_t *r, uint32_t min_complete, uint32_t timeout_us)
+{
+    struct __kernel_timespec      ts;
+    struct io_uring_getevents_arg arg;
+    uint32_t submit = r->to_submit;
+    int32_t  rc;
+
+    /* Publish queued SQEs to the kernel */
+    __atomic_store_n(r->sq_tail, r->sq_local_tail, __ATOMIC_RELEASE);
+
+    (void)memset(&arg, 0, sizeof(arg));
+    ts.tv_sec  = (long long)(timeout_us / 1000000U);
+    ts.tv_nsec = (long long)(timeout_us % 1000000U) * 1000LL;
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+
+    r->stats.enters++;
+    rc = SysEnter(r->ring_fd, submit, min_complete,
+                  IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    r->to_submit = r->sq_local_tail - __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE);
+    if ((rc >= 0) || (errno == ETIME) || (errno == EINTR) || (errno == EBUSY) || (errno == EAGAIN))
+    {
+        return 0;                       /* submitted, timed out or CQ busy */
+    }
+    return -1;
+}
+
+static struct io_uring_sqe *GetSqe(UringRing_t *r)
+{
+    uint32_t head = __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE);
+    struct io_uring_sqe *sqe;
+    uint32_t idx;
+
+    if ((r->sq_local_tail - head) >= (r->sq_mask + 1U))
+    {
+        return NULL;                    /* full until the next enter */
+    }
+
+    idx = r->sq_local_tail & r->sq_mask;
+    sqe = &((struct io_uring_sqe *)r->sqes)[idx];
+    (void)memset(sqe, 0, sizeof(*sqe));
+    r->sq_array[idx] = idx;
+    r->sq_local_tail++;
+    r->to_submit++;
+    r->stats.sqes++;
+    return sqe;
+}
+
+/* One multishot receive per endpoint, buffers from the frame ring */
+static int32_t ArmRecv(UringRing_t *r, uint32_t ep)
+{
+    struct io_uring_sqe *sqe = GetSqe(r);
+
+    if (sqe == NULL)
+    {
+        return -1;
+    }
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = (int32_t)ep;      /* registered file index */
+    sqe->flags     = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->buf_group = URING_BGID;
+    sqe->user_data = UD_RECV | ep;
+    r->armed[ep] = 1U;
+    return 0;
+}
+
+/*----------------------------------------------------------
+ * Provided buffer ring: pool frames lent to the kernel
+ *----------------------------------------------------------*/
+static void Replenish(UringRing_t *r)
+{
+    struct io_uring_buf_ring *br = (struct io_uring_buf_ring *)r->buf_ring;
+    uint16_t bid;
+    uint16_t added = 0U;
+
+    for (bid = 0U; bid < URING_RX_FRAMES; bid++)
+    {
+        if (r->rx_frame[bid] == NULL)
+        {
+            struct io_uring_buf *buf;
+            Frame_t *frame = FRAME_Acquire();
+
+            if (frame == NULL)
+            {
+                break;                  /* views still held; retry next poll */
+            }
+            r->rx_frame[bid] = frame;
+            buf = &br->bufs[(uint16_t)(r->buf_tail + added) & (URING_RX_FRAMES - 1U)];
+            buf->addr = (uint64_t)(uintptr_t)frame->data;
+            buf->len  = (uint32_t)sizeof(frame->data);
+            buf->bid  = bid;
+            added++;
+        }
+    }
+
+    if (added > 0U)
+    {
+        r->buf_tail = (uint16_t)(r->buf_tail + added);
+        __atomic_store_n(&br->tail, r->buf_tail, __ATOMIC_RELEASE);
+    }
+}
+
+/*----------------------------------------------------------
+ * Completion side
+ *----------------------------------------------------------*/
+static int32_t OnRecv(UringRing_t *r, const struct io_uring_cqe *cqe)
+{
+    uint32_t     ep = UD_INDEX(cqe->user_data);
+    Transport_t *t  = r->ep[ep];
+    int32_t      done = 0;
+
+    if ((cqe->flags & IORING_CQE_F_BUFFER) != 0U)
+    {
+        uint16_t bid   = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        Frame_t *frame = r->rx_frame[bid];
+
+        r->rx_frame[bid] = NULL;
+        if ((frame != NULL) && (cqe->res > 0))
+        {
+            r->stats.datagrams++;
+            frame->len = (uint16_t)cqe->res;
+            frame->rx_us = TIME_NowUs();
+            frame->rx_src = TSTAMP_SRC_USER;
+            done = t->ops->match(t, frame);     /* keeps or releases it */
+        }
+        else
+        {
+            FRAME_Release(frame);
+        }
+    }
+
+    if ((cqe->flags & IORING_CQE_F_MORE) == 0U)
+    {
+        /* Ended: out of buffers, an ICMP error on the socket, or no
+         * multishot support. Datagrams wait in the socket until the
+         * next poll re-arms it. */
+        if ((cqe->res == -EINVAL) || (cqe->res == -EOPNOTSUPP))
+        {
+            printf("[ERROR] io_uring receive on endpoint %u failed (%d)\n",
+                   (unsigned)ep, (int)cqe->res);
+            r->armed[ep] = 2U;
+        }
+        else
+        {
+            r->armed[ep] = 0U;
+        }
+    }
+    return done;
+}
+
+static void OnSend(UringRing_t *r, const struct io_uring_cqe *cqe)
+{
+    uint32_t slot = UD_INDEX(cqe->user_data);
+
+    if (cqe->res < 0)
+    {
+        r->stats.send_errors++;
+        TRANSPORT_Abort(r->ep[r->tx_ep[slot]], r->tx_req[slot], MODBUS_ERR_IO);
+    }
+    r->tx_req[slot] = NULL;
+    r->tx_free[r->tx_free_n++] = (uint16_t)slot;
+}
+
+static int32_t Reap(UringRing_t *r)
+{
+    uint32_t head = *r->cq_head;
+    uint32_t tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+    int32_t  done = 0;
+
+    while (head != tail)
+    {
+        const struct io_uring_cqe *cqe =
+            &((const struct io_uring_cqe *)r->cqes)[head & r->cq_mask];
+
+        if (UD_KIND(cqe->user_data) == UD_RECV)
+        {
+            done += OnRecv(r, cqe);
+        }
+        else
+        {
+            OnSend(r, cqe);
+        }
+        head++;
+        r->stats.cqes++;
+    }
+    __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    return done;
+}
+
+/*----------------------------------------------------------
+ * Set-up and tear-down
+ *----------------------------------------------------------*/
+int32_t URING_Open(UringRing_t *r)
+{
+    struct io_uring_params p;
+    struct io_uring_buf_reg reg;
+    int32_t  files[URING_MAX_ENDPOINTS];
+    uint32_t i;
+
+    (void)memset(r, 0, sizeof(*r));
+    r->ring_fd = -1;
+
+    (void)memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    r->ring_fd = SysSetup(URING_SQ_ENTRIES, &p);
+    if (r->ring_fd < 0)
+    {
+        (void)memset(&p, 0, sizeof(p));         /* kernels before 6.1 */
+        r->ring_fd = SysSetup(URING_SQ_ENTRIES, &p);
+    }
+    if ((r->ring_fd < 0) || ((p.features & IORING_FEAT_EXT_ARG) == 0U))
+    {
+        printf("[ERROR] io_uring not available\n");
+        URING_Close(r);
+        return -1;
+    }
+
+    /* Map the rings */
+    r->sq_ring_sz = p.sq_off.array + (p.sq_entries * (uint32_t)sizeof(uint32_t));
+    r->cq_ring_sz = p.cq_off.cqes + (p.cq_entries * (uint32_t)sizeof(struct io_uring_cqe));
+    if ((p.features & IORING_FEAT_SINGLE_MMAP) != 0U)
+    {
+        r->sq_ring_sz = (r->cq_ring_sz > r->sq_ring_sz) ? r->cq_ring_sz : r->sq_ring_sz;
+        r->cq_ring_sz = 0U;
+    }
+    r->sqes_sz = p.sq_entries * (uint32_t)sizeof(struct io_uring_sqe);
+
+    r->sq_ptr = mmap(NULL, r->sq_ring_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->ring_fd, (off_t)IORING_OFF_SQ_RING);
+    r->cq_ptr = (r->cq_ring_sz == 0U) ? r->sq_ptr
+              : mmap(NULL, r->cq_ring_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->ring_fd, (off_t)IORING_OFF_CQ_RING);
+    r->sqes   = mmap(NULL, r->sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->ring_fd, (off_t)IORING_OFF_SQES);
+    if ((r->sq_ptr == MAP_FAILED) || (r->cq_ptr == MAP_FAILED) || (r->sqes == MAP_FAILED))
+    {
+        printf("[ERROR] io_uring ring mapping failed\n");
+        URING_Close(r);
+        return -1;
+    }
+
+    r->sq_head  = (uint32_t *)((uint8_t *)r->sq_ptr + p.sq_off.head);
+    r->sq_tail  = (uint32_t *)((uint8_t *)r->sq_ptr + p.sq_off.tail);
+    r->sq_array = (uint32_t *)((uint8_t *)r->sq_ptr + p.sq_off.array);
+    r->sq_mask  = *(uint32_t *)((uint8_t *)r->sq_ptr + p.sq_off.ring_mask);
+    r->cq_head  = (uint32_t *)((uint8_t *)r->cq_ptr + p.cq_off.head);
+    r->cq_tail  = (uint32_t *)((uint8_t *)r->cq_ptr + p.cq_off.tail);
+    r->cqes     = (uint8_t *)r->cq_ptr + p.cq_off.cqes;
+    r->cq_mask  = *(uint32_t *)((uint8_t *)r->cq_ptr + p.cq_off.ring_mask);
+    r->sq_local_tail = *r->sq_tail;
+
+    /* Sparse file table, one slot per endpoint */
+    for (i = 0U; i < URING_MAX_ENDPOINTS; i++)
+    {
+        files[i] = -1;
+    }
+    if (SysRegister(r->ring_fd, IORING_REGISTER_FILES, files, URING_MAX_ENDPOINTS) < 0)
+    {
+        printf("[ERROR] io_uring file registration failed\n");
+        URING_Close(r);
+        return -1;
+    }
+
+    /* Provided buffer ring (5.19+) */
+    r->buf_ring = mmap(NULL, URING_RX_FRAMES * sizeof(struct io_uring_buf),
+                       PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (r->buf_ring == MAP_FAILED)
+    {
+        r->buf_ring = NULL;
+        URING_Close(r);
+        return -1;
+    }
+    (void)memset(&reg, 0, sizeof(reg));
+    reg.ring_addr    = (uint64_t)(uintptr_t)r->buf_ring;
+    reg.ring_entries = URING_RX_FRAMES;
+    reg.bgid         = URING_BGID;
+    if (SysRegister(r->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1U) < 0)
+    {
+        printf("[ERROR] io_uring provided buffers not supported\n");
+        (void)munmap(r->buf_ring, URING_RX_FRAMES * sizeof(struct io_uring_buf));
+        r->buf_ring = NULL;
+        URING_Close(r);
+        return -1;
+    }
+    Replenish(r);
+
+    for (i = 0U; i < URING_SQ_ENTRIES; i++)
+    {
+        r->tx_free[i] = (uint16_t)((URING_SQ_ENTRIES - 1U) - i);
+    }
+    r->tx_free_n = URING_SQ_ENTRIES;
+    return 0;
+}
+
+void URING_Close(UringRing_t *r)
+{
+    uint32_t i;
+
+    /* Take the frames back from the kernel before they return to the
+     * pool; closing the ring cancels the receives and sends in flight */
+    if (r->ring_fd >= 0)
+    {
+        if (r->buf_ring != NULL)
+        {
+            struct io_uring_buf_reg reg;
+
+            (void)memset(&reg, 0, sizeof(reg));
+            reg.bgid = URING_BGID;
+            (void)SysRegister(r->ring_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1U);
+        }
+        (void)close(r->ring_fd);
+        r->ring_fd = -1;
+    }
+    if ((r->sqes != NULL) && (r->sqes != MAP_FAILED))
+    {
+        (void)munmap(r->sqes, r->sqes_sz);
+    }
+    if ((r->cq_ptr != NULL) && (r->cq_ptr != MAP_FAILED) && (r->cq_ptr != r->sq_ptr))
+    {
+        (void)munmap(r->cq_ptr, r->cq_ring_sz);
+    }
+    if ((r->sq_ptr != NULL) && (r->sq_ptr != MAP_FAILED))
+    {
+        (void)munmap(r->sq_ptr, r->sq_ring_sz);
+    }
+    if (r->buf_ring != NULL)
+    {
+        (void)munmap(r->buf_ring, URING_RX_FRAMES * sizeof(struct io_uring_buf));
+    }
+    r->sqes = NULL;
+    r->cq_ptr = NULL;
+    r->sq_ptr = NULL;
+    r->buf_ring = NULL;
+
+    for (i = 0U; i < URING_RX_FRAMES; i++)
+    {
+        FRAME_Release(r->rx_frame[i]);
+        r->rx_frame[i] = NULL;
+    }
+    r->ep_n = 0U;
+}
+
+int32_t URING_Attach(UringRing_t *r, Transport_t *t)
+{
+    struct io_uring_files_update upd;
+    int32_t  fd = (int32_t)t->sock;
+    uint32_t ep = r->ep_n;
+
+    if ((r->ring_fd < 0) || (ep >= URING_MAX_ENDPOINTS) ||
+        (t->ops == NULL) || (t->ops->match == NULL))
+    {
+        return -1;                      /* full, or not a UDP transport */
+    }
+
+    (void)memset(&upd, 0, sizeof(upd));
+    upd.offset = ep;
+    upd.fds    = (uint64_t)(uintptr_t)&fd;
+    if (SysRegister(r->ring_fd, IORING_REGISTER_FILES_UPDATE, &upd, 1U) < 0)
+    {
+        return -1;
+    }
+
+    /* The ring never reads the error queue: send stamps would
+     * pile up in it. Times are taken in user space instead. */
+    TSTAMP_Disable(t->sock);
+    t->stamp_src = TSTAMP_SRC_USER;
+
+    r->ep[ep] = t;
+    r->ep_n++;
+    (void)ArmRecv(r, ep);               /* goes out with the next enter */
+    return (int32_t)ep;
+}
+
+/*----------------------------------------------------------
+ * Requests
+ *----------------------------------------------------------*/
+int32_t URING_SendBatch(UringRing_t *r, int32_t ep, ModbusReq_t *const *reqs, uint32_t n)
+{
+    Transport_t *t;
+    uint32_t     taken;
+
+    if ((ep < 0) || ((uint32_t)ep >= r->ep_n))
+    {
+        return -1;
+    }
+    t = r->ep[ep];
+
+    for (taken = 0U; taken < n; taken++)
+    {
+        struct io_uring_sqe *sqe;
+        uint16_t slot;
+        int32_t  len;
+
+        if (r->tx_free_n == 0U)
+        {
+            break;
+        }
+        slot = r->tx_free[r->tx_free_n - 1U];
+
+        len = TRANSPORT_Track(t, reqs[taken], r->tx[slot]);
+        if (len < 0)
+        {
+            break;                      /* endpoint window full */
+        }
+        if (len == 0)
+        {
+            continue;                   /* completed with MODBUS_ERR_LENGTH */
+        }
+
+        sqe = GetSqe(r);
+        if (sqe == NULL)
+        {
+            /* Ring full: push what is queued and retry once */
+            if ((Enter(r, 0U, 0U) != 0) || ((sqe = GetSqe(r)) == NULL))
+            {
+                TRANSPORT_Abort(t, reqs[taken], MODBUS_ERR_IO);
+                break;
+            }
+        }
+        r->tx_free_n--;
+        r->tx_req[slot] = reqs[taken];
+        r->tx_ep[slot]  = (uint16_t)ep;
+
+        sqe->opcode    = IORING_OP_SEND;
+        sqe->fd        = ep;
+        sqe->flags     = IOSQE_FIXED_FILE;
+        sqe->addr      = (uint64_t)(uintptr_t)r->tx[slot];
+        sqe->len       = (uint32_t)len;
+        sqe->user_data = UD_SEND | slot;
+    }
+    return (int32_t)taken;
+}
+
+uint32_t URING_Pending(const UringRing_t *r)
+{
+    uint32_t n = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < r->ep_n; i++)
+    {
+        n += r->ep[i]->inflight_n;
+    }
+    return n;
+}
+
+int32_t URING_Poll(UringRing_t *r, uint32_t wait_for, uint32_t timeout_us)
+{
+    int32_t  done;
+    uint32_t pending;
+    uint32_t i;
+    uint64_t now;
+
+    if (r->ring_fd < 0)
+    {
+        return -1;
+    }
+
+    /* Re-arm receives that ran out of buffers, once frames are back */
+    Replenish(r);
+    for (i = 0U; i < r->ep_n; i++)
+    {
+        if ((r->armed[i] == 0U) && (ArmRecv(r, i) == 0))
+        {
+            r->stats.rearms++;
+        }
+    }
+
+    pending = URING_Pending(r);
+    if ((r->to_submit == 0U) && (pending == 0U))
+    {
+        return Reap(r);
+    }
+
+    /* A request completes with its receive CQE; the send CQEs still
+     * outstanding come first */
+    wait_for = (wait_for > pending) ? pending : wait_for;
+    wait_for = (wait_for == 0U) ? ((pending > 0U) ? 1U : 0U) : wait_for;
+    if (wait_for > 0U)
+    {
+        wait_for += URING_SQ_ENTRIES - r->tx_free_n;
+    }
+
+    /* Submit everything queued and wait, in one system call */
+    if (Enter(r, wait_for, timeout_us) != 0)
+    {
+        printf("[ERROR] io_uring_enter failed (%d)\n", errno);
+        return -1;
+    }
+    done = Reap(r);
+    Replenish(r);
+
+    now = TIME_NowUs();
+    for (i = 0U; i < r->ep_n; i++)
+    {
+        if (r->ep[i]->inflight_n > 0U)
+        {
+            done += TRANSPORT_Expire(r->ep[i], now);
+        }
+    }
+    return done;
+}
+
+#else /* !URING_AVAILABLE */
+
+int32_t URING_Open(UringRing_t *r)
+{
+    (void)memset(r, 0, sizeof(*r));
+    r->ring_fd = -1;
+    return -1;
+}
+
+void URING_Close(UringRing_t *r)
+{
+    r->ring_fd = -1;
+}
+
+int32_t URING_Attach(UringRing_t *r, Transport_t *t)
+{
+    (void)r;
+    (void)t;
+    return -1;
+}
+
+int32_t URING_SendBatch(UringRing_t *r, int32_t ep, ModbusReq_t *const *reqs, uint32_t n)
+{
+    (void)r;
+    (void)ep;
+    (void)reqs;
+    (void)n;
+    return -1;
+}
+
+int32_t URING_Poll(UringRing_t *r, uint32_t wait_for, uint32_t timeout_us)
+{
+    (void)r;
+    (void)wait_for;
+    (void)timeout_us;
+    return -1;
+}
+
+uint32_t URING_Pending(const UringRing_t *r)
+{
+    (void)r;
+    return 0U;
+}
+
+#endif /* URING_AVAILABLE */
@@ -0,0 +1,152 @@
+#ifndef MODBUS_URING_H
+#define MODBUS_URING_H
+
+#include <stdint.h>
+#include "config.h"
+#include "modbus_transport.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * io_uring Backend (Linux)
+ *===========================================================*/
+/* Drives the UDP transports of many endpoints from one ring, for
+ * gateways that poll a large fleet. Requests of every endpoint are
+ * queued as SQEs and submitted together with the wait, so a poll
+ * cycle is one io_uring_enter() per wake-up. Each socket is a
+ * registered file with one multishot receive armed on it; datagrams
+ * land directly in pool frames lent to the kernel as a provided
+ * buffer ring and go to the endpoint's matcher without a copy.
+ * Stamps are user space: send time when queued, receive time when
+ * the completion is reaped.
+ *
+ * Raw system calls, no liburing. Elsewhere, or built with
+ * -DMODBUS_NO_URING, URING_Open fails and the caller keeps using
+ * TRANSPORT_Poll on each endpoint. */
+#if defined(__linux__) && !defined(MODBUS_NO_URING)
+    #define URING_AVAILABLE      (1)
+#else
+    #define URING_AVAILABLE      (0)
+#endif
+
+#ifndef URING_MAX_ENDPOINTS
+    #define URING_MAX_ENDPOINTS  (256U)
+#endif
+#ifndef URING_SQ_ENTRIES
+    #define URING_SQ_ENTRIES     (512U)  /* power of two; also send slots */
+#endif
+#ifndef URING_RX_FRAMES
+    #define URING_RX_FRAMES      (8U)    /* power of two, < FRAME_POOL_COUNT */
+#endif
+
+/**
+ * @brief Counters of one ring
+ */
+typedef struct
+{
+    uint32_t enters;          /**< io_uring_enter() calls */
+    uint32_t sqes;            /**< Submissions (sends + receive arms) */
+    uint32_t cqes;            /**< Completions reaped */
+    uint32_t datagrams;       /**< Received */
+    uint32_t rearms;          /**< Multishot receives re-armed */
+    uint32_t send_errors;
+} UringStats_t;
+
+/**
+ * @brief One ring and the endpoints attached to it
+ */
+typedef struct
+{
+    int32_t      ring_fd;                           /**< -1 if closed */
+
+    /* Shared ring memory (io_uring_setup / mmap) */
+    void        *sq_ptr;
+    void        *cq_ptr;
+    void        *sqes;
+    uint32_t     sq_ring_sz;
+    uint32_t     cq_ring_sz;
+    uint32_t     sqes_sz;
+    uint32_t    *sq_head;
+    uint32_t    *sq_tail;
+    uint32_t    *sq_array;
+    uint32_t     sq_mask;
+    uint32_t    *cq_head;
+    uint32_t    *cq_tail;
+    void        *cqes;
+    uint32_t     cq_mask;
+    uint32_t     sq_local_tail;                     /**< Queued, not yet submitted */
+    uint32_t     to_submit;
+
+    /* Provided buffer ring of pool frames, by buffer ID */
+    void        *buf_ring;
+    uint16_t     buf_tail;
+    Frame_t     *rx_frame[URING_RX_FRAMES];
+
+    /* Endpoints (registered file index = endpoint index) */
+    Transport_t *ep[URING_MAX_ENDPOINTS];
+    uint8_t      armed[URING_MAX_ENDPOINTS];
+    uint32_t     ep_n;
+
+    /* Send buffers, held until the send completes */
+    uint8_t      tx[URING_SQ_ENTRIES][MBTCP_MAX_ADU];
+    ModbusReq_t *tx_req[URING_SQ_ENTRIES];
+    uint16_t     tx_ep[URING_SQ_ENTRIES];
+    uint16_t     tx_free[URING_SQ_ENTRIES];
+    uint32_t     tx_free_n;
+
+    UringStats_t stats;
+} UringRing_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Set up the ring, file table and provided buffer ring
+ * @return 0 on success, -1 if io_uring is unavailable (fall back to
+ *         TRANSPORT_Poll)
+ */
+int32_t URING_Open(UringRing_t *r);
+
+/**
+ * @brief  Tear down the ring and return its frames to the pool.
+ *         Close it before the attached transports.
+ */
+void URING_Close(UringRing_t *r);
+
+/**
+ * @brief  Attach an open RTU/UDP or MBAP/UDP transport
+ * @return Endpoint index for URING_SendBatch, or -1
+ */
+int32_t URING_Attach(UringRing_t *r, Transport_t *t);
+
+/**
+ * @brief  Queue requests of one endpoint; nothing is sent until the
+ *         next URING_Poll
+ * @return Requests taken (the rest did not fit the window or ring)
+ */
+int32_t URING_SendBatch(UringRing_t *r, int32_t ep, ModbusReq_t *const *reqs, uint32_t n);
+
+/**
+ * @brief  Submit what is queued, wait until wait_for requests have
+ *         answered (at least one; capped at those in flight) or
+ *         timeout_us passed, then match replies and expire requests
+ *         on every endpoint
+ * @note   wait_for = URING_Pending() collects a whole poll cycle in
+ *         one system call
+ * @return Requests completed by this call, or -1 on ring failure
+ */
+int32_t URING_Poll(UringRing_t *r, uint32_t wait_for, uint32_t timeout_us);
+
+/**
+ * @brief  Requests in flight over all attached endpoints
+ */
+uint32_t URING_Pending(const UringRing_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODBUS_URING_H */
@@ -0,0 +1,227 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* struct timespec in errqueue.h, CMSG_* */
+#endif
+
+#include "config.h"
+#include "net_timestamp.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+#else
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <errno.h>
+
+    typedef int SOCKET;
+#endif
+
+#if defined(__linux__) && (MODBUS_TIMESTAMPING > 0U)
+    #include <time.h>
+    #include <netinet/in.h>
+    #include <linux/errqueue.h>
+    #include <linux/net_tstamp.h>
+
+    #define TSTAMP_KERNEL    (1)
+#else
+    #define TSTAMP_KERNEL    (0)
+#endif
+
+#if TSTAMP_KERNEL
+/*----------------------------------------------------------
+ * Helper: kernel stamp (CLOCK_REALTIME) to monotonic us
+ *----------------------------------------------------------*/
+static uint64_t ToMonotonicUs(const struct timespec *ts)
+{
+    struct timespec real;
+    struct timespec mono;
+    int64_t stamp_ns;
+    int64_t offset_ns;
+
+    (void)clock_gettime(CLOCK_REALTIME, &real);
+    (void)clock_gettime(CLOCK_MONOTONIC, &mono);
+
+    stamp_ns  = ((int64_t)ts->tv_sec * 1000000000LL) + (int64_t)ts->tv_nsec;
+    offset_ns = (((int64_t)real.tv_sec - (int64_t)mono.tv_sec) * 1000000000LL) +
+                ((int64_t)real.tv_nsec - (int64_t)mono.tv_nsec);
+    return (uint64_t)((stamp_ns - offset_ns) / 1000LL);
+}
+
+/*----------------------------------------------------------
+ * Helper: pick the stamp out of an SCM_TIMESTAMPING cmsg
+ * (ts[2] hardware, ts[0] software)
+ *----------------------------------------------------------*/
+static uint8_t PickStamp(const struct scm_timestamping *tss, uint64_t *us)
+{
+    if ((tss->ts[2].tv_sec != 0) || (tss->ts[2].tv_nsec != 0))
+    {
+        *us = ToMonotonicUs(&tss->ts[2]);
+        return TSTAMP_SRC_HARDWARE;
+    }
+    if ((tss->ts[0].tv_sec != 0) || (tss->ts[0].tv_nsec != 0))
+    {
+        *us = ToMonotonicUs(&tss->ts[0]);
+        return TSTAMP_SRC_SOFTWARE;
+    }
+    return TSTAMP_SRC_NONE;
+}
+#endif
+
+uint8_t TSTAMP_Enable(uintptr_t sock)
+{
+#if TSTAMP_KERNEL
+    int flags = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE |
+                SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID |
+                SOF_TIMESTAMPING_OPT_TSONLY;
+    uint8_t src = TSTAMP_SRC_SOFTWARE;
+
+    #if (MODBUS_TIMESTAMPING >= 2U)
+    /* The NIC must have stamping switched on (hwstamp_ctl / ptp4l) */
+    flags |= SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE |
+             SOF_TIMESTAMPING_RAW_HARDWARE;
+    src = TSTAMP_SRC_HARDWARE;
+    #endif
+
+    if (setsockopt((int)sock, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0)
+    {
+        printf("[TSTAMP] SO_TIMESTAMPING refused (errno %d), user-space times\n", errno);
+        return TSTAMP_SRC_USER;
+    }
+    return src;
+#else
+    (void)sock;
+    return TSTAMP_SRC_USER;
+#endif
+}
+
+void TSTAMP_Disable(uintptr_t sock)
+{
+#if TSTAMP_KERNEL
+    int flags = 0;
+
+    (void)setsockopt((int)sock, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+#else
+    (void)sock;
+#endif
+}
+
+int32_t TSTAMP_Recv(uintptr_t sock, uint8_t *buf, uint16_t len, int32_t flags,
+                    uint64_t *rx_us, uint8_t *rx_src)
+{
+#if TSTAMP_KERNEL
+    union
+    {
+        struct cmsghdr align;
+        uint8_t        space[CMSG_SPACE(sizeof(struct scm_timestamping))];
+    } control;
+    struct msghdr   msg;
+    struct iovec    iov;
+    struct cmsghdr *cm;
+    int32_t         n;
+
+    iov.iov_base = buf;
+    iov.iov_len  = len;
+    (void)memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1U;
+    msg.msg_control    = control.space;
+    msg.msg_controllen = sizeof(control.space);
+
+    n = (int32_t)recvmsg((int)sock, &msg, flags);
+    *rx_src = TSTAMP_SRC_NONE;
+    if (n >= 0)
+    {
+        for (cm = CMSG_FIRSTHDR(&msg); cm != NULL; cm = CMSG_NXTHDR(&msg, cm))
+        {
+            if ((cm->cmsg_level == SOL_SOCKET) && (cm->cmsg_type == SCM_TIMESTAMPING))
+            {
+                *rx_src = PickStamp((const struct scm_timestamping *)CMSG_DATA(cm), rx_us);
+            }
+        }
+    }
+    if (*rx_src == TSTAMP_SRC_NONE)
+    {
+        *rx_us  = TIME_NowUs();
+        *rx_src = TSTAMP_SRC_USER;
+    }
+    return n;
+#else
+    int32_t n = (int32_t)recv((SOCKET)sock, (char *)buf, (int)len, (int)flags);
+
+    *rx_us  = TIME_NowUs();
+    *rx_src = TSTAMP_SRC_USER;
+    return n;
+#endif
+}
+
+uint32_t TSTAMP_ReadTx(uintptr_t sock, uint32_t *ids, uint64_t *tx_us,
+                       uint8_t *tx_src, uint32_t max)
+{
+#if TSTAMP_KERNEL
+    uint32_t got = 0U;
+
+    while (got < max)
+    {
+        union
+        {
+            struct cmsghdr align;
+            uint8_t        space[CMSG_SPACE(sizeof(struct scm_timestamping)) +
+                                 CMSG_SPACE(sizeof(struct sock_extended_err) +
+                                            sizeof(struct sockaddr_in))];
+        } control;
+        struct msghdr   msg;
+        struct cmsghdr *cm;
+        uint8_t         src = TSTAMP_SRC_NONE;
+        uint64_t        us = 0U;
+        int32_t         id = -1;
+
+        (void)memset(&msg, 0, sizeof(msg));
+        msg.msg_control    = control.space;
+        msg.msg_controllen = sizeof(control.space);
+
+        /* OPT_TSONLY: no payload, stamp and ID in the control data */
+        if (recvmsg((int)sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        {
+            break;
+        }
+
+        for (cm = CMSG_FIRSTHDR(&msg); cm != NULL; cm = CMSG_NXTHDR(&msg, cm))
+        {
+            if ((cm->cmsg_level == SOL_SOCKET) && (cm->cmsg_type == SCM_TIMESTAMPING))
+            {
+                src = PickStamp((const struct scm_timestamping *)CMSG_DATA(cm), &us);
+            }
+            else if (((cm->cmsg_level == SOL_IP) && (cm->cmsg_type == IP_RECVERR)) ||
+                     ((cm->cmsg_level == SOL_IPV6) && (cm->cmsg_type == IPV6_RECVERR)))
+            {
+                const struct sock_extended_err *ee =
+                    (const struct sock_extended_err *)CMSG_DATA(cm);
+
+                if (ee->ee_origin == SO_EE_ORIGIN_TIMESTAMPING)
+                {
+                    id = (int32_t)ee->ee_data;
+                }
+            }
+        }
+
+        if ((src != TSTAMP_SRC_NONE) && (id >= 0))
+        {
+            ids[got]    = (uint32_t)id;
+            tx_us[got]  = us;
+            tx_src[got] = src;
+            got++;
+        }
+    }
+    return got;
+#else
+    (void)sock;
+    (void)ids;
+    (void)tx_us;
+    (void)tx_src;
+    (void)max;
+    return 0U;
+#endif
+}
@@ -0,0 +1,101 @@
+#ifndef NET_TIMESTAMP_H
+#define NET_TIMESTAMP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*===========================================================
+ * Packet Timestamps
+ *===========================================================*/
+/* Send and receive time of every transaction, on the CLOCK_MONOTONIC
+ * base of TIME_NowUs(). On Linux the kernel stamps the datagrams
+ * (SO_TIMESTAMPING): receive stamps arrive with the datagram, send
+ * stamps on the socket error queue. Kernel stamps are CLOCK_REALTIME
+ * and are moved onto the monotonic base as they are read; hardware
+ * stamps assume the NIC clock is kept on CLOCK_REALTIME (phc2sys).
+ * Where the kernel cannot stamp, the time is taken in user space
+ * right around send and receive.
+ *
+ *   MODBUS_TIMESTAMPING 0   user space only
+ *                       1   kernel software stamps (default)
+ *                       2   hardware stamps, software as fallback */
+#ifndef MODBUS_TIMESTAMPING
+    #define MODBUS_TIMESTAMPING   (1U)
+#endif
+
+/* Where a stamp came from */
+#define TSTAMP_SRC_NONE       (0U)
+#define TSTAMP_SRC_USER       (1U)
+#define TSTAMP_SRC_SOFTWARE   (2U)
+#define TSTAMP_SRC_HARDWARE   (3U)
+
+/**
+ * @brief Send and receive time of one transaction (us, monotonic)
+ */
+typedef struct
+{
+    uint64_t tx_us;
+    uint64_t rx_us;
+    uint8_t  tx_src;          /**< TSTAMP_SRC_* */
+    uint8_t  rx_src;
+} ModbusStamp_t;
+
+/**
+ * @brief  Sample time estimate: midway between request and reply,
+ *         i.e. the drive is assumed to sample half a round trip
+ *         after the request left (symmetric path)
+ * @return Monotonic us, or 0 if the transaction has no reply
+ */
+static inline uint64_t TSTAMP_Midpoint(const ModbusStamp_t *stamp)
+{
+    if ((stamp->rx_us == 0U) || (stamp->rx_us < stamp->tx_us))
+    {
+        return stamp->rx_us;
+    }
+    return stamp->tx_us + ((stamp->rx_us - stamp->tx_us) / 2U);
+}
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Turn on kernel stamping of a UDP socket
+ *         (MODBUS_TIMESTAMPING selects the kind)
+ * @return Best source the socket will deliver (TSTAMP_SRC_USER if the
+ *         kernel cannot stamp it)
+ */
+uint8_t TSTAMP_Enable(uintptr_t sock);
+
+/**
+ * @brief  Turn kernel stamping off again (a socket whose error queue
+ *         is never read, e.g. one handed to io_uring)
+ */
+void TSTAMP_Disable(uintptr_t sock);
+
+/**
+ * @brief  recv() that also returns the receive time
+ * @param  flags   recv flags (e.g. MSG_DONTWAIT)
+ * @param  rx_us   Receive time; kernel stamp if present, else now
+ * @param  rx_src  TSTAMP_SRC_* of rx_us
+ * @return Bytes received, or -1 (errno / WSAGetLastError as recv)
+ */
+int32_t TSTAMP_Recv(uintptr_t sock, uint8_t *buf, uint16_t len, int32_t flags,
+                    uint64_t *rx_us, uint8_t *rx_src);
+
+/**
+ * @brief  Collect queued send stamps. Datagrams are numbered from 0
+ *         in send order, from TSTAMP_Enable on.
+ * @return Stamps returned (at most max); 0 if none are pending
+ */
+uint32_t TSTAMP_ReadTx(uintptr_t sock, uint32_t *ids, uint64_t *tx_us,
+                       uint8_t *tx_src, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_TIMESTAMP_H */
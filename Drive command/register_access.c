@@ -0,0 +1,254 @@
+#include "config.h"
+#include "register_access.h"
+#include "modbus_functions.h"
+#include "modbus_decode.h"
+#include "drive_parameters.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*----------------------------------------------------------
+ * Register table, expanded from DRIVE_AXIS_REGISTERS
+ *----------------------------------------------------------*/
+#define REGTAB_ROW(n, addr, area, w, sc, sg, acc) \
+    { #n, (addr), REG_AREA_##area, (w), &FIX_SCALE_##sc, ((sg) != 0), REG_ACCESS_##acc },
+
+const RegDesc_t REG_TABLE[REGID_COUNT] =
+{
+    DRIVE_AXIS_REGISTERS(REGTAB_ROW)
+};
+#undef REGTAB_ROW
+
+/* Max registers per 0x03/0x04 request */
+#define REG_MAX_BLOCK   (MODBUS_MAX_READ_REGS)
+
+/*----------------------------------------------------------
+ * Helper: read function code of an area
+ *----------------------------------------------------------*/
+static uint8_t AreaFunc(RegArea_t area)
+{
+    return (area == REG_AREA_INPUT) ? (uint8_t)MODBUS_FUNC_READ_INPUT
+                                    : (uint8_t)MODBUS_FUNC_READ_HOLDING;
+}
+
+/*----------------------------------------------------------
+ * Raw single-register access
+ *----------------------------------------------------------*/
+static int32_t ReadRawAt(Axis_t axis, uint16_t pan_addr, RegArea_t area,
+                         uint16_t *raw, uint64_t *sample_us)
+{
+    ModbusView_t view;
+    int32_t len = MODBUS_ReadView(AXIS_UnitId(axis), AreaFunc(area),
+                                  AXIS_Reg(axis, pan_addr), 1U, &view);
+
+    if (len < 0)
+    {
+        *raw = 0U;
+        return -1;
+    }
+
+    *raw = MODBUS_ViewReg(&view, 0U);
+    if (sample_us != NULL)
+    {
+        *sample_us = TSTAMP_Midpoint(&view.stamp);
+    }
+    MODBUS_ViewRelease(&view);
+    return len;
+}
+
+int32_t REG_ReadRaw(Axis_t axis, uint16_t pan_addr, RegArea_t area, uint16_t *raw)
+{
+    return ReadRawAt(axis, pan_addr, area, raw, NULL);
+}
+
+int32_t REG_WriteRaw(Axis_t axis, uint16_t pan_addr, uint16_t raw)
+{
+    return MODBUS_WriteSingle(AXIS_UnitId(axis), AXIS_Reg(axis, pan_addr), raw);
+}
+
+/*----------------------------------------------------------
+ * Table-driven access in engineering units
+ *----------------------------------------------------------*/
+int32_t REG_Read(Axis_t axis, RegId_t id, fix16_t *value)
+{
+    const RegDesc_t *d = &REG_TABLE[id];
+    uint16_t raw = 0U;
+    int32_t len = REG_ReadRaw(axis, d->pan_addr, d->area, &raw);
+
+    *value = d->is_signed ? FIX_DecodeS16(raw, d->scale) : FIX_DecodeU16(raw, d->scale);
+    return len;
+}
+
+int32_t REG_ReadSample(Axis_t axis, RegId_t id, RegSample_t *sample)
+{
+    const RegDesc_t *d = &REG_TABLE[id];
+    uint16_t raw = 0U;
+    int32_t len;
+
+    sample->sample_us = 0U;
+    len = ReadRawAt(axis, d->pan_addr, d->area, &raw, &sample->sample_us);
+    sample->value = d->is_signed ? FIX_DecodeS16(raw, d->scale) : FIX_DecodeU16(raw, d->scale);
+    return len;
+}
+
+int32_t REG_Write(Axis_t axis, RegId_t id, fix16_t value)
+{
+    const RegDesc_t *d = &REG_TABLE[id];
+
+    if ((d->access == REG_ACCESS_RO) || (d->area != REG_AREA_HOLDING))
+    {
+        printf("[ERROR] Register %s is not writable\n", d->name);
+        return -1;
+    }
+
+    return REG_WriteRaw(axis, d->pan_addr,
+                        d->is_signed ? FIX_EncodeS16(value, d->scale)
+                                     : FIX_EncodeU16(value, d->scale));
+}
+
+bool REG_CheckValue(Axis_t axis, RegId_t id, float *value)
+{
+    float max;
+
+    switch (id)
+    {
+        case REGID_VELOCITY:
+        case REGID_ACCEL:
+            max = (id == REGID_VELOCITY) ? Compute_MaxVelocity(axis) : Compute_MaxAcceleration(axis);
+            *value = (*value > max) ? max : *value;
+            return true;
+
+        case REGID_POSITION:
+        case REGID_DEG_POS:
+            return Check_SoftwareLimit(axis, *value);
+
+        default:
+            return true;
+    }
+}
+
+/*----------------------------------------------------------
+ * Block planner: sort by (area, address), merge close runs
+ *----------------------------------------------------------*/
+uint32_t REG_PlanBlocks(const RegId_t *ids, uint32_t n_ids, uint16_t max_gap,
+                        RegBlock_t *blocks, uint32_t max_blocks)
+{
+    uint32_t key[REGID_COUNT];
+    uint32_t n = 0U;
+    uint32_t nb = 0U;
+    uint32_t i;
+
+    /* key = area:addr, duplicates dropped, insertion sort (tiny n) */
+    for (i = 0U; i < n_ids; i++)
+    {
+        const RegDesc_t *d = &REG_TABLE[ids[i]];
+        uint32_t k = ((uint32_t)d->area << 16U) | d->pan_addr;
+        uint32_t j = n;
+        bool dup = false;
+        uint32_t m;
+
+        for (m = 0U; m < n; m++) { dup = dup || (key[m] == k); }
+        if (dup || (n >= REGID_COUNT)) { continue; }
+
+        while ((j > 0U) && (key[j - 1U] > k))
+        {
+            key[j] = key[j - 1U];
+            j--;
+        }
+        key[j] = k;
+        n++;
+    }
+
+    for (i = 0U; i < n; i++)
+    {
+        RegArea_t area = (RegArea_t)(key[i] >> 16U);
+        uint16_t  addr = (uint16_t)(key[i] & 0xFFFFU);
+        RegBlock_t *last = (nb > 0U) ? &blocks[nb - 1U] : NULL;
+
+        if ((last != NULL) && (last->area == area))
+        {
+            uint32_t end  = (uint32_t)last->pan_addr + last->count;   /* one past */
+            uint32_t span = ((uint32_t)addr - last->pan_addr) + 1U;
+
+            if ((addr <= (end + max_gap)) && (span <= REG_MAX_BLOCK))
+            {
+                last->count = (uint16_t)span;
+                continue;
+            }
+        }
+
+        if (nb >= max_blocks)
+        {
+            return 0U;
+        }
+        blocks[nb].area     = area;
+        blocks[nb].pan_addr = addr;
+        blocks[nb].count    = 1U;
+        nb++;
+    }
+
+    return nb;
+}
+
+/*----------------------------------------------------------
+ * Read a register set through the block plan
+ *----------------------------------------------------------*/
+uint32_t REG_ReadSet(Axis_t axis, const RegId_t *ids, uint32_t n_ids, fix16_t *values)
+{
+    return REG_ReadSetSampled(axis, ids, n_ids, values, NULL);
+}
+
+uint32_t REG_ReadSetSampled(Axis_t axis, const RegId_t *ids, uint32_t n_ids,
+                            fix16_t *values, uint64_t *sample_us)
+{
+    RegBlock_t blocks[REGID_COUNT];
+    uint32_t   nb = REG_PlanBlocks(ids, n_ids, 8U, blocks, REGID_COUNT);
+    uint32_t   got = 0U;
+    uint32_t   b;
+    uint32_t   i;
+
+    for (i = 0U; i < n_ids; i++)
+    {
+        values[i] = 0;
+        if (sample_us != NULL) { sample_us[i] = 0U; }
+    }
+
+    for (b = 0U; b < nb; b++)
+    {
+        ModbusView_t view;
+        uint16_t words[REG_MAX_BLOCK];
+        uint16_t addr = AXIS_Reg(axis, blocks[b].pan_addr);
+        int32_t  len  = MODBUS_ReadView(AXIS_UnitId(axis), AreaFunc(blocks[b].area),
+                                        addr, blocks[b].count, &view);
+
+        if (len < 0)
+        {
+            printf("[ERROR] Block read @%u x%u failed\n", addr, blocks[b].count);
+            continue;
+        }
+        MODBUS_DecodeWords(view.regs, words, blocks[b].count);
+
+        /* Scatter: every requested register inside this block */
+        for (i = 0U; i < n_ids; i++)
+        {
+            const RegDesc_t *d = &REG_TABLE[ids[i]];
+
+            if ((d->area == blocks[b].area) &&
+                (d->pan_addr >= blocks[b].pan_addr) &&
+                (d->pan_addr < (blocks[b].pan_addr + blocks[b].count)))
+            {
+                uint16_t raw = words[d->pan_addr - blocks[b].pan_addr];
+                values[i] = d->is_signed ? FIX_DecodeS16(raw, d->scale)
+                                         : FIX_DecodeU16(raw, d->scale);
+                if (sample_us != NULL)
+                {
+                    sample_us[i] = TSTAMP_Midpoint(&view.stamp);
+                }
+                got++;
+            }
+        }
+        MODBUS_ViewRelease(&view);
+    }
+
+    return got;
+}
@@ -0,0 +1,180 @@
+#ifndef REGISTER_ACCESS_H
+#define REGISTER_ACCESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_table.h"
+#include "fixed_point.h"
+
+/*===========================================================
+ * Register Descriptors (generated from DRIVE_AXIS_REGISTERS)
+ *===========================================================*/
+typedef enum
+{
+    REG_AREA_HOLDING = 0,      /**< 0x03 / 0x06 / 0x10 */
+    REG_AREA_INPUT   = 1       /**< 0x04 */
+} RegArea_t;
+
+typedef enum
+{
+    REG_ACCESS_RO = 1,
+    REG_ACCESS_WO = 2,
+    REG_ACCESS_RW = 3
+} RegAccess_t;
+
+/* Register IDs: REGID_<name>, in table order */
+#define REGTAB_ID(n, addr, area, w, sc, sg, acc)   REGID_##n,
+typedef enum
+{
+    DRIVE_AXIS_REGISTERS(REGTAB_ID)
+    REGID_COUNT
+} RegId_t;
+#undef REGTAB_ID
+
+/**
+ * @brief One row of the register table
+ */
+typedef struct
+{
+    const char       *name;
+    uint16_t          pan_addr;   /**< Axis 1 address; AXIS_Reg() for others */
+    RegArea_t         area;
+    uint8_t           width;      /**< Words */
+    const FixScale_t *scale;
+    bool              is_signed;
+    RegAccess_t       access;
+} RegDesc_t;
+
+extern const RegDesc_t REG_TABLE[REGID_COUNT];
+
+/**
+ * @brief A decoded value and when the drive sampled it: the midpoint
+ *        of request and reply (TSTAMP_Midpoint), monotonic us
+ */
+typedef struct
+{
+    fix16_t  value;
+    uint64_t sample_us;           /**< 0 if the read failed */
+} RegSample_t;
+
+/**
+ * @brief One contiguous read produced by REG_PlanBlocks
+ */
+typedef struct
+{
+    RegArea_t area;
+    uint16_t  pan_addr;           /**< First register (axis 1 address) */
+    uint16_t  count;              /**< Registers to read */
+} RegBlock_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief Read one register word of an axis
+ * @return Response length, or -1 on a short/failed response (raw = 0)
+ */
+int32_t REG_ReadRaw(Axis_t axis, uint16_t pan_addr, RegArea_t area, uint16_t *raw);
+
+/**
+ * @brief Write one holding register word of an axis (0x06)
+ */
+int32_t REG_WriteRaw(Axis_t axis, uint16_t pan_addr, uint16_t raw);
+
+/**
+ * @brief Table-driven read/write in Q16.16 engineering units
+ */
+int32_t REG_Read(Axis_t axis, RegId_t id, fix16_t *value);
+int32_t REG_Write(Axis_t axis, RegId_t id, fix16_t value);
+
+/**
+ * @brief The checks the Set_* functions make before a write, for any
+ *        writer (script, daemon): VELOCITY and ACCEL above the axis
+ *        maximum are clamped in *value, DEG_POS and POSITION (both
+ *        degrees) outside the software limits are refused
+ * @return true if *value may be written
+ */
+bool REG_CheckValue(Axis_t axis, RegId_t id, float *value);
+
+/**
+ * @brief As REG_Read, with the sample time of the value
+ */
+int32_t REG_ReadSample(Axis_t axis, RegId_t id, RegSample_t *sample);
+
+/**
+ * @brief Coalesce registers into as few reads as possible
+ * @param ids         Registers wanted (any order)
+ * @param max_gap     Largest run of unused registers read through
+ * @param blocks      Output plan, sorted by area then address
+ * @return Number of blocks (0 if max_blocks is too small)
+ */
+uint32_t REG_PlanBlocks(const RegId_t *ids, uint32_t n_ids, uint16_t max_gap,
+                        RegBlock_t *blocks, uint32_t max_blocks);
+
+/**
+ * @brief Read a set of registers with the fewest requests and decode each
+ *        with its own scale
+ * @return Number of values read (values of failed blocks are left as 0)
+ */
+uint32_t REG_ReadSet(Axis_t axis, const RegId_t *ids, uint32_t n_ids, fix16_t *values);
+
+/**
+ * @brief As REG_ReadSet, with each value's sample time (values read in
+ *        one block share it; 0 where the block failed)
+ */
+uint32_t REG_ReadSetSampled(Axis_t axis, const RegId_t *ids, uint32_t n_ids,
+                            fix16_t *values, uint64_t *sample_us);
+
+/*===========================================================
+ * Generated Per-Register Accessors
+ *===========================================================*/
+/* Address, area and scale are literals at every call site:
+ *   REG_Decode_<name>(raw)      -> fix16_t
+ *   REG_Encode_<name>(value)    -> register word (saturating)
+ *   REG_Get_<name>(axis, &v)    readable registers only
+ *   REG_Set_<name>(axis, v)     writable registers only          */
+#define REGTAB_DECODE_1(raw, sc)     FIX_DecodeS16((raw), &FIX_SCALE_##sc)
+#define REGTAB_DECODE_0(raw, sc)     FIX_DecodeU16((raw), &FIX_SCALE_##sc)
+#define REGTAB_ENCODE_1(value, sc)   FIX_EncodeS16((value), &FIX_SCALE_##sc)
+#define REGTAB_ENCODE_0(value, sc)   FIX_EncodeU16((value), &FIX_SCALE_##sc)
+
+#define REGTAB_GETTER(n, addr, area) \
+    static inline int32_t REG_Get_##n(Axis_t axis, fix16_t *value) \
+    { \
+        uint16_t raw = 0U; \
+        int32_t len = REG_ReadRaw(axis, (addr), REG_AREA_##area, &raw); \
+        *value = REG_Decode_##n(raw); \
+        return len; \
+    }
+#define REGTAB_SETTER(n, addr) \
+    static inline int32_t REG_Set_##n(Axis_t axis, fix16_t value) \
+    { \
+        return REG_WriteRaw(axis, (addr), REG_Encode_##n(value)); \
+    }
+
+#define REGTAB_GET_RO(n, addr, area)   REGTAB_GETTER(n, addr, area)
+#define REGTAB_GET_RW(n, addr, area)   REGTAB_GETTER(n, addr, area)
+#define REGTAB_GET_WO(n, addr, area)
+#define REGTAB_SET_RO(n, addr)
+#define REGTAB_SET_RW(n, addr)         REGTAB_SETTER(n, addr)
+#define REGTAB_SET_WO(n, addr)         REGTAB_SETTER(n, addr)
+
+/* Accessors move one word: a wider row fails to compile */
+#define REGTAB_ACCESSORS(n, addr, area, w, sc, sg, acc) \
+    typedef char REG_Width_##n[((w) == 1U) ? 1 : -1]; \
+    static inline fix16_t REG_Decode_##n(uint16_t raw) \
+    { \
+        return REGTAB_DECODE_##sg(raw, sc); \
+    } \
+    static inline uint16_t REG_Encode_##n(fix16_t value) \
+    { \
+        return REGTAB_ENCODE_##sg(value, sc); \
+    } \
+    REGTAB_GET_##acc(n, addr, area) \
+    REGTAB_SET_##acc(n, addr)
+
+DRIVE_AXIS_REGISTERS(REGTAB_ACCESSORS)
+
+#endif /* REGISTER_ACCESS_H */
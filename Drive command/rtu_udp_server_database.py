@@ -1,10 +1,44 @@
+import os
+import re
 import socket
 import threading
 import time
 
 
-UDP_IP = "127.0.0.1"
-UDP_PORT = 502
+# =========================================================
+# REGISTER MAP: parsed from config.h (same table as the C client)
+# =========================================================
+CONFIG_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "config.h")
+
+ROW_RE = re.compile(r"X\(\s*(\w+)\s*,\s*(\d+)U?\s*,\s*(HOLDING|INPUT)\s*,\s*(\d+)U?\s*,"
+                    r"\s*(\w+)\s*,\s*([01])\s*,\s*(RO|WO|RW)\s*\)")
+
+
+def parse_config(path=CONFIG_H):
+    """Return (defines, axis_rows, command_rows) from config.h."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    defines = {}
+    for m in re.finditer(r"^#define\s+(\w+)\s+\(?\s*(\"[^\"]*\"|-?[\d.]+)U?F?\s*\)?", text, re.M):
+        defines[m.group(1)] = m.group(2).strip('"')
+
+    def table(macro):
+        body = re.search(r"#define " + macro + r"\(X\)(.*?)\n\s*\n", text, re.S).group(1)
+        return [dict(name=r[0], addr=int(r[1]), area=r[2], width=int(r[3]),
+                     scale=r[4], signed=r[5] == "1", access=r[6])
+                for r in ROW_RE.findall(body)]
+
+    return defines, table("DRIVE_AXIS_REGISTERS"), table("DRIVE_COMMAND_REGISTERS")
+
+
+CONFIG, AXIS_REGS, CMD_REGS = parse_config()
+
+UDP_IP = CONFIG.get("DRIVE_IP_ADDR", "127.0.0.1")
+UDP_PORT = int(CONFIG.get("DRIVE_PORT_UDP", "502"))
+TCP_PORT = int(CONFIG.get("DRIVE_PORT_TCP", "502"))
+AXIS_COUNT = int(CONFIG.get("AXIS_COUNT", "2"))
+AXIS_REG_STRIDE = int(CONFIG.get("AXIS_REG_STRIDE", "500"))
 
 
 # =========================================================
@@ -28,81 +62,50 @@ def calc_crc(data):
 HR = {}   # Holding registers (0x03, 0x10)
 IR = {}   # Input registers (0x04)
 
+# Start-up values in register counts, one entry per axis (PAN, TILT);
+# registers not listed start at 0, extra axes reuse the last entry
+DEFAULTS = {
+    "POS_DEG":        (2500, 2800),   # deg *100
+    "VEL_SPD":        (120, 90),
+    "POS_MM":         (5000, 4500),   # mm *100
+    "RPM":            (1500, 1300),
+    "ACTUAL_CURRENT": (15, 12),
+    "IO_STATUS":      (1, 1),
+    "DCBUS_VOLT":     (540, 520),
+    "TEMP":           (45, 48),
+    "POSITION":       (1000, 2000),
+    "VELOCITY":       (100, 80),
+    "ACCEL":          (50, 40),
+    "DECEL":          (50, 40),
+}
+
 
 def init_registers():
-    # ------------------------------
-    # PAN INPUT REGISTERS (0x04)
-    # ------------------------------
-    IR[412] = 2500   # deg *100
-    IR[414] = 120    # vel *10
-    IR[416] = 5000   # mm *100
-    IR[418] = 1500   # rpm
-    IR[420] = 15     # current
-    IR[422] = 1      # I/O status
-    IR[424] = 0      # system status
-    IR[426] = 540    # DC bus
-    IR[428] = 45     # Temperature PAN
-    IR[430] = 0      # Fault code PAN
-
-    # ------------------------------
-    # TILT INPUT REGISTERS (0x04)
-    # ------------------------------
-    IR[912] = 2800
-    IR[914] = 90
-    IR[916] = 4500
-    IR[918] = 1300
-    IR[920] = 12
-    IR[922] = 1
-    IR[924] = 0
-    IR[926] = 520
-    IR[928] = 48
-    IR[930] = 0
-
-    # ------------------------------
-    # PAN HOLDING REGISTERS
-    # ------------------------------
-    HR[282] = 1000   # position
-    HR[284] = 100
-    HR[286] = 50
-    HR[288] = 50
-    HR[310] = 0
-    HR[312] = 0
-    HR[314] = 0
-
-    # ------------------------------
-    # TILT HOLDING REGISTERS
-    # ------------------------------
-    HR[782] = 2000
-    HR[784] = 80
-    HR[786] = 40
-    HR[788] = 40
-    HR[810] = 0
-    HR[812] = 0
-    HR[814] = 0
-
-    # -------------------------------
-    # FAULT REGISTERS
-    # -------------------------------
-    HR[384] = 0
-    HR[884] = 0
-
-    # -------------------------------
-    # COMMAND REGISTERS (write only)
-    # -------------------------------
-    HR[445] = 0     # halt
-    HR[446] = 0     # estop
-    HR[448] = 0     # enable
-    HR[449] = 0     # reset
-    HR[451] = 0     # pos move
-    HR[452] = 0     # home move
-    HR[453] = 0     # vel fwd
-    HR[454] = 0     # vel rev
-    HR[455] = 0     # pos move deg
+    for axis in range(AXIS_COUNT):
+        offset = axis * AXIS_REG_STRIDE
+        for reg in AXIS_REGS:
+            values = DEFAULTS.get(reg["name"], (0,))
+            value = values[min(axis, len(values) - 1)] & 0xFFFF
+            db = IR if reg["area"] == "INPUT" else HR
+            for w in range(reg["width"]):
+                db[reg["addr"] + offset + w] = value if w == 0 else 0
+
+    # Command registers (write only, shared by all axes)
+    for reg in CMD_REGS:
+        HR[reg["addr"]] = 0
 
 
 # =========================================================
 # RTU-UDP SERVER (WORKS WITH YOUR C PROGRAM)
 # =========================================================
+EX_ILLEGAL_FUNCTION = 0x01
+EX_ILLEGAL_VALUE = 0x03
+
+
+def exception_response(slave, func, code):
+    return bytes([slave, func | 0x80, code])
+
+
 def process_request(data):
     if len(data) < 4:
         return None
@@ -110,10 +113,21 @@ def process_request(data):
     slave = data[0]
     func = data[1]
     addr = (data[2] << 8) | data[3]
+    count = ((data[4] << 8) | data[5]) if len(data) >= 6 else 0
+
+    # Quantity limits of the Modbus spec
+    if func in (0x03, 0x04) and not 1 <= count <= 125:
+        response = exception_response(slave, func, EX_ILLEGAL_VALUE)
+        func = None
+    elif func == 0x10 and not 1 <= count <= 123:
+        response = exception_response(slave, func, EX_ILLEGAL_VALUE)
+        func = None
 
     # ------------- READ HOLDING (0x03) -------------
-    if func == 0x03:
-        count = (data[4] << 8) | data[5]
+    if func is None:
+        pass
+
+    elif func == 0x03:
         values = []
         for i in range(count):
             v = HR.get(addr + i, 0)
@@ -123,7 +137,6 @@ def process_request(data):
 
     # ------------- READ INPUT (0x04) -------------
     elif func == 0x04:
-        count = (data[4] << 8) | data[5]
         values = []
         for i in range(count):
             v = IR.get(addr + i, 0)
@@ -139,7 +152,6 @@ def process_request(data):
 
     # ------------- WRITE MULTIPLE REGISTERS (0x10) -------------
     elif func == 0x10:
-        count = (data[4] << 8) | data[5]
         byte_count = data[6]
         base = 7
         for i in range(count):
@@ -151,7 +163,7 @@ def process_request(data):
         response = bytes([slave, func, data[2], data[3], data[4], data[5]])
 
     else:
-        return None
+        response = exception_response(slave, func, EX_ILLEGAL_FUNCTION)
 
     # Add CRC
     crc = calc_crc(response)
@@ -159,22 +171,74 @@ def process_request(data):
     return response
 
 
+# =========================================================
+# MODBUS/TCP SERVER (MBAP header, no CRC; same register database)
+# =========================================================
+def serve_tcp_client(conn):
+    buf = b""
+    with conn:
+        while True:
+            chunk = conn.recv(4096)
+            if not chunk:
+                break
+            buf += chunk
+
+            # MBAP: tid(2) | protocol(2) | length(2) | unit, length = unit + PDU
+            while len(buf) >= 7:
+                length = (buf[4] << 8) | buf[5]
+                if len(buf) < 6 + length:
+                    break
+                adu, buf = buf[:6 + length], buf[6 + length:]
+                print("TCP RX:", adu.hex())
+
+                response = process_request(adu[6:])
+                if response:
+                    pdu = response[:-2]          # unit | PDU, RTU CRC dropped
+                    reply = adu[:4] + bytes([len(pdu) >> 8, len(pdu) & 0xFF]) + pdu
+                    print("TCP TX:", reply.hex(), "\n")
+                    conn.sendall(reply)
+
+
+def start_tcp_server():
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind((UDP_IP, TCP_PORT))
+    srv.listen(4)
+
+    while True:
+        conn, _ = srv.accept()
+        conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        threading.Thread(target=serve_tcp_client, args=(conn,), daemon=True).start()
+
+
 def start_rtu_udp_server():
     init_registers()
+    threading.Thread(target=start_tcp_server, daemon=True).start()
 
     sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
     sock.bind((UDP_IP, UDP_PORT))
 
-    print("🔥 FULL RTU-UDP Simulator running at 127.0.0.1:502")
-    print("   ✓ All registers loaded automatically")
+    print(f"🔥 FULL RTU-UDP Simulator running at {UDP_IP}:{UDP_PORT}")
+    print(f"   ✓ {len(AXIS_REGS)} axis x {AXIS_COUNT} + {len(CMD_REGS)} command registers from config.h")
     print("   ✓ Works with your C program (CRC, RTU frame)")
+    print(f"   ✓ MBAP over UDP on the same port, Modbus/TCP on {UDP_IP}:{TCP_PORT}")
     print("-------------------------------------------------\n")
 
     while True:
-        data, addr = sock.recvfrom(256)
+        data, addr = sock.recvfrom(512)
         print("RX:", data.hex())
 
-        response = process_request(data)
+        # RTU frames carry a valid CRC; anything else with a consistent
+        # MBAP header is MBAP over UDP (the "drive control old" format)
+        if (len(data) >= 8 and calc_crc(data) != 0 and data[2:4] == b"\x00\x00"
+                and ((data[4] << 8) | data[5]) == len(data) - 6):
+            response = process_request(data[6:])
+            if response:
+                pdu = response[:-2]
+                response = data[:4] + bytes([len(pdu) >> 8, len(pdu) & 0xFF]) + pdu
+        else:
+            response = process_request(data)
+
         if response:
             print("TX:", response.hex(), "\n")
             sock.sendto(response, addr)
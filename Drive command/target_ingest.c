@@ -0,0 +1,435 @@
+#include "config.h"
+#include "target_ingest.h"
+#include "drive_tracking.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <sys/un.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #include <errno.h>
+
+    typedef int SOCKET;
+    #define INVALID_SOCKET   (-1)
+    #define closesocket      close
+#endif
+
+#define NO_SOCK   ((uintptr_t)(intptr_t)INVALID_SOCKET)
+
+/*----------------------------------------------------------
+ * Little-endian field access
+ *----------------------------------------------------------*/
+static uint32_t GetU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void PutU32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static float GetF32(const uint8_t *p)
+{
+    uint32_t u = GetU32(p);
+    float f;
+
+    (void)memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static void PutF32(uint8_t *p, float f)
+{
+    uint32_t u;
+
+    (void)memcpy(&u, &f, sizeof(u));
+    PutU32(p, u);
+}
+
+bool INGEST_Decode(const uint8_t *msg, uint32_t len, TargetSample_t *out)
+{
+    if ((len != INGEST_MSG_LEN) ||
+        (((uint32_t)msg[0] | ((uint32_t)msg[1] << 8)) != INGEST_MAGIC) ||
+        (msg[2] != INGEST_VERSION))
+    {
+        return false;
+    }
+
+    out->flags    = msg[3] & (uint8_t)(TARGET_PAN | TARGET_TILT);
+    out->seq      = GetU32(&msg[4]);
+    out->t_us     = (uint64_t)GetU32(&msg[8]) | ((uint64_t)GetU32(&msg[12]) << 32);
+    out->pan_deg  = GetF32(&msg[16]);
+    out->pan_vel  = GetF32(&msg[20]);
+    out->tilt_deg = GetF32(&msg[24]);
+    out->tilt_vel = GetF32(&msg[28]);
+    out->rx_us    = 0U;
+
+    /* A NaN or Inf would pass every clamp of the tracker */
+    return (isfinite(out->pan_deg) != 0) && (isfinite(out->pan_vel) != 0) &&
+           (isfinite(out->tilt_deg) != 0) && (isfinite(out->tilt_vel) != 0);
+}
+
+void INGEST_Encode(const TargetSample_t *s, uint8_t *msg)
+{
+    msg[0] = (uint8_t)(INGEST_MAGIC & 0xFFU);
+    msg[1] = (uint8_t)(INGEST_MAGIC >> 8);
+    msg[2] = (uint8_t)INGEST_VERSION;
+    msg[3] = s->flags;
+    PutU32(&msg[4], s->seq);
+    PutU32(&msg[8], (uint32_t)s->t_us);
+    PutU32(&msg[12], (uint32_t)(s->t_us >> 32));
+    PutF32(&msg[16], s->pan_deg);
+    PutF32(&msg[20], s->pan_vel);
+    PutF32(&msg[24], s->tilt_deg);
+    PutF32(&msg[28], s->tilt_vel);
+}
+
+/*----------------------------------------------------------
+ * Latest-value slot. One writer (the receiver), any number
+ * of readers; a reader retries if the generation was odd
+ * (write in progress) or changed while it copied.
+ *----------------------------------------------------------*/
+static void Publish(TargetSlot_t *slot, const TargetSample_t *s)
+{
+    uint32_t g = __atomic_load_n(&slot->gen, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&slot->gen, g + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    (void)memcpy(&slot->sample, s, sizeof(*s));
+    __atomic_store_n(&slot->gen, g + 2U, __ATOMIC_RELEASE);
+}
+
+bool INGEST_Latest(const TargetIngest_t *ing, TargetSample_t *out, uint32_t *gen)
+{
+    uint32_t g1;
+    uint32_t g2;
+
+    do
+    {
+        g1 = __atomic_load_n(&ing->slot.gen, __ATOMIC_ACQUIRE);
+        (void)memcpy(out, &ing->slot.sample, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        g2 = __atomic_load_n(&ing->slot.gen, __ATOMIC_RELAXED);
+    } while (((g1 & 1U) != 0U) || (g1 != g2));
+
+    if ((g1 == 0U) || (g1 == *gen))
+    {
+        return false;                   /* empty, or seen already */
+    }
+    *gen = g1;
+    return true;
+}
+
+/*----------------------------------------------------------
+ * Sockets
+ *----------------------------------------------------------*/
+static void Reset(TargetIngest_t *ing)
+{
+    (void)memset(ing, 0, sizeof(*ing));
+    ing->sock = NO_SOCK;
+}
+
+/* Bounded wait in recv(), so INGEST_Run sees INGEST_Stop */
+static void SetWait(SOCKET s)
+{
+#ifdef _WIN32
+    DWORD ms = INGEST_WAIT_MS;
+
+    (void)setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char *)&ms, sizeof(ms));
+#else
+    struct timeval tv;
+
+    tv.tv_sec  = (time_t)(INGEST_WAIT_MS / 1000U);
+    tv.tv_usec = (suseconds_t)((INGEST_WAIT_MS % 1000U) * 1000U);
+    (void)setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+}
+
+int32_t INGEST_OpenUnix(TargetIngest_t *ing, const char *path)
+{
+    Reset(ing);
+#ifdef _WIN32
+    (void)path;
+    printf("Target ingest: Unix datagram sockets not available, use UDP\n");
+    return -1;
+#else
+    {
+        struct sockaddr_un addr;
+        SOCKET s;
+
+        if (path == NULL)
+        {
+            path = INGEST_UNIX_PATH;
+        }
+        if (strlen(path) >= sizeof(addr.sun_path))
+        {
+            printf("Target ingest: socket path too long\n");
+            return -1;
+        }
+
+        s = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (s == INVALID_SOCKET)
+        {
+            printf("Target ingest: socket() failed (%d)\n", errno);
+            return -1;
+        }
+
+        (void)memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        (void)strcpy(addr.sun_path, path);
+        (void)unlink(path);             /* left behind by a previous run */
+
+        if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            printf("Target ingest: bind %s failed (%d)\n", path, errno);
+            (void)closesocket(s);
+            return -1;
+        }
+
+        SetWait(s);
+        ing->sock = (uintptr_t)s;
+        (void)strcpy(ing->path, path);
+        printf("Target ingest: listening on %s\n", path);
+        return 0;
+    }
+#endif
+}
+
+int32_t INGEST_OpenUdp(TargetIngest_t *ing, uint16_t port)
+{
+    struct sockaddr_in addr;
+    SOCKET s;
+
+    Reset(ing);
+    if (port == 0U)
+    {
+        port = (uint16_t)INGEST_PORT_UDP;
+    }
+
+    s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET)
+    {
+        printf("Target ingest: socket() failed\n");
+        return -1;
+    }
+
+    /* Loopback only: targets come from a process on this host */
+    (void)memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        printf("Target ingest: bind 127.0.0.1:%u failed\n", (unsigned)port);
+        (void)closesocket(s);
+        return -1;
+    }
+
+    SetWait(s);
+    ing->sock = (uintptr_t)s;
+    printf("Target ingest: listening on 127.0.0.1:%u\n", (unsigned)port);
+    return 0;
+}
+
+void INGEST_Close(TargetIngest_t *ing)
+{
+    if (ing->sock != NO_SOCK)
+    {
+        (void)closesocket((SOCKET)ing->sock);
+        ing->sock = NO_SOCK;
+    }
+#ifndef _WIN32
+    if (ing->path[0] != '\0')
+    {
+        (void)unlink(ing->path);
+        ing->path[0] = '\0';
+    }
+#endif
+}
+
+/*----------------------------------------------------------
+ * Receive path
+ *----------------------------------------------------------*/
+
+/* Helper: one datagram. 1 = published, 0 = taken but dropped,
+ * -1 = nothing queued (or the wait ran out), -2 = socket error */
+static int32_t ReceiveOne(TargetIngest_t *ing, bool wait)
+{
+    SOCKET s = (SOCKET)ing->sock;
+    uint8_t buf[INGEST_MSG_LEN + 1U];   /* one spare byte exposes oversize */
+    TargetSample_t t;
+    int n;
+
+#ifdef _WIN32
+    if (!wait)
+    {
+        u_long avail = 0U;
+
+        if ((ioctlsocket(s, FIONREAD, &avail) != 0) || (avail == 0U))
+        {
+            return -1;
+        }
+    }
+    n = recv(s, (char *)buf, (int)sizeof(buf), 0);
+    if (n < 0)
+    {
+        int err = WSAGetLastError();
+
+        if (err == WSAEMSGSIZE)
+        {
+            ing->stats.rejected++;      /* oversize, truncated */
+            return 0;
+        }
+        return (err == WSAETIMEDOUT) ? -1 : -2;
+    }
+#else
+    n = (int)recv(s, buf, sizeof(buf), wait ? 0 : MSG_DONTWAIT);
+    if (n < 0)
+    {
+        return ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) ? -1 : -2;
+    }
+#endif
+
+    if (!INGEST_Decode(buf, (uint32_t)n, &t))
+    {
+        ing->stats.rejected++;
+        return 0;
+    }
+    ing->stats.received++;
+    t.rx_us = TIME_NowUs();
+
+    /* Sequence is compared modulo 2^32 so the sender may wrap; a long
+     * jump back or a silent sender means it restarted */
+    if (ing->have_seq && ((int32_t)(t.seq - ing->last_seq) <= 0))
+    {
+        int32_t back = (int32_t)(ing->last_seq - t.seq);
+        bool    idle = ((t.rx_us - ing->last_rx_us) > INGEST_IDLE_RESET_US);
+
+        if ((back >= 0) && (back <= (int32_t)INGEST_SEQ_RESTART) && !idle)
+        {
+            ing->stats.stale++;
+            return 0;
+        }
+        ing->stats.restarts++;
+    }
+    ing->have_seq   = true;
+    ing->last_seq   = t.seq;
+    ing->last_rx_us = t.rx_us;
+
+    if ((t.t_us == 0U) || (t.t_us > t.rx_us))
+    {
+        t.t_us = t.rx_us;               /* unstamped, or not our clock */
+    }
+    else
+    {
+        uint64_t lat = t.rx_us - t.t_us;
+
+        ing->stats.stamped++;
+        ing->stats.latency_sum_us += lat;
+        if (lat > ing->stats.latency_max_us)
+        {
+            ing->stats.latency_max_us = (lat > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32_t)lat;
+        }
+    }
+
+    Publish(&ing->slot, &t);
+    return 1;
+}
+
+void INGEST_Run(TargetIngest_t *ing)
+{
+    __atomic_store_n(&ing->stop, false, __ATOMIC_RELAXED);
+    while (!__atomic_load_n(&ing->stop, __ATOMIC_RELAXED))
+    {
+        if (ReceiveOne(ing, true) == -2)
+        {
+            printf("Target ingest: receive failed, stopping\n");
+            break;
+        }
+    }
+}
+
+void INGEST_Stop(TargetIngest_t *ing)
+{
+    __atomic_store_n(&ing->stop, true, __ATOMIC_RELAXED);
+}
+
+uint32_t INGEST_Poll(TargetIngest_t *ing)
+{
+    uint32_t n = 0U;
+    uint32_t i;
+    int32_t  rc = 0;
+
+    /* Bounded so a flooding sender cannot hold the cycle */
+    for (i = 0U; (i < INGEST_POLL_MAX) && (rc >= 0); i++)
+    {
+        rc = ReceiveOne(ing, false);
+        n += (rc > 0) ? 1U : 0U;
+    }
+    return n;
+}
+
+/*----------------------------------------------------------
+ * Tracking glue (runs on the cyclic executive's thread)
+ *----------------------------------------------------------*/
+bool INGEST_Apply(IngestFeed_t *feed)
+{
+    TargetSample_t t;
+
+    if (!INGEST_Latest(feed->ing, &t, &feed->gen))
+    {
+        return false;
+    }
+    if ((feed->pan != NULL) && ((t.flags & TARGET_PAN) != 0U))
+    {
+        TRACK_SetTarget(feed->pan, t.pan_deg, t.pan_vel, t.t_us);
+    }
+    if ((feed->tilt != NULL) && ((t.flags & TARGET_TILT) != 0U))
+    {
+        TRACK_SetTarget(feed->tilt, t.tilt_deg, t.tilt_vel, t.t_us);
+    }
+    return true;
+}
+
+void INGEST_FeedTask(void *arg)
+{
+    IngestFeed_t *feed = (IngestFeed_t *)arg;
+
+    if (feed->poll)
+    {
+        (void)INGEST_Poll(feed->ing);
+    }
+    (void)INGEST_Apply(feed);
+}
+
+void INGEST_PrintStats(const TargetIngest_t *ing)
+{
+    const IngestStats_t *s = &ing->stats;
+
+    printf("\n====== TARGET INGEST ======\n");
+    printf("  received   : %llu | rejected %llu | stale %llu | restarts %llu\n",
+           (unsigned long long)s->received, (unsigned long long)s->rejected,
+           (unsigned long long)s->stale, (unsigned long long)s->restarts);
+    if (s->stamped > 0U)
+    {
+        printf("  latency    : mean %llu us | max %lu us (%llu stamped)\n",
+               (unsigned long long)(s->latency_sum_us / s->stamped),
+               (unsigned long)s->latency_max_us, (unsigned long long)s->stamped);
+    }
+}
@@ -0,0 +1,193 @@
+#ifndef TARGET_INGEST_H
+#define TARGET_INGEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "drive_tracking.h"
+
+/*===========================================================
+ * Target Stream Ingest
+ *===========================================================*/
+/* Receives PAN/TILT targets from a local process (e.g. vision) over a
+ * Unix datagram socket or UDP on 127.0.0.1. The newest target goes
+ * into a latest-value slot that the cyclic executive reads without
+ * locks or system calls. Receiving allocates nothing and makes one
+ * recv() per datagram.
+ *
+ * Message, 32 bytes, little-endian:
+ *
+ *   0   u16  magic 0x5447 ("TG")
+ *   2   u8   version (1)
+ *   3   u8   flags: bit 0 PAN valid, bit 1 TILT valid
+ *   4   u32  sequence (newer wins; older datagrams are dropped, but
+ *            see INGEST_SEQ_RESTART / INGEST_IDLE_RESET_US)
+ *   8   u64  target time, CLOCK_MONOTONIC us (TIME_NowUs base); 0 =
+ *            time of receipt
+ *   16  f32  PAN deg      20  f32  PAN deg/s
+ *   24  f32  TILT deg     28  f32  TILT deg/s                       */
+
+#ifndef INGEST_UNIX_PATH
+    #define INGEST_UNIX_PATH      "/tmp/drive_targets.sock"
+#endif
+#ifndef INGEST_PORT_UDP
+    #define INGEST_PORT_UDP       (5600U)
+#endif
+#ifndef INGEST_POLL_MAX
+    #define INGEST_POLL_MAX       (64U)      /* Datagrams per INGEST_Poll */
+#endif
+#ifndef INGEST_WAIT_MS
+    #define INGEST_WAIT_MS        (100U)     /* INGEST_Run checks for stop */
+#endif
+
+/* A restarted sender counts from its start again. A sequence further
+ * back than INGEST_SEQ_RESTART, or any sequence after
+ * INGEST_IDLE_RESET_US without an accepted target, begins a new
+ * stream instead of being dropped as old. The idle time matches
+ * TRACK_TARGET_HORIZON_US: by then the tracker holds the last target
+ * anyway. */
+#ifndef INGEST_SEQ_RESTART
+    #define INGEST_SEQ_RESTART    (1024U)
+#endif
+#ifndef INGEST_IDLE_RESET_US
+    #define INGEST_IDLE_RESET_US  (500000U)
+#endif
+
+#define INGEST_MAGIC              (0x5447U)
+#define INGEST_VERSION            (1U)
+#define INGEST_MSG_LEN            (32U)
+
+#define TARGET_PAN                (0x01U)
+#define TARGET_TILT               (0x02U)
+
+/**
+ * @brief One decoded target
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint8_t  flags;          /**< TARGET_PAN | TARGET_TILT */
+    float    pan_deg;
+    float    pan_vel;        /**< deg/s */
+    float    tilt_deg;
+    float    tilt_vel;
+    uint64_t t_us;           /**< Time the target refers to */
+    uint64_t rx_us;          /**< Time it was received */
+} TargetSample_t;
+
+/**
+ * @brief Latest-value slot (seqlock: gen is odd while it is written)
+ */
+typedef struct
+{
+    uint32_t       gen;
+    TargetSample_t sample;
+} TargetSlot_t;
+
+/**
+ * @brief Receiver counters (written by the receiving thread)
+ */
+typedef struct
+{
+    uint64_t received;
+    uint64_t rejected;       /**< Wrong size, magic or version; not finite */
+    uint64_t stale;          /**< Sequence not newer than the last */
+    uint64_t restarts;       /**< Sequence taken as a sender restart */
+    uint64_t latency_sum_us; /**< Target time to receipt (stamped only) */
+    uint32_t latency_max_us;
+    uint64_t stamped;
+} IngestStats_t;
+
+/**
+ * @brief One ingest endpoint
+ */
+typedef struct
+{
+    uintptr_t     sock;      /**< SOCKET / int */
+    char          path[108]; /**< Unix socket path, unlinked on close */
+    bool          have_seq;
+    uint32_t      last_seq;
+    uint64_t      last_rx_us; /**< Receipt of the last accepted target */
+    volatile bool stop;
+    TargetSlot_t  slot;
+    IngestStats_t stats;
+} TargetIngest_t;
+
+/**
+ * @brief Cyclic task that hands new targets to the tracking loops
+ */
+typedef struct
+{
+    TargetIngest_t *ing;
+    TrackAxis_t    *pan;     /**< NULL: axis not tracked */
+    TrackAxis_t    *tilt;
+    uint32_t        gen;     /**< Slot generation last applied */
+    bool            poll;    /**< Receive in the task too (no INGEST_Run thread) */
+} IngestFeed_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Bind a Unix datagram socket (path NULL = INGEST_UNIX_PATH)
+ * @return 0, or -1 (not available on Windows)
+ */
+int32_t INGEST_OpenUnix(TargetIngest_t *ing, const char *path);
+
+/**
+ * @brief  Bind UDP on 127.0.0.1:port (0 = INGEST_PORT_UDP)
+ */
+int32_t INGEST_OpenUdp(TargetIngest_t *ing, uint16_t port);
+
+void INGEST_Close(TargetIngest_t *ing);
+
+/**
+ * @brief  Decode one message (exposed for senders' tests)
+ * @return false if it is not a valid target message or a position
+ *         or velocity is not finite
+ */
+bool INGEST_Decode(const uint8_t *msg, uint32_t len, TargetSample_t *out);
+
+/**
+ * @brief  Encode one message into INGEST_MSG_LEN bytes
+ */
+void INGEST_Encode(const TargetSample_t *s, uint8_t *msg);
+
+/**
+ * @brief  Receive loop for a thread of its own: blocks in recv(),
+ *         publishes each new target, returns after INGEST_Stop()
+ */
+void INGEST_Run(TargetIngest_t *ing);
+void INGEST_Stop(TargetIngest_t *ing);
+
+/**
+ * @brief  Take every datagram already queued, without waiting
+ *         (single-threaded use, e.g. from a slow cyclic task)
+ * @return Targets published
+ */
+uint32_t INGEST_Poll(TargetIngest_t *ing);
+
+/**
+ * @brief  Read the slot; lock-free, safe against a concurrent receiver
+ * @param  gen  In: generation seen last; out: generation read
+ * @return true if the slot holds a target newer than *gen
+ */
+bool INGEST_Latest(const TargetIngest_t *ing, TargetSample_t *out, uint32_t *gen);
+
+/**
+ * @brief  Hand a new target, if any, to the tracking loops
+ * @return true if one was applied
+ */
+bool INGEST_Apply(IngestFeed_t *feed);
+
+/**
+ * @brief  CyclicTaskFn_t wrapper: arg is an IngestFeed_t *; register
+ *         it ahead of the TRACK_Task entries. With feed->poll set it
+ *         calls INGEST_Poll() first.
+ */
+void INGEST_FeedTask(void *arg);
+
+void INGEST_PrintStats(const TargetIngest_t *ing);
+
+#endif /* TARGET_INGEST_H */
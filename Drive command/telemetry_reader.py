@@ -0,0 +1,81 @@
+import mmap
+import os
+import struct
+import sys
+import time
+
+
+# =========================================================
+# LAYOUT: must match telemetry_shm.h
+# =========================================================
+SHM_PATH = "/dev/shm/drive_telemetry"        # TELEM_SHM_NAME
+
+HEADER = struct.Struct("=IHHIIQQIII20x")      # TelemHeader_t, 64 bytes
+AXIS = struct.Struct("=Q7i4HI")               # TelemAxis_t, 48 bytes
+MAGIC = 0x4C455444
+VERSION = 2
+
+FLAG_FAULT, FLAG_LIMIT, FLAG_NO_DATA = 0x1, 0x2, 0x4
+Q16 = 65536.0
+
+
+def attach(path=SHM_PATH):
+    """Map the segment read-only and check its layout."""
+    fd = os.open(path, os.O_RDONLY)
+    try:
+        mem = mmap.mmap(fd, 0, mmap.MAP_SHARED, mmap.PROT_READ)
+    finally:
+        os.close(fd)
+
+    magic, version, count, rec_size = HEADER.unpack_from(mem, 0)[:4]
+    if magic != MAGIC or version != VERSION or rec_size != AXIS.size:
+        raise RuntimeError("unknown telemetry layout")
+    return mem, count
+
+
+def read(mem, count, retries=1000):
+    """Consistent snapshot (seqlock): (header tuple, [axis dicts]) or None."""
+    for _ in range(retries):
+        seq1 = struct.unpack_from("=I", mem, 12)[0]
+        if seq1 & 1:
+            continue
+        raw = mem[:HEADER.size + count * AXIS.size]
+        seq2 = struct.unpack_from("=I", mem, 12)[0]
+        if seq1 == seq2 and seq1 != 0:
+            break
+    else:
+        return None
+
+    hdr = HEADER.unpack_from(raw, 0)
+    axes = []
+    for i in range(count):
+        v = AXIS.unpack_from(raw, HEADER.size + i * AXIS.size)
+        axes.append(dict(sample_us=v[0], pos_deg=v[1] / Q16, velocity=v[2] / Q16,
+                         pos_mm=v[3] / Q16, rpm=v[4] / Q16, current=v[5] / Q16,
+                         dcbus=v[6] / Q16, temp=v[7] / Q16, fault_bits=v[8],
+                         io=v[9], sys=v[10], fault_code=v[11], flags=v[12]))
+    return hdr, axes
+
+
+# =========================================================
+# MAIN: print the telemetry at a fixed rate
+# =========================================================
+if __name__ == "__main__":
+    period = float(sys.argv[1]) if len(sys.argv) > 1 else 0.5
+    mem, count = attach()
+    print("Attached to %s (%d axes)" % (SHM_PATH, count))
+
+    while True:
+        snap = read(mem, count)
+        if snap is None:
+            print("no consistent snapshot (daemon not publishing?)")
+        else:
+            hdr, axes = snap
+            age_ms = (time.monotonic_ns() // 1000 - hdr[6]) / 1000.0
+            line = "image %-7d age %6.1f ms" % (hdr[5], age_ms)
+            for i, a in enumerate(axes):
+                state = "FAULT" if a["flags"] & FLAG_FAULT else (
+                    "LIMIT" if a["flags"] & FLAG_LIMIT else "ok")
+                line += " | ax%d %8.2f deg %7.2f A %s" % (i + 1, a["pos_deg"], a["current"], state)
+            print(line)
+        time.sleep(period)
@@ -0,0 +1,258 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE      /* shm_open, fchmod, ftruncate under -std=c99 */
+#endif
+
+#include "config.h"
+#include "telemetry_shm.h"
+#include "axis_state.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <errno.h>
+
+/*----------------------------------------------------------
+ * Helper: map a segment of size bytes
+ *----------------------------------------------------------*/
+static int32_t Map(TelemetryShm_t *t, int fd, uint32_t size, bool writable)
+{
+    void *p = mmap(NULL, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                   MAP_SHARED, fd, 0);
+
+    (void)close(fd);                    /* the mapping keeps it */
+    if (p == MAP_FAILED)
+    {
+        printf("Telemetry: mmap failed (%d)\n", errno);
+        return -1;
+    }
+    t->hdr  = (TelemHeader_t *)p;
+    t->axis = (TelemAxis_t *)((uint8_t *)p + sizeof(TelemHeader_t));
+    t->size = size;
+    return 0;
+}
+
+static void SetName(TelemetryShm_t *t, const char *name)
+{
+    (void)memset(t, 0, sizeof(*t));
+    (void)strncpy(t->name, (name != NULL) ? name : TELEM_SHM_NAME, sizeof(t->name) - 1U);
+}
+
+int32_t TELEM_Create(TelemetryShm_t *t, const char *name, uint32_t axis_count)
+{
+    uint32_t size;
+    int fd;
+
+    SetName(t, name);
+    if (axis_count > AXIS_STATE_CAPACITY)
+    {
+        axis_count = AXIS_STATE_CAPACITY;
+    }
+    size = (uint32_t)sizeof(TelemHeader_t) + (axis_count * (uint32_t)sizeof(TelemAxis_t));
+
+    /* A new segment each run: readers of the old one see it go stale */
+    (void)shm_unlink(t->name);
+    fd = shm_open(t->name, O_CREAT | O_EXCL | O_RDWR, TELEM_SHM_MODE);
+    if (fd < 0)
+    {
+        printf("Telemetry: shm_open %s failed (%d)\n", t->name, errno);
+        return -1;
+    }
+    (void)fchmod(fd, TELEM_SHM_MODE);   /* not narrowed by the umask */
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        printf("Telemetry: ftruncate failed (%d)\n", errno);
+        (void)close(fd);
+        (void)shm_unlink(t->name);
+        return -1;
+    }
+    if (Map(t, fd, size, true) != 0)
+    {
+        (void)shm_unlink(t->name);
+        return -1;
+    }
+    t->owner = true;
+
+    /* Pages are zero; the header is complete before readers can trust it */
+    t->hdr->version     = (uint16_t)TELEM_VERSION;
+    t->hdr->axis_count  = (uint16_t)axis_count;
+    t->hdr->record_size = (uint32_t)sizeof(TelemAxis_t);
+    t->hdr->writer_pid  = (uint32_t)getpid();
+    __atomic_store_n(&t->hdr->magic, (uint32_t)TELEM_MAGIC, __ATOMIC_RELEASE);
+
+    printf("Telemetry: publishing %lu axes in %s\n", (unsigned long)axis_count, t->name);
+    return 0;
+}
+
+int32_t TELEM_Attach(TelemetryShm_t *t, const char *name)
+{
+    struct stat st;
+    int fd;
+
+    SetName(t, name);
+    fd = shm_open(t->name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(TelemHeader_t)))
+    {
+        (void)close(fd);
+        return -1;
+    }
+    if (Map(t, fd, (uint32_t)st.st_size, false) != 0)
+    {
+        return -1;
+    }
+
+    if ((__atomic_load_n(&t->hdr->magic, __ATOMIC_ACQUIRE) != (uint32_t)TELEM_MAGIC) ||
+        (t->hdr->version != (uint16_t)TELEM_VERSION) ||
+        (t->hdr->record_size != (uint32_t)sizeof(TelemAxis_t)) ||
+        (t->size < ((uint32_t)sizeof(TelemHeader_t) +
+                    ((uint32_t)t->hdr->axis_count * (uint32_t)sizeof(TelemAxis_t)))))
+    {
+        printf("Telemetry: %s has an unknown layout\n", t->name);
+        TELEM_Close(t);
+        return -1;
+    }
+    return 0;
+}
+
+void TELEM_Close(TelemetryShm_t *t)
+{
+    if (t->hdr != NULL)
+    {
+        (void)munmap((void *)t->hdr, t->size);
+        t->hdr  = NULL;
+        t->axis = NULL;
+    }
+    if (t->owner)
+    {
+        (void)shm_unlink(t->name);
+        t->owner = false;
+    }
+}
+
+#else /* _WIN32: no POSIX shared memory */
+
+int32_t TELEM_Create(TelemetryShm_t *t, const char *name, uint32_t axis_count)
+{
+    (void)memset(t, 0, sizeof(*t));
+    (void)name;
+    (void)axis_count;
+    printf("Telemetry: POSIX shared memory not available on this platform\n");
+    return -1;
+}
+
+int32_t TELEM_Attach(TelemetryShm_t *t, const char *name)
+{
+    (void)memset(t, 0, sizeof(*t));
+    (void)name;
+    return -1;
+}
+
+void TELEM_Close(TelemetryShm_t *t)
+{
+    t->hdr = NULL;
+}
+#endif
+
+/*----------------------------------------------------------
+ * Seqlock writer: one copy of the image per refresh
+ *----------------------------------------------------------*/
+void TELEM_Publish(TelemetryShm_t *t, const AxisStateStore_t *store, uint64_t image_no)
+{
+    TelemHeader_t *h = t->hdr;
+    AxisMask_t limits;
+    AxisMask_t faults;
+    uint32_t n_limits;
+    uint32_t n_faults;
+    uint32_t n;
+    uint32_t i;
+    uint32_t s;
+
+    if (h == NULL)
+    {
+        return;
+    }
+
+    /* Scanned before the write section, to keep it short */
+    n_faults = AXIS_STATE_ScanFaults(store, &faults);
+    n_limits = AXIS_STATE_CheckLimits(store, &limits);
+    n = (store->count < h->axis_count) ? store->count : h->axis_count;
+
+    s = __atomic_load_n(&h->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->seq, s + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (i = 0U; i < n; i++)
+    {
+        TelemAxis_t *a = &t->axis[i];
+
+        a->sample_us    = store->sample_us[i];
+        a->position_deg = store->position_deg[i];
+        a->velocity     = store->velocity[i];
+        a->position_mm  = store->position_mm[i];
+        a->rpm          = store->rpm[i];
+        a->current      = store->current[i];
+        a->dcbus        = store->dcbus[i];
+        a->temperature  = store->temperature[i];
+        a->fault_bits   = store->fault_bits[i];
+        a->io_status    = store->io_status[i];
+        a->sys_status   = store->sys_status[i];
+        a->fault_code   = store->fault_code[i];
+        a->flags        = (AXIS_MASK_Test(&faults, i) ? TELEM_FLAG_FAULT : 0U) |
+                          (AXIS_MASK_Test(&limits, i) ? TELEM_FLAG_LIMIT : 0U) |
+                          ((store->sample_us[i] == 0U) ? TELEM_FLAG_NO_DATA : 0U);
+    }
+    h->image_no   = image_no;
+    h->publish_us = TIME_NowUs();
+    h->fault_count = n_faults;
+    h->limit_count = n_limits;
+
+    __atomic_store_n(&h->seq, s + 2U, __ATOMIC_RELEASE);
+}
+
+/*----------------------------------------------------------
+ * Seqlock reader
+ *----------------------------------------------------------*/
+bool TELEM_Read(const TelemetryShm_t *t, TelemSnapshot_t *out)
+{
+    const TelemHeader_t *h = t->hdr;
+    uint32_t n;
+    uint32_t k;
+    uint32_t s1;
+    uint32_t s2;
+
+    if (h == NULL)
+    {
+        return false;
+    }
+    n = (h->axis_count < AXIS_STATE_CAPACITY) ? h->axis_count : AXIS_STATE_CAPACITY;
+
+    for (k = 0U; k < TELEM_READ_RETRIES; k++)
+    {
+        s1 = __atomic_load_n(&h->seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1U) != 0U)
+        {
+            continue;                   /* refresh in progress */
+        }
+        (void)memcpy(&out->hdr, h, sizeof(*h));
+        (void)memcpy(out->axis, t->axis, n * sizeof(TelemAxis_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&h->seq, __ATOMIC_RELAXED);
+
+        if (s1 == s2)
+        {
+            out->hdr.seq = s1;
+            return (s1 != 0U);          /* 0 = nothing published yet */
+        }
+    }
+    return false;
+}
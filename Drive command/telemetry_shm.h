@@ -0,0 +1,145 @@
+#ifndef TELEMETRY_SHM_H
+#define TELEMETRY_SHM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "axis_state.h"
+
+/*===========================================================
+ * Shared-Memory Telemetry
+ *===========================================================*/
+/* The daemon copies each refresh of its axis image into a POSIX
+ * shared-memory segment. Local readers (HMI, logger, Python tools)
+ * map the segment read-only and take consistent snapshots with no
+ * system call and no round trip. The writer never waits for them.
+ *
+ * Consistency is a seqlock over the whole segment. The header field
+ * seq is odd while a refresh is being written. A reader copies what
+ * it needs between two reads of seq, and retries if seq was odd or
+ * changed between them.
+ *
+ * Layout (host byte order, natural alignment):
+ *
+ *   0    TelemHeader_t   64 bytes
+ *   64   TelemAxis_t     record_size bytes x axis_count
+ *
+ * Values are Q16.16 like the axis state store (divide by 65536).
+ * Times are CLOCK_MONOTONIC us (TIME_NowUs base). A publish_us that
+ * stops advancing means the daemon is gone.
+ *
+ * POSIX only; on Windows the functions fail. */
+
+#ifndef TELEM_SHM_NAME
+    #define TELEM_SHM_NAME        "/drive_telemetry"
+#endif
+#ifndef TELEM_SHM_MODE
+    #define TELEM_SHM_MODE        (0640)     /* owner rw, group r */
+#endif
+#ifndef TELEM_READ_RETRIES
+    #define TELEM_READ_RETRIES    (1000U)    /* Writer died mid-update */
+#endif
+
+#define TELEM_MAGIC               (0x4C455444UL)   /* "DTEL" */
+#define TELEM_VERSION             (2U)
+
+/* TelemAxis_t.flags */
+#define TELEM_FLAG_FAULT          (0x0001U)  /* Any FAULT_ANY_MASK bit */
+#define TELEM_FLAG_LIMIT          (0x0002U)  /* Outside software limits */
+#define TELEM_FLAG_NO_DATA        (0x0004U)  /* Never read successfully */
+
+/**
+ * @brief Segment header (one cache line)
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t axis_count;
+    uint32_t record_size;     /**< sizeof(TelemAxis_t) */
+    uint32_t seq;             /**< Seqlock: odd while written */
+    uint64_t image_no;        /**< Daemon image number */
+    uint64_t publish_us;      /**< Time of the last refresh */
+    uint32_t fault_count;     /**< Axes faulted (per axis: TELEM_FLAG_FAULT) */
+    uint32_t limit_count;     /**< Axes outside limits (TELEM_FLAG_LIMIT) */
+    uint32_t writer_pid;
+    uint8_t  reserved[20];
+} TelemHeader_t;
+
+/**
+ * @brief One axis
+ */
+typedef struct
+{
+    uint64_t sample_us;       /**< 0 = never read */
+    int32_t  position_deg;    /**< Q16.16 */
+    int32_t  velocity;
+    int32_t  position_mm;
+    int32_t  rpm;
+    int32_t  current;
+    int32_t  dcbus;
+    int32_t  temperature;
+    uint16_t fault_bits;
+    uint16_t io_status;
+    uint16_t sys_status;
+    uint16_t fault_code;
+    uint32_t flags;           /**< TELEM_FLAG_* */
+} TelemAxis_t;
+
+/**
+ * @brief A mapped segment (writer or reader)
+ */
+typedef struct
+{
+    TelemHeader_t *hdr;       /**< NULL = not mapped */
+    TelemAxis_t   *axis;
+    uint32_t       size;
+    bool           owner;     /**< Created it: unlink on close */
+    char           name[64];
+} TelemetryShm_t;
+
+/**
+ * @brief A consistent copy taken by TELEM_Read
+ */
+typedef struct
+{
+    TelemHeader_t hdr;
+    TelemAxis_t   axis[AXIS_STATE_CAPACITY];
+} TelemSnapshot_t;
+
+/*===========================================================
+ * Function Prototypes
+ *===========================================================*/
+
+/**
+ * @brief  Writer: create (or replace) the segment for axis_count axes
+ *         (name NULL = TELEM_SHM_NAME)
+ * @return 0, or -1
+ */
+int32_t TELEM_Create(TelemetryShm_t *t, const char *name, uint32_t axis_count);
+
+/**
+ * @brief  Writer: copy one image into the segment (no system calls)
+ */
+void TELEM_Publish(TelemetryShm_t *t, const AxisStateStore_t *store, uint64_t image_no);
+
+/**
+ * @brief  Reader: map an existing segment read-only; checks the
+ *         magic, version and record size
+ * @return 0, or -1
+ */
+int32_t TELEM_Attach(TelemetryShm_t *t, const char *name);
+
+/**
+ * @brief  Reader: consistent copy of the segment (no system calls)
+ * @return false if nothing is published yet, or no stable copy within
+ *         TELEM_READ_RETRIES
+ */
+bool TELEM_Read(const TelemetryShm_t *t, TelemSnapshot_t *out);
+
+/**
+ * @brief  Unmap; the writer also removes the segment name
+ */
+void TELEM_Close(TelemetryShm_t *t);
+
+#endif /* TELEMETRY_SHM_H */
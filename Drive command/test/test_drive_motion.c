@@ -0,0 +1,96 @@
+#include "unity.h"
+#include "drive_motion.h"
+#include "drive_parameters.h"
+#include <stdio.h>
+
+static CoordinatedMove_t move;
+
+/* ================================
+   UNITY SETUP / TEARDOWN
+   ================================ */
+void setUp(void)
+{
+    CoordinatedMove_t zero = {0};
+    move = zero;
+}
+
+void tearDown(void) {}
+
+static void Plan(float pan_start, float pan_target, float tilt_start, float tilt_target)
+{
+    move.pan.start   = pan_start;
+    move.pan.target  = pan_target;
+    move.tilt.start  = tilt_start;
+    move.tilt.target = tilt_target;
+    Plan_CoordinatedMove(&move);
+}
+
+/* ================================
+   TEST CASES
+   ================================ */
+void test_Limits_should_be_converted_to_degrees(void)
+{
+    /* 3000 rpm x 5 mm/rev = 250 mm/s; 180 deg over 200 mm = 0.9 deg/mm */
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.9f, Compute_DegPerMm(AXIS_PAN));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 225.0f, Compute_MaxVelocityDeg(AXIS_PAN));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 337.5f, Compute_MaxAccelerationDeg(AXIS_PAN));
+}
+
+void test_Plan_should_run_triangle_below_max_velocity(void)
+{
+    Plan(0.0F, 90.0F, 10.0F, 10.0F);
+
+    /* 90 deg < vmax^2 / amax = 150 deg: t = 2 sqrt(d / a) */
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0328f, move.move_time_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 174.28f, move.pan.velocity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 337.5f, move.pan.accel);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, move.tilt.velocity);
+}
+
+void test_Plan_should_cap_velocity_at_degree_limit(void)
+{
+    Plan(-90.0F, 90.0F, 0.0F, 0.0F);
+
+    /* Trapezoid: t = d / v + v / a; v never above 225 deg/s (not 250) */
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.4667f, move.move_time_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 225.0f, move.pan.velocity);
+}
+
+void test_Plan_should_stretch_faster_axis_to_common_time(void)
+{
+    float s;
+
+    Plan(-90.0F, 90.0F, 0.0F, -45.0F);
+
+    /* TILT alone: 0.7303 s triangle, stretched by s to PAN's 1.4667 s */
+    s = 0.7303F / 1.4667F;
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.4667f, move.move_time_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 123.24f * s, move.tilt.velocity);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 337.5f * s * s, move.tilt.accel);
+
+    /* The stretched triangle still covers the distance: d = v t / 2 */
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 45.0f, move.tilt.velocity * move.move_time_s * 0.5f);
+}
+
+void test_Plan_should_handle_no_motion(void)
+{
+    Plan(5.0F, 5.0F, -3.0F, -3.0F);
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, move.move_time_s);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, move.pan.velocity);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, move.tilt.velocity);
+}
+
+/* ================================
+   UNITY TEST RUNNER
+   ================================ */
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Limits_should_be_converted_to_degrees);
+    RUN_TEST(test_Plan_should_run_triangle_below_max_velocity);
+    RUN_TEST(test_Plan_should_cap_velocity_at_degree_limit);
+    RUN_TEST(test_Plan_should_stretch_faster_axis_to_common_time);
+    RUN_TEST(test_Plan_should_handle_no_motion);
+    return UNITY_END();
+}
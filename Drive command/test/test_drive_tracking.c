@@ -0,0 +1,166 @@
+#include "unity.h"
+#include "drive_tracking.h"
+#include "axis_predictor.h"
+#include <stdio.h>
+#include <math.h>
+
+static TrackAxis_t trk;
+static AxisPredictor_t pred;
+
+#define T0      (1000000U)
+#define DT_US   (10000U)      /* 100 Hz, as RUN_PERIOD_US */
+
+/* ================================
+   UNITY SETUP / TEARDOWN
+   ================================ */
+void setUp(void)
+{
+    TRACK_Init(&trk, AXIS_PAN, NULL);
+    PRED_Init(&pred, NULL);
+}
+
+void tearDown(void) {}
+
+/* Closed loop on an ideal drive: the axis moves at the commanded
+ * velocity, the predictor sees its position every cycle. Returns the
+ * largest position reached. */
+static float RunLoop(float *pos, uint64_t *t, uint32_t cycles, float *dv_max)
+{
+    float peak = *pos;
+    float v_prev = trk.v_cmd;
+    uint32_t i;
+
+    for (i = 0U; i < cycles; i++)
+    {
+        float v;
+
+        (void)PRED_Update(&trk.pred, *t, *pos, 0.0F);
+        v = TRACK_Compute(&trk, *t);
+        TEST_ASSERT_TRUE(fabsf(v) <= (trk.vmax + 0.001F));
+        if ((dv_max != NULL) && (fabsf(v - v_prev) > *dv_max))
+        {
+            *dv_max = fabsf(v - v_prev);
+        }
+        v_prev = v;
+        *pos += v * ((float)DT_US * 1e-6F);
+        *t   += DT_US;
+        peak = (*pos > peak) ? *pos : peak;
+    }
+    return peak;
+}
+
+/* ================================
+   TEST CASES
+   ================================ */
+void test_Track_should_take_limits_in_degrees(void)
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 225.0f, trk.vmax);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 337.5f, trk.amax);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f / 0.9f, trk.gains.vel_per_deg_s);
+}
+
+void test_Predictor_should_settle_on_a_position_step(void)
+{
+    uint64_t t = T0;
+    uint32_t i;
+
+    for (i = 0U; i < 20U; i++, t += DT_US)
+    {
+        (void)PRED_Update(&pred, t, 0.0F, 0.0F);
+    }
+    (void)PRED_Update(&pred, t, 10.0F, 0.0F);
+    TEST_ASSERT_TRUE(PRED_Position(&pred, t) > 0.0F);
+    TEST_ASSERT_TRUE(PRED_Position(&pred, t) <= 10.0F);
+
+    for (i = 0U; i < 200U; i++)
+    {
+        t += DT_US;
+        (void)PRED_Update(&pred, t, 10.0F, 0.0F);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, PRED_Position(&pred, t));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, PRED_Velocity(&pred));
+}
+
+void test_Predictor_should_extrapolate_a_ramp(void)
+{
+    uint64_t t = T0;
+    uint32_t i;
+
+    for (i = 0U; i < 100U; i++, t += DT_US)
+    {
+        (void)PRED_Update(&pred, t, 50.0F * (float)(t - T0) * 1e-6F, 0.0F);
+    }
+    /* Half a cycle ahead of the last sample, as TRACK_Compute asks */
+    t -= DT_US / 2U;
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 50.0f, PRED_Velocity(&pred));
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 50.0f * (float)(t - T0) * 1e-6F, PRED_Position(&pred, t));
+}
+
+void test_Track_should_command_nothing_without_target(void)
+{
+    (void)PRED_Update(&trk.pred, T0, 5.0F, 0.0F);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, TRACK_Compute(&trk, T0));
+}
+
+void test_Track_should_settle_on_a_step_within_rate_limits(void)
+{
+    float pos = 0.0F;
+    float dv_max = 0.0F;
+    uint64_t t = T0;
+    float peak;
+
+    TRACK_SetTarget(&trk, 20.0F, 0.0F, t);
+    peak = RunLoop(&pos, &t, 1000U, &dv_max);
+
+    /* The velocity change per cycle never exceeds amax * dt; the
+     * integral wound up while accelerating costs under 1 deg of
+     * overshoot, worked off at ki / kp (2.5 s time constant) */
+    TEST_ASSERT_TRUE(dv_max <= ((337.5F * 0.01F) + 0.001F));
+    TEST_ASSERT_TRUE(peak < 21.0F);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 20.0f, pos);
+}
+
+void test_Track_should_follow_a_moving_target(void)
+{
+    float pos = 0.0F;
+    uint64_t t = T0;
+    uint32_t i;
+
+    /* New target every 5 cycles (20 Hz, as a vision tracker sends);
+     * feed-forward carries the ramp between them */
+    for (i = 0U; i < 60U; i++)
+    {
+        TRACK_SetTarget(&trk, 30.0F * (float)(t - T0) * 1e-6F, 30.0F, t);
+        (void)RunLoop(&pos, &t, 5U, NULL);
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 30.0f * (float)(t - T0) * 1e-6F, pos);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 30.0f, trk.v_cmd);
+}
+
+void test_Track_should_not_drive_past_a_limit(void)
+{
+    float pos = 85.0F;
+    uint64_t t = T0;
+
+    /* Target beyond the 90 deg limit is clamped to it */
+    TRACK_SetTarget(&trk, 120.0F, 0.0F, t);
+    (void)RunLoop(&pos, &t, 300U, NULL);
+    TEST_ASSERT_TRUE(pos <= 90.05F);
+}
+
+/* ================================
+   UNITY TEST RUNNER
+   ================================ */
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Track_should_take_limits_in_degrees);
+    RUN_TEST(test_Predictor_should_settle_on_a_position_step);
+    RUN_TEST(test_Predictor_should_extrapolate_a_ramp);
+    RUN_TEST(test_Track_should_command_nothing_without_target);
+    RUN_TEST(test_Track_should_settle_on_a_step_within_rate_limits);
+    RUN_TEST(test_Track_should_follow_a_moving_target);
+    RUN_TEST(test_Track_should_not_drive_past_a_limit);
+    return UNITY_END();
+}
@@ -0,0 +1,90 @@
+#include "unity.h"
+#include "drive_watchdog.h"
+#include <stdio.h>
+
+static AxisStateStore_t store;
+static Watchdog_t wdog;
+
+#define T0   (1000000U)
+
+/* ================================
+   UNITY SETUP / TEARDOWN
+   ================================ */
+void setUp(void)
+{
+    AXIS_STATE_Init(&store, AXIS_COUNT);
+    WDOG_Init(&wdog, &store);
+    wdog.start_us = T0;
+    store.sample_us[0] = T0;
+    store.sample_us[1] = T0;
+}
+
+void tearDown(void) {}
+
+/* ================================
+   TEST CASES
+   ================================ */
+void test_Watchdog_should_pass_fresh_healthy_image(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0U, WDOG_Check(&wdog, T0 + WDOG_STALE_US));
+}
+
+void test_Watchdog_should_flag_stale_axis(void)
+{
+    store.sample_us[1] = T0 + 50000U;
+    TEST_ASSERT_EQUAL_UINT32(WDOG_TRIP_STALE, WDOG_Check(&wdog, T0 + WDOG_STALE_US + 1U));
+    TEST_ASSERT_EQUAL_HEX32(0x1U, wdog.axes.word[0]);
+}
+
+void test_Watchdog_should_give_unread_axis_grace_from_start(void)
+{
+    store.sample_us[0] = 0U;
+    TEST_ASSERT_EQUAL_UINT32(0U, WDOG_Check(&wdog, T0 + 1000U));
+    TEST_ASSERT_EQUAL_UINT32(WDOG_TRIP_STALE, WDOG_Check(&wdog, T0 + WDOG_STALE_US + 1U));
+}
+
+void test_Watchdog_should_flag_fault_bits(void)
+{
+    store.fault_bits[1] = FAULT_OVER_TEMP | FAULT_MOTION_COMPLETE;
+    TEST_ASSERT_EQUAL_UINT32(WDOG_TRIP_FAULT, WDOG_Check(&wdog, T0));
+    TEST_ASSERT_EQUAL_HEX32(0x2U, wdog.axes.word[0]);
+}
+
+void test_Watchdog_should_flag_axis_beyond_soft_limit(void)
+{
+    store.position_deg[0] = store.limit_max_deg[0] + FIX_FromFloat(1.0F);
+    TEST_ASSERT_EQUAL_UINT32(WDOG_TRIP_LIMIT, WDOG_Check(&wdog, T0));
+}
+
+void test_Watchdog_should_cover_every_axis_of_the_capacity(void)
+{
+    uint32_t last = AXIS_STATE_CAPACITY - 1U;
+    uint32_t i;
+
+    /* The last index counts too; with -DAXIS_STATE_CAPACITY=64 it lies
+     * in the second mask word */
+    store.count = AXIS_STATE_CAPACITY;
+    for (i = 0U; i < store.count; i++)
+    {
+        store.sample_us[i] = T0;
+    }
+    store.fault_bits[last] = FAULT_SHORT_CKT;
+    TEST_ASSERT_EQUAL_UINT32(WDOG_TRIP_FAULT, WDOG_Check(&wdog, T0));
+    TEST_ASSERT_TRUE(AXIS_MASK_Test(&wdog.axes, last));
+    TEST_ASSERT_FALSE(AXIS_MASK_Test(&wdog.axes, 0U));
+}
+
+/* ================================
+   UNITY TEST RUNNER
+   ================================ */
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Watchdog_should_pass_fresh_healthy_image);
+    RUN_TEST(test_Watchdog_should_flag_stale_axis);
+    RUN_TEST(test_Watchdog_should_give_unread_axis_grace_from_start);
+    RUN_TEST(test_Watchdog_should_flag_fault_bits);
+    RUN_TEST(test_Watchdog_should_flag_axis_beyond_soft_limit);
+    RUN_TEST(test_Watchdog_should_cover_every_axis_of_the_capacity);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include "unity.h"
+#include "fixed_point.h"
+#include <stdio.h>
+
+/* ================================
+   UNITY SETUP / TEARDOWN
+   ================================ */
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/* ================================
+   TEST CASES
+   ================================ */
+void test_Decode_should_round_signed_and_unsigned_alike(void)
+{
+    /* 7 counts = 0.07 deg = 4587.52 / 65536: both round up to 4588 */
+    TEST_ASSERT_EQUAL_INT32(4588, FIX_DecodeS16(7U, &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_INT32(4588, FIX_DecodeU16(7U, &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_INT32(655, FIX_DecodeU16(1U, &FIX_SCALE_POSITION));
+}
+
+void test_Decode_should_be_symmetric_in_sign(void)
+{
+    uint16_t raw;
+
+    for (raw = 1U; raw < 2000U; raw++)
+    {
+        TEST_ASSERT_EQUAL_INT32(-FIX_DecodeS16(raw, &FIX_SCALE_POSITION),
+                                FIX_DecodeS16((uint16_t)(-(int16_t)raw), &FIX_SCALE_POSITION));
+    }
+    TEST_ASSERT_EQUAL_INT32(-4588, FIX_DecodeS16(0xFFF9U, &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_INT32(FIX16_FROM_INT(-32768), FIX_DecodeS16(0x8000U, &FIX_SCALE_UNITY));
+}
+
+void test_Decode_should_saturate_beyond_q16(void)
+{
+    /* 65535 counts at scale 1 does not fit +/-32768 */
+    TEST_ASSERT_EQUAL_INT32(FIX16_MAX, FIX_DecodeU16(0xFFFFU, &FIX_SCALE_UNITY));
+    TEST_ASSERT_EQUAL_INT32(FIX16_FROM_INT(32767), FIX_DecodeS16(0x7FFFU, &FIX_SCALE_UNITY));
+}
+
+void test_Encode_should_round_half_away_from_zero(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(0x0001U, FIX_EncodeS16(FIX16_ONE / 2, &FIX_SCALE_UNITY));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFFU, FIX_EncodeS16(-FIX16_ONE / 2, &FIX_SCALE_UNITY));
+    TEST_ASSERT_EQUAL_HEX16(0x0000U, FIX_EncodeS16((FIX16_ONE / 2) - 1, &FIX_SCALE_UNITY));
+    TEST_ASSERT_EQUAL_HEX16(0x0001U, FIX_EncodeU16(FIX16_ONE / 2, &FIX_SCALE_UNITY));
+}
+
+void test_Encode_should_saturate_to_register_range(void)
+{
+    /* 400 deg = 40000 counts: above int16 */
+    TEST_ASSERT_EQUAL_HEX16(0x7FFFU, FIX_EncodeS16(FIX16_FROM_INT(400), &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_HEX16(0x8000U, FIX_EncodeS16(FIX16_FROM_INT(-400), &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFFU, FIX_EncodeU16(FIX16_FROM_INT(700), &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_HEX16(0x0000U, FIX_EncodeU16(FIX16_FROM_INT(-1), &FIX_SCALE_POSITION));
+    TEST_ASSERT_EQUAL_HEX16(0x7FFFU, FIX_EncodeS16(FIX16_MAX, &FIX_SCALE_CURRENT));
+    TEST_ASSERT_EQUAL_HEX16(0x8000U, FIX_EncodeS16(FIX16_MIN, &FIX_SCALE_CURRENT));
+}
+
+void test_Decode_then_encode_should_return_every_word(void)
+{
+    uint32_t w;
+
+    for (w = 0U; w <= 0xFFFFU; w++)
+    {
+        TEST_ASSERT_EQUAL_HEX16(w, FIX_EncodeS16(FIX_DecodeS16((uint16_t)w, &FIX_SCALE_POSITION),
+                                                 &FIX_SCALE_POSITION));
+        TEST_ASSERT_EQUAL_HEX16(w, FIX_EncodeU16(FIX_DecodeU16((uint16_t)w, &FIX_SCALE_TEMP),
+                                                 &FIX_SCALE_TEMP));
+    }
+}
+
+void test_FromFloat_should_saturate_and_reject_nan(void)
+{
+    volatile float zero = 0.0F;
+
+    TEST_ASSERT_EQUAL_INT32(FIX16_MAX, FIX_FromFloat(1.0e6F));
+    TEST_ASSERT_EQUAL_INT32(FIX16_MIN, FIX_FromFloat(-1.0e6F));
+    TEST_ASSERT_EQUAL_INT32(0, FIX_FromFloat(zero / zero));
+    TEST_ASSERT_EQUAL_INT32(-FIX16_ONE / 2, FIX_FromFloat(-0.5F));
+}
+
+/* ================================
+   UNITY TEST RUNNER
+   ================================ */
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Decode_should_round_signed_and_unsigned_alike);
+    RUN_TEST(test_Decode_should_be_symmetric_in_sign);
+    RUN_TEST(test_Decode_should_saturate_beyond_q16);
+    RUN_TEST(test_Encode_should_round_half_away_from_zero);
+    RUN_TEST(test_Encode_should_saturate_to_register_range);
+    RUN_TEST(test_Decode_then_encode_should_return_every_word);
+    RUN_TEST(test_FromFloat_should_saturate_and_reject_nan);
+    return UNITY_END();
+}
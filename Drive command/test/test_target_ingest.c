@@ -0,0 +1,128 @@
+#include "unity.h"
+#include "target_ingest.h"
+#include "drive_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#define TEST_PORT   (5611U)
+
+static TargetIngest_t ing;
+static int tx = -1;
+
+/* ================================
+   UNITY SETUP / TEARDOWN
+   ================================ */
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT32(0, INGEST_OpenUdp(&ing, (uint16_t)TEST_PORT));
+    tx = socket(AF_INET, SOCK_DGRAM, 0);
+}
+
+void tearDown(void)
+{
+    (void)close(tx);
+    INGEST_Close(&ing);
+}
+
+/* Send one PAN target and take it in; returns the targets published */
+static uint32_t Send(uint32_t seq, float pan_deg)
+{
+    struct sockaddr_in to;
+    TargetSample_t s;
+    uint8_t msg[INGEST_MSG_LEN];
+
+    (void)memset(&s, 0, sizeof(s));
+    s.seq     = seq;
+    s.flags   = TARGET_PAN;
+    s.pan_deg = pan_deg;
+    INGEST_Encode(&s, msg);
+
+    (void)memset(&to, 0, sizeof(to));
+    to.sin_family      = AF_INET;
+    to.sin_port        = htons((uint16_t)TEST_PORT);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    (void)sendto(tx, msg, sizeof(msg), 0, (struct sockaddr *)&to, sizeof(to));
+    return INGEST_Poll(&ing);
+}
+
+static float LatestPan(void)
+{
+    TargetSample_t t;
+    uint32_t gen = 0U;
+
+    TEST_ASSERT_TRUE(INGEST_Latest(&ing, &t, &gen));
+    return t.pan_deg;
+}
+
+/* ================================
+   TEST CASES
+   ================================ */
+void test_Ingest_should_drop_older_sequence(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(10U, 1.0F));
+    TEST_ASSERT_EQUAL_UINT32(0U, Send(9U, 2.0F));
+    TEST_ASSERT_EQUAL_UINT32(0U, Send(10U, 3.0F));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, LatestPan());
+    TEST_ASSERT_EQUAL_UINT64(2U, ing.stats.stale);
+}
+
+void test_Ingest_should_accept_sequence_wrap(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(0xFFFFFFFFU, 1.0F));
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(0U, 2.0F));
+    TEST_ASSERT_EQUAL_UINT64(0U, ing.stats.restarts);
+}
+
+void test_Ingest_should_take_long_jump_back_as_restart(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(50000U, 1.0F));
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(1U, 2.0F));
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(2U, 3.0F));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, LatestPan());
+    TEST_ASSERT_EQUAL_UINT64(1U, ing.stats.restarts);
+}
+
+void test_Ingest_should_restart_after_idle_sender(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(20U, 1.0F));
+
+    /* Short jump back: dropped while the sender is live ... */
+    TEST_ASSERT_EQUAL_UINT32(0U, Send(1U, 2.0F));
+
+    /* ... accepted once it has been silent past the idle time */
+    ing.last_rx_us = TIME_NowUs() - INGEST_IDLE_RESET_US - 1000U;
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(1U, 3.0F));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, LatestPan());
+    TEST_ASSERT_EQUAL_UINT64(1U, ing.stats.restarts);
+}
+
+void test_Ingest_should_reject_non_finite_target(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(1U, 1.0F));
+    TEST_ASSERT_EQUAL_UINT32(0U, Send(2U, NAN));
+    TEST_ASSERT_EQUAL_UINT32(0U, Send(3U, INFINITY));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, LatestPan());
+    TEST_ASSERT_EQUAL_UINT64(2U, ing.stats.rejected);
+
+    /* The sequence of a rejected message is not taken */
+    TEST_ASSERT_EQUAL_UINT32(1U, Send(2U, 2.0F));
+}
+
+/* ================================
+   UNITY TEST RUNNER
+   ================================ */
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Ingest_should_drop_older_sequence);
+    RUN_TEST(test_Ingest_should_accept_sequence_wrap);
+    RUN_TEST(test_Ingest_should_take_long_jump_back_as_restart);
+    RUN_TEST(test_Ingest_should_restart_after_idle_sender);
+    RUN_TEST(test_Ingest_should_reject_non_finite_target);
+    return UNITY_END();
+}
@@ -12,6 +12,7 @@
 
 #define ENCODER_RESOLUTION        (4096U)   /* counts per revolution */
 #define GEAR_RATIO                (1.0F)
+#define ENCODER_VEL_FILTER_ALPHA  (0.3F)    /* velocity IIR weight, 1 = raw */
 
 
 /*===========================================================
@@ -55,6 +56,15 @@
 #define PAN_PARK_TARGET_POS  (0x0000U)  /* Example park coordinate */
 #define TILT_PARK_TARGET_POS (0x0000U)
 
+/* Drive park profile, used only to estimate the arrival time */
+#define PARK_SPEED_CPS       (40960.0F) /* counts/s (10 rev/s) */
+#define PARK_ACCEL_CPS2      (81920.0F) /* counts/s^2 */
+
+#define PARK_TIMEOUT_US      (5000000U) /* give up after 5 s */
+#define PARK_POLL_FAST_US    (2000U)    /* poll period around arrival */
+#define PARK_POLL_SLOW_US    (50000U)   /* poll period far from arrival */
+#define PARK_POLL_RETRIES    (3U)       /* lost poll responses in a row */
+
 /* ---------------- Limit Switch Register Map -------------- */
 /* Each switch gives binary 1/0 signal (pressed/released) */
 #define REG_PAN_LIMIT_UPPER   (0x4000U)
@@ -4,6 +4,43 @@
 #include "modbus_udp.h"
 #include "config.h"
 
+/*----------------------------------------------------------
+ * Asynchronous park operation
+ *----------------------------------------------------------*/
+#define PARK_BLOCK_REGS   (6U)   /* position(2), speed(2), counts(2), as the feedback block */
+
+typedef enum
+{
+    PARK_IDLE = 0,
+    PARK_MOVING,
+    PARK_DONE,
+    PARK_TIMEOUT,
+    PARK_FAILED
+} ParkState_t;
+
+typedef struct
+{
+    uint32_t speed;          /* Last speed reading (counts/sec) */
+    uint8_t  moving_seen;    /* Non-zero speed observed since start */
+    uint8_t  done;           /* Axis reached park position */
+} ParkAxis_t;
+
+typedef struct
+{
+    ParkState_t     state;
+    uint64_t        start_us;      /* START_PARK command time */
+    uint64_t        eta_us;        /* Expected arrival from park profile */
+    uint64_t        next_poll_us;  /* Next feedback poll */
+    uint64_t        sent_us;       /* Time the in-flight poll was sent */
+    uint64_t        done_us;       /* Completion detected */
+    uint32_t        polls;
+    uint8_t         lost;          /* Poll responses lost in a row */
+    uint8_t         in_flight;     /* 1 = PAN/TILT reads outstanding */
+    ParkAxis_t      pan;
+    ParkAxis_t      tilt;
+    ModbusRequest_t req[2U];       /* [0] = PAN, [1] = TILT */
+} ParkContext_t;
+
 /**
  * @brief Turn ON or OFF Pan motor
  */
@@ -14,8 +51,35 @@ ModbusStatus_t Send_Pan_Command(uint16_t cmd);
  */
 ModbusStatus_t Send_Tilt_Command(uint16_t cmd);
 
+/**
+ * @brief Write park targets, estimate arrival time and start park motion
+ * @param ctx Park context, initialized by this call
+ * @return MODBUS_OK / MODBUS_ERROR
+ */
+ModbusStatus_t Drive_ParkStart(ParkContext_t *ctx);
+
+/**
+ * @brief Advance the park operation; polls PAN and TILT in parallel
+ *
+ * An axis is parked at zero speed once it was seen moving, or once the
+ * expected arrival has passed. A malformed response, or
+ * PARK_POLL_RETRIES lost ones in a row, ends the park as PARK_FAILED.
+ *
+ * @param ctx     Context from Drive_ParkStart()
+ * @param wait_us Maximum time to block for poll responses (0 = never block)
+ * @return PARK_MOVING while in progress, else the final state
+ */
+ParkState_t Drive_ParkPoll(ParkContext_t *ctx, uint32_t wait_us);
+
+/**
+ * @brief Poll interval for the given time: fast near the expected
+ *        arrival, slower while the axes are still far away
+ */
+uint32_t Drive_ParkPollInterval(const ParkContext_t *ctx, uint64_t now_us);
+
 /**
  * @brief Park both Pan and Tilt motors (move to default position)
+ *        Blocking wrapper around Drive_ParkStart() / Drive_ParkPoll()
  */
 ModbusStatus_t Drive_ParkMotion(void);
 
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "modbus_udp.h"
+#include "encoder.h"
 
 /*----------------------------------------------------------
  * Axis Feedback Data with physical units
@@ -36,4 +37,30 @@ ModbusStatus_t Read_Pan_Feedback(AxisFeedback_t *fb);
  */
 ModbusStatus_t Read_Tilt_Feedback(AxisFeedback_t *fb);
 
+/**
+ * @brief Reads Pan and Tilt feedback in one cycle (one read when the
+ *        register layout allows, otherwise two pipelined reads)
+ * @param pan_fb  Pointer to Pan AxisFeedback_t structure
+ * @param tilt_fb Pointer to Tilt AxisFeedback_t structure
+ * @return MODBUS_OK / MODBUS_ERROR
+ */
+ModbusStatus_t Read_Axes_Feedback(AxisFeedback_t *pan_fb, AxisFeedback_t *tilt_fb);
+
+/**
+ * @brief Decodes a 6-register feedback block (position, speed, counts)
+ *        in place from Modbus response data
+ * @param data Register data (big-endian, 12 bytes)
+ * @param fb   Pointer to AxisFeedback_t structure
+ */
+void Decode_AxisFeedback(const uint8_t *data, AxisFeedback_t *fb);
+
+/**
+ * @brief Reads only the Pan and Tilt position counters (one RTT) and
+ *        updates the multi-turn encoders, which also estimate velocity
+ * @param pan_enc  Pan encoder (see Encoder_Init)
+ * @param tilt_enc Tilt encoder (see Encoder_Init)
+ * @return MODBUS_OK / MODBUS_ERROR
+ */
+ModbusStatus_t Read_Axes_Position(Encoder_t *pan_enc, Encoder_t *tilt_enc);
+
 #endif /* DRIVE_FEEDBACK_H */
@@ -0,0 +1,58 @@
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <stdint.h>
+
+/*----------------------------------------------------------
+ * Multi-turn encoder state with velocity estimation
+ *----------------------------------------------------------*/
+typedef struct
+{
+    /* Precomputed scaling (set by Encoder_Init) */
+    float    deg_per_count;   /* 360 / (counts_per_rev * gear_ratio) */
+    float    rpm_per_cps;     /* 60 / (counts_per_rev * gear_ratio) */
+    float    vel_alpha;       /* IIR weight of a new sample, 1 = no filter */
+
+    /* Tracking state */
+    uint32_t last_raw;        /* Last raw 32-bit counter value */
+    uint64_t last_time_us;    /* Sample time of last_raw */
+    int64_t  position;        /* Unwrapped multi-turn position (counts) */
+    float    velocity_cps;    /* Filtered velocity (counts/sec) */
+    uint8_t  initialized;
+} Encoder_t;
+
+/*----------------------------------------------------------
+ * Function Prototypes
+ *----------------------------------------------------------*/
+
+/**
+ * @brief Initialize an encoder channel
+ * @param enc            Encoder state
+ * @param counts_per_rev Encoder resolution (counts per motor revolution)
+ * @param gear_ratio     Motor revolutions per output revolution
+ * @param vel_alpha      Velocity filter weight (0 < alpha <= 1)
+ */
+void Encoder_Init(Encoder_t *enc, uint32_t counts_per_rev, float gear_ratio, float vel_alpha);
+
+/**
+ * @brief Feed a raw 32-bit counter sample taken at time_us
+ *        Wraparound of the counter is unwrapped into the 64-bit position.
+ */
+void Encoder_Update(Encoder_t *enc, uint32_t raw_counts, uint64_t time_us);
+
+/**
+ * @brief Unwrapped multi-turn position in counts
+ */
+int64_t Encoder_GetCounts(const Encoder_t *enc);
+
+/**
+ * @brief Unwrapped multi-turn position in degrees (output side)
+ */
+float Encoder_GetPositionDeg(const Encoder_t *enc);
+
+/**
+ * @brief Filtered velocity in RPM (output side)
+ */
+float Encoder_GetVelocityRPM(const Encoder_t *enc);
+
+#endif /* ENCODER_H */
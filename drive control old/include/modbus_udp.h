@@ -23,6 +23,18 @@ typedef enum {
     MODBUS_ERROR = -1
 } ModbusStatus_t;
 
+#define MODBUS_MBAP_LEN        (7U)     /* MBAP header length */
+#define MODBUS_RESP_BUF_LEN    (260U)   /* == MODBUS_MAX_RESP */
+
+/* One outstanding read request (pipelined API) */
+typedef struct {
+    uint16_t transaction_id;
+    uint16_t num_regs;
+    uint8_t  done;                              /* 1 = response received */
+    int32_t  resp_len;
+    uint8_t  response[MODBUS_RESP_BUF_LEN];     /* raw MBAP response */
+} ModbusRequest_t;
+
 /* Connection control */
 ModbusStatus_t MODBUS_UDP_InitConnection(void);
 void MODBUS_UDP_CloseConnection(void);
@@ -38,4 +50,17 @@ ModbusStatus_t MODBUS_UDP_Read(const char *ip, uint16_t port,
 ModbusStatus_t MODBUS_UDP_Write(const char *ip, uint16_t port,
                                 uint16_t reg_addr, uint16_t reg_value);
 
+/* Pipelined reads: send several requests, then collect by transaction ID */
+ModbusStatus_t MODBUS_UDP_ReadSend(uint16_t start_addr, uint16_t num_regs,
+                                   ModbusRequest_t *req);
+
+ModbusStatus_t MODBUS_UDP_ReadPoll(ModbusRequest_t *reqs, uint8_t count,
+                                   uint32_t timeout_us);
+
+/* Register data of a completed read response, NULL if malformed */
+const uint8_t *MODBUS_UDP_GetData(const ModbusRequest_t *req);
+
+/* Register <index> of a completed read response (big-endian decode) */
+uint16_t MODBUS_UDP_GetReg(const ModbusRequest_t *req, uint16_t index);
+
 #endif /* MODBUS_UDP_H */
\ No newline at end of file
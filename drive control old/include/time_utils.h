@@ -0,0 +1,22 @@
+#ifndef TIME_UTILS_H
+#define TIME_UTILS_H
+
+#include <stdint.h>
+
+/*----------------------------------------------------------
+ * Function Prototypes
+ *----------------------------------------------------------*/
+
+/**
+ * @brief Monotonic timestamp
+ * @return Microseconds since an arbitrary fixed point
+ */
+uint64_t TIME_NowUs(void);
+
+/**
+ * @brief Sleep for at least the given time
+ * @param us Delay in microseconds
+ */
+void TIME_SleepUs(uint32_t us);
+
+#endif /* TIME_UTILS_H */
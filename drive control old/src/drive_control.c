@@ -1,5 +1,8 @@
 #include "drive_control.h"
+#include "time_utils.h"
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 
 ModbusStatus_t Send_Pan_Command(uint16_t cmd)
 {
@@ -10,52 +13,270 @@ ModbusStatus_t Send_Tilt_Command(uint16_t cmd)
 {
     return MODBUS_UDP_Write(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_CONTROL, cmd);
 }
+
 /*----------------------------------------------------------
- * PARK MOTION FUNCTION
+ * Local helpers
  *----------------------------------------------------------*/
-ModbusStatus_t Drive_ParkMotion(void)
+static uint32_t Park_Decode32(const uint8_t *p)
 {
-    ModbusStatus_t status;
+    return ((uint32_t)p[0] << 24U) | ((uint32_t)p[1] << 16U) |
+           ((uint32_t)p[2] << 8U)  | (uint32_t)p[3];
+}
+
+/* Travel time of the drive's park trapezoid for one axis */
+static uint64_t Park_TravelTimeUs(uint32_t position, uint32_t target)
+{
+    float dist = fabsf((float)(int32_t)(position - target));
+    float t;
+
+    if (dist >= ((PARK_SPEED_CPS * PARK_SPEED_CPS) / PARK_ACCEL_CPS2))
+    {
+        t = (dist / PARK_SPEED_CPS) + (PARK_SPEED_CPS / PARK_ACCEL_CPS2);
+    }
+    else
+    {
+        t = 2.0F * sqrtf(dist / PARK_ACCEL_CPS2);
+    }
+    return (uint64_t)(t * 1000000.0F);
+}
+
+/* Read the PAN and TILT blocks with both requests in flight */
+static ModbusStatus_t Park_SendPoll(ParkContext_t *ctx)
+{
+    if ((MODBUS_UDP_ReadSend(REG_PAN_POSITION, PARK_BLOCK_REGS, &ctx->req[0]) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadSend(REG_TILT_POSITION, PARK_BLOCK_REGS, &ctx->req[1]) != MODBUS_OK))
+    {
+        return MODBUS_ERROR;
+    }
+    ctx->in_flight = 1U;
+    ctx->sent_us = TIME_NowUs();
+    ctx->polls++;
+    return MODBUS_OK;
+}
+
+/* data: validated block from MODBUS_UDP_GetData() */
+static void Park_UpdateAxis(ParkAxis_t *axis, const uint8_t *data,
+                            uint64_t now_us, uint64_t eta_us)
+{
+    axis->speed = Park_Decode32(&data[4]);
+
+    if (axis->speed != 0U)
+    {
+        axis->moving_seen = 1U;
+    }
+
+    /* Zero speed before the axis ever moved only counts once past the ETA */
+    if ((axis->speed == 0U) && ((axis->moving_seen != 0U) || (now_us >= eta_us)))
+    {
+        axis->done = 1U;
+    }
+}
+
+/*----------------------------------------------------------
+ * Adaptive poll interval
+ *----------------------------------------------------------*/
+uint32_t Drive_ParkPollInterval(const ParkContext_t *ctx, uint64_t now_us)
+{
+    uint64_t remaining;
+    uint64_t interval;
+
+    if ((now_us + PARK_POLL_FAST_US) >= ctx->eta_us)
+    {
+        return PARK_POLL_FAST_US;
+    }
+
+    /* Halve the distance to the ETA each poll, within [fast, slow] */
+    remaining = ctx->eta_us - now_us;
+    interval = remaining / 2U;
+    if (interval < PARK_POLL_FAST_US) { interval = PARK_POLL_FAST_US; }
+    if (interval > PARK_POLL_SLOW_US) { interval = PARK_POLL_SLOW_US; }
+
+    return (uint32_t)interval;
+}
+
+/*----------------------------------------------------------
+ * Start PARK motion (non-blocking)
+ *----------------------------------------------------------*/
+ModbusStatus_t Drive_ParkStart(ParkContext_t *ctx)
+{
+    const uint8_t *pan_data;
+    const uint8_t *tilt_data;
+    uint64_t t_pan, t_tilt;
+
+    if (ctx == NULL)
+    {
+        return MODBUS_ERROR;
+    }
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->state = PARK_FAILED;
 
     printf(" Starting PARK motion for Pan and Tilt...\n");
 
-    /* 1️⃣ Send PARK command (or target position) */
-    status = MODBUS_UDP_Write(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_PAN_PARK_POS, 0x0000U);
-    if (status != MODBUS_OK)
+    /* 1) Park targets */
+    if (MODBUS_UDP_Write(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_PAN_PARK_POS, PAN_PARK_TARGET_POS) != MODBUS_OK)
     {
         printf(" Failed to set Pan park target.\n");
         return MODBUS_ERROR;
     }
-
-    status = MODBUS_UDP_Write(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_PARK_POS, 0x0000U);
-    if (status != MODBUS_OK)
+    if (MODBUS_UDP_Write(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_PARK_POS, TILT_PARK_TARGET_POS) != MODBUS_OK)
     {
         printf(" Failed to set Tilt park target.\n");
         return MODBUS_ERROR;
     }
 
-    /* 2️⃣ Send START PARK command to both motors */
+    /* 2) Current positions -> expected arrival */
+    if ((Park_SendPoll(ctx) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadPoll(ctx->req, 2U, MODBUS_TIMEOUT_SEC * 1000000U) != MODBUS_OK))
+    {
+        printf(" Failed to read Pan/Tilt position.\n");
+        return MODBUS_ERROR;
+    }
+    ctx->in_flight = 0U;
+    ctx->polls = 0U;
+    pan_data  = MODBUS_UDP_GetData(&ctx->req[0]);
+    tilt_data = MODBUS_UDP_GetData(&ctx->req[1]);
+    if ((pan_data == NULL) || (tilt_data == NULL))
+    {
+        printf(" Invalid Pan/Tilt position response.\n");
+        return MODBUS_ERROR;
+    }
+    t_pan  = Park_TravelTimeUs(Park_Decode32(pan_data), PAN_PARK_TARGET_POS);
+    t_tilt = Park_TravelTimeUs(Park_Decode32(tilt_data), TILT_PARK_TARGET_POS);
+
+    /* 3) START PARK on both motors */
     (void)Send_Pan_Command(CMD_START_PARK);
     (void)Send_Tilt_Command(CMD_START_PARK);
 
-    /* 3️⃣ Wait for motion to complete (poll until stopped) */
-    uint32_t pan_speed = 0U, tilt_speed = 0U;
-    for (int i = 0; i < 50; i++) /* 5 seconds total at 100ms each */
+    ctx->start_us = TIME_NowUs();
+    ctx->eta_us = ctx->start_us + ((t_pan > t_tilt) ? t_pan : t_tilt);
+    ctx->next_poll_us = ctx->start_us + Drive_ParkPollInterval(ctx, ctx->start_us);
+    ctx->state = PARK_MOVING;
+
+    return MODBUS_OK;
+}
+
+/*----------------------------------------------------------
+ * Advance PARK motion
+ *----------------------------------------------------------*/
+ParkState_t Drive_ParkPoll(ParkContext_t *ctx, uint32_t wait_us)
+{
+    const uint8_t *pan_data;
+    const uint8_t *tilt_data;
+    uint64_t now;
+
+    if ((ctx == NULL) || (ctx->state != PARK_MOVING))
     {
-        (void)MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_PAN_SPEED, 1U, &pan_speed);
-        (void)MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_SPEED, 1U, &tilt_speed);
+        return (ctx == NULL) ? PARK_FAILED : ctx->state;
+    }
 
-        printf(" Pan speed=%lu | Tilt speed=%lu\r", 
-               (unsigned long)pan_speed, (unsigned long)tilt_speed);
-        Sleep(100); /* 100ms delay */
+    now = TIME_NowUs();
+    if (ctx->in_flight == 0U)
+    {
+        if (now < ctx->next_poll_us)
+        {
+            return PARK_MOVING;
+        }
+        if (Park_SendPoll(ctx) != MODBUS_OK)
+        {
+            ctx->state = PARK_FAILED;
+            return ctx->state;
+        }
+    }
 
-        if ((pan_speed == 0U) && (tilt_speed == 0U))
+    if (MODBUS_UDP_ReadPoll(ctx->req, 2U, wait_us) != MODBUS_OK)
+    {
+        now = TIME_NowUs();
+        if ((now - ctx->start_us) >= PARK_TIMEOUT_US)
         {
-            printf("\n Both motors parked successfully!\n");
-            return MODBUS_OK;
+            ctx->state = PARK_TIMEOUT;
         }
+        else if ((now - ctx->sent_us) >= (MODBUS_TIMEOUT_SEC * 1000000U))
+        {
+            /* Response lost: poll again, but a silent drive is not "still moving" */
+            ctx->in_flight = 0U;
+            ctx->next_poll_us = now;
+            ctx->lost++;
+            if (ctx->lost >= PARK_POLL_RETRIES)
+            {
+                ctx->state = PARK_FAILED;
+            }
+        }
+        return ctx->state;
+    }
+
+    ctx->in_flight = 0U;
+    ctx->lost = 0U;
+    pan_data  = MODBUS_UDP_GetData(&ctx->req[0]);
+    tilt_data = MODBUS_UDP_GetData(&ctx->req[1]);
+    if ((pan_data == NULL) || (tilt_data == NULL))
+    {
+        ctx->state = PARK_FAILED;
+        return ctx->state;
+    }
+
+    now = TIME_NowUs();
+    Park_UpdateAxis(&ctx->pan,  pan_data,  now, ctx->eta_us);
+    Park_UpdateAxis(&ctx->tilt, tilt_data, now, ctx->eta_us);
+
+    if ((ctx->pan.done != 0U) && (ctx->tilt.done != 0U))
+    {
+        ctx->done_us = now;
+        ctx->state = PARK_DONE;
+    }
+    else if ((now - ctx->start_us) >= PARK_TIMEOUT_US)
+    {
+        ctx->state = PARK_TIMEOUT;
+    }
+    else
+    {
+        ctx->next_poll_us = now + Drive_ParkPollInterval(ctx, now);
     }
 
-    printf("\n Timeout: motors did not stop within limit.\n");
+    return ctx->state;
+}
+
+/*----------------------------------------------------------
+ * PARK MOTION FUNCTION (blocking)
+ *----------------------------------------------------------*/
+ModbusStatus_t Drive_ParkMotion(void)
+{
+    ParkContext_t ctx;
+    ParkState_t state;
+
+    if (Drive_ParkStart(&ctx) != MODBUS_OK)
+    {
+        return MODBUS_ERROR;
+    }
+
+    while ((state = Drive_ParkPoll(&ctx, PARK_POLL_FAST_US)) == PARK_MOVING)
+    {
+        uint64_t now = TIME_NowUs();
+
+        printf(" Pan speed=%lu | Tilt speed=%lu\r",
+               (unsigned long)ctx.pan.speed, (unsigned long)ctx.tilt.speed);
+
+        if ((ctx.in_flight == 0U) && (ctx.next_poll_us > now))
+        {
+            TIME_SleepUs((uint32_t)(ctx.next_poll_us - now));
+        }
+    }
+
+    if (state == PARK_DONE)
+    {
+        printf("\n Both motors parked successfully! (%lu ms, ETA %lu ms, %lu polls)\n",
+               (unsigned long)((ctx.done_us - ctx.start_us) / 1000U),
+               (unsigned long)((ctx.eta_us - ctx.start_us) / 1000U),
+               (unsigned long)ctx.polls);
+        return MODBUS_OK;
+    }
+
+    if (state == PARK_FAILED)
+    {
+        printf("\n Park aborted: Pan/Tilt feedback could not be read.\n");
+    }
+    else
+    {
+        printf("\n Timeout: motors did not stop within limit.\n");
+    }
     return MODBUS_ERROR;
-}
\ No newline at end of file
+}
@@ -1,81 +1,193 @@
 #include "drive_feedback.h"
+#include "time_utils.h"
 #include "config.h"
 #include <string.h>
 #include <stdio.h>
 
+/*----------------------------------------------------------
+ * Block layout: position(2), speed(2), counts(2) per axis
+ *----------------------------------------------------------*/
+#define FEEDBACK_BLOCK_REGS   (6U)
+#define FEEDBACK_MAX_READ     (125U)   /* Modbus limit for 0x03 */
+
+/* Both axes in one read when the TILT block is close enough to PAN */
+#define FEEDBACK_SPAN_REGS    ((REG_TILT_POSITION - REG_PAN_POSITION) + FEEDBACK_BLOCK_REGS)
+#if (REG_TILT_POSITION > REG_PAN_POSITION) && (FEEDBACK_SPAN_REGS <= FEEDBACK_MAX_READ)
+    #define FEEDBACK_SINGLE_READ  (1)
+#else
+    #define FEEDBACK_SINGLE_READ  (0)
+#endif
+
+#define FEEDBACK_TIMEOUT_US   (MODBUS_TIMEOUT_SEC * 1000000U)
+
+/* Reciprocal scale factors, folded at compile time */
+#define DEG_PER_COUNT         (360.0F / (float)ENCODER_RESOLUTION)
+#define RPM_PER_CPS           (60.0F / (float)ENCODER_RESOLUTION)
+
 /*----------------------------------------------------------
  * Local conversion helpers
  *----------------------------------------------------------*/
 static float Convert_Position_To_Degrees(uint32_t counts)
 {
-    /* position (deg) = (counts * 360) / encoder resolution */
-    return ((float)counts * 360.0F) / (float)ENCODER_RESOLUTION;
+    /* position (deg) = counts * 360 / encoder resolution */
+    return (float)counts * DEG_PER_COUNT;
 }
 
 static float Convert_Speed_To_RPM(uint32_t count_per_sec)
 {
-    /* speed (rpm) = (count/sec * 60) / encoder resolution */
-    return ((float)count_per_sec * 60.0F) / (float)ENCODER_RESOLUTION;
+    /* speed (rpm) = count/sec * 60 / encoder resolution */
+    return (float)count_per_sec * RPM_PER_CPS;
+}
+
+static uint32_t Decode_U32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24U) | ((uint32_t)p[1] << 16U) |
+           ((uint32_t)p[2] << 8U)  | (uint32_t)p[3];
 }
 
 /*----------------------------------------------------------
- * Read Feedback for PAN Axis
+ * Decode one feedback block straight from the response buffer
  *----------------------------------------------------------*/
-ModbusStatus_t Read_Pan_Feedback(AxisFeedback_t *fb)
+void Decode_AxisFeedback(const uint8_t *data, AxisFeedback_t *fb)
+{
+    fb->raw_position = Decode_U32(&data[0]);
+    fb->raw_speed    = Decode_U32(&data[4]);
+    fb->raw_counts   = Decode_U32(&data[8]);
+
+    fb->counts_per_sec = (float)fb->raw_speed;
+    fb->speed_rpm      = Convert_Speed_To_RPM(fb->raw_speed);
+    fb->position_deg   = Convert_Position_To_Degrees(fb->raw_position);
+}
+
+/*----------------------------------------------------------
+ * One block read (1 RTT) for a single axis
+ *----------------------------------------------------------*/
+static ModbusStatus_t Read_Axis_Block(uint16_t base_addr, AxisFeedback_t *fb)
 {
+    ModbusRequest_t req;
+    const uint8_t *data;
+
     if (fb == NULL)
     {
         return MODBUS_ERROR;
     }
 
-    /* Read raw data from Modbus registers */
-    if (MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_PAN_POSITION, 2U, &fb->raw_position) != MODBUS_OK)
+    if ((MODBUS_UDP_ReadSend(base_addr, FEEDBACK_BLOCK_REGS, &req) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadPoll(&req, 1U, FEEDBACK_TIMEOUT_US) != MODBUS_OK))
     {
         return MODBUS_ERROR;
     }
-    if (MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_PAN_SPEED, 2U, &fb->raw_speed) != MODBUS_OK)
-    {
-        return MODBUS_ERROR;
-    }
-    if (MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_PAN_COUNTS, 2U, &fb->raw_counts) != MODBUS_OK)
+
+    data = MODBUS_UDP_GetData(&req);
+    if (data == NULL)
     {
         return MODBUS_ERROR;
     }
 
-    /* Compute physical units */
-    fb->counts_per_sec = (float)fb->raw_speed;
-    fb->speed_rpm      = Convert_Speed_To_RPM(fb->raw_speed);
-    fb->position_deg   = Convert_Position_To_Degrees(fb->raw_position);
-
+    Decode_AxisFeedback(data, fb);
     return MODBUS_OK;
 }
 
+/*----------------------------------------------------------
+ * Read Feedback for PAN Axis
+ *----------------------------------------------------------*/
+ModbusStatus_t Read_Pan_Feedback(AxisFeedback_t *fb)
+{
+    return Read_Axis_Block(REG_PAN_POSITION, fb);
+}
+
 /*----------------------------------------------------------
  * Read Feedback for TILT Axis
  *----------------------------------------------------------*/
 ModbusStatus_t Read_Tilt_Feedback(AxisFeedback_t *fb)
 {
-    if (fb == NULL)
+    return Read_Axis_Block(REG_TILT_POSITION, fb);
+}
+
+/*----------------------------------------------------------
+ * Read Feedback for both axes in one feedback cycle
+ *----------------------------------------------------------*/
+ModbusStatus_t Read_Axes_Feedback(AxisFeedback_t *pan_fb, AxisFeedback_t *tilt_fb)
+{
+    const uint8_t *pan_data;
+    const uint8_t *tilt_data;
+
+    if ((pan_fb == NULL) || (tilt_fb == NULL))
     {
         return MODBUS_ERROR;
     }
 
-    if (MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_POSITION, 2U, &fb->raw_position) != MODBUS_OK)
+#if FEEDBACK_SINGLE_READ
+    ModbusRequest_t req;
+
+    /* One read spanning PAN..TILT blocks */
+    if ((MODBUS_UDP_ReadSend(REG_PAN_POSITION, FEEDBACK_SPAN_REGS, &req) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadPoll(&req, 1U, FEEDBACK_TIMEOUT_US) != MODBUS_OK))
     {
         return MODBUS_ERROR;
     }
-    if (MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_SPEED, 2U, &fb->raw_speed) != MODBUS_OK)
+    pan_data = MODBUS_UDP_GetData(&req);
+    tilt_data = (pan_data == NULL) ? NULL :
+                &pan_data[(REG_TILT_POSITION - REG_PAN_POSITION) * 2U];
+#else
+    ModbusRequest_t req[2U];
+
+    /* Two block reads in flight, completed in one RTT */
+    if ((MODBUS_UDP_ReadSend(REG_PAN_POSITION, FEEDBACK_BLOCK_REGS, &req[0]) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadSend(REG_TILT_POSITION, FEEDBACK_BLOCK_REGS, &req[1]) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadPoll(req, 2U, FEEDBACK_TIMEOUT_US) != MODBUS_OK))
     {
         return MODBUS_ERROR;
     }
-    if (MODBUS_UDP_Read(DRIVE_IP_ADDR, DRIVE_PORT_UDP, REG_TILT_COUNTS, 2U, &fb->raw_counts) != MODBUS_OK)
+    pan_data = MODBUS_UDP_GetData(&req[0]);
+    tilt_data = MODBUS_UDP_GetData(&req[1]);
+#endif
+
+    if ((pan_data == NULL) || (tilt_data == NULL))
     {
         return MODBUS_ERROR;
     }
 
-    fb->counts_per_sec = (float)fb->raw_speed;
-    fb->speed_rpm      = Convert_Speed_To_RPM(fb->raw_speed);
-    fb->position_deg   = Convert_Position_To_Degrees(fb->raw_position);
+    Decode_AxisFeedback(pan_data, pan_fb);
+    Decode_AxisFeedback(tilt_data, tilt_fb);
+    return MODBUS_OK;
+}
+
+/*----------------------------------------------------------
+ * Position-only poll for both axes (no speed registers)
+ *   Velocity is estimated by the encoders from the sample times.
+ *----------------------------------------------------------*/
+ModbusStatus_t Read_Axes_Position(Encoder_t *pan_enc, Encoder_t *tilt_enc)
+{
+    ModbusRequest_t req[2U];
+    const uint8_t *pan_data;
+    const uint8_t *tilt_data;
+    uint64_t t_sent;
+    uint64_t t_sample;
+
+    if ((pan_enc == NULL) || (tilt_enc == NULL))
+    {
+        return MODBUS_ERROR;
+    }
+
+    t_sent = TIME_NowUs();
+    if ((MODBUS_UDP_ReadSend(REG_PAN_POSITION, 2U, &req[0]) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadSend(REG_TILT_POSITION, 2U, &req[1]) != MODBUS_OK) ||
+        (MODBUS_UDP_ReadPoll(req, 2U, FEEDBACK_TIMEOUT_US) != MODBUS_OK))
+    {
+        return MODBUS_ERROR;
+    }
+    /* Sample time estimate: middle of the round trip */
+    t_sample = t_sent + ((TIME_NowUs() - t_sent) / 2U);
+
+    pan_data = MODBUS_UDP_GetData(&req[0]);
+    tilt_data = MODBUS_UDP_GetData(&req[1]);
+    if ((pan_data == NULL) || (tilt_data == NULL))
+    {
+        return MODBUS_ERROR;
+    }
 
+    Encoder_Update(pan_enc, Decode_U32(pan_data), t_sample);
+    Encoder_Update(tilt_enc, Decode_U32(tilt_data), t_sample);
     return MODBUS_OK;
 }
@@ -0,0 +1,86 @@
+#include "encoder.h"
+#include <stdio.h>
+#include <string.h>
+
+/*----------------------------------------------------------
+ * Initialize encoder channel
+ *----------------------------------------------------------*/
+void Encoder_Init(Encoder_t *enc, uint32_t counts_per_rev, float gear_ratio, float vel_alpha)
+{
+    float counts_per_out_rev;
+
+    if (enc == NULL)
+    {
+        return;
+    }
+
+    memset(enc, 0, sizeof(*enc));
+
+    /* Reciprocals computed once; the cyclic path only multiplies */
+    counts_per_out_rev = (float)counts_per_rev * gear_ratio;
+    enc->deg_per_count = 360.0F / counts_per_out_rev;
+    enc->rpm_per_cps   = 60.0F / counts_per_out_rev;
+
+    if ((vel_alpha <= 0.0F) || (vel_alpha > 1.0F))
+    {
+        vel_alpha = 1.0F;
+    }
+    enc->vel_alpha = vel_alpha;
+}
+
+/*----------------------------------------------------------
+ * Update with a new timestamped sample
+ *----------------------------------------------------------*/
+void Encoder_Update(Encoder_t *enc, uint32_t raw_counts, uint64_t time_us)
+{
+    int32_t delta;
+    uint64_t dt_us;
+
+    if (enc == NULL)
+    {
+        return;
+    }
+
+    if (enc->initialized == 0U)
+    {
+        /* Counter is two's complement: positions below zero stay negative */
+        enc->position = (int64_t)(int32_t)raw_counts;
+        enc->last_raw = raw_counts;
+        enc->last_time_us = time_us;
+        enc->velocity_cps = 0.0F;
+        enc->initialized = 1U;
+        return;
+    }
+
+    /* Modular difference: correct across 0xFFFFFFFF -> 0 wraparound */
+    delta = (int32_t)(raw_counts - enc->last_raw);
+    enc->position += delta;
+
+    dt_us = time_us - enc->last_time_us;
+    if (dt_us > 0U)
+    {
+        float inst_cps = ((float)delta * 1000000.0F) / (float)dt_us;
+        enc->velocity_cps += enc->vel_alpha * (inst_cps - enc->velocity_cps);
+    }
+
+    enc->last_raw = raw_counts;
+    enc->last_time_us = time_us;
+}
+
+/*----------------------------------------------------------
+ * Accessors
+ *----------------------------------------------------------*/
+int64_t Encoder_GetCounts(const Encoder_t *enc)
+{
+    return enc->position;
+}
+
+float Encoder_GetPositionDeg(const Encoder_t *enc)
+{
+    return (float)enc->position * enc->deg_per_count;
+}
+
+float Encoder_GetVelocityRPM(const Encoder_t *enc)
+{
+    return enc->velocity_cps * enc->rpm_per_cps;
+}
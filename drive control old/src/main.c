@@ -85,8 +85,7 @@ int main(void)
                 break;
 
             case 5:
-                if ((Read_Pan_Feedback(&pan_fb) == MODBUS_OK) &&
-                    (Read_Tilt_Feedback(&tilt_fb) == MODBUS_OK))
+                if (Read_Axes_Feedback(&pan_fb, &tilt_fb) == MODBUS_OK)
                 {
                     printf("\n--- PAN AXIS ---\n");
                     printf(" Position: %.2f°\n", pan_fb.position_deg);
@@ -191,3 +191,156 @@ ModbusStatus_t MODBUS_UDP_Write(const char *ip, uint16_t port,
     modbus_transaction_id++;
     return MODBUS_OK;
 }
+
+
+/*----------------------------------------------------------
+ * Pipelined Read: send request, do not wait for response
+ *----------------------------------------------------------*/
+ModbusStatus_t MODBUS_UDP_ReadSend(uint16_t start_addr, uint16_t num_regs,
+                                   ModbusRequest_t *req)
+{
+    uint8_t request[12];
+
+    if ((modbus_sock == INVALID_SOCKET) || (req == NULL))
+    {
+        return MODBUS_ERROR;
+    }
+
+    req->transaction_id = modbus_transaction_id++;
+    req->num_regs = num_regs;
+    req->done = 0U;
+    req->resp_len = 0;
+
+    request[0] = (uint8_t)(req->transaction_id >> 8);
+    request[1] = (uint8_t)(req->transaction_id & 0xFFU);
+    request[2] = 0x00; request[3] = 0x00;
+    request[4] = 0x00; request[5] = 0x06;
+    request[6] = MODBUS_UNIT_ID;
+    request[7] = MODBUS_READ_FUNC;
+    request[8] = (uint8_t)(start_addr >> 8);
+    request[9] = (uint8_t)(start_addr & 0xFFU);
+    request[10] = (uint8_t)(num_regs >> 8);
+    request[11] = (uint8_t)(num_regs & 0xFFU);
+
+    if (sendto(modbus_sock, (const char *)request, 12, 0,
+               (struct sockaddr *)&modbus_server, modbus_addr_len) == SOCKET_ERROR)
+    {
+        printf("Send failed: %d\n", WSAGetLastError());
+        return MODBUS_ERROR;
+    }
+
+    return MODBUS_OK;
+}
+
+/*----------------------------------------------------------
+ * Pipelined Read: collect responses, matched by transaction ID
+ *   Receives straight into the oldest pending request's buffer;
+ *   only an out-of-order response is copied to its owner.
+ *----------------------------------------------------------*/
+ModbusStatus_t MODBUS_UDP_ReadPoll(ModbusRequest_t *reqs, uint8_t count,
+                                   uint32_t timeout_us)
+{
+    uint8_t pending = 0U;
+    uint8_t i;
+
+    if ((modbus_sock == INVALID_SOCKET) || (reqs == NULL))
+    {
+        return MODBUS_ERROR;
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+        if (reqs[i].done == 0U)
+        {
+            pending++;
+        }
+    }
+
+    while (pending > 0U)
+    {
+        fd_set rfds;
+        struct timeval tv;
+        ModbusRequest_t *slot = NULL;
+        uint16_t tid;
+        int bytes_received;
+
+        FD_ZERO(&rfds);
+        FD_SET(modbus_sock, &rfds);
+        tv.tv_sec = (long)(timeout_us / 1000000U);
+        tv.tv_usec = (long)(timeout_us % 1000000U);
+
+        /* Timeout applies per wait; a quiet socket ends the poll */
+        if (select((int)modbus_sock + 1, &rfds, NULL, NULL, &tv) <= 0)
+        {
+            return MODBUS_ERROR;
+        }
+
+        for (i = 0U; (i < count) && (slot == NULL); i++)
+        {
+            if (reqs[i].done == 0U)
+            {
+                slot = &reqs[i];
+            }
+        }
+
+        bytes_received = recvfrom(modbus_sock, (char *)slot->response,
+                                  sizeof(slot->response), 0, NULL, NULL);
+        if ((bytes_received == SOCKET_ERROR) || (bytes_received < (int)(MODBUS_MBAP_LEN + 2U)))
+        {
+            continue;
+        }
+
+        tid = (uint16_t)((slot->response[0] << 8U) | slot->response[1]);
+        if (tid != slot->transaction_id)
+        {
+            ModbusRequest_t *owner = NULL;
+            for (i = 0U; (i < count) && (owner == NULL); i++)
+            {
+                if ((reqs[i].done == 0U) && (reqs[i].transaction_id == tid))
+                {
+                    owner = &reqs[i];
+                }
+            }
+            if (owner == NULL)
+            {
+                continue;   /* stale or foreign datagram */
+            }
+            memcpy(owner->response, slot->response, (size_t)bytes_received);
+            slot = owner;
+        }
+
+        slot->resp_len = bytes_received;
+        slot->done = 1U;
+        pending--;
+    }
+
+    return MODBUS_OK;
+}
+
+/*----------------------------------------------------------
+ * Register data of a completed pipelined read (in place)
+ *----------------------------------------------------------*/
+const uint8_t *MODBUS_UDP_GetData(const ModbusRequest_t *req)
+{
+    uint16_t byte_count = (uint16_t)(req->num_regs * 2U);
+
+    if ((req->done == 0U) ||
+        (req->response[7] != MODBUS_READ_FUNC) ||
+        (req->response[8] != byte_count) ||
+        (req->resp_len < (int32_t)(MODBUS_MBAP_LEN + 2U + byte_count)))
+    {
+        return NULL;
+    }
+
+    return &req->response[MODBUS_MBAP_LEN + 2U];
+}
+
+/*----------------------------------------------------------
+ * Register accessor for a completed pipelined read
+ *----------------------------------------------------------*/
+uint16_t MODBUS_UDP_GetReg(const ModbusRequest_t *req, uint16_t index)
+{
+    uint16_t pos = (uint16_t)(MODBUS_MBAP_LEN + 2U + (index * 2U));
+
+    return (uint16_t)((req->response[pos] << 8U) | req->response[pos + 1U]);
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "unity.h"
 #include "drive_control.h"
+#include "time_utils.h"
 #include <stdio.h>
 #include <windows.h> // for Sleep mock (optional on Windows)
 
@@ -22,27 +23,75 @@ ModbusStatus_t MODBUS_UDP_Read(const char *ip, uint16_t port,
                                uint32_t *value)
 {
     (void)ip; (void)port; (void)start_addr; (void)num_regs;
+    *value = 0U;
+    return MODBUS_OK;
+}
+
+// Pipelined read mocks: PAN/TILT blocks are position, speed, counts
+static int mock_running_reads = 5;     // reads that still report speed != 0
+static int mock_malformed = 0;         // GetData rejects the response
+static int mock_poll_fail = 0;         // ReadPoll reports no response
+static uint32_t mock_position = 4096U;
+
+static void mock_put_reg(ModbusRequest_t *req, uint16_t index, uint16_t v)
+{
+    req->response[MODBUS_MBAP_LEN + 2U + (index * 2U)] = (uint8_t)(v >> 8U);
+    req->response[MODBUS_MBAP_LEN + 3U + (index * 2U)] = (uint8_t)(v & 0xFFU);
+}
+
+ModbusStatus_t MODBUS_UDP_ReadSend(uint16_t start_addr, uint16_t num_regs,
+                                   ModbusRequest_t *req)
+{
+    uint32_t speed = (mock_read_call_count < mock_running_reads) ? 100U : 0U;
     mock_read_call_count++;
 
-    // Simulate that speeds become 0 after 5 reads
-    static int step = 0;
-    if (step++ < 5)
-        *value = 100U; // running
-    else
-        *value = 0U;   // stopped
+    req->transaction_id = start_addr;
+    req->num_regs = num_regs;
+    req->done = 0U;
+    mock_put_reg(req, 0U, (uint16_t)(mock_position >> 16U));
+    mock_put_reg(req, 1U, (uint16_t)(mock_position & 0xFFFFU));
+    mock_put_reg(req, 2U, (uint16_t)(speed >> 16U));
+    mock_put_reg(req, 3U, (uint16_t)(speed & 0xFFFFU));
 
-    if (start_addr == REG_PAN_SPEED) mock_pan_speed = *value;
-    if (start_addr == REG_TILT_SPEED) mock_tilt_speed = *value;
+    if (start_addr == REG_PAN_POSITION) mock_pan_speed = speed;
+    if (start_addr == REG_TILT_POSITION) mock_tilt_speed = speed;
+    return MODBUS_OK;
+}
 
+ModbusStatus_t MODBUS_UDP_ReadPoll(ModbusRequest_t *reqs, uint8_t count,
+                                   uint32_t timeout_us)
+{
+    (void)timeout_us;
+    if (mock_poll_fail != 0)
+    {
+        return MODBUS_ERROR;
+    }
+    for (uint8_t i = 0U; i < count; i++)
+    {
+        reqs[i].done = 1U;
+    }
     return MODBUS_OK;
 }
 
+const uint8_t *MODBUS_UDP_GetData(const ModbusRequest_t *req)
+{
+    if ((req->done == 0U) || (mock_malformed != 0))
+    {
+        return NULL;
+    }
+    return &req->response[MODBUS_MBAP_LEN + 2U];
+}
+
 // ---- UNITY SETUP ----
 void setUp(void)
 {
     mock_write_call_count = 0;
     mock_read_call_count = 0;
     mock_pan_speed = mock_tilt_speed = 0;
+    mock_running_reads = 5;
+    mock_malformed = 0;
+    mock_poll_fail = 0;
+    mock_position = 4096U;
 }
 
 void tearDown(void) {}
@@ -70,6 +119,73 @@ void test_Drive_ParkMotion_completes_successfully(void)
     TEST_ASSERT_GREATER_OR_EQUAL(5, mock_read_call_count);
 }
 
+void test_Drive_ParkMotion_completes_at_rest_after_eta(void)
+{
+    mock_running_reads = 0;              // never seen moving (already parked)
+    mock_position = 0U;                  // at the target: ETA is now
+    ModbusStatus_t status = Drive_ParkMotion();
+    TEST_ASSERT_EQUAL(MODBUS_OK, status);
+    TEST_ASSERT_EQUAL(4, mock_read_call_count);  // 1 position read + 1 poll, 2 axes each
+}
+
+void test_Drive_ParkPoll_fails_on_malformed_response(void)
+{
+    ParkContext_t ctx;
+    TEST_ASSERT_EQUAL(MODBUS_OK, Drive_ParkStart(&ctx));
+
+    mock_malformed = 1;
+    ctx.next_poll_us = 0U;
+    TEST_ASSERT_EQUAL(PARK_FAILED, Drive_ParkPoll(&ctx, 0U));
+}
+
+void test_Drive_ParkPoll_fails_after_lost_responses(void)
+{
+    ParkContext_t ctx;
+    uint32_t i;
+    TEST_ASSERT_EQUAL(MODBUS_OK, Drive_ParkStart(&ctx));
+
+    mock_poll_fail = 1;
+    for (i = 1U; i <= PARK_POLL_RETRIES; i++)
+    {
+        // a poll in flight for a full Modbus timeout: its response is lost
+        ctx.in_flight = 1U;
+        ctx.start_us = TIME_NowUs();
+        ctx.sent_us = ctx.start_us - (MODBUS_TIMEOUT_SEC * 1000000U);
+        TEST_ASSERT_EQUAL((i < PARK_POLL_RETRIES) ? PARK_MOVING : PARK_FAILED,
+                          Drive_ParkPoll(&ctx, 0U));
+    }
+}
+
+void test_Drive_ParkMotion_fails_when_start_position_invalid(void)
+{
+    mock_malformed = 1;
+    TEST_ASSERT_EQUAL(MODBUS_ERROR, Drive_ParkMotion());
+    TEST_ASSERT_EQUAL(2, mock_read_call_count);   // start read only, no START_PARK
+    TEST_ASSERT_EQUAL(2, mock_write_call_count);  // park targets only
+}
+
+void test_Drive_ParkPollInterval_is_fast_near_arrival(void)
+{
+    ParkContext_t ctx = {0};
+    ctx.eta_us = 1000000U;
+
+    TEST_ASSERT_EQUAL_UINT32(PARK_POLL_SLOW_US, Drive_ParkPollInterval(&ctx, 0U));
+    TEST_ASSERT_EQUAL_UINT32(20000U, Drive_ParkPollInterval(&ctx, 960000U));
+    TEST_ASSERT_EQUAL_UINT32(PARK_POLL_FAST_US, Drive_ParkPollInterval(&ctx, 999000U));
+    TEST_ASSERT_EQUAL_UINT32(PARK_POLL_FAST_US, Drive_ParkPollInterval(&ctx, 2000000U));
+}
+
+void test_Drive_ParkPoll_does_not_block_before_next_poll(void)
+{
+    ParkContext_t ctx;
+    TEST_ASSERT_EQUAL(MODBUS_OK, Drive_ParkStart(&ctx));
+    int reads = mock_read_call_count;
+
+    ctx.next_poll_us = ctx.start_us + 10000000U;
+    TEST_ASSERT_EQUAL(PARK_MOVING, Drive_ParkPoll(&ctx, 0U));
+    TEST_ASSERT_EQUAL(reads, mock_read_call_count);
+}
+
 // ---- UNITY MAIN ----
 int main(void)
 {
@@ -77,5 +193,11 @@ int main(void)
     RUN_TEST(test_Send_Pan_Command);
     RUN_TEST(test_Send_Tilt_Command);
     RUN_TEST(test_Drive_ParkMotion_completes_successfully);
+    RUN_TEST(test_Drive_ParkMotion_completes_at_rest_after_eta);
+    RUN_TEST(test_Drive_ParkPoll_fails_on_malformed_response);
+    RUN_TEST(test_Drive_ParkPoll_fails_after_lost_responses);
+    RUN_TEST(test_Drive_ParkMotion_fails_when_start_position_invalid);
+    RUN_TEST(test_Drive_ParkPollInterval_is_fast_near_arrival);
+    RUN_TEST(test_Drive_ParkPoll_does_not_block_before_next_poll);
     return UNITY_END();
 }
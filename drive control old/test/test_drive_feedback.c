@@ -20,25 +20,58 @@
    ================================ */
 
 static uint32_t dummy_value_counter = 0;
+static int mock_send_calls = 0;
+static int mock_poll_calls = 0;
 
-ModbusStatus_t MODBUS_UDP_Read(const char *ip, uint16_t port,
-                               uint16_t start_addr, uint16_t num_regs,
-                               uint32_t *value)
+ModbusStatus_t MODBUS_UDP_ReadSend(uint16_t start_addr, uint16_t num_regs,
+                                   ModbusRequest_t *req)
 {
-    (void)ip; (void)port; (void)start_addr; (void)num_regs;
+    (void)start_addr;
+    mock_send_calls++;
+
+    req->num_regs = num_regs;
+    req->done = 0U;
+    req->response[7] = 0x03;
+    req->response[8] = (uint8_t)(num_regs * 2U);
+
+    // Provide dummy incremental 32-bit values for each register pair
+    for (uint16_t i = 0U; i < num_regs; i += 2U)
+    {
+        uint32_t value = 1000 + dummy_value_counter;
+        uint8_t *p = &req->response[9U + (i * 2U)];
+        p[0] = (uint8_t)(value >> 24); p[1] = (uint8_t)(value >> 16);
+        p[2] = (uint8_t)(value >> 8);  p[3] = (uint8_t)value;
+        dummy_value_counter += 100;
+    }
+    req->resp_len = (int32_t)(9U + (num_regs * 2U));
+    return MODBUS_OK;
+}
 
-    // Provide dummy incremental values for each register
-    *value = 1000 + dummy_value_counter;
-    dummy_value_counter += 100;
+ModbusStatus_t MODBUS_UDP_ReadPoll(ModbusRequest_t *reqs, uint8_t count,
+                                   uint32_t timeout_us)
+{
+    (void)timeout_us;
+    mock_poll_calls++;
+    for (uint8_t i = 0U; i < count; i++)
+    {
+        reqs[i].done = 1U;
+    }
     return MODBUS_OK;
 }
 
+const uint8_t *MODBUS_UDP_GetData(const ModbusRequest_t *req)
+{
+    return &req->response[9];
+}
+
 /* ================================
    UNITY SETUP / TEARDOWN
    ================================ */
 void setUp(void)
 {
     dummy_value_counter = 0;
+    mock_send_calls = 0;
+    mock_poll_calls = 0;
 }
 
 void tearDown(void) {}
@@ -56,6 +89,53 @@ void test_Read_Pan_Feedback_should_return_valid_data(void)
     TEST_ASSERT_FLOAT_WITHIN(0.1f, (60.0f * fb.raw_speed) / (float)ENCODER_RESOLUTION, fb.speed_rpm);
 }
 
+void test_Read_Pan_Feedback_should_use_one_block_read(void)
+{
+    AxisFeedback_t fb;
+    TEST_ASSERT_EQUAL(MODBUS_OK, Read_Pan_Feedback(&fb));
+    TEST_ASSERT_EQUAL(1, mock_send_calls);
+    TEST_ASSERT_EQUAL_UINT32(1000, fb.raw_position);
+    TEST_ASSERT_EQUAL_UINT32(1100, fb.raw_speed);
+    TEST_ASSERT_EQUAL_UINT32(1200, fb.raw_counts);
+}
+
+void test_Read_Axes_Feedback_should_complete_in_one_round_trip(void)
+{
+    AxisFeedback_t pan_fb;
+    AxisFeedback_t tilt_fb;
+    TEST_ASSERT_EQUAL(MODBUS_OK, Read_Axes_Feedback(&pan_fb, &tilt_fb));
+    TEST_ASSERT_EQUAL(1, mock_poll_calls);
+    TEST_ASSERT_EQUAL_UINT32(1000, pan_fb.raw_position);
+    TEST_ASSERT_EQUAL_UINT32(1300, tilt_fb.raw_position);
+    TEST_ASSERT_EQUAL(MODBUS_ERROR, Read_Axes_Feedback(&pan_fb, NULL));
+}
+
+void test_Decode_AxisFeedback_should_decode_big_endian_block(void)
+{
+    const uint8_t data[12] = { 0x00, 0x00, 0x04, 0x00,   // 1024 counts
+                               0x00, 0x00, 0x10, 0x00,   // 4096 counts/s
+                               0x00, 0x01, 0x00, 0x00 };
+    AxisFeedback_t fb;
+    Decode_AxisFeedback(data, &fb);
+    TEST_ASSERT_EQUAL_UINT32(1024, fb.raw_position);
+    TEST_ASSERT_EQUAL_UINT32(65536, fb.raw_counts);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, fb.position_deg);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, fb.speed_rpm);
+}
+
+void test_Read_Axes_Position_should_update_encoders(void)
+{
+    Encoder_t pan_enc;
+    Encoder_t tilt_enc;
+    Encoder_Init(&pan_enc, ENCODER_RESOLUTION, 1.0F, 1.0F);
+    Encoder_Init(&tilt_enc, ENCODER_RESOLUTION, 1.0F, 1.0F);
+
+    TEST_ASSERT_EQUAL(MODBUS_OK, Read_Axes_Position(&pan_enc, &tilt_enc));
+    TEST_ASSERT_EQUAL(1, mock_poll_calls);
+    TEST_ASSERT_EQUAL_INT64(1000, Encoder_GetCounts(&pan_enc));
+    TEST_ASSERT_EQUAL_INT64(1100, Encoder_GetCounts(&tilt_enc));
+}
+
 void test_Read_Pan_Feedback_should_return_error_when_null(void)
 {
     ModbusStatus_t status = Read_Pan_Feedback(NULL);
@@ -86,6 +166,10 @@ int main(void)
     UNITY_BEGIN();
     RUN_TEST(test_Read_Pan_Feedback_should_return_valid_data);
     RUN_TEST(test_Read_Pan_Feedback_should_return_error_when_null);
+    RUN_TEST(test_Read_Pan_Feedback_should_use_one_block_read);
+    RUN_TEST(test_Read_Axes_Feedback_should_complete_in_one_round_trip);
+    RUN_TEST(test_Decode_AxisFeedback_should_decode_big_endian_block);
+    RUN_TEST(test_Read_Axes_Position_should_update_encoders);
     RUN_TEST(test_Read_Tilt_Feedback_should_return_valid_data);
     RUN_TEST(test_Read_Tilt_Feedback_should_return_error_when_null);
     return UNITY_END();
@@ -0,0 +1,83 @@
+#include "unity.h"
+#include "encoder.h"
+#include <stdio.h>
+
+static Encoder_t enc;
+
+/* ================================
+   UNITY SETUP / TEARDOWN
+   ================================ */
+void setUp(void)
+{
+    Encoder_Init(&enc, 4096U, 1.0F, 1.0F);
+}
+
+void tearDown(void) {}
+
+/* ================================
+   TEST CASES
+   ================================ */
+void test_Encoder_should_start_at_first_sample(void)
+{
+    Encoder_Update(&enc, 2048U, 0U);
+    TEST_ASSERT_EQUAL_INT64(2048, Encoder_GetCounts(&enc));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 180.0f, Encoder_GetPositionDeg(&enc));
+}
+
+void test_Encoder_should_unwrap_counter_overflow(void)
+{
+    Encoder_Update(&enc, 0xFFFFFF00U, 0U);          /* -256 counts */
+    Encoder_Update(&enc, 0x00000100U, 1000U);       /* +512 across wrap */
+    TEST_ASSERT_EQUAL_INT64(256, Encoder_GetCounts(&enc));
+}
+
+void test_Encoder_should_accumulate_multiple_turns(void)
+{
+    uint32_t raw = 0U;
+    Encoder_Update(&enc, raw, 0U);
+    for (int i = 1; i <= 3000; i++)
+    {
+        raw += 0x00100000U;                        /* wraps every 4096 samples */
+        Encoder_Update(&enc, raw, (uint64_t)i * 1000U);
+    }
+    TEST_ASSERT_TRUE(Encoder_GetCounts(&enc) == (int64_t)3000 * 0x00100000);
+}
+
+void test_Encoder_should_estimate_velocity_from_timestamps(void)
+{
+    Encoder_Update(&enc, 0U, 0U);
+    Encoder_Update(&enc, 4096U, 100000U);           /* 1 rev in 100 ms */
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 600.0f, Encoder_GetVelocityRPM(&enc));
+}
+
+void test_Encoder_should_filter_velocity(void)
+{
+    Encoder_Init(&enc, 4096U, 1.0F, 0.5F);
+    Encoder_Update(&enc, 0U, 0U);
+    Encoder_Update(&enc, 4096U, 100000U);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 300.0f, Encoder_GetVelocityRPM(&enc));
+    Encoder_Update(&enc, 8192U, 200000U);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 450.0f, Encoder_GetVelocityRPM(&enc));
+}
+
+void test_Encoder_should_apply_gear_ratio(void)
+{
+    Encoder_Init(&enc, 4096U, 2.0F, 1.0F);
+    Encoder_Update(&enc, 4096U, 0U);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 180.0f, Encoder_GetPositionDeg(&enc));
+}
+
+/* ================================
+   UNITY TEST RUNNER
+   ================================ */
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_Encoder_should_start_at_first_sample);
+    RUN_TEST(test_Encoder_should_unwrap_counter_overflow);
+    RUN_TEST(test_Encoder_should_accumulate_multiple_turns);
+    RUN_TEST(test_Encoder_should_estimate_velocity_from_timestamps);
+    RUN_TEST(test_Encoder_should_filter_velocity);
+    RUN_TEST(test_Encoder_should_apply_gear_ratio);
+    return UNITY_END();
+}